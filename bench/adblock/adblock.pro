@@ -0,0 +1,11 @@
+include(../bench.pri)
+
+TARGET = adblockbenchmark
+QT += webenginewidgets
+DEFINES += USE_WEBENGINE
+
+SOURCES += adblockbenchmark.cpp \
+           $$ROOT_DIR/src/miscellaneous/simpleregexp.cpp \
+           $$ROOT_DIR/src/network-web/adblock/adblockrule.cpp \
+           $$ROOT_DIR/src/network-web/adblock/adblocksearchtree.cpp \
+           $$ROOT_DIR/src/network-web/adblock/adblocktokenindex.cpp
@@ -0,0 +1,215 @@
+// This file is part of RSS Guard.
+//
+// Copyright (C) 2011-2017 by Martin Rotter <rotter.martinos@gmail.com>
+//
+// RSS Guard is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// RSS Guard is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with RSS Guard. If not, see <http://www.gnu.org/licenses/>.
+
+#include "network-web/adblock/adblockrule.h"
+#include "network-web/adblock/adblocksearchtree.h"
+#include "network-web/adblock/adblocktokenindex.h"
+
+#include "definitions/definitions.h"
+
+#include <QFile>
+#include <QTextStream>
+#include <QUrl>
+#include <QtTest>
+
+
+// Rule with public string matching. Unlike networkMatch(), it does not need
+// request from web engine, which cannot be created outside of it.
+class BenchmarkRule : public AdBlockRule {
+	public:
+		explicit BenchmarkRule(const QString& filter) : AdBlockRule(filter) {
+		}
+
+		using AdBlockRule::stringMatch;
+};
+
+// Compares AdBlockTokenIndex with linear scan of network rules, which it replaced.
+// Rules and URLs are read from "rules.txt" and "urls.txt", other files can be
+// used via RSSGUARD_BENCH_RULES and RSSGUARD_BENCH_URLS variables, for example
+// full EasyList and URLs recorded by own browsing.
+class AdBlockBenchmark : public QObject {
+		Q_OBJECT
+
+	private slots:
+		void initTestCase();
+		void cleanupTestCase();
+		void sameResults();
+		void linearScan();
+		void tokenIndex();
+
+	private:
+		static QStringList readLines(const char* variable, const QString& default_file);
+		static bool matches(const AdBlockRule* rule, const QString& domain, const QString& url_string);
+		static const AdBlockRule* linearFind(const QVector<const AdBlockRule*>& rules, const QString& domain,
+		                                     const QString& url_string);
+
+		QList<BenchmarkRule*> m_rules;
+		QVector<const AdBlockRule*> m_exceptionRules;
+		QVector<const AdBlockRule*> m_blockRules;
+		AdBlockTokenIndex m_exceptionIndex;
+		AdBlockTokenIndex m_blockIndex;
+		QStringList m_domains;
+		QStringList m_urlStrings;
+};
+
+QStringList AdBlockBenchmark::readLines(const char* variable, const QString& default_file) {
+	const QString file_name = qEnvironmentVariableIsSet(variable) ? QString::fromLocal8Bit(qgetenv(variable)) : default_file;
+	QFile file(file_name);
+	QStringList lines;
+
+	if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+		qFatal("Cannot open file '%s'.", qPrintable(file_name));
+	}
+
+	QTextStream stream(&file);
+	stream.setCodec("UTF-8");
+
+	while (!stream.atEnd()) {
+		const QString line = stream.readLine().trimmed();
+
+		if (!line.isEmpty() && !line.startsWith(QL1C('#')) && !line.startsWith(QL1S("[Adblock"))) {
+			lines.append(line);
+		}
+	}
+
+	return lines;
+}
+
+bool AdBlockBenchmark::matches(const AdBlockRule* rule, const QString& domain, const QString& url_string) {
+	return static_cast<const BenchmarkRule*>(rule)->stringMatch(domain, url_string);
+}
+
+const AdBlockRule* AdBlockBenchmark::linearFind(const QVector<const AdBlockRule*>& rules, const QString& domain,
+                                                const QString& url_string) {
+	foreach (const AdBlockRule* rule, rules) {
+		if (matches(rule, domain, url_string)) {
+			return rule;
+		}
+	}
+
+	return 0;
+}
+
+void AdBlockBenchmark::initTestCase() {
+	AdBlockSearchTree exception_tree;
+	AdBlockSearchTree block_tree;
+
+	foreach (const QString& filter, readLines("RSSGUARD_BENCH_RULES", QSL(SRCDIR "/rules.txt"))) {
+		BenchmarkRule* rule = new BenchmarkRule(filter);
+		m_rules.append(rule);
+
+		if (!rule->isEnabled() || rule->isInternalDisabled() || rule->isCssRule() || rule->isDocument() ||
+		    rule->isElemhide()) {
+			continue;
+		}
+
+		// Rules accepted by search trees are matched by them,
+		// only remaining network rules were scanned linearly.
+		if (rule->isException()) {
+			if (!exception_tree.add(rule)) {
+				m_exceptionRules.append(rule);
+			}
+		}
+
+		else if (!block_tree.add(rule)) {
+			m_blockRules.append(rule);
+		}
+	}
+
+	m_exceptionIndex.build(m_exceptionRules);
+	m_blockIndex.build(m_blockRules);
+
+	// URLs are prepared in the same way as by AdBlockManager::block().
+	foreach (const QString& url, readLines("RSSGUARD_BENCH_URLS", QSL(SRCDIR "/urls.txt"))) {
+		const QUrl request_url(url);
+
+		m_urlStrings.append(request_url.toEncoded().toLower());
+		m_domains.append(request_url.host().toLower());
+	}
+}
+
+void AdBlockBenchmark::cleanupTestCase() {
+	qDeleteAll(m_rules);
+	m_rules.clear();
+}
+
+void AdBlockBenchmark::sameResults() {
+	int index_checks = 0;
+
+	for (int i = 0; i < m_urlStrings.size(); i++) {
+		const QString& domain = m_domains.at(i);
+		const QString& url_string = m_urlStrings.at(i);
+		auto counting_match = [&](const AdBlockRule* rule) {
+			index_checks++;
+			return matches(rule, domain, url_string);
+		};
+
+		// Several rules may match single URL, so only presence of match is compared.
+		QCOMPARE(m_exceptionIndex.find(domain, url_string, counting_match) != nullptr,
+		         linearFind(m_exceptionRules, domain, url_string) != nullptr);
+		QCOMPARE(m_blockIndex.find(domain, url_string, counting_match) != nullptr,
+		         linearFind(m_blockRules, domain, url_string) != nullptr);
+	}
+
+	qDebug("%d network rules, %d URLs, token index checks %.1f rules per URL.",
+	       m_exceptionRules.size() + m_blockRules.size(), m_urlStrings.size(),
+	       double(index_checks) / qMax(m_urlStrings.size(), 1));
+}
+
+void AdBlockBenchmark::linearScan() {
+	int blocked = 0;
+
+	QBENCHMARK {
+		blocked = 0;
+
+		for (int i = 0; i < m_urlStrings.size(); i++) {
+			if (linearFind(m_exceptionRules, m_domains.at(i), m_urlStrings.at(i)) == nullptr &&
+			    linearFind(m_blockRules, m_domains.at(i), m_urlStrings.at(i)) != nullptr) {
+				blocked++;
+			}
+		}
+	}
+
+	QVERIFY(blocked <= m_urlStrings.size());
+}
+
+void AdBlockBenchmark::tokenIndex() {
+	int blocked = 0;
+
+	QBENCHMARK {
+		blocked = 0;
+
+		for (int i = 0; i < m_urlStrings.size(); i++) {
+			const QString& domain = m_domains.at(i);
+			const QString& url_string = m_urlStrings.at(i);
+			auto match = [&](const AdBlockRule* rule) {
+				return matches(rule, domain, url_string);
+			};
+
+			if (m_exceptionIndex.find(domain, url_string, match) == nullptr &&
+			    m_blockIndex.find(domain, url_string, match) != nullptr) {
+				blocked++;
+			}
+		}
+	}
+
+	QVERIFY(blocked <= m_urlStrings.size());
+}
+
+QTEST_GUILESS_MAIN(AdBlockBenchmark)
+
+#include "adblockbenchmark.moc"
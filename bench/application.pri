@@ -0,0 +1,10 @@
+# Settings needed by application sources which include "miscellaneous/application.h".
+
+QT += gui widgets sql network xml
+
+INCLUDEPATH += $$ROOT_DIR/src/gui \
+               $$ROOT_DIR/src/gui/dialogs \
+               $$ROOT_DIR/src/dynamic-shortcuts
+
+FORMS += $$ROOT_DIR/src/network-web/downloaditem.ui \
+         $$ROOT_DIR/src/network-web/downloadmanager.ui
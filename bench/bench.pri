@@ -0,0 +1,21 @@
+# Shared settings of all benchmarks.
+
+!linux {
+  error(Benchmarks are supported on Linux only.)
+}
+
+TEMPLATE = app
+CONFIG += c++11 console testcase warn_on
+CONFIG -= app_bundle
+QT += core testlib
+
+ROOT_DIR = $$PWD/..
+INCLUDEPATH += $$ROOT_DIR/src
+DEFINES *= QT_USE_QSTRINGBUILDER QT_USE_FAST_CONCATENATION QT_USE_FAST_OPERATOR_PLUS UNICODE _UNICODE
+DEFINES += SRCDIR='"\\\"$$_PRO_FILE_PWD_\\\""'
+
+# Benchmarks are built only from sources they measure. Functions of those sources
+# which need rest of the application are never called, so they are dropped by
+# the linker instead of linking the whole application.
+QMAKE_CXXFLAGS += -ffunction-sections -fdata-sections
+QMAKE_LFLAGS += -Wl,--gc-sections
@@ -0,0 +1,22 @@
+#################################################################
+#
+# Benchmarks of RSS Guard.
+#
+# Each benchmark is standalone QtTest executable, which is built
+# from the application sources it measures. Benchmarks are built via:
+#
+#   qmake bench.pro
+#   make
+#
+# and each of them is then run on its own, for example:
+#
+#   ./adblock/adblockbenchmark
+#
+#################################################################
+
+TEMPLATE = subdirs
+SUBDIRS = adblock \
+          dates \
+          feedparser \
+          htmlentities \
+          normalization
@@ -0,0 +1,7 @@
+include(../bench.pri)
+include(../application.pri)
+
+TARGET = datesbenchmark
+
+SOURCES += datesbenchmark.cpp \
+           $$ROOT_DIR/src/miscellaneous/textfactory.cpp
@@ -0,0 +1,169 @@
+// This file is part of RSS Guard.
+//
+// Copyright (C) 2011-2017 by Martin Rotter <rotter.martinos@gmail.com>
+//
+// RSS Guard is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// RSS Guard is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with RSS Guard. If not, see <http://www.gnu.org/licenses/>.
+
+#include "definitions/definitions.h"
+#include "miscellaneous/textfactory.h"
+
+#include <QFile>
+#include <QLocale>
+#include <QTextStream>
+#include <QtTest>
+
+
+// Former implementation of TextFactory::parseDateTime(), which matched
+// input against list of date/time patterns.
+static QDateTime parseDateTimeByPatterns(const QString& date_time) {
+	const QString input_date = date_time.simplified();
+	QDateTime dt;
+	QTime time_zone_offset;
+	const QLocale locale(QLocale::C);
+	bool positive_time_zone_offset = false;
+	QStringList date_patterns;
+	date_patterns << QSL("yyyy-MM-ddTHH:mm:ss") << QSL("MMM dd yyyy hh:mm:ss") <<
+	              QSL("MMM d yyyy hh:mm:ss") << QSL("ddd, dd MMM yyyy HH:mm:ss") <<
+	              QSL("dd MMM yyyy") << QSL("yyyy-MM-dd HH:mm:ss.z") << QSL("yyyy-MM-dd") <<
+	              QSL("yyyy") << QSL("yyyy-MM") << QSL("yyyy-MM-dd") << QSL("yyyy-MM-ddThh:mm") <<
+	              QSL("yyyy-MM-ddThh:mm:ss");
+	QStringList timezone_offset_patterns;
+	timezone_offset_patterns << QSL("+hh:mm") << QSL("-hh:mm") << QSL("+hhmm")
+	                         << QSL("-hhmm") << QSL("+hh") << QSL("-hh");
+
+	if (input_date.size() >= TIMEZONE_OFFSET_LIMIT) {
+		foreach (const QString& pattern, timezone_offset_patterns) {
+			time_zone_offset = QTime::fromString(input_date.right(pattern.size()), pattern);
+
+			if (time_zone_offset.isValid()) {
+				positive_time_zone_offset = pattern.at(0) == QL1C('+');
+				break;
+			}
+		}
+	}
+
+	foreach (const QString& pattern, date_patterns) {
+		dt = locale.toDateTime(input_date.left(pattern.size()), pattern);
+
+		if (dt.isValid()) {
+			dt.setTimeSpec(Qt::UTC);
+
+			if (time_zone_offset.isValid()) {
+				if (positive_time_zone_offset) {
+					return dt.addSecs(- QTime(0, 0, 0, 0).secsTo(time_zone_offset));
+				}
+
+				else {
+					return dt.addSecs(QTime(0, 0, 0, 0).secsTo(time_zone_offset));
+				}
+			}
+
+			else {
+				return dt;
+			}
+		}
+	}
+
+	return QDateTime();
+}
+
+// Checks TextFactory::parseDateTime() against corpus of date/time strings
+// used by feeds in "dates.txt" and compares its speed with former parser.
+class DatesBenchmark : public QObject {
+		Q_OBJECT
+
+	private slots:
+		void initTestCase();
+		void corpus_data();
+		void corpus();
+		void patternParser();
+		void tokenizingParser();
+
+	private:
+		static QString toText(const QDateTime& date_time);
+
+		QList<QPair<QString, QString>> m_corpus;
+};
+
+QString DatesBenchmark::toText(const QDateTime& date_time) {
+	return date_time.isValid() ? date_time.toUTC().toString(QSL("yyyy-MM-ddTHH:mm:ss.zzz")) : QSL("invalid");
+}
+
+void DatesBenchmark::initTestCase() {
+	QFile file(QSL(SRCDIR "/dates.txt"));
+
+	QVERIFY(file.open(QIODevice::ReadOnly | QIODevice::Text));
+
+	QTextStream stream(&file);
+	stream.setCodec("UTF-8");
+
+	while (!stream.atEnd()) {
+		const QString line = stream.readLine();
+		const int separator = line.lastIndexOf(QL1C('\t'));
+
+		if (!line.startsWith(QL1C('#')) && separator > 0) {
+			m_corpus.append(qMakePair(line.left(separator), line.mid(separator + 1)));
+		}
+	}
+
+	QVERIFY(!m_corpus.isEmpty());
+}
+
+void DatesBenchmark::corpus_data() {
+	QTest::addColumn<QString>("input");
+	QTest::addColumn<QString>("expected");
+
+	for (int i = 0; i < m_corpus.size(); i++) {
+		QTest::newRow(qPrintable(m_corpus.at(i).first)) << m_corpus.at(i).first << m_corpus.at(i).second;
+	}
+}
+
+void DatesBenchmark::corpus() {
+	QFETCH(QString, input);
+	QFETCH(QString, expected);
+
+	QCOMPARE(toText(TextFactory::parseDateTime(input)), expected);
+}
+
+void DatesBenchmark::patternParser() {
+	int valid = 0;
+
+	QBENCHMARK {
+		valid = 0;
+
+		for (int i = 0; i < m_corpus.size(); i++) {
+			valid += parseDateTimeByPatterns(m_corpus.at(i).first).isValid() ? 1 : 0;
+		}
+	}
+
+	QVERIFY(valid > 0);
+}
+
+void DatesBenchmark::tokenizingParser() {
+	int valid = 0;
+
+	QBENCHMARK {
+		valid = 0;
+
+		for (int i = 0; i < m_corpus.size(); i++) {
+			valid += TextFactory::parseDateTime(m_corpus.at(i).first).isValid() ? 1 : 0;
+		}
+	}
+
+	QVERIFY(valid > 0);
+}
+
+QTEST_GUILESS_MAIN(DatesBenchmark)
+
+#include "datesbenchmark.moc"
@@ -0,0 +1,12 @@
+include(../bench.pri)
+include(../application.pri)
+
+TARGET = feedparserbenchmark
+
+SOURCES += feedparserbenchmark.cpp \
+           $$ROOT_DIR/src/core/message.cpp \
+           $$ROOT_DIR/src/miscellaneous/textfactory.cpp \
+           $$ROOT_DIR/src/network-web/htmlentities.cpp \
+           $$ROOT_DIR/src/network-web/webfactory.cpp \
+           $$ROOT_DIR/src/services/standard/feedparser.cpp \
+           $$ROOT_DIR/src/services/standard/rssparser.cpp
@@ -0,0 +1,278 @@
+// This file is part of RSS Guard.
+//
+// Copyright (C) 2011-2017 by Martin Rotter <rotter.martinos@gmail.com>
+//
+// RSS Guard is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// RSS Guard is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with RSS Guard. If not, see <http://www.gnu.org/licenses/>.
+
+#include "services/standard/rssparser.h"
+
+#include "definitions/definitions.h"
+#include "miscellaneous/textfactory.h"
+#include "network-web/webfactory.h"
+
+#include <QDomDocument>
+#include <QFile>
+#include <QtTest>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+
+#define FEED_MESSAGES             8000
+#define FEED_CHUNK_SIZE           16384
+
+// Former parser of RSS feeds, which built DOM tree of whole document.
+// Messages are extracted in the same way as before streaming parser
+// was introduced, only exception is replaced by return value.
+class DomRssParser {
+	public:
+		explicit DomRssParser(const QString& data) {
+			m_xml.setContent(data, true);
+		}
+
+		QList<Message> messages() const {
+			QList<Message> messages;
+			const QDateTime current_time = QDateTime::currentDateTime();
+			const QDomNodeList messages_in_xml = m_xml.namedItem(QSL("rss")).namedItem(QSL("channel")).toElement()
+			                                     .elementsByTagName(QSL("item"));
+
+			for (int i = 0; i < messages_in_xml.size(); i++) {
+				Message new_message;
+
+				if (extractMessage(messages_in_xml.item(i).toElement(), current_time, new_message)) {
+					messages.append(new_message);
+				}
+			}
+
+			return messages;
+		}
+
+	private:
+		bool extractMessage(const QDomElement& msg_element, const QDateTime& current_time, Message& new_message) const {
+			const QString elem_title = msg_element.namedItem(QSL("title")).toElement().text().simplified();
+			QString elem_description = msg_element.namedItem(QSL("encoded")).toElement().text();
+
+			if (elem_description.isEmpty()) {
+				elem_description = msg_element.namedItem(QSL("description")).toElement().text();
+			}
+
+			if (elem_title.isEmpty()) {
+				if (elem_description.isEmpty()) {
+					return false;
+				}
+
+				new_message.m_title = WebFactory::instance()->stripTags(elem_description.simplified());
+			}
+
+			else {
+				new_message.m_title = WebFactory::instance()->stripTags(elem_title);
+			}
+
+			new_message.m_contents = elem_description;
+			new_message.m_url = msg_element.namedItem(QSL("link")).toElement().text();
+			new_message.m_author = msg_element.namedItem(QSL("author")).toElement().text();
+			new_message.m_created = TextFactory::parseDateTime(msg_element.namedItem(QSL("pubDate")).toElement().text());
+
+			if (!(new_message.m_createdFromFeed = !new_message.m_created.isNull())) {
+				new_message.m_created = current_time;
+			}
+
+			return true;
+		}
+
+		QDomDocument m_xml;
+};
+
+// Compares time and peak memory of streaming RssParser, which is fed with
+// document in chunks as it is downloaded, with former DOM parser.
+class FeedParserBenchmark : public QObject {
+		Q_OBJECT
+
+	private slots:
+		void initTestCase();
+		void sameMessages();
+		void domParser();
+		void streamingParser();
+		void peakMemory();
+
+	private:
+		static QByteArray generateFeed(int message_count);
+		static qint64 statusValue(const QByteArray& name);
+		static qint64 peakMemoryGrowth(QList<Message> (*parse)(const QByteArray& feed), const QByteArray& feed);
+
+		static QList<Message> parseByDom(const QByteArray& feed);
+		static QList<Message> parseByStreaming(const QByteArray& feed);
+
+		QByteArray m_feed;
+};
+
+QByteArray FeedParserBenchmark::generateFeed(int message_count) {
+	QByteArray feed;
+	const QByteArray paragraph = QByteArrayLiteral("&lt;p&gt;Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do "
+	                                               "eiusmod tempor incididunt ut labore et dolore magna aliqua &amp; ut enim "
+	                                               "ad minim veniam, quis nostrud exercitation ullamco laboris.&lt;/p&gt;\n");
+	const QDateTime date(QDate(2017, 5, 2), QTime(8, 30), Qt::UTC);
+	const QLocale c_locale = QLocale::c();
+
+	feed.reserve(message_count * 1600);
+	feed += "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+	        "<rss version=\"2.0\">\n<channel>\n<title>Benchmark feed</title>\n"
+	        "<link>https://www.example.com/</link>\n<description>Generated feed</description>\n";
+
+	for (int i = 0; i < message_count; i++) {
+		feed += "<item>\n<title>Message " + QByteArray::number(i) + " &amp; its   title</title>\n"
+		        "<link>https://www.example.com/articles/" + QByteArray::number(i) + "</link>\n"
+		        "<guid isPermaLink=\"false\">urn:example:" + QByteArray::number(i) + "</guid>\n"
+		        "<category>Benchmark</category>\n"
+		        "<author>editor@example.com (Editor " + QByteArray::number(i % 10) + ")</author>\n"
+		        "<pubDate>" + c_locale.toString(date.addSecs(-60 * i), QSL("ddd, dd MMM yyyy HH:mm:ss")).toLatin1() + " +0000</pubDate>\n"
+		        "<description>";
+
+		for (int j = 0; j < 6; j++) {
+			feed += paragraph;
+		}
+
+		feed += "</description>\n</item>\n";
+	}
+
+	feed += "</channel>\n</rss>\n";
+	return feed;
+}
+
+QList<Message> FeedParserBenchmark::parseByDom(const QByteArray& feed) {
+	// Former parser got whole document decoded to string.
+	return DomRssParser(QString::fromUtf8(feed)).messages();
+}
+
+QList<Message> FeedParserBenchmark::parseByStreaming(const QByteArray& feed) {
+	RssParser parser;
+
+	for (int i = 0; i < feed.size(); i += FEED_CHUNK_SIZE) {
+		parser.addData(feed.mid(i, FEED_CHUNK_SIZE));
+	}
+
+	return parser.messages();
+}
+
+qint64 FeedParserBenchmark::statusValue(const QByteArray& name) {
+	QFile status(QSL("/proc/self/status"));
+
+	if (status.open(QIODevice::ReadOnly)) {
+		foreach (const QByteArray& line, status.readAll().split('\n')) {
+			if (line.startsWith(name + ':')) {
+				// Values are in kB, e.g. "VmHWM:     2048 kB".
+				return line.mid(name.size() + 1).simplified().split(' ').first().toLongLong();
+			}
+		}
+	}
+
+	return -1;
+}
+
+qint64 FeedParserBenchmark::peakMemoryGrowth(QList<Message> (*parse)(const QByteArray& feed), const QByteArray& feed) {
+	// Parser runs in forked process, so that memory
+	// released by former runs does not affect result.
+	int result_pipe[2];
+
+	if (pipe(result_pipe) != 0) {
+		return -1;
+	}
+
+	const pid_t pid = fork();
+
+	if (pid == 0) {
+		QFile clear_refs(QSL("/proc/self/clear_refs"));
+		qint64 growth = -1;
+
+		// Writing "5" resets peak resident memory of process to current one.
+		if (clear_refs.open(QIODevice::WriteOnly) && clear_refs.write("5") == 1) {
+			clear_refs.close();
+			const qint64 resident = statusValue(QByteArrayLiteral("VmHWM"));
+			const QList<Message> messages = parse(feed);
+
+			growth = messages.isEmpty() ? -1 : statusValue(QByteArrayLiteral("VmHWM")) - resident;
+		}
+
+		if (write(result_pipe[1], &growth, sizeof(growth)) != sizeof(growth)) {
+			_exit(1);
+		}
+
+		_exit(0);
+	}
+
+	qint64 growth = -1;
+
+	close(result_pipe[1]);
+
+	if (pid < 0 || read(result_pipe[0], &growth, sizeof(growth)) != sizeof(growth)) {
+		growth = -1;
+	}
+
+	close(result_pipe[0]);
+
+	if (pid > 0) {
+		waitpid(pid, nullptr, 0);
+	}
+
+	return growth;
+}
+
+void FeedParserBenchmark::initTestCase() {
+	m_feed = generateFeed(FEED_MESSAGES);
+	qDebug("Feed has %d messages and %.1f MiB.", FEED_MESSAGES, m_feed.size() / (1024.0 * 1024.0));
+}
+
+void FeedParserBenchmark::sameMessages() {
+	const QList<Message> dom_messages = parseByDom(m_feed);
+	const QList<Message> streamed_messages = parseByStreaming(m_feed);
+
+	QCOMPARE(dom_messages.size(), FEED_MESSAGES);
+	QCOMPARE(streamed_messages.size(), FEED_MESSAGES);
+
+	for (int i = 0; i < FEED_MESSAGES; i++) {
+		QCOMPARE(streamed_messages.at(i).m_title, dom_messages.at(i).m_title);
+		QCOMPARE(streamed_messages.at(i).m_url, dom_messages.at(i).m_url);
+		QCOMPARE(streamed_messages.at(i).m_author, dom_messages.at(i).m_author);
+		QCOMPARE(streamed_messages.at(i).m_contents, dom_messages.at(i).m_contents);
+		QCOMPARE(streamed_messages.at(i).m_created, dom_messages.at(i).m_created);
+	}
+}
+
+void FeedParserBenchmark::domParser() {
+	QBENCHMARK {
+		QCOMPARE(parseByDom(m_feed).size(), FEED_MESSAGES);
+	}
+}
+
+void FeedParserBenchmark::streamingParser() {
+	QBENCHMARK {
+		QCOMPARE(parseByStreaming(m_feed).size(), FEED_MESSAGES);
+	}
+}
+
+void FeedParserBenchmark::peakMemory() {
+	const qint64 dom_growth = peakMemoryGrowth(&FeedParserBenchmark::parseByDom, m_feed);
+	const qint64 streaming_growth = peakMemoryGrowth(&FeedParserBenchmark::parseByStreaming, m_feed);
+
+	if (dom_growth < 0 || streaming_growth < 0) {
+		QSKIP("Peak memory cannot be measured, /proc/self/clear_refs is not supported.");
+	}
+
+	qDebug("Peak memory growth: DOM parser %lld kB, streaming parser %lld kB.", dom_growth, streaming_growth);
+	QVERIFY(streaming_growth < dom_growth);
+}
+
+QTEST_GUILESS_MAIN(FeedParserBenchmark)
+
+#include "feedparserbenchmark.moc"
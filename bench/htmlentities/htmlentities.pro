@@ -0,0 +1,6 @@
+include(../bench.pri)
+
+TARGET = htmlentitiesbenchmark
+
+SOURCES += htmlentitiesbenchmark.cpp \
+           $$ROOT_DIR/src/network-web/htmlentities.cpp
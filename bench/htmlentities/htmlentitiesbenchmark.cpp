@@ -0,0 +1,171 @@
+// This file is part of RSS Guard.
+//
+// Copyright (C) 2011-2017 by Martin Rotter <rotter.martinos@gmail.com>
+//
+// RSS Guard is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// RSS Guard is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with RSS Guard. If not, see <http://www.gnu.org/licenses/>.
+
+#include "definitions/definitions.h"
+#include "network-web/htmlentities.h"
+
+#include <QMap>
+#include <QtTest>
+
+
+// Compares HtmlEntities with former replacing of each known reference
+// in whole text, which was done by WebFactory::escapeHtml() and
+// WebFactory::deEscapeHtml(), on texts of growing size.
+class HtmlEntitiesBenchmark : public QObject {
+		Q_OBJECT
+
+	private slots:
+		void initTestCase();
+		void sameResults();
+		void mapDecoding_data();
+		void mapDecoding();
+		void singlePassDecoding_data();
+		void singlePassDecoding();
+		void mapEncoding_data();
+		void mapEncoding();
+		void singlePassEncoding_data();
+		void singlePassEncoding();
+
+	private:
+		static QString replaceAll(const QString& text, const QMap<QString, QString>& replacements);
+		static QString sample(const QString& text, int size);
+		static void addSizes();
+
+		QMap<QString, QString> m_escapes;
+		QMap<QString, QString> m_deEscapes;
+};
+
+// Text without '"', which former encoding escaped twice, and text
+// without "&nbsp;", which former decoding replaced with plain space.
+static const char* const DECODED_TEXT = "<p>Price & value of 'item' is 5 \xC2\xB1 1 \xC3\x97 2.</p>\n";
+static const char* const ENCODED_TEXT = "&lt;p&gt;Price &amp; value of &#039;item&#039; is 5 &plusmn; 1 &times; 2.&lt;/p&gt;\n";
+
+void HtmlEntitiesBenchmark::initTestCase() {
+	m_escapes[QSL("&lt;")]     = QL1C('<');
+	m_escapes[QSL("&gt;")]     = QL1C('>');
+	m_escapes[QSL("&amp;")]    = QL1C('&');
+	m_escapes[QSL("&quot;")]   = QL1C('\"');
+	m_escapes[QSL("&nbsp;")]   = QL1C(' ');
+	m_escapes[QSL("&plusmn;")]    = QSL("±");
+	m_escapes[QSL("&times;")]  = QSL("×");
+	m_escapes[QSL("&#039;")]   = QL1C('\'');
+
+	m_deEscapes[QSL("<")]  = QSL("&lt;");
+	m_deEscapes[QSL(">")]  = QSL("&gt;");
+	m_deEscapes[QSL("&")]  = QSL("&amp;");
+	m_deEscapes[QSL("\"")]    = QSL("&quot;");
+	m_deEscapes[QSL("±")]  = QSL("&plusmn;");
+	m_deEscapes[QSL("×")]  = QSL("&times;");
+	m_deEscapes[QSL("\'")] = QSL("&#039;");
+}
+
+QString HtmlEntitiesBenchmark::replaceAll(const QString& text, const QMap<QString, QString>& replacements) {
+	QString output = text;
+	QMapIterator<QString, QString> i(replacements);
+
+	while (i.hasNext()) {
+		i.next();
+		output = output.replace(i.key(), i.value());
+	}
+
+	return output;
+}
+
+QString HtmlEntitiesBenchmark::sample(const QString& text, int size) {
+	QString output;
+
+	output.reserve(size + text.size());
+
+	while (output.size() < size) {
+		output += text;
+	}
+
+	return output;
+}
+
+void HtmlEntitiesBenchmark::addSizes() {
+	QTest::addColumn<int>("size");
+
+	foreach (int size, QList<int>() << 1024 << 16 * 1024 << 256 * 1024 << 1024 * 1024) {
+		QTest::newRow(qPrintable(QSL("%1 kB").arg(size / 1024))) << size;
+	}
+}
+
+void HtmlEntitiesBenchmark::sameResults() {
+	const QString decoded = sample(QString::fromUtf8(DECODED_TEXT), 4096);
+	const QString encoded = sample(QString::fromUtf8(ENCODED_TEXT), 4096);
+
+	QCOMPARE(HtmlEntities::decode(encoded), replaceAll(encoded, m_escapes));
+	QCOMPARE(HtmlEntities::encode(decoded), replaceAll(decoded, m_deEscapes));
+	QCOMPARE(HtmlEntities::decode(HtmlEntities::encode(decoded)), decoded);
+}
+
+void HtmlEntitiesBenchmark::mapDecoding_data() {
+	addSizes();
+}
+
+void HtmlEntitiesBenchmark::mapDecoding() {
+	QFETCH(int, size);
+	const QString text = sample(QString::fromUtf8(ENCODED_TEXT), size);
+
+	QBENCHMARK {
+		replaceAll(text, m_escapes);
+	}
+}
+
+void HtmlEntitiesBenchmark::singlePassDecoding_data() {
+	addSizes();
+}
+
+void HtmlEntitiesBenchmark::singlePassDecoding() {
+	QFETCH(int, size);
+	const QString text = sample(QString::fromUtf8(ENCODED_TEXT), size);
+
+	QBENCHMARK {
+		HtmlEntities::decode(text);
+	}
+}
+
+void HtmlEntitiesBenchmark::mapEncoding_data() {
+	addSizes();
+}
+
+void HtmlEntitiesBenchmark::mapEncoding() {
+	QFETCH(int, size);
+	const QString text = sample(QString::fromUtf8(DECODED_TEXT), size);
+
+	QBENCHMARK {
+		replaceAll(text, m_deEscapes);
+	}
+}
+
+void HtmlEntitiesBenchmark::singlePassEncoding_data() {
+	addSizes();
+}
+
+void HtmlEntitiesBenchmark::singlePassEncoding() {
+	QFETCH(int, size);
+	const QString text = sample(QString::fromUtf8(DECODED_TEXT), size);
+
+	QBENCHMARK {
+		HtmlEntities::encode(text);
+	}
+}
+
+QTEST_GUILESS_MAIN(HtmlEntitiesBenchmark)
+
+#include "htmlentitiesbenchmark.moc"
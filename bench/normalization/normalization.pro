@@ -0,0 +1,10 @@
+include(../bench.pri)
+include(../application.pri)
+
+TARGET = normalizationbenchmark
+
+SOURCES += normalizationbenchmark.cpp \
+           $$ROOT_DIR/src/core/message.cpp \
+           $$ROOT_DIR/src/miscellaneous/textfactory.cpp \
+           $$ROOT_DIR/src/network-web/htmlentities.cpp \
+           $$ROOT_DIR/src/network-web/webfactory.cpp
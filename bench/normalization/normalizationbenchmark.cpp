@@ -0,0 +1,134 @@
+// This file is part of RSS Guard.
+//
+// Copyright (C) 2011-2017 by Martin Rotter <rotter.martinos@gmail.com>
+//
+// RSS Guard is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// RSS Guard is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with RSS Guard. If not, see <http://www.gnu.org/licenses/>.
+
+#include "core/message.h"
+#include "definitions/definitions.h"
+#include "miscellaneous/textfactory.h"
+#include "network-web/webfactory.h"
+
+#include <QRegExp>
+#include <QUrl>
+#include <QtTest>
+
+
+#define SAMPLE_MESSAGES           1000
+
+// Compares normalization of downloaded messages, i.e. stripping of tags
+// from their titles followed by Feed::normalizeMessages(), with former
+// implementation based on regular expressions.
+class NormalizationBenchmark : public QObject {
+		Q_OBJECT
+
+	private slots:
+		void initTestCase();
+		void sameResults();
+		void regExpNormalization();
+		void singlePassNormalization();
+
+	private:
+		// Former WebFactory::stripTags() and Feed::normalizeMessages().
+		static void normalizeByRegExps(QList<Message>& messages);
+
+		// Current WebFactory::stripTags() and Feed::normalizeMessages().
+		static void normalize(QList<Message>& messages);
+
+		QList<Message> m_messages;
+};
+
+void NormalizationBenchmark::normalizeByRegExps(QList<Message>& messages) {
+	for (int i = 0; i < messages.size(); i++) {
+		messages[i].m_title = messages[i].m_title.remove(QRegExp(QSL("<[^>]*>")));
+	}
+
+	for (int i = 0; i < messages.size(); i++) {
+		messages[i].m_contents = QUrl::fromPercentEncoding(messages[i].m_contents.toUtf8());
+		messages[i].m_author = messages[i].m_author.toUtf8();
+		messages[i].m_title = QUrl::fromPercentEncoding(messages[i].m_title.toUtf8())
+		                      .replace(QRegExp(QSL("[\\s]{2,}")), QSL(" "))
+		                      .remove(QRegExp(QSL("([\\n\\r])|(^\\s)")));
+	}
+}
+
+void NormalizationBenchmark::normalize(QList<Message>& messages) {
+	for (int i = 0; i < messages.size(); i++) {
+		messages[i].m_title = WebFactory::instance()->stripTags(messages[i].m_title);
+	}
+
+	for (int i = 0; i < messages.size(); i++) {
+		messages[i].m_contents = TextFactory::fromPercentEncoding(messages[i].m_contents);
+		messages[i].m_title = TextFactory::normalizeTitle(TextFactory::fromPercentEncoding(messages[i].m_title));
+	}
+}
+
+void NormalizationBenchmark::initTestCase() {
+	const QStringList titles = QStringList() <<
+	                           QSL("Plain title of the message") <<
+	                           QSL("  Title with <b>tags</b> and   runs of\twhite space ") <<
+	                           QSL("\n\tTitle spread\r\nover several\nlines\n") <<
+	                           QSL("Title%20with%20percent%20encoding") <<
+	                           QSL("Title with <unterminated tag");
+	const QString paragraph = QSL("<p>Lorem ipsum dolor sit amet, <a href=\"https://www.example.com/\">consectetur</a> "
+	                              "adipiscing elit, sed do eiusmod tempor incididunt ut labore et dolore magna aliqua.</p>\n");
+	QString contents;
+
+	for (int i = 0; i < 10; i++) {
+		contents += paragraph;
+	}
+
+	for (int i = 0; i < SAMPLE_MESSAGES; i++) {
+		Message message;
+
+		message.m_title = titles.at(i % titles.size());
+		message.m_author = QSL("Editor %1").arg(i % 10);
+
+		// Some contents contain percent signs.
+		message.m_contents = i % 10 == 0 ? contents + QSL("<p>Up to 50% off, see %C3%A1.</p>") : contents;
+		m_messages.append(message);
+	}
+}
+
+void NormalizationBenchmark::sameResults() {
+	QList<Message> regexp_messages = m_messages;
+	QList<Message> messages = m_messages;
+
+	normalizeByRegExps(regexp_messages);
+	normalize(messages);
+
+	for (int i = 0; i < messages.size(); i++) {
+		QCOMPARE(messages.at(i).m_title, regexp_messages.at(i).m_title);
+		QCOMPARE(messages.at(i).m_contents, regexp_messages.at(i).m_contents);
+		QCOMPARE(messages.at(i).m_author, regexp_messages.at(i).m_author);
+	}
+}
+
+void NormalizationBenchmark::regExpNormalization() {
+	QBENCHMARK {
+		QList<Message> messages = m_messages;
+		normalizeByRegExps(messages);
+	}
+}
+
+void NormalizationBenchmark::singlePassNormalization() {
+	QBENCHMARK {
+		QList<Message> messages = m_messages;
+		normalize(messages);
+	}
+}
+
+QTEST_GUILESS_MAIN(NormalizationBenchmark)
+
+#include "normalizationbenchmark.moc"
@@ -12,7 +12,7 @@ CREATE TABLE IF NOT EXISTS Information (
   inf_value       TEXT        NOT NULL
 );
 -- !
-INSERT INTO Information VALUES (1, 'schema_version', '8');
+INSERT INTO Information VALUES (1, 'schema_version', '13');
 -- !
 CREATE TABLE IF NOT EXISTS Accounts (
   id              INTEGER     PRIMARY KEY,
@@ -28,6 +28,7 @@ CREATE TABLE IF NOT EXISTS TtRssAccounts (
   auth_password   TEXT,
   url             TEXT        NOT NULL,
   force_update    INTEGER(1)  NOT NULL DEFAULT 0 CHECK (force_update >= 0 AND force_update <= 1),
+  last_headline_id INTEGER,
   
   FOREIGN KEY (id) REFERENCES Accounts (id)
 );
@@ -38,6 +39,7 @@ CREATE TABLE IF NOT EXISTS OwnCloudAccounts (
   password        TEXT,
   url             TEXT        NOT NULL,
   force_update    INTEGER(1)  NOT NULL DEFAULT 0 CHECK (force_update >= 0 AND force_update <= 1),
+  last_modified   BIGINT,
   
   FOREIGN KEY (id) REFERENCES Accounts (id)
 );
@@ -75,6 +77,9 @@ CREATE TABLE IF NOT EXISTS Feeds (
   type            INTEGER,
   account_id      INTEGER       NOT NULL,
   custom_id       TEXT,
+  http_etag       TEXT,
+  http_last_mod   TEXT,
+  update_deadline BIGINT,
   
   FOREIGN KEY (account_id) REFERENCES Accounts (id)
 );
@@ -97,10 +102,17 @@ CREATE TABLE IF NOT EXISTS Messages (
   account_id      INTEGER     NOT NULL,
   custom_id       TEXT,
   custom_hash     TEXT,
+  url_hash        BIGINT,
   
   FOREIGN KEY (account_id) REFERENCES Accounts (id)
 );
 -- !
+CREATE INDEX idx_Messages_url_hash ON Messages (account_id, feed(64), url_hash);
+-- !
+CREATE INDEX idx_Messages_custom_id ON Messages (account_id, custom_id(191));
+-- !
+CREATE INDEX idx_Messages_feed_state ON Messages (account_id, feed(64), is_deleted, is_pdeleted, is_read);
+-- !
 DROP TABLE IF EXISTS Labels;
 -- !
 CREATE TABLE IF NOT EXISTS Labels (
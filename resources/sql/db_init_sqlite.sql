@@ -6,7 +6,7 @@ CREATE TABLE IF NOT EXISTS Information (
   inf_value       TEXT        NOT NULL
 );
 -- !
-INSERT INTO Information VALUES (1, 'schema_version', '8');
+INSERT INTO Information VALUES (1, 'schema_version', '13');
 -- !
 CREATE TABLE IF NOT EXISTS Accounts (
   id              INTEGER     PRIMARY KEY,
@@ -22,6 +22,7 @@ CREATE TABLE IF NOT EXISTS TtRssAccounts (
   auth_password   TEXT,
   url             TEXT        NOT NULL,
   force_update    INTEGER(1)  NOT NULL CHECK (force_update >= 0 AND force_update <= 1) DEFAULT 0,
+  last_headline_id INTEGER,
   
   FOREIGN KEY (id) REFERENCES Accounts (id)
 );
@@ -32,6 +33,7 @@ CREATE TABLE IF NOT EXISTS OwnCloudAccounts (
   password        TEXT,
   url             TEXT        NOT NULL,
   force_update    INTEGER(1)  NOT NULL CHECK (force_update >= 0 AND force_update <= 1) DEFAULT 0,
+  last_modified   INTEGER,
   
   FOREIGN KEY (id) REFERENCES Accounts (id)
 );
@@ -70,6 +72,9 @@ CREATE TABLE IF NOT EXISTS Feeds (
   type            INTEGER,
   account_id      INTEGER     NOT NULL,
   custom_id       TEXT,
+  http_etag       TEXT,
+  http_last_mod   TEXT,
+  update_deadline INTEGER,
   
   FOREIGN KEY (account_id) REFERENCES Accounts (id)
 );
@@ -92,10 +97,17 @@ CREATE TABLE IF NOT EXISTS Messages (
   account_id      INTEGER     NOT NULL,
   custom_id       TEXT,
   custom_hash     TEXT,
+  url_hash        INTEGER,
   
   FOREIGN KEY (account_id) REFERENCES Accounts (id)
 );
 -- !
+CREATE INDEX IF NOT EXISTS idx_Messages_url_hash ON Messages (account_id, feed, url_hash);
+-- !
+CREATE INDEX IF NOT EXISTS idx_Messages_custom_id ON Messages (account_id, custom_id);
+-- !
+CREATE INDEX IF NOT EXISTS idx_Messages_feed_state ON Messages (account_id, feed, is_deleted, is_pdeleted, is_read);
+-- !
 DROP TABLE IF EXISTS Labels;
 -- !
 CREATE TABLE IF NOT EXISTS Labels (
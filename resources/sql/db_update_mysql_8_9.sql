@@ -0,0 +1,9 @@
+ALTER TABLE Messages ADD COLUMN url_hash BIGINT;
+-- !
+CREATE INDEX idx_Messages_url_hash ON Messages (account_id, feed(64), url_hash);
+-- !
+CREATE INDEX idx_Messages_custom_id ON Messages (account_id, custom_id(191));
+-- !
+CREATE INDEX idx_Messages_feed_state ON Messages (account_id, feed(64), is_deleted, is_pdeleted, is_read);
+-- !
+UPDATE Information SET inf_value = '9' WHERE inf_key = 'schema_version';
\ No newline at end of file
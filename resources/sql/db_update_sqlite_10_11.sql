@@ -0,0 +1,3 @@
+ALTER TABLE Feeds ADD COLUMN update_deadline INTEGER;
+-- !
+UPDATE Information SET inf_value = '11' WHERE inf_key = 'schema_version';
@@ -0,0 +1,3 @@
+ALTER TABLE OwnCloudAccounts ADD COLUMN last_modified INTEGER;
+-- !
+UPDATE Information SET inf_value = '12' WHERE inf_key = 'schema_version';
@@ -0,0 +1,3 @@
+ALTER TABLE TtRssAccounts ADD COLUMN last_headline_id INTEGER;
+-- !
+UPDATE Information SET inf_value = '13' WHERE inf_key = 'schema_version';
@@ -0,0 +1,9 @@
+ALTER TABLE Messages ADD COLUMN url_hash INTEGER;
+-- !
+CREATE INDEX IF NOT EXISTS idx_Messages_url_hash ON Messages (account_id, feed, url_hash);
+-- !
+CREATE INDEX IF NOT EXISTS idx_Messages_custom_id ON Messages (account_id, custom_id);
+-- !
+CREATE INDEX IF NOT EXISTS idx_Messages_feed_state ON Messages (account_id, feed, is_deleted, is_pdeleted, is_read);
+-- !
+UPDATE Information SET inf_value = '9' WHERE inf_key = 'schema_version';
\ No newline at end of file
@@ -0,0 +1,5 @@
+ALTER TABLE Feeds ADD COLUMN http_etag TEXT;
+-- !
+ALTER TABLE Feeds ADD COLUMN http_last_mod TEXT;
+-- !
+UPDATE Information SET inf_value = '10' WHERE inf_key = 'schema_version';
\ No newline at end of file
@@ -264,6 +264,7 @@ HEADERS +=  src/core/feeddownloader.h \
             src/miscellaneous/iconfactory.h \
             src/miscellaneous/iofactory.h \
             src/miscellaneous/localization.h \
+            src/miscellaneous/messagefingerprintcache.h \
             src/miscellaneous/mutex.h \
             src/miscellaneous/settings.h \
             src/miscellaneous/settingsproperties.h \
@@ -273,6 +274,7 @@ HEADERS +=  src/core/feeddownloader.h \
             src/miscellaneous/textfactory.h \
             src/network-web/basenetworkaccessmanager.h \
             src/network-web/downloader.h \
+            src/network-web/htmlentities.h \
             src/network-web/downloadmanager.h \
             src/network-web/networkfactory.h \
             src/network-web/silentnetworkaccessmanager.h \
@@ -332,7 +334,6 @@ HEADERS +=  src/core/feeddownloader.h \
             src/services/abstract/cacheforserviceroot.h \
             src/services/tt-rss/gui/formeditttrssaccount.h \
             src/gui/guiutilities.h \
-            src/core/messagesmodelcache.h \
             src/core/messagesmodelsqllayer.h \
             src/gui/treeviewcolumnsmenu.h \
             src/services/abstract/labelsrootitem.h \
@@ -393,6 +394,7 @@ SOURCES +=  src/core/feeddownloader.cpp \
             src/miscellaneous/iconfactory.cpp \
             src/miscellaneous/iofactory.cpp \
             src/miscellaneous/localization.cpp \
+            src/miscellaneous/messagefingerprintcache.cpp \
             src/miscellaneous/mutex.cpp \
             src/miscellaneous/settings.cpp \
             src/miscellaneous/simplecrypt/simplecrypt.cpp \
@@ -401,6 +403,7 @@ SOURCES +=  src/core/feeddownloader.cpp \
             src/miscellaneous/textfactory.cpp \
             src/network-web/basenetworkaccessmanager.cpp \
             src/network-web/downloader.cpp \
+            src/network-web/htmlentities.cpp \
             src/network-web/downloadmanager.cpp \
             src/network-web/networkfactory.cpp \
             src/network-web/silentnetworkaccessmanager.cpp \
@@ -458,7 +461,6 @@ SOURCES +=  src/core/feeddownloader.cpp \
             src/services/abstract/cacheforserviceroot.cpp \
             src/services/tt-rss/gui/formeditttrssaccount.cpp \
             src/gui/guiutilities.cpp \
-            src/core/messagesmodelcache.cpp \
             src/core/messagesmodelsqllayer.cpp \
             src/gui/treeviewcolumnsmenu.cpp \
             src/services/abstract/labelsrootitem.cpp \
@@ -515,6 +517,7 @@ equals(USE_WEBENGINE, true) {
                 src/network-web/adblock/adblockrule.h \
                 src/network-web/adblock/adblocksearchtree.h \
                 src/network-web/adblock/adblocksubscription.h \
+                src/network-web/adblock/adblocktokenindex.h \
                 src/network-web/adblock/adblocktreewidget.h \
                 src/network-web/adblock/adblockurlinterceptor.h \
                 src/network-web/urlinterceptor.h \
@@ -530,6 +533,7 @@ equals(USE_WEBENGINE, true) {
                 src/network-web/adblock/adblockrule.cpp \
                 src/network-web/adblock/adblocksearchtree.cpp \
                 src/network-web/adblock/adblocksubscription.cpp \
+                src/network-web/adblock/adblocktokenindex.cpp \
                 src/network-web/adblock/adblocktreewidget.cpp \
                 src/network-web/adblock/adblockurlinterceptor.cpp \
                 src/network-web/networkurlinterceptor.cpp \
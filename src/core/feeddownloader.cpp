@@ -18,6 +18,12 @@
 #include "core/feeddownloader.h"
 
 #include "services/abstract/feed.h"
+#include "services/abstract/serviceroot.h"
+#include "services/abstract/recyclebin.h"
+#include "network-web/downloader.h"
+#include "miscellaneous/application.h"
+#include "miscellaneous/databasequeries.h"
+#include "miscellaneous/messagefingerprintcache.h"
 #include "definitions/definitions.h"
 
 #include <QThread>
@@ -25,14 +31,48 @@
 #include <QThreadPool>
 #include <QMutexLocker>
 #include <QString>
+#include <QUrl>
+#include <QTimer>
+#include <QSqlError>
 
 
+FeedDataParser::FeedDataParser(FeedDownloader* feed_downloader, Feed* feed, const QByteArray& feed_contents)
+	: QRunnable(), m_feedDownloader(feed_downloader), m_feed(feed), m_feedContents(feed_contents) {
+}
+
+void FeedDataParser::run() {
+	qDebug().nospace() << "Parsing new messages for feed "
+	                   << m_feed->customId() << " in thread: \'"
+	                   << QThread::currentThreadId() << "\'.";
+	if (m_feedDownloader->isUpdateStopped()) {
+		// Update was stopped before this job got its turn, data are thrown away.
+		QMetaObject::invokeMethod(m_feedDownloader, "oneFeedParsed", Qt::QueuedConnection,
+		                          Q_ARG(Feed*, m_feed), Q_ARG(QList<Message>, QList<Message>()), Q_ARG(bool, true));
+		return;
+	}
+
+	QList<Message> msgs = m_feed->parseDownloadedData(m_feedContents);
+	// Now, do some general operations on messages (tweak encoding etc.).
+	Feed::normalizeMessages(msgs);
+	QMetaObject::invokeMethod(m_feedDownloader, "oneFeedParsed", Qt::QueuedConnection,
+	                          Q_ARG(Feed*, m_feed), Q_ARG(QList<Message>, msgs), Q_ARG(bool, false));
+}
+
 FeedDownloader::FeedDownloader(QObject* parent)
 	: QObject(parent), m_feeds(QList<Feed*>()), m_mutex(new QMutex()), m_threadPool(new QThreadPool(this)),
-	  m_results(FeedDownloadResults()), m_feedsUpdated(0),
-	  m_feedsUpdating(0), m_feedsOriginalCount(0) {
+	  m_parsingPool(new QThreadPool(this)), m_downloads(QHash<Downloader*, Feed*>()),
+	  m_hostDownloads(QHash<QString, int>()), m_queuedResults(QList<FeedResult>()), m_queuedMessagesCount(0),
+	  m_storingTimer(new QTimer(this)), m_results(FeedDownloadResults()), m_feedsUpdated(0),
+	  m_feedsUpdating(0), m_feedsOriginalCount(0), m_maxDownloads(FEED_DOWNLOADER_MAX_DOWNLOADS),
+	  m_maxHostDownloads(FEED_DOWNLOADER_MAX_HOST_DOWNLOADS), m_updateStopped(0), m_fingerprintHitsAtStart(0),
+	  m_fingerprintMissesAtStart(0) {
 	qRegisterMetaType<FeedDownloadResults>("FeedDownloadResults");
+	qRegisterMetaType<Feed*>("Feed*");
 	m_threadPool->setMaxThreadCount(FEED_DOWNLOADER_MAX_THREADS);
+	m_parsingPool->setMaxThreadCount(qMax(1, QThread::idealThreadCount()));
+	m_storingTimer->setSingleShot(true);
+	m_storingTimer->setInterval(FEED_DOWNLOADER_STORE_LATENCY);
+	connect(m_storingTimer, &QTimer::timeout, this, &FeedDownloader::storingTimeout);
 }
 
 FeedDownloader::~FeedDownloader() {
@@ -43,28 +83,71 @@ FeedDownloader::~FeedDownloader() {
 }
 
 bool FeedDownloader::isUpdateRunning() const {
-	return !m_feeds.isEmpty() || m_feedsUpdating > 0;
+	return !m_feeds.isEmpty() || m_feedsUpdating > 0 || !m_queuedResults.isEmpty();
+}
+
+bool FeedDownloader::isUpdateStopped() const {
+	return m_updateStopped.load() != 0;
 }
 
 void FeedDownloader::updateAvailableFeeds() {
-	while (!m_feeds.isEmpty()) {
-		connect(m_feeds.first(), &Feed::messagesObtained, this, &FeedDownloader::oneFeedUpdateFinished,
-		        (Qt::ConnectionType)(Qt::UniqueConnection | Qt::AutoConnection));
+	bool downloads_full = m_downloads.size() >= m_maxDownloads;
+	bool threads_full = false;
+
+	for (int i = 0; i < m_feeds.size() && !(downloads_full && threads_full);) {
+		Feed* feed = m_feeds.at(i);
 
-		if (m_threadPool->tryStart(m_feeds.first())) {
-			m_feeds.removeFirst();
-			m_feedsUpdating++;
+		if (feed->supportsAsynchronousUpdate()) {
+			const QString host = QUrl(feed->url()).host();
+
+			if (!downloads_full && m_hostDownloads.value(host) < m_maxHostDownloads) {
+				m_feeds.removeAt(i);
+				startFeedDownload(feed, host);
+				downloads_full = m_downloads.size() >= m_maxDownloads;
+				continue;
+			}
 		}
 
-		else {
-			// We want to start update of some feeds but all working threads are occupied.
-			break;
+		else if (!threads_full) {
+			connect(feed, &Feed::messagesObtained, this, &FeedDownloader::oneFeedUpdateFinished,
+			        (Qt::ConnectionType)(Qt::UniqueConnection | Qt::AutoConnection));
+
+			if (m_threadPool->tryStart(feed)) {
+				m_feeds.removeAt(i);
+				m_feedsUpdating++;
+				continue;
+			}
+
+			else {
+				// All working threads are occupied, feeds of this kind must wait.
+				disconnect(feed, &Feed::messagesObtained, this, &FeedDownloader::oneFeedUpdateFinished);
+				threads_full = true;
+			}
 		}
+
+		// This feed cannot be updated right now, try next one.
+		i++;
 	}
 }
 
+void FeedDownloader::startFeedDownload(Feed* feed, const QString& host) {
+	qDebug().nospace() << "Downloading new messages for feed "
+	                   << feed->customId() << " in thread: \'"
+	                   << QThread::currentThreadId() << "\'.";
+	// Save all cached data first.
+	feed->getParentServiceRoot()->saveAllCachedData();
+	Downloader* downloader = new Downloader(this);
+	m_downloads.insert(downloader, feed);
+	m_hostDownloads[host]++;
+	m_feedsUpdating++;
+	connect(downloader, &Downloader::completed, this, &FeedDownloader::oneFeedDownloadFinished);
+	feed->startDownload(downloader);
+}
+
 void FeedDownloader::updateFeeds(const QList<Feed*>& feeds) {
 	QMutexLocker locker(m_mutex);
+	m_fingerprintHitsAtStart = qApp->database()->fingerprintCache()->hits();
+	m_fingerprintMissesAtStart = qApp->database()->fingerprintCache()->misses();
 
 	if (feeds.isEmpty()) {
 		qDebug("No feeds to update in worker thread, aborting update.");
@@ -77,6 +160,9 @@ void FeedDownloader::updateFeeds(const QList<Feed*>& feeds) {
 		m_feedsOriginalCount = m_feeds.size();
 		m_results.clear();
 		m_feedsUpdated = m_feedsUpdating = 0;
+		m_updateStopped.store(0);
+		m_maxDownloads = qMax(1, qApp->settings()->value(GROUP(Feeds), SETTING(Feeds::MaxDownloads)).toInt());
+		m_maxHostDownloads = qMax(1, qApp->settings()->value(GROUP(Feeds), SETTING(Feeds::MaxHostDownloads)).toInt());
 		// Job starts now.
 		emit updateStarted();
 		updateAvailableFeeds();
@@ -84,38 +170,239 @@ void FeedDownloader::updateFeeds(const QList<Feed*>& feeds) {
 }
 
 void FeedDownloader::stopRunningUpdate() {
+	m_updateStopped.store(1);
 	m_threadPool->clear();
 	m_feeds.clear();
+
+	// Running downloads are aborted, their feeds finish with error. Parsing
+	// jobs which did not start yet finish without parsing their data.
+	foreach (Downloader* downloader, m_downloads.keys()) {
+		downloader->cancel();
+	}
 }
 
 void FeedDownloader::oneFeedUpdateFinished(const QList<Message>& messages, bool error_during_obtaining) {
 	QMutexLocker locker(m_mutex);
-	m_feedsUpdated++;
-	m_feedsUpdating--;
 	Feed* feed = qobject_cast<Feed*>(sender());
 	disconnect(feed, &Feed::messagesObtained, this, &FeedDownloader::oneFeedUpdateFinished);
+	queueFeedMessages(feed, messages, error_during_obtaining);
+}
+
+void FeedDownloader::oneFeedDownloadFinished() {
+	QMutexLocker locker(m_mutex);
+	Downloader* downloader = qobject_cast<Downloader*>(sender());
+	Feed* feed = m_downloads.take(downloader);
+	const QString host = QUrl(feed->url()).host();
+
+	if (--m_hostDownloads[host] <= 0) {
+		m_hostDownloads.remove(host);
+	}
+
+	QByteArray feed_contents;
+	bool error_during_obtaining;
+	bool needs_parsing = feed->finishDownload(downloader, &feed_contents, &error_during_obtaining);
+	downloader->deleteLater();
+
+	if (needs_parsing) {
+		// Parsing is left to worker thread, network slot of this feed
+		// can be used by other feed.
+		m_parsingPool->start(new FeedDataParser(this, feed, feed_contents));
+		updateAvailableFeeds();
+	}
+
+	else {
+		queueFeedMessages(feed, QList<Message>(), error_during_obtaining);
+	}
+}
+
+void FeedDownloader::oneFeedParsed(Feed* feed, const QList<Message>& messages, bool error_during_obtaining) {
+	QMutexLocker locker(m_mutex);
+	queueFeedMessages(feed, messages, error_during_obtaining);
+}
+
+void FeedDownloader::storingTimeout() {
+	QMutexLocker locker(m_mutex);
+	storeQueuedMessages();
+}
+
+void FeedDownloader::queueFeedMessages(Feed* feed, const QList<Message>& messages, bool error_during_obtaining) {
+	FeedResult result;
+	result.m_feed = feed;
+	result.m_messages = messages;
+	result.m_errorDuringObtaining = error_during_obtaining;
+	m_queuedResults.append(result);
+	m_queuedMessagesCount += messages.size();
+	m_feedsUpdating--;
 	// Now, we check if there are any feeds we would like to update too.
 	updateAvailableFeeds();
-	// Now make sure, that messages are actually stored to SQL in a locked state.
-	qDebug().nospace() << "Saving messages of feed "
-	                   << feed->id() << " in thread: \'"
+
+	if (m_queuedMessagesCount >= FEED_DOWNLOADER_STORE_BATCH_SIZE || (m_feeds.isEmpty() && m_feedsUpdating <= 0)) {
+		// Batch is full or there is nothing else to wait for.
+		storeQueuedMessages();
+	}
+
+	else if (!m_storingTimer->isActive()) {
+		m_storingTimer->start();
+	}
+}
+
+void FeedDownloader::storeQueuedMessages() {
+	m_storingTimer->stop();
+
+	if (m_queuedResults.isEmpty()) {
+		return;
+	}
+
+	const QList<FeedResult> results = m_queuedResults;
+	QList<int> updated_messages;
+	QList<bool> anything_updated;
+	QList<QPair<int, int>> inserted_counts;
+	m_queuedResults.clear();
+	m_queuedMessagesCount = 0;
+	qDebug().nospace() << "Saving messages of " << results.size() << " feeds in thread: \'"
 	                   << QThread::currentThreadId() << "\'.";
-	int updated_messages = feed->updateMessages(messages, error_during_obtaining);
+	// Now make sure, that messages are actually stored to SQL in a locked state.
+	QSqlDatabase database = qApp->database()->connection(metaObject()->className(), DatabaseFactory::FromSettings);
+	QSqlQuery query_begin_transaction(database);
+	// Whole batch is stored in single transaction, so that it is either stored completely or not at all.
+	bool ok = query_begin_transaction.exec(qApp->database()->obtainBeginTransactionSql());
+
+	if (!ok) {
+		qCritical("Transaction start for message downloader failed: '%s'.", qPrintable(query_begin_transaction.lastError().text()));
+	}
+
+	foreach (const FeedResult& result, results) {
+		bool any_message_changed = false;
+		QPair<int, int> inserted(0, 0);
+		int updated = 0;
+
+		if (ok && !result.m_errorDuringObtaining) {
+			updated = result.m_feed->storeMessages(database, result.m_messages, &any_message_changed, &inserted);
+		}
+
+		updated_messages.append(updated);
+		anything_updated.append(any_message_changed);
+		inserted_counts.append(inserted);
+	}
+
+	if (ok && !database.commit()) {
+		qCritical("Transaction commit for message downloader failed: '%s'.", qPrintable(database.lastError().text()));
+
+		if (!database.rollback()) {
+			qCritical("Transaction rollback for message downloader failed: '%s'.", qPrintable(database.lastError().text()));
+		}
+
+		// Fingerprints of messages which were not stored in the end must be forgotten.
+		qApp->database()->fingerprintCache()->clear();
+		ok = false;
+	}
+
+	foreach (const FeedResult& result, results) {
+		result.m_feed->updateStateCommitted(ok && !result.m_errorDuringObtaining);
+	}
+
+	// Feeds are now updated, gather items which need recalculation of counts
+	// and notification of model. Feeds of each account are processed together.
+	QList<ServiceRoot*> service_roots;
+	QHash<ServiceRoot*, QList<Feed*>> feeds_to_recount;
+	QHash<ServiceRoot*, QList<RootItem*>> items_to_update;
+	QList<ServiceRoot*> bins_to_recount;
+
+	for (int i = 0; i < results.size(); i++) {
+		Feed* feed = results.at(i).m_feed;
+		ServiceRoot* service_root = feed->getParentServiceRoot();
+
+		if (!service_roots.contains(service_root)) {
+			service_roots.append(service_root);
+		}
+
+		if (!ok && !results.at(i).m_errorDuringObtaining) {
+			// Messages were obtained, but they could not be stored.
+			feed->setStatus(Feed::OtherError);
+		}
+
+		else if (ok && !results.at(i).m_errorDuringObtaining) {
+			feed->setStatus(updated_messages.at(i) > 0 ? Feed::NewMessages : Feed::Normal);
+
+			if (anything_updated.at(i)) {
+				// Some already existing messages were changed, their previous state
+				// is not known here, so counts are recalculated from database.
+				feeds_to_recount[service_root].append(feed);
+
+				if (!bins_to_recount.contains(service_root)) {
+					bins_to_recount.append(service_root);
+				}
+			}
 
-	/*
-	QMetaObject::invokeMethod(feed, "updateMessages", Qt::BlockingQueuedConnection,
-	                          Q_RETURN_ARG(int, updated_messages),
-	                          Q_ARG(QList<Message>, messages));
-	*/
+			else {
+				// Only new messages were added, counts can be simply adjusted.
+				// NOTE: Counts are changed in main thread, where they are read.
+				QMetaObject::invokeMethod(feed, "changeCounts", Qt::QueuedConnection,
+				                          Q_ARG(int, inserted_counts.at(i).first),
+				                          Q_ARG(int, inserted_counts.at(i).second));
+			}
 
-	if (updated_messages > 0) {
-		m_results.appendUpdatedFeed(QPair<QString, int>(feed->title(), updated_messages));
+			if (updated_messages.at(i) > 0) {
+				m_results.appendUpdatedFeed(QPair<QString, int>(feed->title(), updated_messages.at(i)));
+			}
+		}
+
+		if (feed->autoUpdateType() == Feed::AdaptiveAutoUpdate) {
+			feed->updateAutoUpdateStatistics(database, !ok || results.at(i).m_errorDuringObtaining);
+		}
+
+		items_to_update[service_root].append(feed);
 	}
 
-	qDebug("Made progress in feed updates, total feeds count %d/%d (id of feed is %d).", m_feedsUpdated, m_feedsOriginalCount, feed->id());
-	emit updateProgress(feed, m_feedsUpdated, m_feedsOriginalCount);
+	foreach (ServiceRoot* service_root, service_roots) {
+		const QList<Feed*> feeds = feeds_to_recount.value(service_root);
+
+		if (!feeds.isEmpty()) {
+			QList<int> feed_ids;
+			bool counts_ok;
+
+			foreach (const Feed* feed, feeds) {
+				feed_ids.append(feed->customId());
+			}
+
+			QMap<int, QPair<int, int>> counts = DatabaseQueries::getMessageCountsForFeeds(database, feed_ids,
+			                                                                              service_root->accountId(),
+			                                                                              &counts_ok);
+
+			foreach (Feed* feed, feeds) {
+				if (counts_ok) {
+					const QPair<int, int> feed_counts = counts.value(feed->customId(), QPair<int, int>(0, 0));
+					QMetaObject::invokeMethod(feed, "setCounts", Qt::QueuedConnection,
+					                          Q_ARG(int, feed_counts.first), Q_ARG(int, feed_counts.second));
+				}
+
+				else {
+					QMetaObject::invokeMethod(feed, "updateCounts", Qt::QueuedConnection, Q_ARG(bool, true));
+				}
+			}
+		}
+
+		if (bins_to_recount.contains(service_root) && service_root->recycleBin() != nullptr) {
+			RecycleBin* bin = service_root->recycleBin();
+			const int bin_unread_count = DatabaseQueries::getMessageCountsForBin(database, service_root->accountId(), false);
+			const int bin_total_count = DatabaseQueries::getMessageCountsForBin(database, service_root->accountId(), true);
+
+			QMetaObject::invokeMethod(bin, "setCounts", Qt::QueuedConnection,
+			                          Q_ARG(int, bin_unread_count), Q_ARG(int, bin_total_count));
+			items_to_update[service_root].append(bin);
+		}
 
-	if (m_feeds.isEmpty() && m_feedsUpdating <= 0) {
+		service_root->itemChanged(items_to_update.value(service_root));
+	}
+
+	foreach (const FeedResult& result, results) {
+		m_feedsUpdated++;
+		qDebug("Made progress in feed updates, total feeds count %d/%d (id of feed is %d).",
+		       m_feedsUpdated, m_feedsOriginalCount, result.m_feed->id());
+		emit updateProgress(result.m_feed, m_feedsUpdated, m_feedsOriginalCount);
+	}
+
+	if (m_feeds.isEmpty() && m_feedsUpdating <= 0 && m_queuedResults.isEmpty()) {
 		finalizeUpdate();
 	}
 }
@@ -123,6 +410,14 @@ void FeedDownloader::oneFeedUpdateFinished(const QList<Message>& messages, bool
 void FeedDownloader::finalizeUpdate() {
 	qDebug().nospace() << "Finished feed updates in thread: \'" << QThread::currentThreadId() << "\'.";
 	m_results.sort();
+
+	// NOTE: Counters of the cache are not reset when it is cleared.
+	const MessageFingerprintCache* fingerprints = qApp->database()->fingerprintCache();
+	m_results.setFingerprintCacheStatistics(fingerprints->hits() - m_fingerprintHitsAtStart,
+	                                        fingerprints->misses() - m_fingerprintMissesAtStart);
+	qDebug("Fingerprint cache skipped %llu of %llu looked up messages during the update.",
+	       m_results.fingerprintHits(), m_results.fingerprintHits() + m_results.fingerprintMisses());
+
 	// Update of feeds has finished.
 	// NOTE: This means that now "update lock" can be unlocked
 	// and feeds can be added/edited/deleted and application
@@ -130,7 +425,8 @@ void FeedDownloader::finalizeUpdate() {
 	emit updateFinished(m_results);
 }
 
-FeedDownloadResults::FeedDownloadResults() : m_updatedFeeds(QList<QPair<QString, int>>()) {
+FeedDownloadResults::FeedDownloadResults()
+	: m_updatedFeeds(QList<QPair<QString, int>>()), m_fingerprintHits(0), m_fingerprintMisses(0) {
 }
 
 QString FeedDownloadResults::overview(int how_many_feeds) const {
@@ -163,6 +459,21 @@ bool FeedDownloadResults::lessThan(const QPair<QString, int>& lhs, const QPair<Q
 
 void FeedDownloadResults::clear() {
 	m_updatedFeeds.clear();
+	m_fingerprintHits = 0;
+	m_fingerprintMisses = 0;
+}
+
+quint64 FeedDownloadResults::fingerprintHits() const {
+	return m_fingerprintHits;
+}
+
+quint64 FeedDownloadResults::fingerprintMisses() const {
+	return m_fingerprintMisses;
+}
+
+void FeedDownloadResults::setFingerprintCacheStatistics(quint64 hits, quint64 misses) {
+	m_fingerprintHits = hits;
+	m_fingerprintMisses = misses;
 }
 
 QList<QPair<QString, int>> FeedDownloadResults::updatedFeeds() const {
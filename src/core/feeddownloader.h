@@ -21,13 +21,19 @@
 #include <QObject>
 
 #include <QPair>
+#include <QHash>
+#include <QRunnable>
+#include <QAtomicInt>
 
 #include "core/message.h"
 
 
 class Feed;
+class FeedDownloader;
+class Downloader;
 class QThreadPool;
 class QMutex;
+class QTimer;
 
 // Represents results of batch feed updates.
 class FeedDownloadResults {
@@ -41,14 +47,42 @@ class FeedDownloadResults {
 		void sort();
 		void clear();
 
+		// Numbers of messages which were (or were not) skipped during
+		// the update because fingerprint cache knew them as unchanged.
+		quint64 fingerprintHits() const;
+		quint64 fingerprintMisses() const;
+		void setFingerprintCacheStatistics(quint64 hits, quint64 misses);
+
 		static bool lessThan(const QPair<QString, int>& lhs, const QPair<QString, int>& rhs);
 
 	private:
 		// QString represents title if the feed, int represents count of newly downloaded messages.
 		QList<QPair<QString, int>> m_updatedFeeds;
+		quint64 m_fingerprintHits;
+		quint64 m_fingerprintMisses;
+};
+
+// Parses data of one asynchronously downloaded feed in worker thread
+// and hands obtained messages back to feed downloader.
+class FeedDataParser : public QRunnable {
+	public:
+		explicit FeedDataParser(FeedDownloader* feed_downloader, Feed* feed, const QByteArray& feed_contents);
+
+		void run();
+
+	private:
+		FeedDownloader* m_feedDownloader;
+		Feed* m_feed;
+		QByteArray m_feedContents;
 };
 
 // This class offers means to "update" feeds and "special" categories.
+// Feeds which support it are updated in three stages. Their data are downloaded
+// asynchronously (with global and per-host limit of parallel downloads), then parsed
+// in pool of worker threads and finally stored by this class. Results of many
+// feeds are stored in batches, each one in single transaction, and counts of
+// all feeds of the batch are then recalculated at once.
+// Other feeds are updated in limited pool of threads via blocking Feed::run().
 // NOTE: This class is used within separate thread.
 class FeedDownloader : public QObject {
 		Q_OBJECT
@@ -60,6 +94,10 @@ class FeedDownloader : public QObject {
 
 		bool isUpdateRunning() const;
 
+		// Returns true if running update was requested to stop.
+		// Can be called from any thread.
+		bool isUpdateStopped() const;
+
 	public slots:
 		// Performs update of all feeds from the "feeds" parameter.
 		// New messages are downloaded for each feed and they
@@ -72,6 +110,9 @@ class FeedDownloader : public QObject {
 
 	private slots:
 		void oneFeedUpdateFinished(const QList<Message>& messages, bool error_during_obtaining);
+		void oneFeedDownloadFinished();
+		void oneFeedParsed(Feed* feed, const QList<Message>& messages, bool error_during_obtaining);
+		void storingTimeout();
 
 	signals:
 		// Emitted if feed updates started.
@@ -89,16 +130,52 @@ class FeedDownloader : public QObject {
 
 	private:
 		void updateAvailableFeeds();
+		void startFeedDownload(Feed* feed, const QString& host);
+		void queueFeedMessages(Feed* feed, const QList<Message>& messages, bool error_during_obtaining);
+		void storeQueuedMessages();
 		void finalizeUpdate();
 
+		// Update result of one feed, which waits to be stored.
+		struct FeedResult {
+			Feed* m_feed;
+			QList<Message> m_messages;
+			bool m_errorDuringObtaining;
+		};
+
 		QList<Feed*> m_feeds;
 		QMutex* m_mutex;
+
+		// Pool for feeds which must be updated in blocking way.
 		QThreadPool* m_threadPool;
+
+		// Pool for parsing of asynchronously downloaded data.
+		QThreadPool* m_parsingPool;
+
+		// Running downloads with feeds they belong to and numbers
+		// of running downloads per host.
+		QHash<Downloader*, Feed*> m_downloads;
+		QHash<QString, int> m_hostDownloads;
+
+		// Results waiting to be stored. They are stored when there is
+		// enough of messages or when timer times out.
+		QList<FeedResult> m_queuedResults;
+		int m_queuedMessagesCount;
+		QTimer* m_storingTimer;
 		FeedDownloadResults m_results;
 
 		int m_feedsUpdated;
 		int m_feedsUpdating;
 		int m_feedsOriginalCount;
+
+		// Limits of simultaneous downloads, loaded when update starts.
+		int m_maxDownloads;
+		int m_maxHostDownloads;
+
+		QAtomicInt m_updateStopped;
+
+		// Counters of fingerprint cache when update started.
+		quint64 m_fingerprintHitsAtStart;
+		quint64 m_fingerprintMissesAtStart;
 };
 
 #endif // FEEDDOWNLOADER_H
@@ -327,46 +327,6 @@ StandardServiceRoot* FeedsModel::standardServiceRoot() const {
 	return nullptr;
 }
 
-QList<Feed*> FeedsModel::feedsForScheduledUpdate(bool auto_update_now) {
-	QList<Feed*> feeds_for_update;
-
-	foreach (Feed* feed, m_rootItem->getSubTreeFeeds()) {
-		switch (feed->autoUpdateType()) {
-			case Feed::DontAutoUpdate:
-				// Do not auto-update this feed ever.
-				continue;
-
-			case Feed::DefaultAutoUpdate:
-				if (auto_update_now) {
-					feeds_for_update.append(feed);
-				}
-
-				break;
-
-			case Feed::SpecificAutoUpdate:
-			default:
-				int remaining_interval = feed->autoUpdateRemainingInterval();
-
-				if (--remaining_interval <= 0) {
-					// Interval of this feed passed, include this feed in the output list
-					// and reset the interval.
-					feeds_for_update.append(feed);
-					feed->setAutoUpdateRemainingInterval(feed->autoUpdateInitialInterval());
-				}
-
-				else {
-					// Interval did not pass, set new decremented interval and do NOT
-					// include this feed in the output list.
-					feed->setAutoUpdateRemainingInterval(remaining_interval);
-				}
-
-				break;
-		}
-	}
-
-	return feeds_for_update;
-}
-
 QList<Message> FeedsModel::messagesForItem(RootItem* item) const {
 	return item->undeletedMessages();
 }
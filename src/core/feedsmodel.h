@@ -72,15 +72,6 @@ class FeedsModel : public QAbstractItemModel {
 		// Direct and the only global accessor to standard service root.
 		StandardServiceRoot* standardServiceRoot() const;
 
-		// Returns the list of feeds which should be updated
-		// according to auto-update schedule.
-		// Variable "auto_update_now" is true, when global timeout
-		// for scheduled auto-update was met and global auto-update strategy is enabled
-		// so feeds with "default" auto-update strategy should be updated.
-		//
-		// This method might change some properties of some feeds.
-		QList<Feed*> feedsForScheduledUpdate(bool auto_update_now);
-
 		// Returns (undeleted) messages for given feeds.
 		// This is usually used for displaying whole feeds
 		// in "newspaper" mode.
@@ -73,7 +73,7 @@ Message::Message() {
 }
 
 Message Message::fromSqlRecord(const QSqlRecord& record, bool* result) {
-	if (record.count() != MSG_DB_CUSTOM_HASH_INDEX + 1) {
+	if (record.count() < MSG_DB_CUSTOM_HASH_INDEX + 1) {
 		if (result != nullptr) {
 			*result = false;
 			return Message();
@@ -24,15 +24,16 @@
 #include "miscellaneous/iconfactory.h"
 #include "miscellaneous/databasequeries.h"
 #include "services/abstract/serviceroot.h"
-#include "core/messagesmodelcache.h"
 #include "services/abstract/recyclebin.h"
 
-#include <QSqlField>
+#include <QSqlQuery>
+#include <QSqlError>
 
 
 MessagesModel::MessagesModel(QObject* parent)
-	: QSqlQueryModel(parent), MessagesModelSqlLayer(),
-	  m_cache(new MessagesModelCache(this)), m_messageHighlighter(NoHighlighting), m_customDateFormat(QString()) {
+	: QAbstractTableModel(parent), MessagesModelSqlLayer(),
+	  m_messages(QList<QSqlRecord>()), m_canFetchMore(false), m_messageHighlighter(NoHighlighting),
+	  m_customDateFormat(QString()) {
 	setupFonts();
 	setupIcons();
 	setupHeaderData();
@@ -51,20 +52,86 @@ void MessagesModel::setupIcons() {
 }
 
 void MessagesModel::repopulate() {
-	m_cache->clear();
-	setQuery(selectStatement(), m_db);
+	beginResetModel();
+	m_messages.clear();
+	m_messages = fetchNextPage();
+	endResetModel();
+}
+
+QList<QSqlRecord> MessagesModel::fetchNextPage() {
+	QList<QSqlRecord> page;
+	QVariantList bound_values;
+	QSqlQuery query(m_db);
+	const QString statement = selectStatement(m_messages.isEmpty() ? QSqlRecord() : m_messages.last(),
+	                                          m_messages.size(), MSG_MODEL_PAGE_SIZE, &bound_values);
+
+	query.setForwardOnly(true);
+	query.prepare(statement);
+
+	foreach (const QVariant& value, bound_values) {
+		query.addBindValue(value);
+	}
+
+	if (!query.exec()) {
+		qWarning("Failed to fetch messages for the list: '%s'.", qPrintable(query.lastError().text()));
+		m_canFetchMore = false;
+		return page;
+	}
+
+	while (query.next()) {
+		page.append(query.record());
+	}
+
+	// Short page means that there are no more messages.
+	m_canFetchMore = page.size() == MSG_MODEL_PAGE_SIZE;
+	return page;
+}
+
+int MessagesModel::rowCount(const QModelIndex& parent) const {
+	return parent.isValid() ? 0 : m_messages.size();
+}
+
+int MessagesModel::columnCount(const QModelIndex& parent) const {
+	return parent.isValid() ? 0 : m_headerData.size();
+}
+
+bool MessagesModel::canFetchMore(const QModelIndex& parent) const {
+	return !parent.isValid() && m_canFetchMore;
+}
+
+void MessagesModel::fetchMore(const QModelIndex& parent) {
+	if (!canFetchMore(parent)) {
+		return;
+	}
+
+	const QList<QSqlRecord> page = fetchNextPage();
 
-	while (canFetchMore()) {
-		fetchMore();
+	if (!page.isEmpty()) {
+		beginInsertRows(QModelIndex(), m_messages.size(), m_messages.size() + page.size() - 1);
+		m_messages.append(page);
+		endInsertRows();
 	}
 }
 
 bool MessagesModel::setData(const QModelIndex& index, const QVariant& value, int role) {
 	Q_UNUSED(role)
-	m_cache->setData(index, value, record(index.row()));
+
+	if (!index.isValid() || index.row() >= m_messages.size()) {
+		return false;
+	}
+
+	m_messages[index.row()].setValue(index.column(), value);
 	return true;
 }
 
+QVariant MessagesModel::fieldValue(const QModelIndex& index) const {
+	if (!index.isValid() || index.row() >= m_messages.size()) {
+		return QVariant();
+	}
+
+	return m_messages.at(index.row()).value(index.column());
+}
+
 
 void MessagesModel::setupFonts() {
 	m_normalFont = Application::font("MessagesView");
@@ -150,7 +217,17 @@ void MessagesModel::reloadWholeLayout() {
 }
 
 Message MessagesModel::messageAt(int row_index) const {
-	return Message::fromSqlRecord(m_cache->containsData(row_index) ? m_cache->record(row_index) : record(row_index));
+	Message message = messageHeaderAt(row_index);
+
+	if (message.m_id > 0) {
+		message.m_contents = DatabaseQueries::getMessageContents(m_db, message.m_id);
+	}
+
+	return message;
+}
+
+Message MessagesModel::messageHeaderAt(int row_index) const {
+	return Message::fromSqlRecord(row_index >= 0 && row_index < m_messages.size() ? m_messages.at(row_index) : QSqlRecord());
 }
 
 void MessagesModel::setupHeaderData() {
@@ -190,14 +267,13 @@ QVariant MessagesModel::data(int row, int column, int role) const {
 }
 
 QVariant MessagesModel::data(const QModelIndex& idx, int role) const {
-	// This message is not in cache, return real data from live query.
 	switch (role) {
 		// Human readable data for viewing.
 		case Qt::DisplayRole: {
 			int index_column = idx.column();
 
 			if (index_column == MSG_DB_DCREATED_INDEX) {
-				QDateTime dt = TextFactory::parseDateTime(QSqlQueryModel::data(idx, role).value<qint64>()).toLocalTime();
+				QDateTime dt = TextFactory::parseDateTime(fieldValue(idx).value<qint64>()).toLocalTime();
 
 				if (m_customDateFormat.isEmpty()) {
 					return dt.toString(Qt::DefaultLocaleShortDate);
@@ -209,12 +285,12 @@ QVariant MessagesModel::data(const QModelIndex& idx, int role) const {
 			}
 
 			else if (index_column == MSG_DB_AUTHOR_INDEX) {
-				const QString author_name = QSqlQueryModel::data(idx, role).toString();
+				const QString author_name = fieldValue(idx).toString();
 				return author_name.isEmpty() ? QSL("-") : author_name;
 			}
 
 			else if (index_column != MSG_DB_IMPORTANT_INDEX && index_column != MSG_DB_READ_INDEX) {
-				return QSqlQueryModel::data(idx, role);
+				return fieldValue(idx);
 			}
 
 			else {
@@ -223,7 +299,7 @@ QVariant MessagesModel::data(const QModelIndex& idx, int role) const {
 		}
 
 		case Qt::EditRole:
-			return m_cache->containsData(idx.row()) ? m_cache->data(idx) : QSqlQueryModel::data(idx, role);
+			return fieldValue(idx);
 
 		case Qt::FontRole: {
 			QModelIndex idx_read = index(idx.row(), MSG_DB_READ_INDEX);
@@ -256,13 +332,13 @@ QVariant MessagesModel::data(const QModelIndex& idx, int role) const {
 			switch (m_messageHighlighter) {
 				case HighlightImportant: {
 					QModelIndex idx_important = index(idx.row(), MSG_DB_IMPORTANT_INDEX);
-					QVariant dta = m_cache->containsData(idx_important.row()) ? m_cache->data(idx_important) : QSqlQueryModel::data(idx_important);
+					QVariant dta = fieldValue(idx_important);
 					return dta.toInt() == 1 ? QColor(Qt::blue) : QVariant();
 				}
 
 				case HighlightUnread: {
 					QModelIndex idx_read = index(idx.row(), MSG_DB_READ_INDEX);
-					QVariant dta = m_cache->containsData(idx_read.row()) ? m_cache->data(idx_read) : QSqlQueryModel::data(idx_read);
+					QVariant dta = fieldValue(idx_read);
 					return dta.toInt() == 0 ? QColor(Qt::blue) : QVariant();
 				}
 
@@ -276,13 +352,13 @@ QVariant MessagesModel::data(const QModelIndex& idx, int role) const {
 
 			if (index_column == MSG_DB_READ_INDEX) {
 				QModelIndex idx_read = index(idx.row(), MSG_DB_READ_INDEX);
-				QVariant dta = m_cache->containsData(idx_read.row()) ? m_cache->data(idx_read) : QSqlQueryModel::data(idx_read);
+				QVariant dta = fieldValue(idx_read);
 				return dta.toInt() == 1 ? m_readIcon : m_unreadIcon;
 			}
 
 			else if (index_column == MSG_DB_IMPORTANT_INDEX) {
 				QModelIndex idx_important = index(idx.row(), MSG_DB_IMPORTANT_INDEX);
-				QVariant dta = m_cache->containsData(idx_important.row()) ? m_cache->data(idx_important) : QSqlQueryModel::data(idx_important);
+				QVariant dta = fieldValue(idx_important);
 				return dta.toInt() == 1 ? m_favoriteIcon : QVariant();
 			}
 
@@ -303,7 +379,7 @@ bool MessagesModel::setMessageRead(int row_index, RootItem::ReadStatus read) {
 		return true;
 	}
 
-	Message message = messageAt(row_index);
+	Message message = messageHeaderAt(row_index);
 
 	if (!m_selectedItem->getParentServiceRoot()->onBeforeSetMessagesRead(m_selectedItem, QList<Message>() << message, read)) {
 		// Cannot change read status of the item. Abort.
@@ -319,8 +395,11 @@ bool MessagesModel::setMessageRead(int row_index, RootItem::ReadStatus read) {
 		return false;
 	}
 
-	if (DatabaseQueries::markMessagesReadUnread(m_db, QStringList() << QString::number(message.m_id), read)) {
-		return m_selectedItem->getParentServiceRoot()->onAfterSetMessagesRead(m_selectedItem, QList<Message>() << message, read);
+	QMap<int, QPair<int, int>> changed_counts;
+
+	if (DatabaseQueries::markMessagesReadUnread(m_db, QStringList() << QString::number(message.m_id), read, &changed_counts)) {
+		return m_selectedItem->getParentServiceRoot()->onAfterSetMessagesRead(m_selectedItem, QList<Message>() << message, read,
+		                                                                      changed_counts);
 	}
 
 	else {
@@ -351,7 +430,7 @@ bool MessagesModel::switchMessageImportance(int row_index) {
 	const RootItem::Importance current_importance = (RootItem::Importance) data(target_index, Qt::EditRole).toInt();
 	const RootItem::Importance next_importance = current_importance == RootItem::Important ?
 	                                             RootItem::NotImportant : RootItem::Important;
-	const Message message = messageAt(row_index);
+	const Message message = messageHeaderAt(row_index);
 	const QPair<Message, RootItem::Importance> pair(message, next_importance);
 
 	if (!m_selectedItem->getParentServiceRoot()->onBeforeSwitchMessageImportance(m_selectedItem,
@@ -386,7 +465,7 @@ bool MessagesModel::switchBatchMessageImportance(const QModelIndexList& messages
 
 	// Obtain IDs of all desired messages.
 	foreach (const QModelIndex& message, messages) {
-		const Message msg = messageAt(message.row());
+		const Message msg = messageHeaderAt(message.row());
 		RootItem::Importance message_importance = messageImportance((message.row()));
 		message_states.append(QPair<Message, RootItem::Importance>(msg, message_importance == RootItem::Important ?
 		                                                           RootItem::NotImportant :
@@ -419,7 +498,7 @@ bool MessagesModel::setBatchMessagesDeleted(const QModelIndexList& messages) {
 
 	// Obtain IDs of all desired messages.
 	foreach (const QModelIndex& message, messages) {
-		const Message msg = messageAt(message.row());
+		const Message msg = messageHeaderAt(message.row());
 		msgs.append(msg);
 		message_ids.append(QString::number(msg.m_id));
 
@@ -438,18 +517,19 @@ bool MessagesModel::setBatchMessagesDeleted(const QModelIndexList& messages) {
 		return false;
 	}
 
+	QMap<int, QPair<int, int>> changed_counts;
 	bool deleted;
 
 	if (m_selectedItem->kind() != RootItemKind::Bin) {
-		deleted = DatabaseQueries::deleteOrRestoreMessagesToFromBin(m_db, message_ids, true);
+		deleted = DatabaseQueries::deleteOrRestoreMessagesToFromBin(m_db, message_ids, true, &changed_counts);
 	}
 
 	else {
-		deleted = DatabaseQueries::permanentlyDeleteMessages(m_db, message_ids);
+		deleted = DatabaseQueries::permanentlyDeleteMessages(m_db, message_ids, &changed_counts);
 	}
 
 	if (deleted) {
-		return m_selectedItem->getParentServiceRoot()->onAfterMessagesDelete(m_selectedItem, msgs);
+		return m_selectedItem->getParentServiceRoot()->onAfterMessagesDelete(m_selectedItem, msgs, changed_counts);
 	}
 
 	else {
@@ -463,7 +543,7 @@ bool MessagesModel::setBatchMessagesRead(const QModelIndexList& messages, RootIt
 
 	// Obtain IDs of all desired messages.
 	foreach (const QModelIndex& message, messages) {
-		Message msg = messageAt(message.row());
+		Message msg = messageHeaderAt(message.row());
 		msgs.append(msg);
 		message_ids.append(QString::number(msg.m_id));
 		setData(index(message.row(), MSG_DB_READ_INDEX), (int) read);
@@ -475,8 +555,10 @@ bool MessagesModel::setBatchMessagesRead(const QModelIndexList& messages, RootIt
 		return false;
 	}
 
-	if (DatabaseQueries::markMessagesReadUnread(m_db, message_ids, read)) {
-		return m_selectedItem->getParentServiceRoot()->onAfterSetMessagesRead(m_selectedItem, msgs, read);
+	QMap<int, QPair<int, int>> changed_counts;
+
+	if (DatabaseQueries::markMessagesReadUnread(m_db, message_ids, read, &changed_counts)) {
+		return m_selectedItem->getParentServiceRoot()->onAfterSetMessagesRead(m_selectedItem, msgs, read, changed_counts);
 	}
 
 	else {
@@ -490,7 +572,7 @@ bool MessagesModel::setBatchMessagesRestored(const QModelIndexList& messages) {
 
 	// Obtain IDs of all desired messages.
 	foreach (const QModelIndex& message, messages) {
-		const Message msg = messageAt(message.row());
+		const Message msg = messageHeaderAt(message.row());
 		msgs.append(msg);
 		message_ids.append(QString::number(msg.m_id));
 		setData(index(message.row(), MSG_DB_PDELETED_INDEX), 0);
@@ -503,8 +585,10 @@ bool MessagesModel::setBatchMessagesRestored(const QModelIndexList& messages) {
 		return false;
 	}
 
-	if (DatabaseQueries::deleteOrRestoreMessagesToFromBin(m_db, message_ids, false)) {
-		return m_selectedItem->getParentServiceRoot()->onAfterMessagesRestoredFromBin(m_selectedItem, msgs);
+	QMap<int, QPair<int, int>> changed_counts;
+
+	if (DatabaseQueries::deleteOrRestoreMessagesToFromBin(m_db, message_ids, false, &changed_counts)) {
+		return m_selectedItem->getParentServiceRoot()->onAfterMessagesRestoredFromBin(m_selectedItem, msgs, changed_counts);
 	}
 
 	else {
@@ -18,7 +18,7 @@
 #ifndef MESSAGESMODEL_H
 #define MESSAGESMODEL_H
 
-#include <QSqlQueryModel>
+#include <QAbstractTableModel>
 #include "core/messagesmodelsqllayer.h"
 
 #include "definitions/definitions.h"
@@ -27,11 +27,10 @@
 
 #include <QFont>
 #include <QIcon>
+#include <QSqlRecord>
 
 
-class MessagesModelCache;
-
-class MessagesModel : public QSqlQueryModel, public MessagesModelSqlLayer {
+class MessagesModel : public QAbstractTableModel, public MessagesModelSqlLayer {
 		Q_OBJECT
 
 	public:
@@ -47,18 +46,23 @@ class MessagesModel : public QSqlQueryModel, public MessagesModelSqlLayer {
 		explicit MessagesModel(QObject* parent = 0);
 		virtual ~MessagesModel();
 
-		// Fetches ALL available data to the model.
-		// NOTE: This activates the SQL query and populates the model with new data.
+		// Activates the SQL query and populates the model with new data.
+		// NOTE: Only first page of messages is fetched immediately, next
+		// pages are fetched when view asks for them via fetchMore().
 		void repopulate();
 
 		// Model implementation.
+		int rowCount(const QModelIndex& parent = QModelIndex()) const;
+		int columnCount(const QModelIndex& parent = QModelIndex()) const;
+		bool canFetchMore(const QModelIndex& parent = QModelIndex()) const;
+		void fetchMore(const QModelIndex& parent = QModelIndex());
 		bool setData(const QModelIndex& index, const QVariant& value, int role = Qt::EditRole);
 		QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const;
 		QVariant data(int row, int column, int role = Qt::DisplayRole) const;
 		QVariant headerData(int section, Qt::Orientation orientation, int role) const;
 		Qt::ItemFlags flags(const QModelIndex& index) const;
 
-		// Returns message at given index.
+		// Returns message at given index, including its contents.
 		Message messageAt(int row_index) const;
 		int messageId(int row_index) const;
 		RootItem::Importance messageImportance(int row_index) const;
@@ -90,11 +94,21 @@ class MessagesModel : public QSqlQueryModel, public MessagesModelSqlLayer {
 		bool setMessageReadById(int id, RootItem::ReadStatus read);
 
 	private:
+		// Returns message at given index without its contents.
+		Message messageHeaderAt(int row_index) const;
+
+		// Returns raw value of given field of fetched message.
+		QVariant fieldValue(const QModelIndex& index) const;
+
+		// Selects next page of messages from database.
+		QList<QSqlRecord> fetchNextPage();
+
 		void setupHeaderData();
 		void setupFonts();
 		void setupIcons();
 
-		MessagesModelCache* m_cache;
+		QList<QSqlRecord> m_messages;
+		bool m_canFetchMore;
 		MessageHighlighter m_messageHighlighter;
 
 		QString m_customDateFormat;
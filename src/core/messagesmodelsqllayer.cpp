@@ -20,6 +20,9 @@
 #include "definitions/definitions.h"
 #include "miscellaneous/application.h"
 
+#include <QRegExp>
+#include <QSqlRecord>
+
 
 MessagesModelSqlLayer::MessagesModelSqlLayer()
 	: m_filter(QSL(DEFAULT_SQL_MESSAGES_FILTER)), m_fieldNames(QMap<int, QString>()),
@@ -70,36 +73,153 @@ void MessagesModelSqlLayer::addSortState(int column, Qt::SortOrder order) {
 		m_sortOrders.prepend(order);
 	}
 
-	qDebug("Added sort state, select statement is now:\n'%s'", qPrintable(selectStatement()));
+	qDebug("Added sort state, order clause is now:\n'%s'", qPrintable(orderByClause()));
 }
 
 void MessagesModelSqlLayer::setFilter(const QString& filter) {
 	m_filter = filter;
 }
 
+void MessagesModelSqlLayer::setSearchPhrase(const QString& phrase) {
+	// Only words are searched for, this also removes any characters
+	// which have special meaning in SQL or in full-text query syntax.
+	m_searchWords = phrase.split(QRegExp(QSL("\\W+")), QString::SkipEmptyParts);
+}
+
+QString MessagesModelSqlLayer::searchClause() const {
+	if (m_searchWords.isEmpty()) {
+		return QString();
+	}
+
+	QStringList terms;
+
+	// All words must be present, each of them can be just
+	// prefix of a longer word as user might be still typing it.
+	if (qApp->database()->activeDatabaseDriver() == DatabaseFactory::MYSQL) {
+		const int min_word_length = qApp->database()->searchIndexMinWordLength();
+		QStringList conditions;
+
+		foreach (const QString& word, m_searchWords) {
+			if (word.size() < min_word_length) {
+				// Index does not contain short words at all, they are looked up in texts.
+				conditions.append(QString("(title LIKE '%%1%' OR author LIKE '%%1%' OR contents LIKE '%%1%')").arg(word));
+			}
+
+			else {
+				terms.append(QL1C('+') + word + QL1C('*'));
+			}
+		}
+
+		if (terms.isEmpty()) {
+			return QString(" JOIN (SELECT id, 0 AS relevance FROM MessagesSearch WHERE %1) AS Search "
+			               "ON Search.id = Messages.id").arg(conditions.join(QSL(" AND ")));
+		}
+
+		conditions.prepend(QString("MATCH (title, author, contents) AGAINST ('%1' IN BOOLEAN MODE)").arg(terms.join(QL1C(' '))));
+		return QString(" JOIN (SELECT id, MATCH (title, author, contents) AGAINST ('%1' IN BOOLEAN MODE) AS relevance "
+		               "FROM MessagesSearch WHERE %2) AS Search "
+		               "ON Search.id = Messages.id").arg(terms.join(QL1C(' ')), conditions.join(QSL(" AND ")));
+	}
+
+	else {
+		foreach (const QString& word, m_searchWords) {
+			terms.append(QL1C('"') + word + QSL("\"*"));
+		}
+
+		return QString(" JOIN (SELECT rowid AS id, -rank AS relevance FROM MessagesSearch WHERE MessagesSearch MATCH '%1') AS Search "
+		               "ON Search.id = Messages.id").arg(terms.join(QL1C(' ')));
+	}
+}
+
 QString MessagesModelSqlLayer::formatFields() const {
-	return m_fieldNames.values().join(QSL(", "));
+	QStringList fields = m_fieldNames.values();
+
+	// Contents of messages are not part of the list, they are
+	// loaded only for messages which are actually displayed.
+	fields[MSG_DB_CONTENTS_INDEX] = QSL("NULL");
+	return fields.join(QSL(", "));
 }
 
-QString MessagesModelSqlLayer::selectStatement() const {
+QString MessagesModelSqlLayer::selectStatement(const QSqlRecord& last_message, int fetched_count, int page_size,
+                                               QVariantList* bound_values) const {
+	QString where_clause = QL1C('(') + m_filter + QL1C(')');
+	QString limit_clause = QString(" LIMIT %1").arg(page_size);
+
+	if (!last_message.isEmpty()) {
+		if (m_searchWords.isEmpty() && !m_sortColumns.contains(MSG_DB_CONTENTS_INDEX)) {
+			// Next page starts right after the last fetched message.
+			where_clause += QSL(" AND ") + keysetClause(last_message, bound_values);
+		}
+
+		else {
+			limit_clause += QString(" OFFSET %1").arg(fetched_count);
+		}
+	}
+
 	return QL1S("SELECT ") + formatFields() +
-	       QSL(" FROM Messages LEFT JOIN Feeds ON Messages.feed = Feeds.custom_id AND Messages.account_id = Feeds.account_id WHERE ") +
-	       m_filter + orderByClause() + QL1C(';');
+	       QSL(" FROM Messages LEFT JOIN Feeds ON Messages.feed = Feeds.custom_id AND Messages.account_id = Feeds.account_id") +
+	       searchClause() + QSL(" WHERE ") + where_clause + orderByClause() + limit_clause + QL1C(';');
 }
 
-QString MessagesModelSqlLayer::orderByClause() const {
-	if (m_sortColumns.isEmpty()) {
-		return QString();
+QList<MessagesModelSqlLayer::SortState> MessagesModelSqlLayer::sortStates() const {
+	QList<SortState> states;
+
+	for (int i = 0; i < m_sortColumns.size(); i++) {
+		states.append(SortState(m_sortColumns.at(i), m_sortOrders.at(i)));
 	}
 
-	else {
-		QStringList sorts;
+	if (!m_sortColumns.contains(MSG_DB_ID_INDEX)) {
+		states.append(SortState(MSG_DB_ID_INDEX, Qt::AscendingOrder));
+	}
+
+	return states;
+}
 
-		for (int i = 0; i < m_sortColumns.size(); i++) {
-			QString field_name(m_fieldNames[m_sortColumns[i]]);
-			sorts.append(field_name + (m_sortOrders[i] == Qt::AscendingOrder ? QSL(" ASC") : QSL(" DESC")));
+QString MessagesModelSqlLayer::keysetClause(const QSqlRecord& last_message, QVariantList* bound_values) const {
+	const QList<SortState> states = sortStates();
+	QStringList alternatives;
+	QStringList equal_conditions;
+	QVariantList equal_values;
+
+	// Message follows the last one if all its leading sort keys are equal and the next
+	// one follows. Both SQLite and MySQL sort NULL values before all other values.
+	foreach (const SortState& state, states) {
+		const QString field_name = m_fieldNames[state.first];
+		const QVariant value = last_message.value(state.first);
+		QStringList conditions = equal_conditions;
+		*bound_values += equal_values;
+
+		if (value.isNull()) {
+			conditions.append(state.second == Qt::AscendingOrder ? field_name + QSL(" IS NOT NULL") : QSL("1 = 0"));
+			equal_conditions.append(field_name + QSL(" IS NULL"));
 		}
 
-		return QL1S(" ORDER BY ") + sorts.join(QSL(", "));
+		else {
+			conditions.append(state.second == Qt::AscendingOrder ?
+			                  field_name + QSL(" > ?") :
+			                  QString("(%1 < ? OR %1 IS NULL)").arg(field_name));
+			equal_conditions.append(field_name + QSL(" = ?"));
+			bound_values->append(value);
+			equal_values.append(value);
+		}
+
+		alternatives.append(QL1C('(') + conditions.join(QSL(" AND ")) + QL1C(')'));
 	}
+
+	return QL1C('(') + alternatives.join(QSL(" OR ")) + QL1C(')');
+}
+
+QString MessagesModelSqlLayer::orderByClause() const {
+	QStringList sorts;
+
+	if (!m_searchWords.isEmpty()) {
+		// Found messages are sorted by relevance first.
+		sorts.append(QSL("Search.relevance DESC"));
+	}
+
+	foreach (const SortState& state, sortStates()) {
+		sorts.append(m_fieldNames[state.first] + (state.second == Qt::AscendingOrder ? QSL(" ASC") : QSL(" DESC")));
+	}
+
+	return QL1S(" ORDER BY ") + sorts.join(QSL(", "));
 }
@@ -23,8 +23,13 @@
 
 #include <QMap>
 #include <QList>
+#include <QPair>
+#include <QStringList>
+#include <QVariantList>
 
 
+class QSqlRecord;
+
 class MessagesModelSqlLayer {
 	public:
 		explicit MessagesModelSqlLayer();
@@ -35,15 +40,42 @@ class MessagesModelSqlLayer {
 		// Sets SQL WHERE clause, without "WHERE" keyword.
 		void setFilter(const QString& filter);
 
+		// Restricts messages to those which match given phrase in full-text
+		// search index, most relevant messages go first. Empty phrase
+		// turns the search off.
+		void setSearchPhrase(const QString& phrase);
+
 	protected:
 		QString orderByClause() const;
-		QString selectStatement() const;
 		QString formatFields() const;
+		QString searchClause() const;
+
+		// Returns statement which selects at most "page_size" messages which
+		// follow given last already fetched message in current sort order.
+		// Empty record selects the first page. Values which must be bound
+		// to the statement are appended to "bound_values".
+		// NOTE: Pages are found by comparing sort keys with the last fetched
+		// message, only if messages are sorted by relevance of search or by
+		// their contents, which are not fetched, previous pages are skipped.
+		QString selectStatement(const QSqlRecord& last_message, int fetched_count, int page_size,
+		                        QVariantList* bound_values) const;
+
+	private:
+		typedef QPair<int, Qt::SortOrder> SortState;
+
+		// Returns columns which messages are sorted by, messages with
+		// same values of sort columns are always sorted by their IDs.
+		QList<SortState> sortStates() const;
+
+		// Returns condition which matches only messages which
+		// follow given message in current sort order.
+		QString keysetClause(const QSqlRecord& last_message, QVariantList* bound_values) const;
 
 		QSqlDatabase m_db;
 
 	private:
 		QString m_filter;
+		QStringList m_searchWords;
 
 		// NOTE: These two lists contain data for multicolumn sorting.
 		// They are always same length. Most important sort column/order
@@ -34,6 +34,10 @@
 #define ADBLOCK_CUSTOMLIST_NAME               "customlist.txt"
 #define ADBLOCK_LISTS_SUBDIRECTORY            "adblock"
 #define ADBLOCK_EASYLIST_URL                  "https://easylist-downloads.adblockplus.org/easylist.txt"
+#define ADBLOCK_MIN_TOKEN_LENGTH              2
+#define ADBLOCK_CACHE_EXTENSION               ".cache"
+#define ADBLOCK_CACHE_MAGIC                   0x41444243
+#define ADBLOCK_CACHE_VERSION                 1
 #define DEFAULT_SQL_MESSAGES_FILTER           "0 > 1"
 #define MAX_MULTICOLUMN_SORT_STATES           3
 #define ENCLOSURES_OUTER_SEPARATOR            '#'
@@ -49,6 +53,7 @@
 #define USER_AGENT_HTTP_HEADER                "User-Agent"
 #define TEXT_TITLE_LIMIT                      30
 #define RESELECT_MESSAGE_THRESSHOLD           500
+#define MSG_MODEL_PAGE_SIZE                   256
 #define ICON_SIZE_SETTINGS                    16
 #define NO_PARENT_CATEGORY                    -1
 #define ID_RECYCLE_BIN                        -2
@@ -59,11 +64,25 @@
 #define MESSAGES_VIEW_MINIMUM_COL             36
 #define FEEDS_VIEW_COLUMN_COUNT               2
 #define FEED_DOWNLOADER_MAX_THREADS           6
+#define FEED_DOWNLOADER_MAX_DOWNLOADS         24
+#define FEED_DOWNLOADER_MAX_HOST_DOWNLOADS    4
+#define FEED_DOWNLOADER_STORE_BATCH_SIZE      1000
+#define FEED_DOWNLOADER_STORE_LATENCY         1000
+#define FEED_DOWNLOADER_REJECTED_TYPES        "image/,audio/,video/,font/,application/pdf,application/zip"
+#define DEFAULT_FEED_MAX_SIZE                 20
+#define FEEDS_IMPORT_MAX_LOOKUPS              12
+#define FEEDS_IMPORT_MAX_HOST_LOOKUPS         2
 #define DEFAULT_DAYS_TO_DELETE_MSG            14
 #define ELLIPSIS_LENGTH                       3
 #define MIN_CATEGORY_NAME_LENGTH              1
 #define DEFAULT_AUTO_UPDATE_INTERVAL          15
+#define DEFAULT_ADAPTIVE_UPDATE_MAX_INTERVAL  1440
+#define ADAPTIVE_UPDATE_HISTORY               20
+#define ADAPTIVE_UPDATE_MAX_BACKOFF           6
 #define AUTO_UPDATE_INTERVAL                  60000
+#define AUTO_UPDATE_JITTER_PERCENTAGE         10
+#define AUTO_UPDATE_SPREAD_INTERVAL           600000
+#define AUTO_UPDATE_MAX_SLEEP                 86400000
 #define STARTUP_UPDATE_DELAY                  30000
 #define TIMEZONE_OFFSET_LIMIT                 6
 #define CHANGE_EVENT_DELAY                    250
@@ -83,6 +102,10 @@
 #define GOOGLE_SUGGEST_URL                    "http://suggestqueries.google.com/complete/search?output=toolbar&hl=en&q=%1"
 #define ENCRYPTION_FILE_NAME                  "key.private"
 #define RELOAD_MODEL_BORDER_NUM               10
+#define MSG_BULK_MAX_BOUND_VALUES             999
+#define MSG_FINGERPRINT_CACHE_SIZE            100000
+#define MSG_SEARCH_INDEX_FILL_CHUNK_SIZE      500
+#define MSG_SEARCH_INDEX_FILL_INTERVAL        100
 
 #define MAX_ZOOM_FACTOR     5.0f
 #define MIN_ZOOM_FACTOR     0.25f
@@ -116,9 +139,13 @@
 #define APP_DB_SQLITE_INIT            "db_init_sqlite.sql"
 #define APP_DB_SQLITE_PATH            "database/local"
 #define APP_DB_SQLITE_FILE            "database.db"
+#define APP_DB_SQLITE_BUSY_TIMEOUT    30000
+#define APP_DB_SQLITE_GUI_BUSY_TIMEOUT  5000
+#define APP_DB_CHECKPOINT_INTERVAL    300000
+#define APP_DB_MEMORY_SAVE_INTERVAL   60000
 
 // Keep this in sync with schema versions declared in SQL initialization code.
-#define APP_DB_SCHEMA_VERSION         "8"
+#define APP_DB_SCHEMA_VERSION         "13"
 #define APP_DB_UPDATE_FILE_PATTERN    "db_update_%1_%2_%3.sql"
 #define APP_DB_COMMENT_SPLIT          "-- !\n"
 #define APP_DB_NAME_PLACEHOLDER       "##"
@@ -201,6 +228,9 @@
 #define FDS_DB_TYPE_INDEX             13
 #define FDS_DB_ACCOUNT_ID_INDEX       14
 #define FDS_DB_CUSTOM_ID_INDEX        15
+#define FDS_DB_HTTP_ETAG_INDEX        16
+#define FDS_DB_HTTP_LAST_MOD_INDEX    17
+#define FDS_DB_UPDATE_DEADLINE_INDEX  18
 
 // Indexes of columns for feed models.
 #define FDS_MODEL_TITLE_INDEX           0
@@ -157,12 +157,14 @@ void MessagePreviewer::markMessageAsReadUnread(RootItem::ReadStatus read) {
 		if (m_root->getParentServiceRoot()->onBeforeSetMessagesRead(m_root.data(),
 		                                                            QList<Message>() << m_message,
 		                                                            read)) {
+			QMap<int, QPair<int, int>> changed_counts;
+
 			DatabaseQueries::markMessagesReadUnread(qApp->database()->connection(objectName(), DatabaseFactory::FromSettings),
 			                                        QStringList() << QString::number(m_message.m_id),
-			                                        read);
+			                                        read, &changed_counts);
 			m_root->getParentServiceRoot()->onAfterSetMessagesRead(m_root.data(),
 			                                                       QList<Message>() << m_message,
-			                                                       read);
+			                                                       read, changed_counts);
 			m_message.m_isRead = read == RootItem::Read;
 			emit markMessageRead(m_message.m_id, read);
 			updateButtons();
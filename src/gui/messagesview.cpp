@@ -89,31 +89,35 @@ void MessagesView::reloadSelections() {
 	const QDateTime dt1 = QDateTime::currentDateTime();
 	QModelIndex current_index = selectionModel()->currentIndex();
 	const QModelIndex mapped_current_index = m_proxyModel->mapToSource(current_index);
-	const Message selected_message = m_sourceModel->messageAt(mapped_current_index.row());
+	const int selected_message_id = mapped_current_index.isValid() ? m_sourceModel->messageId(mapped_current_index.row()) : 0;
+	// Selected message was among already fetched messages, new messages could move it at most a page further.
+	const int max_fetched_rows = m_sourceModel->rowCount() + MSG_MODEL_PAGE_SIZE;
 	const int col = header()->sortIndicatorSection();
 	const Qt::SortOrder ord = header()->sortIndicatorOrder();
 	// Reload the model now.
 	sort(col, ord, true, false, false);
 
 	// Now, we must find the same previously focused message.
-	if (selected_message.m_id > 0) {
-		if (m_proxyModel->rowCount() == 0) {
-			current_index = QModelIndex();
-		}
+	if (selected_message_id > 0) {
+		int i = 0;
+		current_index = QModelIndex();
 
-		else {
-			for (int i = 0; i < m_proxyModel->rowCount(); i++) {
-				QModelIndex msg_idx = m_proxyModel->index(i, MSG_DB_TITLE_INDEX);
-				Message msg = m_sourceModel->messageAt(m_proxyModel->mapToSource(msg_idx).row());
+		while (!current_index.isValid()) {
+			if (i < m_proxyModel->rowCount()) {
+				const QModelIndex msg_idx = m_proxyModel->index(i++, MSG_DB_TITLE_INDEX);
 
-				if (msg.m_id == selected_message.m_id) {
+				if (m_sourceModel->messageId(m_proxyModel->mapToSource(msg_idx).row()) == selected_message_id) {
 					current_index = msg_idx;
-					break;
 				}
+			}
 
-				if (i == m_proxyModel->rowCount() - 1) {
-					current_index = QModelIndex();
-				}
+			else if (m_sourceModel->canFetchMore() && m_sourceModel->rowCount() < max_fetched_rows) {
+				// Message might not be fetched yet.
+				m_sourceModel->fetchMore();
+			}
+
+			else {
+				break;
 			}
 		}
 	}
@@ -226,7 +230,7 @@ void MessagesView::mousePressEvent(QMouseEvent* event) {
 
 			if (clicked_index.isValid()) {
 				const QModelIndex mapped_index = m_proxyModel->mapToSource(clicked_index);
-				const QString url = m_sourceModel->messageAt(mapped_index.row()).m_url;
+				const QString url = m_sourceModel->data(mapped_index.row(), MSG_DB_URL_INDEX, Qt::EditRole).toString();
 
 				if (!url.isEmpty()) {
 					qApp->mainForm()->tabWidget()->addLinkedBrowser(url);
@@ -284,7 +288,7 @@ void MessagesView::loadItem(RootItem* item) {
 
 void MessagesView::openSelectedSourceMessagesExternally() {
 	foreach (const QModelIndex& index, selectionModel()->selectedRows()) {
-		const QString link = m_sourceModel->messageAt(m_proxyModel->mapToSource(index).row()).m_url;
+		const QString link = m_sourceModel->data(m_proxyModel->mapToSource(index).row(), MSG_DB_URL_INDEX, Qt::EditRole).toString();
 
 		if (!WebFactory::instance()->openUrlInExternalBrowser(link)) {
 			qApp->showGuiMessage(tr("Problem with starting external web browser"),
@@ -476,15 +480,29 @@ void MessagesView::selectNextUnreadItem() {
 }
 
 void MessagesView::searchMessages(const QString& pattern) {
-	m_proxyModel->setFilterRegExp(pattern);
-
-	if (selectionModel()->selectedRows().size() == 0) {
-		emit currentMessageRemoved();
+	if (qApp->database()->isSearchIndexComplete()) {
+		// Messages are looked up in full-text index and only
+		// matching messages are loaded into the list.
+		m_sourceModel->setSearchPhrase(pattern);
+		reloadSelections();
 	}
 
 	else {
-		// Scroll to selected message, it could become scrolled out due to filter change.
-		scrollTo(selectionModel()->selectedRows().at(0));
+		// Filter must see all messages, not only already fetched pages.
+		while (!pattern.isEmpty() && m_sourceModel->canFetchMore()) {
+			m_sourceModel->fetchMore();
+		}
+
+		m_proxyModel->setFilterRegExp(pattern);
+
+		if (selectionModel()->selectedRows().size() == 0) {
+			emit currentMessageRemoved();
+		}
+
+		else {
+			// Scroll to selected message, it could become scrolled out due to filter change.
+			scrollTo(selectionModel()->selectedRows().at(0));
+		}
 	}
 }
 
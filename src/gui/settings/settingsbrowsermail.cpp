@@ -188,5 +188,6 @@ void SettingsBrowserMail::saveSettings() {
 	settings()->setValue(GROUP(Proxy), Proxy::Port, m_ui->m_spinProxyPort->value());
 	// Reload settings for all network access managers.
 	SilentNetworkAccessManager::instance()->loadSettings();
+	SilentNetworkAccessManager::reloadThreadInstances();
 	onEndSaveSettings();
 }
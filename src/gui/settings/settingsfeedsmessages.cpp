@@ -43,6 +43,12 @@ SettingsFeedsMessages::SettingsFeedsMessages(Settings* settings, QWidget* parent
 	connect(m_ui->m_checkUpdateAllFeedsOnStartup, &QCheckBox::toggled, this, &SettingsFeedsMessages::dirtifySettings);
 	connect(m_ui->m_spinAutoUpdateInterval, static_cast<void (QDoubleSpinBox::*)(double)>(&QDoubleSpinBox::valueChanged),
 	        this, &SettingsFeedsMessages::dirtifySettings);
+	connect(m_ui->m_spinAdaptiveUpdateMinInterval, static_cast<void (QDoubleSpinBox::*)(double)>(&QDoubleSpinBox::valueChanged),
+	        this, &SettingsFeedsMessages::dirtifySettings);
+	connect(m_ui->m_spinAdaptiveUpdateMaxInterval, static_cast<void (QDoubleSpinBox::*)(double)>(&QDoubleSpinBox::valueChanged),
+	        this, &SettingsFeedsMessages::dirtifySettings);
+	connect(m_ui->m_spinMaxFeedSize, static_cast<void (QSpinBox::*)(int)>(&QSpinBox::valueChanged),
+	        this, &SettingsFeedsMessages::dirtifySettings);
 	connect(m_ui->m_spinHeightImageAttachments, static_cast<void (QSpinBox::*)(int)>(&QSpinBox::valueChanged),
 	        this, &SettingsFeedsMessages::dirtifySettings);
 	connect(m_ui->m_checkAutoUpdate, &QCheckBox::toggled, m_ui->m_spinAutoUpdateInterval, &TimeSpinBox::setEnabled);
@@ -58,6 +64,10 @@ SettingsFeedsMessages::SettingsFeedsMessages(Settings* settings, QWidget* parent
 	if (!m_ui->m_spinFeedUpdateTimeout->suffix().startsWith(' ')) {
 		m_ui->m_spinFeedUpdateTimeout->setSuffix(QSL(" ") + m_ui->m_spinFeedUpdateTimeout->suffix());
 	}
+
+	if (!m_ui->m_spinMaxFeedSize->suffix().startsWith(' ')) {
+		m_ui->m_spinMaxFeedSize->setSuffix(QSL(" ") + m_ui->m_spinMaxFeedSize->suffix());
+	}
 }
 
 SettingsFeedsMessages::~SettingsFeedsMessages() {
@@ -96,7 +106,10 @@ void SettingsFeedsMessages::loadSettings() {
 	m_ui->m_checkRemoveReadMessagesOnExit->setChecked(settings()->value(GROUP(Messages), SETTING(Messages::ClearReadOnExit)).toBool());
 	m_ui->m_checkAutoUpdate->setChecked(settings()->value(GROUP(Feeds), SETTING(Feeds::AutoUpdateEnabled)).toBool());
 	m_ui->m_spinAutoUpdateInterval->setValue(settings()->value(GROUP(Feeds), SETTING(Feeds::AutoUpdateInterval)).toInt());
+	m_ui->m_spinAdaptiveUpdateMinInterval->setValue(settings()->value(GROUP(Feeds), SETTING(Feeds::AdaptiveUpdateMinInterval)).toInt());
+	m_ui->m_spinAdaptiveUpdateMaxInterval->setValue(settings()->value(GROUP(Feeds), SETTING(Feeds::AdaptiveUpdateMaxInterval)).toInt());
 	m_ui->m_spinFeedUpdateTimeout->setValue(settings()->value(GROUP(Feeds), SETTING(Feeds::UpdateTimeout)).toInt());
+	m_ui->m_spinMaxFeedSize->setValue(settings()->value(GROUP(Feeds), SETTING(Feeds::MaxFeedSize)).toInt());
 	m_ui->m_checkUpdateAllFeedsOnStartup->setChecked(settings()->value(GROUP(Feeds), SETTING(Feeds::FeedsUpdateOnStartup)).toBool());
 	m_ui->m_cmbCountsFeedList->addItems(QStringList() << "(%unread)" << "[%unread]" << "%unread/%all" << "%unread-%all" << "[%unread|%all]");
 	m_ui->m_cmbCountsFeedList->setEditText(settings()->value(GROUP(Feeds), SETTING(Feeds::CountFormat)).toString());
@@ -125,7 +138,11 @@ void SettingsFeedsMessages::saveSettings() {
 	settings()->setValue(GROUP(Messages), Messages::ClearReadOnExit, m_ui->m_checkRemoveReadMessagesOnExit->isChecked());
 	settings()->setValue(GROUP(Feeds), Feeds::AutoUpdateEnabled, m_ui->m_checkAutoUpdate->isChecked());
 	settings()->setValue(GROUP(Feeds), Feeds::AutoUpdateInterval, m_ui->m_spinAutoUpdateInterval->value());
+	settings()->setValue(GROUP(Feeds), Feeds::AdaptiveUpdateMinInterval, m_ui->m_spinAdaptiveUpdateMinInterval->value());
+	settings()->setValue(GROUP(Feeds), Feeds::AdaptiveUpdateMaxInterval,
+	                     qMax(m_ui->m_spinAdaptiveUpdateMinInterval->value(), m_ui->m_spinAdaptiveUpdateMaxInterval->value()));
 	settings()->setValue(GROUP(Feeds), Feeds::UpdateTimeout, m_ui->m_spinFeedUpdateTimeout->value());
+	settings()->setValue(GROUP(Feeds), Feeds::MaxFeedSize, m_ui->m_spinMaxFeedSize->value());
 	settings()->setValue(GROUP(Feeds), Feeds::FeedsUpdateOnStartup, m_ui->m_checkUpdateAllFeedsOnStartup->isChecked());
 	settings()->setValue(GROUP(Feeds), Feeds::CountFormat, m_ui->m_cmbCountsFeedList->currentText());
 	settings()->setValue(GROUP(Messages), Messages::UseCustomDate, m_ui->m_checkMessagesDateTimeFormat->isChecked());
@@ -239,12 +239,14 @@ void WebBrowser::markMessageAsRead(int id, bool read) {
 		if (msg != nullptr && m_root->getParentServiceRoot()->onBeforeSetMessagesRead(m_root.data(),
 		        QList<Message>() << *msg,
 		        read ? RootItem::Read : RootItem::Unread)) {
+			QMap<int, QPair<int, int>> changed_counts;
+
 			DatabaseQueries::markMessagesReadUnread(qApp->database()->connection(objectName(), DatabaseFactory::FromSettings),
 			                                        QStringList() << QString::number(msg->m_id),
-			                                        read ? RootItem::Read : RootItem::Unread);
+			                                        read ? RootItem::Read : RootItem::Unread, &changed_counts);
 			m_root->getParentServiceRoot()->onAfterSetMessagesRead(m_root.data(),
 			                                                       QList<Message>() << *msg,
-			                                                       read ? RootItem::Read : RootItem::Unread);
+			                                                       read ? RootItem::Read : RootItem::Unread, changed_counts);
 			emit markMessageRead(msg->m_id, read ? RootItem::Read : RootItem::Unread);
 			msg->m_isRead = read ? RootItem::Read : RootItem::Unread;
 		}
@@ -20,20 +20,55 @@
 #include "miscellaneous/iofactory.h"
 #include "miscellaneous/application.h"
 #include "miscellaneous/textfactory.h"
+#include "miscellaneous/databasequeries.h"
+#include "miscellaneous/messagefingerprintcache.h"
+#include "miscellaneous/mutex.h"
 #include "gui/messagebox.h"
 
 #include <QDir>
+#include <QThread>
+#include <QTimer>
 #include <QSqlQuery>
 #include <QSqlError>
 #include <QVariant>
 
+#include <limits>
+
+
+ThreadConnection::ThreadConnection(const QString& connection_name) : m_connectionName(connection_name) {
+}
+
+ThreadConnection::~ThreadConnection() {
+	if (QSqlDatabase::contains(m_connectionName)) {
+		qDebug("Removing database connection '%s' of finished thread.", qPrintable(m_connectionName));
+		QSqlDatabase::removeDatabase(m_connectionName);
+	}
+}
+
+QString ThreadConnection::connectionName() const {
+	return m_connectionName;
+}
 
 DatabaseFactory::DatabaseFactory(QObject* parent)
 	: QObject(parent),
+	  m_searchIndexAvailable(false),
+	  m_searchIndexPosition(-1),
+	  m_searchIndexMinWordLength(0),
+	  m_searchIndexFillTimer(new QTimer(this)),
+	  m_fingerprintCache(new MessageFingerprintCache(MSG_FINGERPRINT_CACHE_SIZE)),
+	  m_threadConnectionsCounter(0),
 	  m_mysqlDatabaseInitialized(false),
 	  m_sqliteFileBasedDatabaseinitialized(false),
-	  m_sqliteInMemoryDatabaseInitialized(false) {
+	  m_sqliteInMemoryDatabaseInitialized(false),
+	  m_sqliteCheckpointTimer(new QTimer(this)),
+	  m_sqliteMemorySaveTimer(new QTimer(this)) {
 	setObjectName(QSL("DatabaseFactory"));
+	m_sqliteCheckpointTimer->setInterval(APP_DB_CHECKPOINT_INTERVAL);
+	m_sqliteMemorySaveTimer->setInterval(APP_DB_MEMORY_SAVE_INTERVAL);
+	m_searchIndexFillTimer->setInterval(MSG_SEARCH_INDEX_FILL_INTERVAL);
+	connect(m_sqliteCheckpointTimer, &QTimer::timeout, this, &DatabaseFactory::sqliteCheckpointDatabase);
+	connect(m_sqliteMemorySaveTimer, &QTimer::timeout, this, &DatabaseFactory::sqliteSaveMemoryDatabaseWhenIdle);
+	connect(m_searchIndexFillTimer, &QTimer::timeout, this, &DatabaseFactory::fillSearchIndexChunk);
 	determineDriver();
 }
 
@@ -183,7 +218,13 @@ void DatabaseFactory::finishRestoration() {
 	if (QFile::exists(backup_database_file)) {
 		qWarning("Backup database file '%s' was detected. Restoring it.", qPrintable(QDir::toNativeSeparators(backup_database_file)));
 
-		if (IOFactory::copyFile(backup_database_file, m_sqliteDatabaseFilePath + QDir::separator() + APP_DB_SQLITE_FILE)) {
+		const QString database_file = m_sqliteDatabaseFilePath + QDir::separator() + APP_DB_SQLITE_FILE;
+
+		// Write-ahead log of replaced database must not be applied to restored one.
+		QFile::remove(database_file + QSL("-wal"));
+		QFile::remove(database_file + QSL("-shm"));
+
+		if (IOFactory::copyFile(backup_database_file, database_file)) {
 			QFile::remove(backup_database_file);
 			qDebug("Database file was restored successully.");
 		}
@@ -254,12 +295,14 @@ QSqlDatabase DatabaseFactory::sqliteInitializeInMemoryDatabase() {
 		// Loading messages from file-based database.
 		QSqlDatabase file_database = sqliteConnection(objectName(), StrictlyFileBased);
 		QSqlQuery copy_contents(database);
+		// Search index is copied from file-based database below.
+		initializeSearchIndex(database, false);
 		// Attach database.
 		copy_contents.exec(QString("ATTACH DATABASE '%1' AS 'storage';").arg(file_database.databaseName()));
 		// Copy all stuff.
 		QStringList tables;
 
-		if (copy_contents.exec(QSL("SELECT name FROM storage.sqlite_master WHERE type='table';"))) {
+		if (copy_contents.exec(QSL("SELECT name FROM storage.sqlite_master WHERE type='table' AND name NOT LIKE 'MessagesSearch%';"))) {
 			while (copy_contents.next()) {
 				tables.append(copy_contents.value(0).toString());
 			}
@@ -273,13 +316,26 @@ QSqlDatabase DatabaseFactory::sqliteInitializeInMemoryDatabase() {
 			copy_contents.exec(QString("INSERT INTO main.%1 SELECT * FROM storage.%1;").arg(table));
 		}
 
+		if (m_searchIndexAvailable) {
+			// Internal tables of full-text index cannot be copied directly.
+			copy_contents.exec(QSL("INSERT INTO main.MessagesSearch (rowid, title, author, contents) "
+			                       "SELECT rowid, title, author, contents FROM storage.MessagesSearch;"));
+		}
+
 		qDebug("Copying data from file-based database into working in-memory database.");
 		// Detach database and finish.
 		copy_contents.exec(QSL("DETACH 'storage'"));
 		copy_contents.finish();
 		query_db.finish();
+		// From now on, all changes are tracked so that only they are saved.
+		sqliteInitializeMemoryChangeTracking(database, tables);
+		// Index of file-based database need not be complete yet, rest of it is filled here then.
+		DatabaseQueries::storeSearchIndexPosition(database, DatabaseQueries::getSearchIndexPosition(file_database));
+		resumeSearchIndexFilling(database);
 	}
 
+	m_sqliteMemorySaveTimer->start();
+
 	// Everything is initialized now.
 	m_sqliteInMemoryDatabaseInitialized = true;
 	return database;
@@ -306,6 +362,7 @@ QSqlDatabase DatabaseFactory::sqliteInitializeFileBasedDatabase(const QString& c
 	QSqlDatabase database;
 	database = QSqlDatabase::addDatabase(APP_DB_SQLITE_DRIVER, connection_name);
 	database.setDatabaseName(db_file.fileName());
+	sqliteSetupConnection(database);
 
 	if (!database.open()) {
 		qFatal("File-based SQLite database was NOT opened. Delivered error message: '%s'",
@@ -316,12 +373,16 @@ QSqlDatabase DatabaseFactory::sqliteInitializeFileBasedDatabase(const QString& c
 		QSqlQuery query_db(database);
 		query_db.setForwardOnly(true);
 		query_db.exec(QSL("PRAGMA encoding = \"UTF-8\""));
-		query_db.exec(QSL("PRAGMA synchronous = OFF"));
-		query_db.exec(QSL("PRAGMA journal_mode = MEMORY"));
 		query_db.exec(QSL("PRAGMA page_size = 4096"));
-		query_db.exec(QSL("PRAGMA cache_size = 16384"));
-		query_db.exec(QSL("PRAGMA count_changes = OFF"));
-		query_db.exec(QSL("PRAGMA temp_store = MEMORY"));
+
+		// Write-ahead log allows readers to work while feeds are being stored
+		// and keeps database file consistent even if application crashes.
+		// Journal mode is persistent, so it is set for all future connections too.
+		if (!query_db.exec(QSL("PRAGMA journal_mode = WAL"))) {
+			qWarning("Write-ahead log of SQLite database cannot be enabled: '%s'.", qPrintable(query_db.lastError().text()));
+		}
+
+		sqliteSetupOpenedConnection(database);
 
 		// Sample query which checks for existence of tables.
 		if (!query_db.exec(QSL("SELECT inf_value FROM Information WHERE inf_key = 'schema_version'"))) {
@@ -357,7 +418,7 @@ QSqlDatabase DatabaseFactory::sqliteInitializeFileBasedDatabase(const QString& c
 			const QString installed_db_schema = query_db.value(0).toString();
 			query_db.finish();
 
-			if (installed_db_schema < APP_DB_SCHEMA_VERSION) {
+			if (installed_db_schema.toInt() < QString(APP_DB_SCHEMA_VERSION).toInt()) {
 				if (sqliteUpdateDatabaseSchema(database, installed_db_schema)) {
 					qDebug("Database schema was updated from '%s' to '%s' successully or it is already up to date.",
 					       qPrintable(installed_db_schema),
@@ -378,6 +439,13 @@ QSqlDatabase DatabaseFactory::sqliteInitializeFileBasedDatabase(const QString& c
 		}
 	}
 
+	initializeSearchIndex(database, true);
+
+	if (m_activeDatabaseDriver == SQLITE) {
+		m_sqliteCheckpointTimer->start();
+		resumeSearchIndexFilling(database);
+	}
+
 	// Everything is initialized now.
 	m_sqliteFileBasedDatabaseinitialized = true;
 	return database;
@@ -392,6 +460,9 @@ bool DatabaseFactory::sqliteUpdateDatabaseSchema(QSqlDatabase database, const QS
 	const int current_version = QString(APP_DB_SCHEMA_VERSION).remove('.').toInt();
 
 	// Now, it would be good to create backup of SQLite DB file.
+	// All committed data must be moved from write-ahead log into the file first.
+	database.exec(QSL("PRAGMA wal_checkpoint(TRUNCATE)"));
+
 	if (IOFactory::copyFile(sqliteDatabaseFilePath(), sqliteDatabaseFilePath() + ".bak")) {
 		qDebug("Creating backup of SQLite DB file.");
 	}
@@ -475,12 +546,29 @@ bool DatabaseFactory::mysqlUpdateDatabaseSchema(QSqlDatabase database, const QSt
 QSqlDatabase DatabaseFactory::connection(const QString& connection_name, DesiredType desired_type) {
 	switch (m_activeDatabaseDriver) {
 		case MYSQL:
-			return mysqlConnection(connection_name);
+			return mysqlConnection(threadConnectionName(connection_name));
 
 		case SQLITE:
 		case SQLITE_MEMORY:
 		default:
-			return sqliteConnection(connection_name, desired_type);
+			return sqliteConnection(threadConnectionName(connection_name), desired_type);
+	}
+}
+
+QString DatabaseFactory::threadConnectionName(const QString& connection_name) {
+	if (QThread::currentThread() == qApp->thread()) {
+		return connection_name;
+	}
+
+	else {
+		// Each worker thread has its own connection, no matter
+		// which component of the thread asks for it.
+		if (!m_threadConnections.hasLocalData()) {
+			const int connection_number = m_threadConnectionsCounter.fetchAndAddOrdered(1);
+			m_threadConnections.setLocalData(new ThreadConnection(QString(QSL("thread_%1")).arg(connection_number)));
+		}
+
+		return m_threadConnections.localData()->connectionName();
 	}
 }
 
@@ -525,29 +613,110 @@ QString DatabaseFactory::obtainBeginTransactionSql() const {
 	}
 }
 
+void DatabaseFactory::sqliteInitializeMemoryChangeTracking(QSqlDatabase database, const QStringList& tables) {
+	QSqlQuery query_tracking(database);
+	QStringList statements;
+
+	// Messages are tracked row by row, other tables are small
+	// enough to be saved as a whole when any of their rows changes.
+	statements << QSL("CREATE TEMP TABLE IF NOT EXISTS DirtyMessages (id INTEGER PRIMARY KEY);")
+	           << QSL("CREATE TEMP TABLE IF NOT EXISTS DirtyTables (name TEXT PRIMARY KEY);")
+	           << QSL("CREATE TEMP TRIGGER IF NOT EXISTS DirtyMessagesInsert AFTER INSERT ON main.Messages BEGIN "
+	                  "INSERT OR IGNORE INTO DirtyMessages VALUES (NEW.id); END;")
+	           << QSL("CREATE TEMP TRIGGER IF NOT EXISTS DirtyMessagesUpdate AFTER UPDATE ON main.Messages BEGIN "
+	                  "INSERT OR IGNORE INTO DirtyMessages VALUES (OLD.id); "
+	                  "INSERT OR IGNORE INTO DirtyMessages VALUES (NEW.id); END;")
+	           << QSL("CREATE TEMP TRIGGER IF NOT EXISTS DirtyMessagesDelete AFTER DELETE ON main.Messages BEGIN "
+	                  "INSERT OR IGNORE INTO DirtyMessages VALUES (OLD.id); END;");
+
+	foreach (const QString& table, tables) {
+		if (table == QSL("Messages")) {
+			continue;
+		}
+
+		foreach (const QString& operation, QStringList() << QSL("INSERT") << QSL("UPDATE") << QSL("DELETE")) {
+			statements << QString(QSL("CREATE TEMP TRIGGER IF NOT EXISTS Dirty%1%2 AFTER %2 ON main.%1 BEGIN "
+			                          "INSERT OR IGNORE INTO DirtyTables VALUES ('%1'); END;")).arg(table, operation);
+		}
+	}
+
+	foreach (const QString& statement, statements) {
+		if (!query_tracking.exec(statement)) {
+			qFatal("Changes of in-memory SQLite database cannot be tracked: '%s'.", qPrintable(query_tracking.lastError().text()));
+		}
+	}
+}
+
 void DatabaseFactory::sqliteSaveMemoryDatabase() {
-	qDebug("Saving in-memory working database back to persistent file-based storage.");
 	QSqlDatabase database = sqliteConnection(objectName(), StrictlyInMemory);
 	QSqlDatabase file_database = sqliteConnection(objectName(), StrictlyFileBased);
 	QSqlQuery copy_contents(database);
-	// Attach database.
-	copy_contents.exec(QString(QSL("ATTACH DATABASE '%1' AS 'storage';")).arg(file_database.databaseName()));
-	// Copy all stuff.
+	copy_contents.setForwardOnly(true);
 	QStringList tables;
+	int messages = 0;
 
-	if (copy_contents.exec(QSL("SELECT name FROM storage.sqlite_master WHERE type='table';"))) {
+	if (copy_contents.exec(QSL("SELECT name FROM temp.DirtyTables;"))) {
 		while (copy_contents.next()) {
 			tables.append(copy_contents.value(0).toString());
 		}
 	}
 
-	else {
-		qFatal("Cannot obtain list of table names from file-base SQLite database.");
+	if (copy_contents.exec(QSL("SELECT COUNT(*) FROM temp.DirtyMessages;")) && copy_contents.next()) {
+		messages = copy_contents.value(0).toInt();
+	}
+
+	if (tables.isEmpty() && messages == 0) {
+		return;
 	}
 
+	qDebug("Saving %d changed messages and %d changed tables of in-memory working database back to persistent file-based storage.",
+	       messages, tables.size());
+
+	QStringList statements;
+
 	foreach (const QString& table, tables) {
-		copy_contents.exec(QString(QSL("DELETE FROM storage.%1;")).arg(table));
-		copy_contents.exec(QString(QSL("INSERT INTO storage.%1 SELECT * FROM main.%1;")).arg(table));
+		statements << QString(QSL("DELETE FROM storage.%1;")).arg(table)
+		           << QString(QSL("INSERT INTO storage.%1 SELECT * FROM main.%1;")).arg(table);
+	}
+
+	if (messages > 0) {
+		statements << QSL("DELETE FROM storage.Messages WHERE id IN (SELECT id FROM temp.DirtyMessages);")
+		           << QSL("INSERT INTO storage.Messages SELECT * FROM main.Messages WHERE id IN (SELECT id FROM temp.DirtyMessages);");
+
+		if (m_searchIndexAvailable) {
+			statements << QSL("DELETE FROM storage.MessagesSearch WHERE rowid IN (SELECT id FROM temp.DirtyMessages);")
+			           << QSL("INSERT INTO storage.MessagesSearch (rowid, title, author, contents) "
+			                  "SELECT rowid, title, author, contents FROM main.MessagesSearch "
+			                  "WHERE rowid IN (SELECT id FROM temp.DirtyMessages);");
+		}
+	}
+
+	statements << QSL("DELETE FROM temp.DirtyTables;")
+	           << QSL("DELETE FROM temp.DirtyMessages;");
+
+	// Attach database.
+	copy_contents.exec(QString(QSL("ATTACH DATABASE '%1' AS 'storage';")).arg(file_database.databaseName()));
+
+	if (!database.transaction()) {
+		qCritical("Transaction for saving of in-memory SQLite database was NOT started: '%s'.",
+		          qPrintable(database.lastError().text()));
+		copy_contents.exec(QSL("DETACH 'storage'"));
+		return;
+	}
+
+	foreach (const QString& statement, statements) {
+		if (!copy_contents.exec(statement)) {
+			// Changes stay marked, so that they are saved next time.
+			qCritical("Changes of in-memory SQLite database were NOT saved: '%s'.", qPrintable(copy_contents.lastError().text()));
+			database.rollback();
+			copy_contents.exec(QSL("DETACH 'storage'"));
+			return;
+		}
+	}
+
+	if (!database.commit()) {
+		qCritical("Changes of in-memory SQLite database were NOT saved: '%s'.", qPrintable(database.lastError().text()));
+		database.rollback();
 	}
 
 	// Detach database and finish.
@@ -555,6 +724,19 @@ void DatabaseFactory::sqliteSaveMemoryDatabase() {
 	copy_contents.finish();
 }
 
+void DatabaseFactory::sqliteSaveMemoryDatabaseWhenIdle() {
+	// Feed downloader stores its batches within transaction over the same
+	// in-memory connection, so saving is deferred until update of feeds finishes.
+	if (qApp->feedUpdateLock()->tryLock()) {
+		sqliteSaveMemoryDatabase();
+		qApp->feedUpdateLock()->unlock();
+	}
+
+	else {
+		qDebug("Saving of in-memory SQLite database is deferred, feeds are being updated.");
+	}
+}
+
 void DatabaseFactory::determineDriver() {
 	const QString db_driver = qApp->settings()->value(GROUP(Database), SETTING(Database::ActiveDriver)).toString();
 
@@ -583,6 +765,79 @@ void DatabaseFactory::determineDriver() {
 	}
 }
 
+void DatabaseFactory::initializeSearchIndex(QSqlDatabase database, bool fill_new_index) {
+	bool created;
+
+	m_searchIndexAvailable = DatabaseQueries::initializeSearchIndex(database, &created);
+	m_searchIndexMinWordLength = m_searchIndexAvailable && database.driverName() == APP_DB_MYSQL_DRIVER ?
+	                             DatabaseQueries::getSearchIndexMinWordLength(database) : 0;
+
+	if (m_searchIndexAvailable && created && fill_new_index) {
+		// Existing messages are added in chunks, so that application is not blocked.
+		qDebug("Full-text search index of messages was created, existing messages will be added to it.");
+		DatabaseQueries::storeSearchIndexPosition(database, 0);
+	}
+}
+
+void DatabaseFactory::resumeSearchIndexFilling(QSqlDatabase database) {
+	m_searchIndexPosition = m_searchIndexAvailable ? DatabaseQueries::getSearchIndexPosition(database) : -1;
+
+	if (m_searchIndexPosition >= 0) {
+		qDebug("Search index is not complete, messages after ID '%d' will be added to it.", m_searchIndexPosition);
+		m_searchIndexFillTimer->start();
+	}
+}
+
+void DatabaseFactory::fillSearchIndexChunk() {
+	// Messages are stored by feed downloader within transaction over
+	// the same connection, so filling waits until update of feeds finishes.
+	if (!qApp->feedUpdateLock()->tryLock()) {
+		return;
+	}
+
+	QSqlDatabase database = connection(objectName(), FromSettings);
+	const int previous_position = m_searchIndexPosition;
+
+	if (!DatabaseQueries::fillSearchIndex(database, &m_searchIndexPosition)) {
+		qWarning("Filling of search index is stopped, it continues after restart.");
+		m_searchIndexFillTimer->stop();
+	}
+
+	else {
+		if (m_activeDatabaseDriver == SQLITE_MEMORY) {
+			// Index rows are saved to file-based database together with their messages.
+			QSqlQuery q(database);
+			q.prepare(QSL("INSERT OR IGNORE INTO temp.DirtyMessages SELECT id FROM main.Messages WHERE id > :from AND id <= :to;"));
+			q.bindValue(QSL(":from"), previous_position);
+			q.bindValue(QSL(":to"), m_searchIndexPosition < 0 ? std::numeric_limits<int>::max() : m_searchIndexPosition);
+			q.exec();
+		}
+
+		if (m_searchIndexPosition < 0) {
+			qDebug("Search index now contains all messages.");
+			m_searchIndexFillTimer->stop();
+		}
+	}
+
+	qApp->feedUpdateLock()->unlock();
+}
+
+bool DatabaseFactory::isSearchIndexAvailable() const {
+	return m_searchIndexAvailable;
+}
+
+bool DatabaseFactory::isSearchIndexComplete() const {
+	return m_searchIndexAvailable && m_searchIndexPosition < 0;
+}
+
+int DatabaseFactory::searchIndexMinWordLength() const {
+	return m_searchIndexMinWordLength;
+}
+
+MessageFingerprintCache* DatabaseFactory::fingerprintCache() const {
+	return m_fingerprintCache.data();
+}
+
 DatabaseFactory::UsedDriver DatabaseFactory::activeDatabaseDriver() const {
 	return m_activeDatabaseDriver;
 }
@@ -689,7 +944,7 @@ QSqlDatabase DatabaseFactory::mysqlInitializeDatabase(const QString& connection_
 			query_db.next();
 			const QString installed_db_schema = query_db.value(0).toString();
 
-			if (installed_db_schema < APP_DB_SCHEMA_VERSION) {
+			if (installed_db_schema.toInt() < QString(APP_DB_SCHEMA_VERSION).toInt()) {
 				if (mysqlUpdateDatabaseSchema(database, installed_db_schema, database_name)) {
 					qDebug("Database schema was updated from '%s' to '%s' successully or it is already up to date.",
 					       qPrintable(installed_db_schema),
@@ -705,6 +960,8 @@ QSqlDatabase DatabaseFactory::mysqlInitializeDatabase(const QString& connection_
 		}
 
 		query_db.finish();
+		initializeSearchIndex(database, true);
+		resumeSearchIndexFilling(database);
 	}
 
 	// Everything is initialized now.
@@ -770,11 +1027,16 @@ QSqlDatabase DatabaseFactory::sqliteConnection(const QString& connection_name, D
 				QFile db_file(db_path.absoluteFilePath(APP_DB_SQLITE_FILE));
 				// Setup database file path.
 				database.setDatabaseName(db_file.fileName());
+				sqliteSetupConnection(database);
 			}
 
-			if (!database.isOpen() && !database.open()) {
-				qFatal("File-based SQLite database was NOT opened. Delivered error message: '%s'.",
-				       qPrintable(database.lastError().text()));
+			if (!database.isOpen()) {
+				if (!database.open()) {
+					qFatal("File-based SQLite database was NOT opened. Delivered error message: '%s'.",
+					       qPrintable(database.lastError().text()));
+				}
+
+				sqliteSetupOpenedConnection(database);
 			}
 
 			else {
@@ -788,6 +1050,36 @@ QSqlDatabase DatabaseFactory::sqliteConnection(const QString& connection_name, D
 	}
 }
 
+void DatabaseFactory::sqliteSetupConnection(QSqlDatabase& database) {
+	// Writers are serialized by SQLite itself, connection which wants
+	// to write waits until other connection finishes its transaction.
+	// Main thread does not wait that long, so that GUI does not freeze.
+	const int busy_timeout = QThread::currentThread() == qApp->thread() ?
+	                         APP_DB_SQLITE_GUI_BUSY_TIMEOUT :
+	                         APP_DB_SQLITE_BUSY_TIMEOUT;
+
+	database.setConnectOptions(QString(QSL("QSQLITE_BUSY_TIMEOUT=%1")).arg(busy_timeout));
+}
+
+void DatabaseFactory::sqliteSetupOpenedConnection(QSqlDatabase database) {
+	QSqlQuery query_db(database);
+	query_db.setForwardOnly(true);
+	// With write-ahead log, only checkpoints need to be synced to disk.
+	query_db.exec(QSL("PRAGMA synchronous = NORMAL"));
+	query_db.exec(QSL("PRAGMA cache_size = 16384"));
+	query_db.exec(QSL("PRAGMA count_changes = OFF"));
+	query_db.exec(QSL("PRAGMA temp_store = MEMORY"));
+}
+
+void DatabaseFactory::sqliteCheckpointDatabase() {
+	QSqlQuery query_checkpoint(sqliteConnection(objectName(), StrictlyFileBased));
+
+	// Passive checkpoint does not wait for readers nor writers.
+	if (!query_checkpoint.exec(QSL("PRAGMA wal_checkpoint(PASSIVE)"))) {
+		qWarning("Checkpoint of SQLite database failed: '%s'.", qPrintable(query_checkpoint.lastError().text()));
+	}
+}
+
 bool DatabaseFactory::sqliteVacuumDatabase() {
 	QSqlDatabase database;
 
@@ -812,6 +1104,12 @@ void DatabaseFactory::saveDatabase() {
 	switch (m_activeDatabaseDriver) {
 		case SQLITE_MEMORY:
 			sqliteSaveMemoryDatabase();
+			sqliteConnection(objectName(), StrictlyFileBased).exec(QSL("PRAGMA wal_checkpoint(TRUNCATE)"));
+			break;
+
+		case SQLITE:
+			// Whole database is moved into single file, so that it can be copied.
+			sqliteConnection(objectName(), StrictlyFileBased).exec(QSL("PRAGMA wal_checkpoint(TRUNCATE)"));
 			break;
 
 		default:
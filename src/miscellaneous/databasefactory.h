@@ -20,8 +20,28 @@
 
 #include <QObject>
 #include <QSqlDatabase>
+#include <QStringList>
+#include <QScopedPointer>
+#include <QThreadStorage>
+#include <QAtomicInt>
 
 
+class QTimer;
+class MessageFingerprintCache;
+
+// Database connection of one worker thread. Connection is
+// removed when the thread finishes and this object is deleted.
+class ThreadConnection {
+	public:
+		explicit ThreadConnection(const QString& connection_name);
+		virtual ~ThreadConnection();
+
+		QString connectionName() const;
+
+	private:
+		QString m_connectionName;
+};
+
 class DatabaseFactory : public QObject {
 		Q_OBJECT
 
@@ -70,6 +90,8 @@ class DatabaseFactory : public QObject {
 		// If in-memory is true, then :memory: database is returned
 		// In-memory database is DEFAULT database.
 		// NOTE: This always returns OPENED database.
+		// NOTE: Connections cannot be shared among threads, all callers from
+		// the same non-GUI thread therefore get single connection of that thread.
 		QSqlDatabase connection(const QString& connection_name, DesiredType desired_type = FromSettings);
 
 		QString humanDriverName(UsedDriver driver) const;
@@ -90,6 +112,22 @@ class DatabaseFactory : public QObject {
 		// Returns identification of currently active database driver.
 		UsedDriver activeDatabaseDriver() const;
 
+		// Returns true if full-text search index of messages is supported
+		// by active database, messages are added to it when they are stored.
+		bool isSearchIndexAvailable() const;
+
+		// Returns true if search index contains also all messages stored
+		// before it was created, so that it can be used for searching.
+		bool isSearchIndexComplete() const;
+
+		// Returns minimal length of words which can be searched for
+		// via search index, zero if there is no such limit.
+		int searchIndexMinWordLength() const;
+
+		// Returns cache of fingerprints of stored messages, which
+		// is used to skip unchanged messages when updating feeds.
+		MessageFingerprintCache* fingerprintCache() const;
+
 		// Copies selected backup database (file) to active database path.
 		bool initiateRestoration(const QString& database_backup_file_path);
 
@@ -114,17 +152,50 @@ class DatabaseFactory : public QObject {
 		// Interprets MySQL error code.
 		QString mysqlInterpretErrorCode(MySQLError error_code) const;
 
+	private slots:
+		// Moves pages from write-ahead log into SQLite database file.
+		void sqliteCheckpointDatabase();
+
+		// Saves rows of in-memory database changed since last save
+		// to file-based database.
+		void sqliteSaveMemoryDatabase();
+
+		// Saves in-memory database unless feeds are being updated.
+		void sqliteSaveMemoryDatabaseWhenIdle();
+
+		// Adds next chunk of already stored messages to search index.
+		void fillSearchIndexChunk();
+
 	private:
 		//
 		// GENERAL stuff.
 		//
 
+		// Returns name of connection which is used from current thread.
+		QString threadConnectionName(const QString& connection_name);
+
 		// Decides which database backend will be used in this
 		// application session.
 		void determineDriver();
 
+		// Creates full-text search index of messages if it does not exist. Newly
+		// created index is filled with already stored messages if requested.
+		void initializeSearchIndex(QSqlDatabase database, bool fill_new_index);
+
+		// Continues filling of search index of working database if it is not complete.
+		void resumeSearchIndexFilling(QSqlDatabase database);
+
 		// Holds the type of currently activated database backend.
 		UsedDriver m_activeDatabaseDriver;
+		bool m_searchIndexAvailable;
+		int m_searchIndexPosition;
+		int m_searchIndexMinWordLength;
+		QTimer* m_searchIndexFillTimer;
+		QScopedPointer<MessageFingerprintCache> m_fingerprintCache;
+
+		// Connections of worker threads, names of connections are never reused.
+		QThreadStorage<ThreadConnection*> m_threadConnections;
+		QAtomicInt m_threadConnectionsCounter;
 
 		//
 		// MYSQL stuff.
@@ -152,12 +223,17 @@ class DatabaseFactory : public QObject {
 
 		QSqlDatabase sqliteConnection(const QString& connection_name, DesiredType desired_type);
 
+		// Sets options of new connection to file-based database, must be called before it is opened.
+		void sqliteSetupConnection(QSqlDatabase& database);
+
+		// Sets properties of opened connection to file-based database.
+		void sqliteSetupOpenedConnection(QSqlDatabase database);
+
 		// Runs "VACUUM" on the database.
 		bool sqliteVacuumDatabase();
 
-		// Performs saving of items from in-memory database
-		// to file-based database.
-		void sqliteSaveMemoryDatabase();
+		// Creates triggers which mark rows of in-memory database as changed.
+		void sqliteInitializeMemoryChangeTracking(QSqlDatabase database, const QStringList& tables);
 
 		// Assemblies database file path.
 		void sqliteAssemblyDatabaseFilePath();
@@ -176,6 +252,12 @@ class DatabaseFactory : public QObject {
 		// Is database file initialized?
 		bool m_sqliteFileBasedDatabaseinitialized;
 		bool m_sqliteInMemoryDatabaseInitialized;
+
+		// Periodically checkpoints write-ahead log of database file.
+		QTimer* m_sqliteCheckpointTimer;
+
+		// Periodically saves changes of in-memory database.
+		QTimer* m_sqliteMemorySaveTimer;
 };
 
 #endif // DATABASEFACTORY_H
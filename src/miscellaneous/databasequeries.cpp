@@ -32,17 +32,23 @@
 #include "miscellaneous/textfactory.h"
 #include "miscellaneous/application.h"
 #include "miscellaneous/iconfactory.h"
+#include "miscellaneous/messagefingerprintcache.h"
+#include "network-web/webfactory.h"
 
 #include <QVariant>
 #include <QUrl>
 #include <QSqlError>
+#include <QSet>
+#include <QCryptographicHash>
+#include <QtEndian>
 
 
-bool DatabaseQueries::markMessagesReadUnread(QSqlDatabase db, const QStringList& ids, RootItem::ReadStatus read) {
-	QSqlQuery q(db);
-	q.setForwardOnly(true);
-	return q.exec(QString(QSL("UPDATE Messages SET is_read = %2 WHERE id IN (%1);"))
-	              .arg(ids.join(QSL(", ")), read == RootItem::Read ? QSL("1") : QSL("0")));
+bool DatabaseQueries::markMessagesReadUnread(QSqlDatabase db, const QStringList& ids, RootItem::ReadStatus read,
+                                             QMap<int, QPair<int, int>>* changed_counts) {
+	const QString assignment = read == RootItem::Read ? QSL("is_read = 1") : QSL("is_read = 0");
+	const QString condition = read == RootItem::Read ? QSL("is_read = 0") : QSL("is_read = 1");
+
+	return changeMessages(db, ids, assignment, condition, changed_counts);
 }
 
 bool DatabaseQueries::markMessageImportant(QSqlDatabase db, int id, RootItem::Importance importance) {
@@ -95,18 +101,72 @@ bool DatabaseQueries::switchMessagesImportance(QSqlDatabase db, const QStringLis
 	return q.exec(QString(QSL("UPDATE Messages SET is_important = NOT is_important WHERE id IN (%1);")).arg(ids.join(QSL(", "))));
 }
 
-bool DatabaseQueries::permanentlyDeleteMessages(QSqlDatabase db, const QStringList& ids) {
-	QSqlQuery q(db);
-	q.setForwardOnly(true);
-	return q.exec(QString(QSL("UPDATE Messages SET is_pdeleted = 1 WHERE id IN (%1);")).arg(ids.join(QSL(", "))));
+bool DatabaseQueries::permanentlyDeleteMessages(QSqlDatabase db, const QStringList& ids,
+                                                QMap<int, QPair<int, int>>* changed_counts) {
+	return changeMessages(db, ids, QSL("is_pdeleted = 1"), QSL("is_pdeleted = 0"), changed_counts);
+}
+
+bool DatabaseQueries::deleteOrRestoreMessagesToFromBin(QSqlDatabase db, const QStringList& ids, bool deleted,
+                                                       QMap<int, QPair<int, int>>* changed_counts) {
+	return changeMessages(db, ids, deleted ? QSL("is_deleted = 1, is_pdeleted = 0") : QSL("is_deleted = 0, is_pdeleted = 0"),
+	                      deleted ? QSL("is_deleted = 0 AND is_pdeleted = 0") : QSL("is_deleted = 1 AND is_pdeleted = 0"),
+	                      changed_counts);
 }
 
-bool DatabaseQueries::deleteOrRestoreMessagesToFromBin(QSqlDatabase db, const QStringList& ids, bool deleted) {
+bool DatabaseQueries::changeMessages(QSqlDatabase db, const QStringList& ids, const QString& assignment,
+                                     const QString& condition, QMap<int, QPair<int, int>>* changed_counts) {
 	QSqlQuery q(db);
 	q.setForwardOnly(true);
-	return q.exec(QString(QSL("UPDATE Messages SET is_deleted = %2, is_pdeleted = %3 WHERE id IN (%1);")).arg(ids.join(QSL(", ")),
-	              QString::number(deleted ? 1 : 0),
-	              QString::number(0)));
+
+	if (changed_counts == nullptr) {
+		return q.exec(QString("UPDATE Messages SET %1 WHERE id IN (%2);").arg(assignment, ids.join(QSL(", "))));
+	}
+
+	// Feed of message never changes, so messages can be safely split by feeds in advance.
+	QMap<int, QStringList> feed_message_ids;
+
+	if (!q.exec(QString("SELECT id, feed FROM Messages WHERE id IN (%1);").arg(ids.join(QSL(", "))))) {
+		qWarning("Cannot obtain feeds of messages: '%s'.", qPrintable(q.lastError().text()));
+		return false;
+	}
+
+	while (q.next()) {
+		feed_message_ids[q.value(1).toInt()].append(q.value(0).toString());
+	}
+
+	// Messages which do not match the condition already have required state, so only
+	// really changed ones are counted. Unread and read messages are changed separately
+	// and the number of changed ones is told by database itself. Message whose read
+	// status was changed by other connection meanwhile is changed in next round.
+	for (QMap<int, QStringList>::const_iterator i = feed_message_ids.constBegin(); i != feed_message_ids.constEnd(); i++) {
+		QPair<int, int> counts(0, 0);
+		int changed_in_round;
+
+		do {
+			changed_in_round = 0;
+
+			for (int is_read = 0; is_read <= 1; is_read++) {
+				if (!q.exec(QString("UPDATE Messages SET %1 WHERE id IN (%2) AND %3 AND is_read = %4;")
+				            .arg(assignment, i.value().join(QSL(", ")), condition, QString::number(is_read)))) {
+					qWarning("Cannot change messages: '%s'.", qPrintable(q.lastError().text()));
+					return false;
+				}
+
+				const int changed_messages = q.numRowsAffected();
+
+				changed_in_round += changed_messages;
+				counts.first += is_read == 0 ? changed_messages : 0;
+				counts.second += changed_messages;
+			}
+		}
+		while (changed_in_round > 0 && counts.second < i.value().size());
+
+		if (counts.second > 0) {
+			changed_counts->insert(i.key(), counts);
+		}
+	}
+
+	return true;
 }
 
 bool DatabaseQueries::restoreBin(QSqlDatabase db, int account_id) {
@@ -122,7 +182,10 @@ bool DatabaseQueries::purgeImportantMessages(QSqlDatabase db) {
 	QSqlQuery q(db);
 	q.setForwardOnly(true);
 	q.prepare(QSL("DELETE FROM Messages WHERE is_important = 1;"));
-	return q.exec();
+	const bool result = q.exec();
+	// Removed messages must be stored again if they appear in feeds.
+	qApp->database()->fingerprintCache()->clear();
+	return result;
 }
 
 bool DatabaseQueries::purgeReadMessages(QSqlDatabase db) {
@@ -134,7 +197,9 @@ bool DatabaseQueries::purgeReadMessages(QSqlDatabase db) {
 	q.bindValue(QSL(":is_deleted"), 0);
 	// Remove only messages which are NOT starred.
 	q.bindValue(QSL(":is_important"), 0);
-	return q.exec();
+	const bool result = q.exec();
+	qApp->database()->fingerprintCache()->clear();
+	return result;
 }
 
 bool DatabaseQueries::purgeOldMessages(QSqlDatabase db, int older_than_days) {
@@ -145,7 +210,9 @@ bool DatabaseQueries::purgeOldMessages(QSqlDatabase db, int older_than_days) {
 	q.bindValue(QSL(":date_created"), since_epoch);
 	// Remove only messages which are NOT starred.
 	q.bindValue(QSL(":is_important"), 0);
-	return q.exec();
+	const bool result = q.exec();
+	qApp->database()->fingerprintCache()->clear();
+	return result;
 }
 
 bool DatabaseQueries::purgeRecycleBin(QSqlDatabase db) {
@@ -155,7 +222,9 @@ bool DatabaseQueries::purgeRecycleBin(QSqlDatabase db) {
 	q.bindValue(QSL(":is_deleted"), 1);
 	// Remove only messages which are NOT starred.
 	q.bindValue(QSL(":is_important"), 0);
-	return q.exec();
+	const bool result = q.exec();
+	qApp->database()->fingerprintCache()->clear();
+	return result;
 }
 
 QMap<int, QPair<int, int>> DatabaseQueries::getMessageCountsForCategory(QSqlDatabase db, int custom_id, int account_id,
@@ -257,6 +326,53 @@ bool including_total_counts, bool* ok) {
 	return counts;
 }
 
+QMap<int, QPair<int, int>> DatabaseQueries::getMessageCountsForFeeds(QSqlDatabase db, const QList<int>& feed_custom_ids,
+int account_id, bool* ok) {
+	QMap<int, QPair<int, int>> counts;
+	QSqlQuery q(db);
+	q.setForwardOnly(true);
+
+	// Feeds are split into chunks, so that we never cross
+	// the limit of bound values in single statement.
+	for (int i = 0; i < feed_custom_ids.size(); i += MSG_BULK_MAX_BOUND_VALUES - 1) {
+		const QList<int> chunk = feed_custom_ids.mid(i, MSG_BULK_MAX_BOUND_VALUES - 1);
+		QStringList placeholders;
+
+		for (int j = 0; j < chunk.size(); j++) {
+			placeholders.append(QSL("?"));
+		}
+
+		q.prepare(QString("SELECT feed, sum((is_read + 1) % 2), count(*) FROM Messages "
+		                  "WHERE is_deleted = 0 AND is_pdeleted = 0 AND account_id = ? AND feed IN (%1) "
+		                  "GROUP BY feed;").arg(placeholders.join(QSL(", "))));
+		q.addBindValue(account_id);
+
+		foreach (int feed_custom_id, chunk) {
+			q.addBindValue(feed_custom_id);
+		}
+
+		if (!q.exec()) {
+			qWarning("Failed to obtain message counts of feeds: '%s'.", qPrintable(q.lastError().text()));
+
+			if (ok != nullptr) {
+				*ok = false;
+			}
+
+			return QMap<int, QPair<int, int>>();
+		}
+
+		while (q.next()) {
+			counts.insert(q.value(0).toInt(), QPair<int, int>(q.value(1).toInt(), q.value(2).toInt()));
+		}
+	}
+
+	if (ok != nullptr) {
+		*ok = true;
+	}
+
+	return counts;
+}
+
 int DatabaseQueries::getMessageCountsForFeed(QSqlDatabase db, int feed_custom_id,
                                              int account_id, bool including_total_counts, bool* ok) {
 	QSqlQuery q(db);
@@ -292,6 +408,191 @@ int DatabaseQueries::getMessageCountsForFeed(QSqlDatabase db, int feed_custom_id
 	}
 }
 
+qint64 DatabaseQueries::getPublishingIntervalForFeed(QSqlDatabase db, int feed_custom_id, int account_id, bool* ok) {
+	QSqlQuery q(db);
+	q.setForwardOnly(true);
+	q.prepare(QString("SELECT count(*), min(date_created) FROM "
+	                  "(SELECT date_created FROM Messages WHERE feed = :feed AND is_pdeleted = 0 AND account_id = :account_id "
+	                  "ORDER BY date_created DESC LIMIT %1) AS History;").arg(ADAPTIVE_UPDATE_HISTORY));
+	q.bindValue(QSL(":feed"), feed_custom_id);
+	q.bindValue(QSL(":account_id"), account_id);
+
+	if (q.exec() && q.next()) {
+		if (ok != nullptr) {
+			*ok = true;
+		}
+
+		const int count = q.value(0).toInt();
+
+		if (count > 0) {
+			// Each message closes one gap, the last gap is still open.
+			return qMax(qint64(0), QDateTime::currentDateTimeUtc().toMSecsSinceEpoch() - q.value(1).toLongLong()) / count;
+		}
+
+		else {
+			return 0;
+		}
+	}
+
+	else {
+		if (ok != nullptr) {
+			*ok = false;
+		}
+
+		return 0;
+	}
+}
+
+bool DatabaseQueries::hasFeedAnyMessages(QSqlDatabase db, int feed_custom_id, int account_id, bool* ok) {
+	QSqlQuery q(db);
+	q.setForwardOnly(true);
+	q.prepare(QSL("SELECT id FROM Messages WHERE feed = :feed AND account_id = :account_id LIMIT 1;"));
+	q.bindValue(QSL(":feed"), feed_custom_id);
+	q.bindValue(QSL(":account_id"), account_id);
+
+	if (q.exec()) {
+		if (ok != nullptr) {
+			*ok = true;
+		}
+
+		return q.next();
+	}
+
+	else {
+		if (ok != nullptr) {
+			*ok = false;
+		}
+
+		return false;
+	}
+}
+
+QMap<int, int> DatabaseQueries::getStateCountsForSynchronization(QSqlDatabase db, int account_id, int* starred_count,
+                                                                bool* ok) {
+	QMap<int, int> unread_counts;
+	QSqlQuery q(db);
+	q.setForwardOnly(true);
+
+	// Server knows nothing about deleting of messages, so deleted messages are counted too.
+	q.prepare(QSL("SELECT feed, sum((is_read + 1) % 2), sum(is_important) FROM Messages "
+	              "WHERE account_id = :account_id GROUP BY feed;"));
+	q.bindValue(QSL(":account_id"), account_id);
+	*starred_count = 0;
+
+	if (!q.exec()) {
+		qWarning("Failed to obtain message states of account '%d': '%s'.", account_id, qPrintable(q.lastError().text()));
+
+		if (ok != nullptr) {
+			*ok = false;
+		}
+
+		return unread_counts;
+	}
+
+	while (q.next()) {
+		unread_counts.insert(q.value(0).toInt(), q.value(1).toInt());
+		*starred_count += q.value(2).toInt();
+	}
+
+	if (ok != nullptr) {
+		*ok = true;
+	}
+
+	return unread_counts;
+}
+
+int DatabaseQueries::synchronizeMessageStates(QSqlDatabase db, int feed_custom_id, int account_id,
+                                              const QSet<int>* unread_custom_ids, const QSet<int>* starred_custom_ids,
+                                              bool* ok) {
+	bool read_ok = true;
+	bool starred_ok = true;
+	int changed_messages = 0;
+
+	if (unread_custom_ids != nullptr) {
+		changed_messages += synchronizeMessageFlag(db, feed_custom_id, account_id, QSL("is_read"),
+		                                           *unread_custom_ids, false, &read_ok);
+	}
+
+	if (starred_custom_ids != nullptr) {
+		changed_messages += synchronizeMessageFlag(db, feed_custom_id, account_id, QSL("is_important"),
+		                                           *starred_custom_ids, true, &starred_ok);
+	}
+
+	if (ok != nullptr) {
+		*ok = read_ok && starred_ok;
+	}
+
+	return changed_messages;
+}
+
+int DatabaseQueries::synchronizeMessageFlag(QSqlDatabase db, int feed_custom_id, int account_id, const QString& column,
+                                            const QSet<int>& custom_ids, bool value, bool* ok) {
+	QSqlQuery q(db);
+	q.setForwardOnly(true);
+	q.prepare(QString("SELECT custom_id FROM Messages "
+	                  "WHERE feed = :feed AND account_id = :account_id AND %1 = :value;").arg(column));
+	q.bindValue(QSL(":feed"), feed_custom_id);
+	q.bindValue(QSL(":account_id"), account_id);
+	q.bindValue(QSL(":value"), (int) value);
+
+	if (!q.exec()) {
+		qWarning("Cannot obtain states of messages of feed '%d': '%s'.", feed_custom_id, qPrintable(q.lastError().text()));
+		*ok = false;
+		return 0;
+	}
+
+	QSet<int> stored_ids;
+
+	while (q.next()) {
+		stored_ids.insert(q.value(0).toInt());
+	}
+
+	// Only messages whose state differs are written. Listed IDs
+	// of messages which are not stored do not match any row.
+	const QList<int> set_ids = (custom_ids - stored_ids).toList();
+	const QList<int> cleared_ids = (stored_ids - custom_ids).toList();
+	int changed_messages = 0;
+
+	*ok = true;
+
+	for (int k = 0; k < 2; k++) {
+		const QList<int>& ids = k == 0 ? set_ids : cleared_ids;
+
+		// IDs are split into chunks, so that we never cross
+		// the limit of bound values in single statement.
+		for (int i = 0; i < ids.size(); i += MSG_BULK_MAX_BOUND_VALUES - 3) {
+			const QList<int> chunk = ids.mid(i, MSG_BULK_MAX_BOUND_VALUES - 3);
+			QStringList placeholders;
+
+			for (int j = 0; j < chunk.size(); j++) {
+				placeholders.append(QSL("?"));
+			}
+
+			q.prepare(QString("UPDATE Messages SET %1 = ? "
+			                  "WHERE feed = ? AND account_id = ? AND custom_id IN (%2);").arg(column,
+			                                                                                 placeholders.join(QSL(", "))));
+			q.addBindValue((int) (k == 0 ? value : !value));
+			q.addBindValue(feed_custom_id);
+			q.addBindValue(account_id);
+
+			foreach (int custom_id, chunk) {
+				q.addBindValue(QString::number(custom_id));
+			}
+
+			if (q.exec()) {
+				changed_messages += q.numRowsAffected();
+			}
+
+			else {
+				qWarning("Failed to update states of messages in DB: '%s'.", qPrintable(q.lastError().text()));
+				*ok = false;
+			}
+		}
+	}
+
+	return changed_messages;
+}
+
 int DatabaseQueries::getMessageCountsForBin(QSqlDatabase db, int account_id, bool including_total_counts, bool* ok) {
 	QSqlQuery q(db);
 	q.setForwardOnly(true);
@@ -325,11 +626,35 @@ int DatabaseQueries::getMessageCountsForBin(QSqlDatabase db, int account_id, boo
 	}
 }
 
+QString DatabaseQueries::getMessageContents(QSqlDatabase db, int message_id, bool* ok) {
+	QSqlQuery q(db);
+	q.setForwardOnly(true);
+	q.prepare(QSL("SELECT contents FROM Messages WHERE id = :id;"));
+	q.bindValue(QSL(":id"), message_id);
+
+	if (q.exec() && q.next()) {
+		if (ok != nullptr) {
+			*ok = true;
+		}
+
+		return q.value(0).toString();
+	}
+
+	else {
+		if (ok != nullptr) {
+			*ok = false;
+		}
+
+		return QString();
+	}
+}
+
 QList<Message> DatabaseQueries::getUndeletedMessagesForFeed(QSqlDatabase db, int feed_custom_id, int account_id, bool* ok) {
 	QList<Message> messages;
 	QSqlQuery q(db);
 	q.setForwardOnly(true);
-	q.prepare("SELECT * "
+	q.prepare("SELECT id, is_read, is_deleted, is_important, feed, title, url, author, date_created, contents, "
+	          "is_pdeleted, enclosures, account_id, custom_id, custom_hash, feed "
 	          "FROM Messages "
 	          "WHERE is_deleted = 0 AND is_pdeleted = 0 AND feed = :feed AND account_id = :account_id;");
 	q.bindValue(QSL(":feed"), feed_custom_id);
@@ -345,84 +670,437 @@ QList<Message> DatabaseQueries::getUndeletedMessagesForFeed(QSqlDatabase db, int
 			}
 		}
 
-		if (ok != nullptr) {
-			*ok = true;
+		if (ok != nullptr) {
+			*ok = true;
+		}
+	}
+
+	else {
+		if (ok != nullptr) {
+			*ok = false;
+		}
+	}
+
+	return messages;
+}
+
+QList<Message> DatabaseQueries::getUndeletedMessagesForBin(QSqlDatabase db, int account_id, bool* ok) {
+	QList<Message> messages;
+	QSqlQuery q(db);
+	q.setForwardOnly(true);
+	q.prepare("SELECT id, is_read, is_deleted, is_important, feed, title, url, author, date_created, contents, "
+	          "is_pdeleted, enclosures, account_id, custom_id, custom_hash, feed "
+	          "FROM Messages "
+	          "WHERE is_deleted = 1 AND is_pdeleted = 0 AND account_id = :account_id;");
+	q.bindValue(QSL(":account_id"), account_id);
+
+	if (q.exec()) {
+		while (q.next()) {
+			bool decoded;
+			Message message = Message::fromSqlRecord(q.record(), &decoded);
+
+			if (decoded) {
+				messages.append(message);
+			}
+		}
+
+		if (ok != nullptr) {
+			*ok = true;
+		}
+	}
+
+	else {
+		if (ok != nullptr) {
+			*ok = false;
+		}
+	}
+
+	return messages;
+}
+
+QList<Message> DatabaseQueries::getUndeletedMessagesForAccount(QSqlDatabase db, int account_id, bool* ok) {
+	QList<Message> messages;
+	QSqlQuery q(db);
+	q.setForwardOnly(true);
+	q.prepare("SELECT id, is_read, is_deleted, is_important, feed, title, url, author, date_created, contents, "
+	          "is_pdeleted, enclosures, account_id, custom_id, custom_hash, feed "
+	          "FROM Messages "
+	          "WHERE is_deleted = 0 AND is_pdeleted = 0 AND account_id = :account_id;");
+	q.bindValue(QSL(":account_id"), account_id);
+
+	if (q.exec()) {
+		while (q.next()) {
+			bool decoded;
+			Message message = Message::fromSqlRecord(q.record(), &decoded);
+
+			if (decoded) {
+				messages.append(message);
+			}
+		}
+
+		if (ok != nullptr) {
+			*ok = true;
+		}
+	}
+
+	else {
+		if (ok != nullptr) {
+			*ok = false;
+		}
+	}
+
+	return messages;
+}
+
+QString DatabaseQueries::messageUrlKey(const QString& title, const QString& url, const QString& author) {
+	return title + QL1C('\0') + url + QL1C('\0') + author;
+}
+
+qint64 DatabaseQueries::messageUrlHash(const QString& title, const QString& url, const QString& author) {
+	const QByteArray digest = QCryptographicHash::hash(messageUrlKey(title, url, author).toUtf8(), QCryptographicHash::Md5);
+	return qFromLittleEndian<qint64>(reinterpret_cast<const uchar*>(digest.constData()));
+}
+
+QString DatabaseQueries::bulkPlaceholders(int rows, int columns) {
+	QStringList row_placeholders;
+	QStringList column_placeholders;
+
+	for (int i = 0; i < columns; i++) {
+		column_placeholders.append(QSL("?"));
+	}
+
+	const QString row = QSL("(") + column_placeholders.join(QSL(", ")) + QSL(")");
+
+	for (int i = 0; i < rows; i++) {
+		row_placeholders.append(row);
+	}
+
+	return row_placeholders.join(QSL(", "));
+}
+
+QHash<int, DatabaseQueries::ExistingMessage> DatabaseQueries::existingMessagesByCustomId(QSqlDatabase db, const QStringList& custom_ids,
+                                                                                          int account_id) {
+	QHash<int, ExistingMessage> existing;
+	QSqlQuery q(db);
+	q.setForwardOnly(true);
+
+	// Database compares IDs with collation of the column, which need not be exact (MySQL),
+	// so it also tells which of looked up IDs each returned row matches. Lookup is split
+	// into chunks, so that we never cross the limit of bound values in single statement.
+	const int chunk_size = (MSG_BULK_MAX_BOUND_VALUES - 1) / 2;
+
+	for (int i = 0; i < custom_ids.size(); i += chunk_size) {
+		const QStringList chunk = custom_ids.mid(i, chunk_size);
+		QStringList cases;
+		QStringList placeholders;
+
+		for (int j = 0; j < chunk.size(); j++) {
+			cases.append(QString("WHEN custom_id = ? THEN %1").arg(i + j));
+			placeholders.append(QSL("?"));
+		}
+
+		// Newest row is returned first for each ID.
+		q.prepare(QString("SELECT id, date_created, is_read, is_important, contents, CASE %1 END FROM Messages "
+		                  "WHERE account_id = ? AND custom_id IN (%2) ORDER BY id DESC;").arg(cases.join(QSL(" ")),
+		                                                                                    placeholders.join(QSL(", "))));
+
+		foreach (const QString& custom_id, chunk) {
+			q.addBindValue(custom_id);
+		}
+
+		q.addBindValue(account_id);
+
+		foreach (const QString& custom_id, chunk) {
+			q.addBindValue(custom_id);
+		}
+
+		if (q.exec()) {
+			while (q.next()) {
+				const int index = q.value(5).toInt();
+
+				if (!q.value(5).isNull() && !existing.contains(index)) {
+					ExistingMessage message;
+					message.m_id = q.value(0).toInt();
+					message.m_created = q.value(1).value<qint64>();
+					message.m_isRead = q.value(2).toBool();
+					message.m_isImportant = q.value(3).toBool();
+					message.m_contents = q.value(4).toString();
+					existing.insert(index, message);
+				}
+			}
+		}
+
+		else {
+			qDebug("Failed to check for existing messages in DB via ID: '%s'.", qPrintable(q.lastError().text()));
+		}
+
+		q.finish();
+	}
+
+	return existing;
+}
+
+QHash<int, DatabaseQueries::ExistingMessage> DatabaseQueries::existingMessagesByUrl(QSqlDatabase db, const QList<Message>& messages,
+                                                                                     int feed_custom_id, int account_id) {
+	QHash<int, ExistingMessage> existing;
+	QSqlQuery q(db);
+	q.setForwardOnly(true);
+
+	// SQLite compares texts exactly, so lookup is narrowed down by compact hashes of
+	// TITLE, URL & AUTHOR. MySQL compares them with case and accent insensitive collation,
+	// which hashes cannot follow, so lookup is narrowed down by URLs there. In both cases
+	// database itself confirms which of looked up messages each returned row matches.
+	const bool exact_comparison = db.driverName() != QSL(APP_DB_MYSQL_DRIVER);
+	const int chunk_size = (MSG_BULK_MAX_BOUND_VALUES - 2) / 4;
+
+	for (int i = 0; i < messages.size(); i += chunk_size) {
+		const QList<Message> chunk = messages.mid(i, chunk_size);
+		QStringList cases;
+		QStringList placeholders;
+
+		for (int j = 0; j < chunk.size(); j++) {
+			cases.append(QString("WHEN title = ? AND url = ? AND author = ? THEN %1").arg(i + j));
+			placeholders.append(QSL("?"));
+		}
+
+		// Newest row is returned first for each message.
+		q.prepare(QString("SELECT id, date_created, is_read, is_important, contents, CASE %1 END FROM Messages "
+		                  "WHERE account_id = ? AND feed = ? AND %2 IN (%3) ORDER BY id DESC;").arg(cases.join(QSL(" ")),
+		                                                                                          exact_comparison ? QSL("url_hash") : QSL("url"),
+		                                                                                          placeholders.join(QSL(", "))));
+
+		foreach (const Message& message, chunk) {
+			q.addBindValue(message.m_title);
+			q.addBindValue(message.m_url);
+			q.addBindValue(message.m_author);
+		}
+
+		q.addBindValue(account_id);
+		q.addBindValue(feed_custom_id);
+
+		foreach (const Message& message, chunk) {
+			if (exact_comparison) {
+				q.addBindValue(messageUrlHash(message.m_title, message.m_url, message.m_author));
+			}
+
+			else {
+				q.addBindValue(message.m_url);
+			}
+		}
+
+		if (q.exec()) {
+			while (q.next()) {
+				const int index = q.value(5).toInt();
+
+				if (!q.value(5).isNull() && !existing.contains(index)) {
+					ExistingMessage message;
+					message.m_id = q.value(0).toInt();
+					message.m_created = q.value(1).value<qint64>();
+					message.m_isRead = q.value(2).toBool();
+					message.m_isImportant = q.value(3).toBool();
+					message.m_contents = q.value(4).toString();
+					existing.insert(index, message);
+				}
+			}
+		}
+
+		else {
+			qWarning("Failed to check for existing messages in DB via URL: '%s'.", qPrintable(q.lastError().text()));
+		}
+
+		q.finish();
+	}
+
+	return existing;
+}
+
+void DatabaseQueries::fillMissingUrlHashes(QSqlDatabase db, int feed_custom_id, int account_id) {
+	QSqlQuery q(db);
+	QSqlQuery query_update(db);
+	QList<QPair<int, qint64>> hashes;
+	q.setForwardOnly(true);
+	// Messages stored before schema version 9 do not have their hashes computed.
+	// This is done lazily, once per feed, because hash cannot be calculated in SQL.
+	q.prepare(QSL("SELECT id, title, url, author FROM Messages "
+	              "WHERE account_id = :account_id AND feed = :feed AND url_hash IS NULL;"));
+	q.bindValue(QSL(":account_id"), account_id);
+	q.bindValue(QSL(":feed"), feed_custom_id);
+
+	if (!q.exec()) {
+		qWarning("Failed to obtain messages without URL hash: '%s'.", qPrintable(q.lastError().text()));
+		return;
+	}
+
+	while (q.next()) {
+		hashes.append(QPair<int, qint64>(q.value(0).toInt(),
+		                                 messageUrlHash(q.value(1).toString(), q.value(2).toString(), q.value(3).toString())));
+	}
+
+	q.finish();
+
+	if (hashes.isEmpty()) {
+		return;
+	}
+
+	// Hashes are stored in bulk, each statement updates as many messages as
+	// bound values allow. Whole backfill runs within transaction of the caller.
+	const int chunk_size = MSG_BULK_MAX_BOUND_VALUES / 3;
+	int stored_hashes = 0;
+	query_update.setForwardOnly(true);
+
+	for (int i = 0; i < hashes.size(); i += chunk_size) {
+		const QList<QPair<int, qint64>> chunk = hashes.mid(i, chunk_size);
+		QStringList cases;
+		QStringList placeholders;
+
+		for (int j = 0; j < chunk.size(); j++) {
+			cases.append(QSL("WHEN ? THEN ?"));
+			placeholders.append(QSL("?"));
+		}
+
+		query_update.prepare(QString("UPDATE Messages SET url_hash = CASE id %1 END WHERE id IN (%2);")
+		                     .arg(cases.join(QSL(" ")), placeholders.join(QSL(", "))));
+
+		for (int j = 0; j < chunk.size(); j++) {
+			query_update.addBindValue(chunk.at(j).first);
+			query_update.addBindValue(chunk.at(j).second);
+		}
+
+		for (int j = 0; j < chunk.size(); j++) {
+			query_update.addBindValue(chunk.at(j).first);
 		}
-	}
 
-	else {
-		if (ok != nullptr) {
-			*ok = false;
+		if (query_update.exec()) {
+			stored_hashes += chunk.size();
+		}
+
+		else {
+			qWarning("Failed to store URL hashes of messages: '%s'.", qPrintable(query_update.lastError().text()));
 		}
+
+		query_update.finish();
 	}
 
-	return messages;
+	qDebug("Computed URL hashes for %d of %d messages of feed '%d'.", stored_hashes, hashes.size(), feed_custom_id);
 }
 
-QList<Message> DatabaseQueries::getUndeletedMessagesForBin(QSqlDatabase db, int account_id, bool* ok) {
-	QList<Message> messages;
+int DatabaseQueries::insertMessages(QSqlDatabase db, const QList<Message>& messages, int feed_custom_id, int account_id,
+                                    int* inserted_unread) {
+	// Number of columns filled for each inserted message.
+	const int columns = 13;
+	const int chunk_size = MSG_BULK_MAX_BOUND_VALUES / columns;
+	int inserted_messages = 0;
 	QSqlQuery q(db);
 	q.setForwardOnly(true);
-	q.prepare("SELECT * "
-	          "FROM Messages "
-	          "WHERE is_deleted = 1 AND is_pdeleted = 0 AND account_id = :account_id;");
-	q.bindValue(QSL(":account_id"), account_id);
 
-	if (q.exec()) {
-		while (q.next()) {
-			bool decoded;
-			Message message = Message::fromSqlRecord(q.record(), &decoded);
+	for (int i = 0; i < messages.size(); i += chunk_size) {
+		const QList<Message> chunk = messages.mid(i, chunk_size);
+
+		q.prepare(QString("INSERT INTO Messages "
+		                  "(feed, title, is_read, is_important, url, author, date_created, contents, enclosures, custom_id, custom_hash, account_id, url_hash) "
+		                  "VALUES %1;").arg(bulkPlaceholders(chunk.size(), columns)));
+
+		foreach (const Message& message, chunk) {
+			q.addBindValue(feed_custom_id);
+			q.addBindValue(message.m_title);
+			q.addBindValue((int) message.m_isRead);
+			q.addBindValue((int) message.m_isImportant);
+			q.addBindValue(message.m_url);
+			q.addBindValue(message.m_author);
+			q.addBindValue(message.m_created.toMSecsSinceEpoch());
+			q.addBindValue(message.m_contents);
+			q.addBindValue(Enclosures::encodeEnclosuresToString(message.m_enclosures));
+			q.addBindValue(message.m_customId);
+			q.addBindValue(message.m_customHash);
+			q.addBindValue(account_id);
+			q.addBindValue(messageUrlHash(message.m_title, message.m_url, message.m_author));
+		}
 
-			if (decoded) {
-				messages.append(message);
+		if (q.exec()) {
+			inserted_messages += q.numRowsAffected();
+			qDebug("Added %d new messages to DB.", chunk.size());
+
+			foreach (const Message& message, chunk) {
+				if (!message.m_isRead) {
+					(*inserted_unread)++;
+				}
+			}
+
+			if (qApp->database()->isSearchIndexAvailable()) {
+				// IDs of rows inserted by single statement need not be consecutive
+				// (for example with InnoDB "interleaved" lock mode), so they are queried.
+				const QList<int> inserted_ids = insertedMessageIds(db, chunk, feed_custom_id, account_id);
+				QList<int> ids;
+				QList<Message> indexed_messages;
+
+				for (int j = 0; j < chunk.size(); j++) {
+					if (inserted_ids.at(j) > 0) {
+						ids.append(inserted_ids.at(j));
+						indexed_messages.append(chunk.at(j));
+					}
+
+					else {
+						qWarning("ID of inserted message '%s' was not found, message is not indexed.", qPrintable(chunk.at(j).m_title));
+					}
+				}
+
+				indexMessages(db, ids, indexed_messages);
 			}
 		}
 
-		if (ok != nullptr) {
-			*ok = true;
+		else if (chunk.size() > 1) {
+			// Whole chunk is rejected if single message in it is malformed,
+			// we therefore insert messages one by one to keep the valid ones.
+			qWarning("Failed to insert chunk of messages to DB: '%s'. Inserting messages one by one.", qPrintable(q.lastError().text()));
+			q.finish();
+
+			foreach (const Message& message, chunk) {
+				inserted_messages += insertMessages(db, QList<Message>() << message, feed_custom_id, account_id, inserted_unread);
+			}
 		}
-	}
 
-	else {
-		if (ok != nullptr) {
-			*ok = false;
+		else {
+			qWarning("Failed to insert message to DB: '%s' - message title is '%s'.",
+			         qPrintable(q.lastError().text()),
+			         qPrintable(chunk.first().m_title));
 		}
+
+		q.finish();
 	}
 
-	return messages;
+	return inserted_messages;
 }
 
-QList<Message> DatabaseQueries::getUndeletedMessagesForAccount(QSqlDatabase db, int account_id, bool* ok) {
-	QList<Message> messages;
-	QSqlQuery q(db);
-	q.setForwardOnly(true);
-	q.prepare("SELECT * "
-	          "FROM Messages "
-	          "WHERE is_deleted = 0 AND is_pdeleted = 0 AND account_id = :account_id;");
-	q.bindValue(QSL(":account_id"), account_id);
-
-	if (q.exec()) {
-		while (q.next()) {
-			bool decoded;
-			Message message = Message::fromSqlRecord(q.record(), &decoded);
+QList<int> DatabaseQueries::insertedMessageIds(QSqlDatabase db, const QList<Message>& messages, int feed_custom_id, int account_id) {
+	QStringList custom_ids;
+	QList<Message> url_messages;
+	QList<int> positions;
 
-			if (decoded) {
-				messages.append(message);
-			}
+	foreach (const Message& message, messages) {
+		if (message.m_customId.isEmpty()) {
+			positions.append(url_messages.size());
+			url_messages.append(message);
 		}
 
-		if (ok != nullptr) {
-			*ok = true;
+		else {
+			positions.append(custom_ids.size());
+			custom_ids.append(message.m_customId);
 		}
 	}
 
-	else {
-		if (ok != nullptr) {
-			*ok = false;
-		}
+	// Messages are looked up in the same way as when checking for existing messages.
+	// Rows inserted just now have the highest IDs among rows with their keys.
+	const QHash<int, ExistingMessage> existing_with_id = existingMessagesByCustomId(db, custom_ids, account_id);
+	const QHash<int, ExistingMessage> existing_with_url = existingMessagesByUrl(db, url_messages, feed_custom_id, account_id);
+	QList<int> ids;
+
+	for (int i = 0; i < messages.size(); i++) {
+		const QHash<int, ExistingMessage>& existing = messages.at(i).m_customId.isEmpty() ? existing_with_url : existing_with_id;
+
+		ids.append(existing.contains(positions.at(i)) ? existing.value(positions.at(i)).m_id : 0);
 	}
 
-	return messages;
+	return ids;
 }
 
 int DatabaseQueries::updateMessages(QSqlDatabase db,
@@ -431,51 +1109,50 @@ int DatabaseQueries::updateMessages(QSqlDatabase db,
                                     int account_id,
                                     const QString& url,
                                     bool* any_message_changed,
-                                    bool* ok) {
+                                    QPair<int, int>* inserted_counts) {
+	*any_message_changed = false;
+
+	if (inserted_counts != nullptr) {
+		*inserted_counts = QPair<int, int>(0, 0);
+	}
+
 	if (messages.isEmpty()) {
-		*any_message_changed = false;
-		*ok = true;
 		return 0;
 	}
 
-	bool use_transactions = qApp->settings()->value(GROUP(Database), SETTING(Database::UseTransactions)).toBool();
 	// Does not make any difference, since each feed now has
 	// its own "custom ID" (standard feeds have their custom ID equal to primary key ID).
 	int updated_messages = 0;
-	// Prepare queries.
-	QSqlQuery query_select_with_url(db);
-	QSqlQuery query_select_with_id(db);
 	QSqlQuery query_update(db);
-	QSqlQuery query_insert(db);
-	QSqlQuery query_begin_transaction(db);
-	// Here we have query which will check for existence of the "same" message in given feed.
-	// The two message are the "same" if:
-	//   1) they belong to the same feed AND,
-	//   2) they have same URL AND,
-	//   3) they have same AUTHOR.
-	query_select_with_url.setForwardOnly(true);
-	query_select_with_url.prepare("SELECT id, date_created, is_read, is_important, contents FROM Messages "
-	                              "WHERE feed = :feed AND title = :title AND url = :url AND author = :author AND account_id = :account_id;");
-	// When we have custom ID of the message, we can check directly for existence
-	// of that particular message.
-	query_select_with_id.setForwardOnly(true);
-	query_select_with_id.prepare("SELECT id, date_created, is_read, is_important, contents FROM Messages "
-	                             "WHERE custom_id = :custom_id AND account_id = :account_id;");
-	// Used to insert new messages.
-	query_insert.setForwardOnly(true);
-	query_insert.prepare("INSERT INTO Messages "
-	                     "(feed, title, is_read, is_important, url, author, date_created, contents, enclosures, custom_id, custom_hash, account_id) "
-	                     "VALUES (:feed, :title, :is_read, :is_important, :url, :author, :date_created, :contents, :enclosures, :custom_id, :custom_hash, :account_id);");
 	// Used to update existing messages.
 	query_update.setForwardOnly(true);
 	query_update.prepare("UPDATE Messages "
 	                     "SET title = :title, is_read = :is_read, is_important = :is_important, url = :url, author = :author, date_created = :date_created, contents = :contents, enclosures = :enclosures "
 	                     "WHERE id = :id;");
-
-	if (use_transactions && !query_begin_transaction.exec(qApp->database()->obtainBeginTransactionSql())) {
-		qCritical("Transaction start for message downloader failed: '%s'.", qPrintable(query_begin_transaction.lastError().text()));
-		return updated_messages;
-	}
+	QSqlQuery query_update_flags(db);
+	// Used to update only read/starred states of existing messages.
+	query_update_flags.setForwardOnly(true);
+	query_update_flags.prepare(QSL("UPDATE Messages SET is_read = :is_read, is_important = :is_important WHERE id = :id;"));
+
+	// Messages are processed in these steps:
+	//   1) all messages are normalized and split according to the way we recognize them,
+	//   2) existing messages are looked up with few bulk queries,
+	//   3) new messages are inserted with multi-row statements, changed messages are updated.
+	//
+	// The two message are the "same" if:
+	//   a) they have same custom ID (messages from TT-RSS or ownCloud News) OR,
+	//   b) they belong to the same feed AND have same TITLE, URL and AUTHOR (messages from standard account).
+	//
+	// Messages without custom ID which are known to be stored unchanged are skipped
+	// right away with help of fingerprint cache, so no queries are run for them.
+	MessageFingerprintCache* fingerprints = qApp->database()->fingerprintCache();
+	QList<Message> normalized_messages;
+	QStringList custom_ids;
+	QList<Message> url_messages;
+	QList<int> positions;
+	QSet<QString> seen_keys;
+	int skipped_messages = 0;
+	int duplicate_messages = 0;
 
 	foreach (Message message, messages) {
 		// Check if messages contain relative URLs and if they do, then replace them.
@@ -493,69 +1170,94 @@ int DatabaseQueries::updateMessages(QSqlDatabase db,
 			message.m_url = new_message_url;
 		}
 
-		int id_existing_message = -1;
-		qint64 date_existing_message;
-		bool is_read_existing_message;
-		bool is_important_existing_message;
-		QString contents_existing_message;
+		const QString key = message.m_customId.isEmpty() ?
+		                    messageUrlKey(message.m_title, message.m_url, message.m_author) :
+		                    QL1C('\0') + message.m_customId;
+
+		// Feed might contain the same message more than once, we
+		// store only its first occurrence.
+		if (seen_keys.contains(key)) {
+			qDebug("Message '%s' occurs more than once in update of feed '%d', only its first occurrence is stored.",
+			       qPrintable(message.m_title), feed_custom_id);
+			duplicate_messages++;
+			continue;
+		}
+
+		seen_keys.insert(key);
 
 		if (message.m_customId.isEmpty()) {
-			// We need to recognize existing messages according URL & AUTHOR.
-			// NOTE: This particularly concerns messages from standard account.
-			query_select_with_url.bindValue(QSL(":feed"), feed_custom_id);
-			query_select_with_url.bindValue(QSL(":title"), message.m_title);
-			query_select_with_url.bindValue(QSL(":url"), message.m_url);
-			query_select_with_url.bindValue(QSL(":author"), message.m_author);
-			query_select_with_url.bindValue(QSL(":account_id"), account_id);
-
-			if (query_select_with_url.exec() && query_select_with_url.next()) {
-				id_existing_message = query_select_with_url.value(0).toInt();
-				date_existing_message = query_select_with_url.value(1).value<qint64>();
-				is_read_existing_message = query_select_with_url.value(2).toBool();
-				is_important_existing_message = query_select_with_url.value(3).toBool();
-				contents_existing_message = query_select_with_url.value(4).toString();
-			}
-
-			else if (query_select_with_url.lastError().isValid()) {
-				qWarning("Failed to check for existing message in DB via URL: '%s'.", qPrintable(query_select_with_url.lastError().text()));
+			if (fingerprints->isUnchanged(MessageFingerprintCache::messageKey(account_id, feed_custom_id, key),
+			                              message.m_created.toMSecsSinceEpoch(), message.m_contents, message.m_createdFromFeed)) {
+				skipped_messages++;
+				continue;
 			}
 
-			query_select_with_url.finish();
+			positions.append(url_messages.size());
+			url_messages.append(message);
 		}
 
 		else {
-			// We can recognize existing messages via their custom ID.
-			// NOTE: This concerns messages from custom accounts, like TT-RSS or ownCloud News.
-			query_select_with_id.bindValue(QSL(":account_id"), account_id);
-			query_select_with_id.bindValue(QSL(":custom_id"), message.m_customId);
-
-			if (query_select_with_id.exec() && query_select_with_id.next()) {
-				id_existing_message = query_select_with_id.value(0).toInt();
-				date_existing_message = query_select_with_id.value(1).value<qint64>();
-				is_read_existing_message = query_select_with_id.value(2).toBool();
-				is_important_existing_message = query_select_with_id.value(3).toBool();
-				contents_existing_message = query_select_with_id.value(4).toString();
-			}
+			positions.append(custom_ids.size());
+			custom_ids.append(message.m_customId);
+		}
 
-			else if (query_select_with_id.lastError().isValid()) {
-				qDebug("Failed to check for existing message in DB via ID: '%s'.", qPrintable(query_select_with_id.lastError().text()));
-			}
+		normalized_messages.append(message);
+	}
 
-			query_select_with_id.finish();
-		}
+	if (!url_messages.isEmpty() && db.driverName() != QSL(APP_DB_MYSQL_DRIVER)) {
+		// Hashes are used for lookup only where texts are compared exactly.
+		fillMissingUrlHashes(db, feed_custom_id, account_id);
+	}
+
+	// Existing messages are keyed by position of messages in lists they were looked up with.
+	const QHash<int, ExistingMessage> existing_with_id = existingMessagesByCustomId(db, custom_ids, account_id);
+	const QHash<int, ExistingMessage> existing_with_url = existingMessagesByUrl(db, url_messages, feed_custom_id, account_id);
+	QList<Message> messages_to_insert;
+	QList<Message> messages_to_reindex;
+	QList<int> ids_to_reindex;
+	bool fixup_custom_ids = false;
+
+	for (int i = 0; i < normalized_messages.size(); i++) {
+		const Message& message = normalized_messages.at(i);
+		const QHash<int, ExistingMessage>& existing_messages = message.m_customId.isEmpty() ? existing_with_url : existing_with_id;
+		const QHash<int, ExistingMessage>::const_iterator existing = existing_messages.constFind(positions.at(i));
 
 		// Now, check if this message is already in the DB.
-		if (id_existing_message >= 0) {
+		if (existing != existing_messages.constEnd()) {
+			bool stored_changed = false;
+
 			// Message is already in the DB.
 			//
 			// Now, we update it if at least one of next conditions is true:
 			//   1) Message has custom ID AND (its date OR read status OR starred status are changed).
 			//   2) Message has its date fetched from feed AND its date is different from date in DB and contents is changed.
-			if (/* 1 */ (!message.m_customId.isEmpty() && (message.m_created.toMSecsSinceEpoch() != date_existing_message
-			                                               || message.m_isRead != is_read_existing_message
-			                                               || message.m_isImportant != is_important_existing_message)) ||
-			            /* 2 */ (message.m_createdFromFeed && message.m_created.toMSecsSinceEpoch() != date_existing_message
-			                     && message.m_contents != contents_existing_message)) {
+			//
+			// Messages with custom ID which differ only in read/starred states get just these flags updated in place.
+			if (!message.m_customId.isEmpty() && message.m_created.toMSecsSinceEpoch() == existing->m_created) {
+				if (message.m_isRead != existing->m_isRead || message.m_isImportant != existing->m_isImportant) {
+					query_update_flags.bindValue(QSL(":is_read"), (int) message.m_isRead);
+					query_update_flags.bindValue(QSL(":is_important"), (int) message.m_isImportant);
+					query_update_flags.bindValue(QSL(":id"), existing->m_id);
+					*any_message_changed = true;
+
+					if (!query_update_flags.exec()) {
+						qWarning("Failed to update states of message in DB: '%s'.", qPrintable(query_update_flags.lastError().text()));
+					}
+
+					else if (!message.m_isRead && existing->m_isRead) {
+						// Message was marked unread by server, it counts as updated one.
+						updated_messages++;
+					}
+
+					query_update_flags.finish();
+				}
+			}
+
+			else if (/* 1 */ (!message.m_customId.isEmpty() && (message.m_created.toMSecsSinceEpoch() != existing->m_created
+			                                               || message.m_isRead != existing->m_isRead
+			                                               || message.m_isImportant != existing->m_isImportant)) ||
+			            /* 2 */ (message.m_createdFromFeed && message.m_created.toMSecsSinceEpoch() != existing->m_created
+			                     && message.m_contents != existing->m_contents)) {
 				// Message exists, it is changed, update it.
 				query_update.bindValue(QSL(":title"), message.m_title);
 				query_update.bindValue(QSL(":is_read"), (int) message.m_isRead);
@@ -565,77 +1267,278 @@ int DatabaseQueries::updateMessages(QSqlDatabase db,
 				query_update.bindValue(QSL(":date_created"), message.m_created.toMSecsSinceEpoch());
 				query_update.bindValue(QSL(":contents"), message.m_contents);
 				query_update.bindValue(QSL(":enclosures"), Enclosures::encodeEnclosuresToString(message.m_enclosures));
-				query_update.bindValue(QSL(":id"), id_existing_message);
+				query_update.bindValue(QSL(":id"), existing->m_id);
 				*any_message_changed = true;
 
-				if (query_update.exec() && !message.m_isRead) {
-					updated_messages++;
+				if (query_update.exec()) {
+					stored_changed = true;
+					ids_to_reindex.append(existing->m_id);
+					messages_to_reindex.append(message);
+
+					if (!message.m_isRead) {
+						updated_messages++;
+					}
 				}
 
-				else if (query_update.lastError().isValid()) {
+				else {
 					qWarning("Failed to update message in DB: '%s'.", qPrintable(query_update.lastError().text()));
 				}
 
 				query_update.finish();
 				qDebug("Updating message '%s' in DB.", qPrintable(message.m_title));
 			}
+
+			if (message.m_customId.isEmpty()) {
+				// Remember state of the message as it is now stored in DB.
+				const quint64 fingerprint_key = MessageFingerprintCache::messageKey(account_id, feed_custom_id,
+				                                                                    messageUrlKey(message.m_title,
+				                                                                                  message.m_url,
+				                                                                                  message.m_author));
+
+				if (stored_changed) {
+					fingerprints->insert(fingerprint_key, message.m_created.toMSecsSinceEpoch(), message.m_contents);
+				}
+
+				else {
+					fingerprints->insert(fingerprint_key, existing->m_created, existing->m_contents);
+				}
+			}
 		}
 
 		else {
 			// Message with this URL is not fetched in this feed yet.
-			query_insert.bindValue(QSL(":feed"), feed_custom_id);
-			query_insert.bindValue(QSL(":title"), message.m_title);
-			query_insert.bindValue(QSL(":is_read"), (int) message.m_isRead);
-			query_insert.bindValue(QSL(":is_important"), (int) message.m_isImportant);
-			query_insert.bindValue(QSL(":url"), message.m_url);
-			query_insert.bindValue(QSL(":author"), message.m_author);
-			query_insert.bindValue(QSL(":date_created"), message.m_created.toMSecsSinceEpoch());
-			query_insert.bindValue(QSL(":contents"), message.m_contents);
-			query_insert.bindValue(QSL(":enclosures"), Enclosures::encodeEnclosuresToString(message.m_enclosures));
-			query_insert.bindValue(QSL(":custom_id"), message.m_customId);
-			query_insert.bindValue(QSL(":custom_hash"), message.m_customHash);
-			query_insert.bindValue(QSL(":account_id"), account_id);
-
-			if (query_insert.exec() && query_insert.numRowsAffected() == 1) {
-				updated_messages++;
-				qDebug("Added new message '%s' to DB.", qPrintable(message.m_title));
-			}
+			fixup_custom_ids |= message.m_customId.isEmpty();
+			messages_to_insert.append(message);
+		}
+	}
 
-			else if (query_insert.lastError().isValid()) {
-				qWarning("Failed to insert message to DB: '%s' - message title is '%s'.",
-				         qPrintable(query_insert.lastError().text()),
-				         qPrintable(message.m_title));
-			}
+	if (!ids_to_reindex.isEmpty() && qApp->database()->isSearchIndexAvailable()) {
+		indexMessages(db, ids_to_reindex, messages_to_reindex);
+	}
 
-			query_insert.finish();
+	int inserted_unread = 0;
+	const int inserted_total = insertMessages(db, messages_to_insert, feed_custom_id, account_id, &inserted_unread);
+
+	updated_messages += inserted_total;
+
+	if (inserted_total == messages_to_insert.size()) {
+		foreach (const Message& message, messages_to_insert) {
+			if (message.m_customId.isEmpty()) {
+				fingerprints->insert(MessageFingerprintCache::messageKey(account_id, feed_custom_id,
+				                                                         messageUrlKey(message.m_title, message.m_url, message.m_author)),
+				                     message.m_created.toMSecsSinceEpoch(), message.m_contents);
+			}
 		}
 	}
 
+	if (duplicate_messages > 0) {
+		qDebug("Skipped %d duplicate messages of feed '%d'.", duplicate_messages, feed_custom_id);
+	}
+
+	if (skipped_messages > 0) {
+		qDebug("Skipped %d unchanged messages of feed '%d', fingerprint cache hit rate is %.1f %%.",
+		       skipped_messages, feed_custom_id, fingerprints->hitRate());
+	}
+
+	if (inserted_counts != nullptr) {
+		*inserted_counts = QPair<int, int>(inserted_unread, inserted_total);
+	}
+
 	// Now, fixup custom IDS for messages which initially did not have them,
-	// just to keep the data consistent.
-	if (db.exec("UPDATE Messages "
-	            "SET custom_id = id "
-	            "WHERE custom_id IS NULL OR custom_id = '';").lastError().isValid()) {
-		qWarning("Failed to set custom ID for all messages: '%s'.", qPrintable(db.lastError().text()));
+	// just to keep the data consistent. Only messages just inserted into this feed can lack them.
+	if (fixup_custom_ids) {
+		QSqlQuery query_fixup(db);
+		query_fixup.setForwardOnly(true);
+		query_fixup.prepare(QSL("UPDATE Messages "
+		                        "SET custom_id = id "
+		                        "WHERE feed = :feed AND account_id = :account_id AND (custom_id IS NULL OR custom_id = '');"));
+		query_fixup.bindValue(QSL(":feed"), feed_custom_id);
+		query_fixup.bindValue(QSL(":account_id"), account_id);
+
+		if (!query_fixup.exec()) {
+			qWarning("Failed to set custom ID for new messages: '%s'.", qPrintable(query_fixup.lastError().text()));
+		}
 	}
 
-	if (use_transactions && !db.commit()) {
-		qCritical("Transaction commit for message downloader failed: '%s'.", qPrintable(db.lastError().text()));
-		db.rollback();
+	return updated_messages;
+}
 
-		if (ok != nullptr) {
-			*ok = false;
-			updated_messages = 0;
+QString DatabaseQueries::searchIndexInsertStatement(QSqlDatabase db) {
+	if (db.driverName() == QSL(APP_DB_MYSQL_DRIVER)) {
+		return QSL("REPLACE INTO MessagesSearch (id, title, author, contents) VALUES (?, ?, ?, ?);");
+	}
+
+	else {
+		return QSL("INSERT OR REPLACE INTO MessagesSearch (rowid, title, author, contents) VALUES (?, ?, ?, ?);");
+	}
+}
+
+void DatabaseQueries::indexMessages(QSqlDatabase db, const QList<int>& ids, const QList<Message>& messages) {
+	QSqlQuery q(db);
+	q.setForwardOnly(true);
+	q.prepare(searchIndexInsertStatement(db));
+
+	for (int i = 0; i < messages.size(); i++) {
+		const Message& message = messages.at(i);
+
+		q.addBindValue(ids.at(i));
+		q.addBindValue(message.m_title);
+		q.addBindValue(message.m_author);
+		q.addBindValue(WebFactory::instance()->stripTags(message.m_contents));
+
+		if (!q.exec()) {
+			qWarning("Failed to add message '%d' to search index: '%s'.", ids.at(i), qPrintable(q.lastError().text()));
 		}
 	}
+}
+
+bool DatabaseQueries::initializeSearchIndex(QSqlDatabase db, bool* created) {
+	const bool is_mysql = db.driverName() == QSL(APP_DB_MYSQL_DRIVER);
+	QSqlQuery q(db);
+	q.setForwardOnly(true);
+	*created = false;
+
+	if (is_mysql) {
+		q.exec(QSL("SHOW TABLES LIKE 'MessagesSearch';"));
+	}
 
 	else {
-		if (ok != nullptr) {
-			*ok = true;
+		q.exec(QSL("SELECT name FROM sqlite_master WHERE type = 'table' AND name = 'MessagesSearch';"));
+	}
+
+	if (q.next()) {
+		// Index exists already.
+		return true;
+	}
+
+	q.finish();
+
+	// Index holds plain text of messages and IDs of messages are used
+	// as its row IDs. Messages are added to index when they are stored,
+	// removed messages are dropped from index by trigger.
+	if (is_mysql) {
+		if (!q.exec(QSL("CREATE TABLE MessagesSearch ("
+		                "id INTEGER PRIMARY KEY, title TEXT, author TEXT, contents TEXT, "
+		                "FULLTEXT INDEX idx_MessagesSearch (title, author, contents)) ENGINE = InnoDB;"))) {
+			qWarning("Full-text search index cannot be created: '%s'.", qPrintable(q.lastError().text()));
+			return false;
+		}
+
+		if (!q.exec(QSL("CREATE TRIGGER MessagesSearchDelete AFTER DELETE ON Messages FOR EACH ROW "
+		                "DELETE FROM MessagesSearch WHERE id = OLD.id;"))) {
+			qWarning("Trigger of full-text search index cannot be created: '%s'.", qPrintable(q.lastError().text()));
 		}
 	}
 
-	return updated_messages;
+	else {
+		if (!q.exec(QSL("CREATE VIRTUAL TABLE MessagesSearch USING fts5 "
+		                "(title, author, contents, tokenize = 'unicode61 remove_diacritics 1');"))) {
+			qWarning("Full-text search index cannot be created: '%s'.", qPrintable(q.lastError().text()));
+			return false;
+		}
+
+		if (!q.exec(QSL("CREATE TRIGGER IF NOT EXISTS MessagesSearchDelete AFTER DELETE ON Messages "
+		                "BEGIN DELETE FROM MessagesSearch WHERE rowid = old.id; END;"))) {
+			qWarning("Trigger of full-text search index cannot be created: '%s'.", qPrintable(q.lastError().text()));
+		}
+	}
+
+	*created = true;
+	return true;
+}
+
+int DatabaseQueries::getSearchIndexPosition(QSqlDatabase db) {
+	QSqlQuery q(db);
+	q.setForwardOnly(true);
+
+	if (q.exec(QSL("SELECT inf_value FROM Information WHERE inf_key = 'search_index_position';")) && q.next()) {
+		return q.value(0).toInt();
+	}
+
+	else {
+		return -1;
+	}
+}
+
+bool DatabaseQueries::storeSearchIndexPosition(QSqlDatabase db, int position) {
+	QSqlQuery q(db);
+	q.setForwardOnly(true);
+
+	if (!q.exec(QSL("DELETE FROM Information WHERE inf_key = 'search_index_position';"))) {
+		return false;
+	}
+
+	else if (position < 0) {
+		// Index is complete.
+		return true;
+	}
+
+	q.prepare(QSL("INSERT INTO Information (inf_key, inf_value) VALUES ('search_index_position', :position);"));
+	q.bindValue(QSL(":position"), QString::number(position));
+	return q.exec();
+}
+
+bool DatabaseQueries::fillSearchIndex(QSqlDatabase db, int* position) {
+	QSqlQuery q(db);
+	QSqlQuery q_index(db);
+	int indexed_messages = 0;
+	int fetched_messages = 0;
+	int last_id = *position;
+
+	q.setForwardOnly(true);
+	q_index.setForwardOnly(true);
+	q_index.prepare(searchIndexInsertStatement(db));
+	q.prepare(QString("SELECT id, title, author, contents FROM Messages WHERE id > :position AND is_pdeleted = 0 "
+	                  "ORDER BY id LIMIT %1;").arg(MSG_SEARCH_INDEX_FILL_CHUNK_SIZE));
+	q.bindValue(QSL(":position"), *position);
+
+	if (!q.exec()) {
+		qWarning("Failed to obtain messages for search index: '%s'.", qPrintable(q.lastError().text()));
+		return false;
+	}
+
+	db.transaction();
+
+	while (q.next()) {
+		last_id = q.value(0).toInt();
+		fetched_messages++;
+		q_index.addBindValue(last_id);
+		q_index.addBindValue(q.value(1).toString());
+		q_index.addBindValue(q.value(2).toString());
+		q_index.addBindValue(WebFactory::instance()->stripTags(q.value(3).toString()));
+
+		if (q_index.exec()) {
+			indexed_messages++;
+		}
+	}
+
+	// Messages stored meanwhile have higher IDs, so they are either
+	// indexed when they are stored or they are added by next chunk.
+	const int new_position = fetched_messages < MSG_SEARCH_INDEX_FILL_CHUNK_SIZE ? -1 : last_id;
+
+	if (!storeSearchIndexPosition(db, new_position) || !db.commit()) {
+		qWarning("Failed to commit search index: '%s'.", qPrintable(db.lastError().text()));
+		db.rollback();
+		return false;
+	}
+
+	*position = new_position;
+	qDebug("Added %d messages to search index.", indexed_messages);
+	return true;
+}
+
+int DatabaseQueries::getSearchIndexMinWordLength(QSqlDatabase db) {
+	QSqlQuery q(db);
+	q.setForwardOnly(true);
+
+	// Index is stored in InnoDB table, which ignores shorter words.
+	if (q.exec(QSL("SELECT @@innodb_ft_min_token_size;")) && q.next()) {
+		return q.value(0).toInt();
+	}
+
+	else {
+		return 0;
+	}
 }
 
 bool DatabaseQueries::purgeMessagesFromBin(QSqlDatabase db, bool clear_only_read, int account_id) {
@@ -677,6 +1580,7 @@ bool DatabaseQueries::deleteAccount(QSqlDatabase db, int account_id) {
 		}
 	}
 
+	qApp->database()->fingerprintCache()->clear();
 	return true;
 }
 
@@ -689,6 +1593,7 @@ bool DatabaseQueries::deleteAccountData(QSqlDatabase db, int account_id, bool de
 		q.prepare(QSL("DELETE FROM Messages WHERE account_id = :account_id;"));
 		q.bindValue(QSL(":account_id"), account_id);
 		result &= q.exec();
+		qApp->database()->fingerprintCache()->clear();
 	}
 
 	q.prepare(QSL("DELETE FROM Feeds WHERE account_id = :account_id;"));
@@ -742,6 +1647,7 @@ bool DatabaseQueries::purgeLeftoverMessages(QSqlDatabase db, int account_id) {
 	}
 
 	else {
+		qApp->database()->fingerprintCache()->clear();
 		return true;
 	}
 }
@@ -877,6 +1783,7 @@ QList<ServiceRoot*> DatabaseQueries::getOwnCloudAccounts(QSqlDatabase db, bool*
 			root->network()->setAuthPassword(TextFactory::decrypt(query.value(2).toString()));
 			root->network()->setUrl(query.value(3).toString());
 			root->network()->setForceServerSideUpdate(query.value(4).toBool());
+			root->setLastModified(query.value(5).toLongLong());
 			root->updateTitle();
 			roots.append(root);
 		}
@@ -913,6 +1820,7 @@ QList<ServiceRoot*> DatabaseQueries::getTtRssAccounts(QSqlDatabase db, bool* ok)
 			root->network()->setAuthPassword(TextFactory::decrypt(query.value(5).toString()));
 			root->network()->setUrl(query.value(6).toString());
 			root->network()->setForceServerSideUpdate(query.value(7).toBool());
+			root->setLastHeadlineId(query.value(8).toInt());
 			root->updateTitle();
 			roots.append(root);
 		}
@@ -985,6 +1893,22 @@ bool DatabaseQueries::createOwnCloudAccount(QSqlDatabase db, int id_to_assign, c
 	}
 }
 
+bool DatabaseQueries::storeOwnCloudLastModified(QSqlDatabase db, qint64 last_modified, int account_id) {
+	QSqlQuery q(db);
+	q.prepare(QSL("UPDATE OwnCloudAccounts SET last_modified = :last_modified WHERE id = :id;"));
+	q.bindValue(QSL(":last_modified"), last_modified);
+	q.bindValue(QSL(":id"), account_id);
+
+	if (q.exec()) {
+		return true;
+	}
+
+	else {
+		qWarning("ownCloud: Storing of last modification time failed: '%s'.", qPrintable(q.lastError().text()));
+		return false;
+	}
+}
+
 int DatabaseQueries::createAccount(QSqlDatabase db, const QString& code, bool* ok) {
 	QSqlQuery q(db);
 
@@ -1093,6 +2017,7 @@ bool DatabaseQueries::deleteFeed(QSqlDatabase db, int feed_custom_id, int accoun
 		return false;
 	}
 
+	qApp->database()->fingerprintCache()->clear();
 	// Remove feed itself.
 	q.prepare(QSL("DELETE FROM Feeds WHERE custom_id = :feed AND account_id = :account_id;"));
 	q.bindValue(QSL(":feed"), feed_custom_id);
@@ -1234,7 +2159,8 @@ bool DatabaseQueries::editFeed(QSqlDatabase db, int parent_id, int feed_id, cons
 	QSqlQuery q(db);
 	q.setForwardOnly(true);
 	q.prepare("UPDATE Feeds "
-	          "SET title = :title, description = :description, icon = :icon, category = :category, encoding = :encoding, url = :url, protected = :protected, username = :username, password = :password, update_type = :update_type, update_interval = :update_interval, type = :type "
+	          "SET title = :title, description = :description, icon = :icon, category = :category, encoding = :encoding, url = :url, protected = :protected, username = :username, password = :password, update_type = :update_type, update_interval = :update_interval, type = :type, "
+	          "http_etag = NULL, http_last_mod = NULL "
 	          "WHERE id = :id;");
 	q.bindValue(QSL(":title"), title);
 	q.bindValue(QSL(":description"), description);
@@ -1260,6 +2186,19 @@ bool DatabaseQueries::editFeed(QSqlDatabase db, int parent_id, int feed_id, cons
 	return q.exec();
 }
 
+bool DatabaseQueries::editFeedHttpValidators(QSqlDatabase db, int feed_id, const QString& http_etag,
+                                             const QString& http_last_modified) {
+	QSqlQuery q(db);
+	q.setForwardOnly(true);
+	q.prepare("UPDATE Feeds "
+	          "SET http_etag = :http_etag, http_last_mod = :http_last_mod "
+	          "WHERE id = :id;");
+	q.bindValue(QSL(":http_etag"), http_etag);
+	q.bindValue(QSL(":http_last_mod"), http_last_modified);
+	q.bindValue(QSL(":id"), feed_id);
+	return q.exec();
+}
+
 bool DatabaseQueries::editBaseFeed(QSqlDatabase db, int feed_id, Feed::AutoUpdateType auto_update_type,
                                    int auto_update_interval) {
 	QSqlQuery q(db);
@@ -1273,6 +2212,30 @@ bool DatabaseQueries::editBaseFeed(QSqlDatabase db, int feed_id, Feed::AutoUpdat
 	return q.exec();
 }
 
+bool DatabaseQueries::storeFeedsAutoUpdateDeadlines(QSqlDatabase db, const QList<Feed*>& feeds) {
+	QSqlQuery q(db);
+	q.setForwardOnly(true);
+	q.prepare(QSL("UPDATE Feeds SET update_deadline = :update_deadline WHERE id = :id;"));
+	db.transaction();
+
+	foreach (const Feed* feed, feeds) {
+		q.bindValue(QSL(":update_deadline"), feed->autoUpdateDeadline() > 0 ? QVariant(feed->autoUpdateDeadline()) : QVariant());
+		q.bindValue(QSL(":id"), feed->id());
+
+		if (!q.exec()) {
+			qWarning("Failed to store auto-update deadline of feed with id %d: '%s'.", feed->id(), qPrintable(q.lastError().text()));
+		}
+	}
+
+	if (!db.commit()) {
+		qWarning("Failed to commit auto-update deadlines of feeds: '%s'.", qPrintable(db.lastError().text()));
+		db.rollback();
+		return false;
+	}
+
+	return true;
+}
+
 QList<ServiceRoot*> DatabaseQueries::getAccounts(QSqlDatabase db, bool* ok) {
 	QSqlQuery q(db);
 	QList<ServiceRoot*> roots;
@@ -1442,6 +2405,22 @@ bool DatabaseQueries::createTtRssAccount(QSqlDatabase db, int id_to_assign, cons
 	}
 }
 
+bool DatabaseQueries::storeTtRssLastHeadlineId(QSqlDatabase db, int last_headline_id, int account_id) {
+	QSqlQuery q(db);
+	q.prepare(QSL("UPDATE TtRssAccounts SET last_headline_id = :last_headline_id WHERE id = :id;"));
+	q.bindValue(QSL(":last_headline_id"), last_headline_id);
+	q.bindValue(QSL(":id"), account_id);
+
+	if (q.exec()) {
+		return true;
+	}
+
+	else {
+		qWarning("TT-RSS: Storing of ID of last headline failed: '%s'.", qPrintable(q.lastError().text()));
+		return false;
+	}
+}
+
 Assignment DatabaseQueries::getTtRssCategories(QSqlDatabase db, int account_id, bool* ok) {
 	Assignment categories;
 	// Obtain data for categories from the database.
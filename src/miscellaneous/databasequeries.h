@@ -24,19 +24,26 @@
 #include "services/standard/standardfeed.h"
 
 #include <QSqlQuery>
+#include <QHash>
+#include <QSet>
 
 
 class DatabaseQueries {
 	public:
-		// Mark read/unread/starred/delete messages.
-		static bool markMessagesReadUnread(QSqlDatabase db, const QStringList& ids, RootItem::ReadStatus read);
+		// Mark read/unread/starred/delete messages. If "changed_counts" are given, numbers of really
+		// changed messages are returned via them. They are keyed by custom IDs of feeds and hold numbers
+		// of changed messages, which were unread before the change, and of all changed messages.
+		static bool markMessagesReadUnread(QSqlDatabase db, const QStringList& ids, RootItem::ReadStatus read,
+		                                   QMap<int, QPair<int, int>>* changed_counts = nullptr);
 		static bool markMessageImportant(QSqlDatabase db, int id, RootItem::Importance importance);
 		static bool markFeedsReadUnread(QSqlDatabase db, const QStringList& ids, int account_id, RootItem::ReadStatus read);
 		static bool markBinReadUnread(QSqlDatabase db, int account_id, RootItem::ReadStatus read);
 		static bool markAccountReadUnread(QSqlDatabase db, int account_id, RootItem::ReadStatus read);
 		static bool switchMessagesImportance(QSqlDatabase db, const QStringList& ids);
-		static bool permanentlyDeleteMessages(QSqlDatabase db, const QStringList& ids);
-		static bool deleteOrRestoreMessagesToFromBin(QSqlDatabase db, const QStringList& ids, bool deleted);
+		static bool permanentlyDeleteMessages(QSqlDatabase db, const QStringList& ids,
+		                                      QMap<int, QPair<int, int>>* changed_counts = nullptr);
+		static bool deleteOrRestoreMessagesToFromBin(QSqlDatabase db, const QStringList& ids, bool deleted,
+		                                             QMap<int, QPair<int, int>>* changed_counts = nullptr);
 		static bool restoreBin(QSqlDatabase db, int account_id);
 
 		// Purge database.
@@ -52,11 +59,37 @@ class DatabaseQueries {
 		                               bool including_total_counts, bool* ok = nullptr);
 		static QMap<int, QPair<int, int>> getMessageCountsForAccount(QSqlDatabase db, int account_id,
 		                               bool including_total_counts, bool* ok = nullptr);
+
+		// Obtains unread/all counts of given feeds with single grouped query.
+		// Feeds without any messages are not present in the result.
+		static QMap<int, QPair<int, int>> getMessageCountsForFeeds(QSqlDatabase db, const QList<int>& feed_custom_ids,
+		                               int account_id, bool* ok = nullptr);
 		static int getMessageCountsForFeed(QSqlDatabase db, int feed_custom_id, int account_id,
 		                                   bool including_total_counts, bool* ok = nullptr);
 		static int getMessageCountsForBin(QSqlDatabase db, int account_id, bool including_total_counts, bool* ok = nullptr);
 
+		// Estimates average interval (in milliseconds) between publishing of recent messages
+		// of the feed, time elapsed since the newest message is included. Returns zero if
+		// feed has no messages.
+		static qint64 getPublishingIntervalForFeed(QSqlDatabase db, int feed_custom_id, int account_id, bool* ok = nullptr);
+
+		// Returns true if at least one message of the feed is stored, including deleted ones.
+		static bool hasFeedAnyMessages(QSqlDatabase db, int feed_custom_id, int account_id, bool* ok = nullptr);
+
+		// Returns numbers of unread messages of particular feeds of the account and number of its
+		// starred messages via "starred_count", so that they can be compared with the server.
+		static QMap<int, int> getStateCountsForSynchronization(QSqlDatabase db, int account_id, int* starred_count,
+		                                                       bool* ok = nullptr);
+
+		// Sets read and starred states of stored messages of the feed according to given numeric
+		// custom IDs of unread and starred messages, null set leaves its state untouched.
+		// Returns number of changed messages.
+		static int synchronizeMessageStates(QSqlDatabase db, int feed_custom_id, int account_id,
+		                                    const QSet<int>* unread_custom_ids, const QSet<int>* starred_custom_ids,
+		                                    bool* ok = nullptr);
+
 		// Get messages (for newspaper view for example).
+		static QString getMessageContents(QSqlDatabase db, int message_id, bool* ok = nullptr);
 		static QList<Message> getUndeletedMessagesForFeed(QSqlDatabase db, int feed_custom_id, int account_id, bool* ok = nullptr);
 		static QList<Message> getUndeletedMessagesForBin(QSqlDatabase db, int account_id, bool* ok = nullptr);
 		static QList<Message> getUndeletedMessagesForAccount(QSqlDatabase db, int account_id, bool* ok = nullptr);
@@ -67,9 +100,28 @@ class DatabaseQueries {
 		static QStringList customIdsOfMessagesFromFeed(QSqlDatabase db, int feed_custom_id, int account_id, bool* ok = nullptr);
 
 		// Common accounts methods.
+		// NOTE: Caller is responsible for wrapping the update in transaction.
+		// Counts (unread, total) of newly inserted messages are stored into "inserted_counts",
+		// "any_message_changed" is set if some already existing message was changed.
 		static int updateMessages(QSqlDatabase db, const QList<Message>& messages, int feed_custom_id,
-		                          int account_id, const QString& url, bool* any_message_changed, bool* ok = nullptr);
+		                          int account_id, const QString& url, bool* any_message_changed,
+		                          QPair<int, int>* inserted_counts = nullptr);
 		static bool deleteAccount(QSqlDatabase db, int account_id);
+
+		// Full-text search index of messages. Index is created if it does not exist yet,
+		// "created" is set if index was just created and is therefore empty.
+		// Returns false if database engine does not support full-text search.
+		static bool initializeSearchIndex(QSqlDatabase db, bool* created);
+
+		// Existing messages are added to new index in chunks, in order of their IDs. Position is
+		// ID of last added message, it is kept in DB so that filling continues after restart.
+		// Negative position means that index contains all messages.
+		static int getSearchIndexPosition(QSqlDatabase db);
+		static bool storeSearchIndexPosition(QSqlDatabase db, int position);
+		static bool fillSearchIndex(QSqlDatabase db, int* position);
+
+		// Returns minimal length of words stored in MySQL full-text index.
+		static int getSearchIndexMinWordLength(QSqlDatabase db);
 		static bool deleteAccountData(QSqlDatabase db, int account_id, bool delete_messages_too);
 		static bool cleanFeeds(QSqlDatabase db, const QStringList& ids, bool clean_read_only, int account_id);
 
@@ -77,6 +129,9 @@ class DatabaseQueries {
 		static bool editBaseFeed(QSqlDatabase db, int feed_id, Feed::AutoUpdateType auto_update_type,
 		                         int auto_update_interval);
 
+		// Stores deadlines of next auto-updates of given feeds.
+		static bool storeFeedsAutoUpdateDeadlines(QSqlDatabase db, const QList<Feed*>& feeds);
+
 		// ownCloud account.
 		static QList<ServiceRoot*> getOwnCloudAccounts(QSqlDatabase db, bool* ok = nullptr);
 		static bool deleteOwnCloudAccount(QSqlDatabase db, int account_id);
@@ -84,6 +139,7 @@ class DatabaseQueries {
 		                                     const QString& url, bool force_server_side_feed_update, int account_id);
 		static bool createOwnCloudAccount(QSqlDatabase db, int id_to_assign, const QString& username, const QString& password,
 		                                  const QString& url, bool force_server_side_feed_update);
+		static bool storeOwnCloudLastModified(QSqlDatabase db, qint64 last_modified, int account_id);
 		static int createAccount(QSqlDatabase db, const QString& code, bool* ok = nullptr);
 		static Assignment getOwnCloudCategories(QSqlDatabase db, int account_id, bool* ok = nullptr);
 		static Assignment getOwnCloudFeeds(QSqlDatabase db, int account_id, bool* ok = nullptr);
@@ -106,6 +162,8 @@ class DatabaseQueries {
 		                     const QString& encoding, const QString& url, bool is_protected,
 		                     const QString& username, const QString& password, Feed::AutoUpdateType auto_update_type,
 		                     int auto_update_interval, StandardFeed::Type feed_format);
+		static bool editFeedHttpValidators(QSqlDatabase db, int feed_id, const QString& http_etag,
+		                                   const QString& http_last_modified);
 		static QList<ServiceRoot*> getAccounts(QSqlDatabase db, bool* ok = nullptr);
 		static Assignment getCategories(QSqlDatabase db, int account_id, bool* ok = nullptr);
 		static Assignment getFeeds(QSqlDatabase db, int account_id, bool* ok = nullptr);
@@ -120,10 +178,43 @@ class DatabaseQueries {
 		                               const QString& password, bool auth_protected, const QString& auth_username,
 		                               const QString& auth_password, const QString& url,
 		                               bool force_server_side_feed_update);
+		static bool storeTtRssLastHeadlineId(QSqlDatabase db, int last_headline_id, int account_id);
 		static Assignment getTtRssCategories(QSqlDatabase db, int account_id, bool* ok = nullptr);
 		static Assignment getTtRssFeeds(QSqlDatabase db, int account_id, bool* ok = nullptr);
 
 	private:
+		// Sets "assignment" to given messages which match "condition", see markMessagesReadUnread().
+		static bool changeMessages(QSqlDatabase db, const QStringList& ids, const QString& assignment,
+		                           const QString& condition, QMap<int, QPair<int, int>>* changed_counts);
+
+		// State of message which is already stored in DB.
+		struct ExistingMessage {
+			int m_id;
+			qint64 m_created;
+			bool m_isRead;
+			bool m_isImportant;
+			QString m_contents;
+		};
+
+		// Helpers for bulk update of messages.
+		static QString messageUrlKey(const QString& title, const QString& url, const QString& author);
+		static qint64 messageUrlHash(const QString& title, const QString& url, const QString& author);
+		static QString bulkPlaceholders(int rows, int columns);
+		static QHash<int, ExistingMessage> existingMessagesByCustomId(QSqlDatabase db, const QStringList& custom_ids, int account_id);
+		static QHash<int, ExistingMessage> existingMessagesByUrl(QSqlDatabase db, const QList<Message>& messages,
+		                                                         int feed_custom_id, int account_id);
+		static void fillMissingUrlHashes(QSqlDatabase db, int feed_custom_id, int account_id);
+
+		// Sets given flag column of messages of the feed to "value" for listed
+		// custom IDs and to opposite value for others.
+		static int synchronizeMessageFlag(QSqlDatabase db, int feed_custom_id, int account_id, const QString& column,
+		                                  const QSet<int>& custom_ids, bool value, bool* ok);
+		static int insertMessages(QSqlDatabase db, const QList<Message>& messages, int feed_custom_id, int account_id,
+		                          int* inserted_unread);
+		static QList<int> insertedMessageIds(QSqlDatabase db, const QList<Message>& messages, int feed_custom_id, int account_id);
+		static void indexMessages(QSqlDatabase db, const QList<int>& ids, const QList<Message>& messages);
+		static QString searchIndexInsertStatement(QSqlDatabase db);
+
 		explicit DatabaseQueries();
 };
 
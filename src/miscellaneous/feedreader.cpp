@@ -30,23 +30,41 @@
 #include "miscellaneous/databasecleaner.h"
 #include "miscellaneous/application.h"
 #include "miscellaneous/mutex.h"
+#include "miscellaneous/databasequeries.h"
 
+#include <QDateTime>
 #include <QThread>
 #include <QTimer>
 #include <QtConcurrent/QtConcurrentRun>
 
+#include <algorithm>
+#include <random>
+
+
+static bool isLaterAutoUpdate(const QPair<qint64, QPointer<Feed>>& lhs, const QPair<qint64, QPointer<Feed>>& rhs) {
+	return lhs.first > rhs.first;
+}
+
+static qint64 randomAutoUpdateOffset(qint64 range) {
+	// Generator is seeded once per run, so that feeds are spread differently after each start.
+	static std::mt19937_64 generator((std::random_device())());
+	return range > 0 ? std::uniform_int_distribution<qint64>(0, range)(generator) : 0;
+}
 
 FeedReader::FeedReader(QObject* parent)
 	: QObject(parent), m_feedServices(QList<ServiceEntryPoint*>()),
 	  m_cacheSaveFutureWatcher(new QFutureWatcher<void>(this)), m_autoUpdateTimer(new QTimer(this)),
-	  m_feedDownloaderThread(nullptr), m_feedDownloader(nullptr),
+	  m_autoUpdateReschedulingRequested(false), m_settingAutoUpdateDeadline(false), m_feedDownloaderThread(nullptr), m_feedDownloader(nullptr),
 	  m_dbCleanerThread(nullptr), m_dbCleaner(nullptr) {
 	m_feedsModel = new FeedsModel(this);
 	m_feedsProxyModel = new FeedsProxyModel(m_feedsModel, this);
 	m_messagesModel = new MessagesModel(this);
 	m_messagesProxyModel = new MessagesProxyModel(m_messagesModel, this);
+	m_autoUpdateTimer->setSingleShot(true);
 	connect(m_cacheSaveFutureWatcher, &QFutureWatcher<void>::finished, this, &FeedReader::asyncCacheSaveFinished);
 	connect(m_autoUpdateTimer, &QTimer::timeout, this, &FeedReader::executeNextAutoUpdate);
+	connect(m_feedsModel, &FeedsModel::rowsInserted, this, &FeedReader::requestAutoUpdatesRescheduling);
+	connect(m_feedsModel, &FeedsModel::modelReset, this, &FeedReader::requestAutoUpdatesRescheduling);
 	updateAutoUpdateStatus();
 	asyncCacheSaveFinished();
 
@@ -102,34 +120,158 @@ void FeedReader::updateAutoUpdateStatus() {
 	// Restore global intervals.
 	// NOTE: Specific per-feed interval are left intact.
 	m_globalAutoUpdateInitialInterval = qApp->settings()->value(GROUP(Feeds), SETTING(Feeds::AutoUpdateInterval)).toInt();
-	m_globalAutoUpdateRemainingInterval = m_globalAutoUpdateInitialInterval;
 	m_globalAutoUpdateEnabled = qApp->settings()->value(GROUP(Feeds), SETTING(Feeds::AutoUpdateEnabled)).toBool();
+	m_adaptiveAutoUpdateMinInterval = qApp->settings()->value(GROUP(Feeds), SETTING(Feeds::AdaptiveUpdateMinInterval)).toInt();
+	m_adaptiveAutoUpdateMaxInterval = qMax(m_adaptiveAutoUpdateMinInterval,
+	                                       qApp->settings()->value(GROUP(Feeds), SETTING(Feeds::AdaptiveUpdateMaxInterval)).toInt());
 
-	// Start global auto-update timer if it is not running yet.
-	// NOTE: The timer must run even if global auto-update
+	// NOTE: Feeds must be scheduled even if global auto-update
 	// is not enabled because user can still enable auto-update
 	// for individual feeds.
-	if (!m_autoUpdateTimer->isActive()) {
-		m_autoUpdateTimer->setInterval(AUTO_UPDATE_INTERVAL);
-		m_autoUpdateTimer->start();
-		qDebug("Auto-update timer started with interval %d.", m_autoUpdateTimer->interval());
+	requestAutoUpdatesRescheduling();
+}
+
+bool FeedReader::autoUpdateEnabled() const {
+	return m_globalAutoUpdateEnabled;
+}
+
+int FeedReader::autoUpdateInitialInterval() const {
+	return m_globalAutoUpdateInitialInterval;
+}
+
+qint64 FeedReader::autoUpdateInterval(const Feed* feed) const {
+	switch (feed->autoUpdateType()) {
+		case Feed::DontAutoUpdate:
+			return 0;
+
+		case Feed::DefaultAutoUpdate:
+			return m_globalAutoUpdateEnabled ? qint64(m_globalAutoUpdateInitialInterval) * 60000 : 0;
+
+		case Feed::AdaptiveAutoUpdate:
+			return adaptiveAutoUpdateInterval(feed);
+
+		case Feed::SpecificAutoUpdate:
+		default:
+			return qint64(feed->autoUpdateInitialInterval()) * 60000;
+	}
+}
+
+qint64 FeedReader::adaptiveAutoUpdateInterval(const Feed* feed) const {
+	const qint64 min_interval = qint64(m_adaptiveAutoUpdateMinInterval) * 60000;
+	const qint64 max_interval = qint64(m_adaptiveAutoUpdateMaxInterval) * 60000;
+
+	// Feed is checked twice per its average publishing interval,
+	// but never sooner than its server allows.
+	qint64 interval = feed->publishingInterval() > 0 ? feed->publishingInterval() / 2 : min_interval;
+
+	interval = qBound(min_interval, qMax(interval, qint64(feed->autoUpdateServerHint()) * 1000), max_interval);
+
+	if (feed->autoUpdateErrors() > 0) {
+		// Failing feeds are checked less and less often.
+		interval = qMin(interval << qMin(feed->autoUpdateErrors(), ADAPTIVE_UPDATE_MAX_BACKOFF), max_interval);
+	}
+
+	return interval;
+}
+
+void FeedReader::scheduleAutoUpdate(Feed* feed) {
+	if (feed->autoUpdateType() == Feed::AdaptiveAutoUpdate) {
+		// Statistics are not persisted, they are computed
+		// from stored messages when they are needed first.
+		feed->loadAutoUpdateStatistics(qApp->database()->connection(metaObject()->className(), DatabaseFactory::FromSettings));
+	}
+
+	const qint64 interval = autoUpdateInterval(feed);
+
+	if (interval <= 0) {
+		// Feed is not auto-updated, its possible entries in queue are skipped later.
+		return;
+	}
+
+	const qint64 now = QDateTime::currentMSecsSinceEpoch();
+
+	if (!m_settingAutoUpdateDeadline &&
+	        (feed->autoUpdateDeadline() <= 0 || feed->autoUpdateDeadline() > now + interval + autoUpdateJitter(interval))) {
+		// Feed is scheduled for the first time or its interval was shortened. Random
+		// part of deadline spreads feeds which share the same interval.
+		// NOTE: Deadlines set by scheduler itself are queued as they are.
+		setAutoUpdateDeadline(feed, now + interval - randomAutoUpdateOffset(interval / 2));
 	}
 
 	else {
-		qDebug("Auto-update timer is already running.");
+		m_autoUpdateQueue.append(ScheduledAutoUpdate(feed->autoUpdateDeadline(), feed));
+		std::push_heap(m_autoUpdateQueue.begin(), m_autoUpdateQueue.end(), isLaterAutoUpdate);
+		startAutoUpdateTimer();
 	}
 }
 
-bool FeedReader::autoUpdateEnabled() const {
-	return m_globalAutoUpdateEnabled;
+void FeedReader::rescheduleAdaptiveAutoUpdate(Feed* feed) {
+	if (feed->autoUpdateType() == Feed::AdaptiveAutoUpdate) {
+		const qint64 interval = autoUpdateInterval(feed);
+		const qint64 jitter = autoUpdateJitter(interval);
+
+		setAutoUpdateDeadline(feed, QDateTime::currentMSecsSinceEpoch() + interval - jitter + randomAutoUpdateOffset(2 * jitter));
+	}
 }
 
-int FeedReader::autoUpdateRemainingInterval() const {
-	return m_globalAutoUpdateRemainingInterval;
+void FeedReader::setAutoUpdateDeadline(Feed* feed, qint64 deadline) {
+	m_settingAutoUpdateDeadline = true;
+	feed->setAutoUpdateDeadline(deadline);
+	m_settingAutoUpdateDeadline = false;
 }
 
-int FeedReader::autoUpdateInitialInterval() const {
-	return m_globalAutoUpdateInitialInterval;
+qint64 FeedReader::autoUpdateJitter(qint64 interval) const {
+	return interval * AUTO_UPDATE_JITTER_PERCENTAGE / 100;
+}
+
+void FeedReader::requestAutoUpdatesRescheduling() {
+	if (!m_autoUpdateReschedulingRequested) {
+		// Service accounts load their feeds after they are inserted into
+		// the model, so the queue is rebuilt once control returns to event loop.
+		m_autoUpdateReschedulingRequested = true;
+		QMetaObject::invokeMethod(this, "rescheduleAutoUpdates", Qt::QueuedConnection);
+	}
+}
+
+void FeedReader::rescheduleAutoUpdates() {
+	const qint64 now = QDateTime::currentMSecsSinceEpoch();
+
+	m_autoUpdateReschedulingRequested = false;
+	m_autoUpdateQueue.clear();
+
+	foreach (Feed* feed, m_feedsModel->rootItem()->getSubTreeFeeds()) {
+		connect(feed, &Feed::autoUpdateScheduleChanged, this, &FeedReader::scheduleAutoUpdate, Qt::UniqueConnection);
+		connect(feed, &Feed::autoUpdateStatisticsChanged, this, &FeedReader::rescheduleAdaptiveAutoUpdate, Qt::UniqueConnection);
+		const qint64 interval = autoUpdateInterval(feed);
+
+		if (interval > 0 && feed->autoUpdateDeadline() > 0 && feed->autoUpdateDeadline() < now) {
+			// Feeds whose deadline passed while application was not running
+			// are spread, so that they are not all updated at once.
+			setAutoUpdateDeadline(feed, now + randomAutoUpdateOffset(qMin(interval, qint64(AUTO_UPDATE_SPREAD_INTERVAL))));
+		}
+
+		else {
+			scheduleAutoUpdate(feed);
+		}
+	}
+
+	qDebug("Auto-update queue was rebuilt with %d feeds.", m_autoUpdateQueue.size());
+	startAutoUpdateTimer();
+}
+
+void FeedReader::startAutoUpdateTimer() {
+	if (m_autoUpdateQueue.isEmpty()) {
+		m_autoUpdateTimer->stop();
+		return;
+	}
+
+	const qint64 sleep = qBound(qint64(0),
+	                            m_autoUpdateQueue.first().first - QDateTime::currentMSecsSinceEpoch(),
+	                            qint64(AUTO_UPDATE_MAX_SLEEP));
+
+	if (!m_autoUpdateTimer->isActive() || m_autoUpdateTimer->remainingTime() > sleep) {
+		m_autoUpdateTimer->start(int(sleep));
+	}
 }
 
 void FeedReader::updateAllFeeds() {
@@ -177,22 +319,36 @@ void FeedReader::executeNextAutoUpdate() {
 	if (!qApp->feedUpdateLock()->tryLock()) {
 		qDebug("Delaying scheduled feed auto-updates for one minute due to another running update.");
 		// Cannot update, quit.
+		m_autoUpdateTimer->start(AUTO_UPDATE_INTERVAL);
 		return;
 	}
 
-	// If global auto-update is enabled and its interval counter reached zero,
-	// then we need to restore it.
-	if (m_globalAutoUpdateEnabled && --m_globalAutoUpdateRemainingInterval < 0) {
-		// We should start next auto-update interval.
-		m_globalAutoUpdateRemainingInterval = m_globalAutoUpdateInitialInterval;
+	const qint64 now = QDateTime::currentMSecsSinceEpoch();
+	QList<Feed*> feeds_for_update;
+
+	while (!m_autoUpdateQueue.isEmpty() && m_autoUpdateQueue.first().first <= now) {
+		std::pop_heap(m_autoUpdateQueue.begin(), m_autoUpdateQueue.end(), isLaterAutoUpdate);
+		const ScheduledAutoUpdate scheduled = m_autoUpdateQueue.takeLast();
+		Feed* feed = scheduled.second.data();
+
+		// Skip entries of removed feeds and entries which were replaced with newer deadline.
+		if (feed == nullptr || feed->autoUpdateDeadline() != scheduled.first) {
+			continue;
+		}
+
+		const qint64 interval = autoUpdateInterval(feed);
+
+		if (interval > 0) {
+			feeds_for_update.append(feed);
+			// Schedule next update, jitter keeps feeds with same interval apart.
+			const qint64 jitter = autoUpdateJitter(interval);
+			setAutoUpdateDeadline(feed, now + interval - jitter + randomAutoUpdateOffset(2 * jitter));
+		}
 	}
 
-	qDebug("Starting auto-update event, pass %d/%d.", m_globalAutoUpdateRemainingInterval, m_globalAutoUpdateInitialInterval);
-	// Pass needed interval data and lets the model decide which feeds
-	// should be updated in this pass.
-	QList<Feed*> feeds_for_update = m_feedsModel->feedsForScheduledUpdate(m_globalAutoUpdateEnabled &&
-	                                m_globalAutoUpdateRemainingInterval == 0);
+	qDebug("Starting auto-update event for %d feeds, %d feeds remain scheduled.", feeds_for_update.size(), m_autoUpdateQueue.size());
 	qApp->feedUpdateLock()->unlock();
+	startAutoUpdateTimer();
 
 	if (!feeds_for_update.isEmpty()) {
 		// Request update for given feeds.
@@ -260,11 +416,15 @@ void FeedReader::quit() {
 		m_autoUpdateTimer->stop();
 	}
 
+	// Deadlines are kept, so that feeds are not all updated right after next start.
+	DatabaseQueries::storeFeedsAutoUpdateDeadlines(qApp->database()->connection(metaObject()->className(), DatabaseFactory::FromSettings),
+	                                               m_feedsModel->rootItem()->getSubTreeFeeds());
 	checkServicesForAsyncOperations(true);
 
 	// Close worker threads.
 	if (m_feedDownloaderThread != nullptr && m_feedDownloaderThread->isRunning()) {
-		m_feedDownloader->stopRunningUpdate();
+		// Downloader lives in its own thread, so are its running downloads.
+		QMetaObject::invokeMethod(m_feedDownloader, "stopRunningUpdate", Qt::BlockingQueuedConnection);
 
 		if (m_feedDownloader->isUpdateRunning()) {
 			QEventLoop loop(this);
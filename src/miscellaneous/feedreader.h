@@ -24,6 +24,8 @@
 #include "core/feeddownloader.h"
 
 #include <QFutureWatcher>
+#include <QPointer>
+#include <QVector>
 
 
 class FeedsModel;
@@ -62,11 +64,10 @@ class FeedReader : public QObject {
 		bool isFeedUpdateRunning() const;
 
 		// Resets global auto-update intervals according to settings
-		// and starts/stop the timer as needed.
+		// and schedules auto-updates of all feeds again.
 		void updateAutoUpdateStatus();
 
 		bool autoUpdateEnabled() const;
-		int autoUpdateRemainingInterval() const;
 		int autoUpdateInitialInterval() const;
 
 	public slots:
@@ -76,8 +77,19 @@ class FeedReader : public QObject {
 		void quit();
 
 	private slots:
-		// Is executed when next auto-update round could be done.
+		// Is executed when deadline of the earliest scheduled auto-update passes.
 		void executeNextAutoUpdate();
+
+		// Puts feed into auto-update queue according to its deadline.
+		void scheduleAutoUpdate(Feed* feed);
+
+		// Moves next auto-update of adaptively updated feed
+		// according to its fresh statistics.
+		void rescheduleAdaptiveAutoUpdate(Feed* feed);
+
+		// Rebuilds auto-update queue from all feeds in the model.
+		void rescheduleAutoUpdates();
+		void requestAutoUpdatesRescheduling();
 		void checkServicesForAsyncOperations();
 		void checkServicesForAsyncOperations(bool wait_for_future);
 		void asyncCacheSaveFinished();
@@ -88,6 +100,24 @@ class FeedReader : public QObject {
 		void feedUpdatesProgress(const Feed* feed, int current, int total);
 
 	private:
+		typedef QPair<qint64, QPointer<Feed>> ScheduledAutoUpdate;
+
+		// Returns auto-update interval of the feed in milliseconds,
+		// zero if feed should not be auto-updated.
+		qint64 autoUpdateInterval(const Feed* feed) const;
+
+		// Returns auto-update interval of adaptively updated feed in milliseconds.
+		qint64 adaptiveAutoUpdateInterval(const Feed* feed) const;
+
+		// Sets auto-update timer to fire at the earliest deadline.
+		void startAutoUpdateTimer();
+
+		// Sets deadline computed by scheduler, the feed is queued with it as it is.
+		void setAutoUpdateDeadline(Feed* feed, qint64 deadline);
+
+		// Returns maximal random shift of deadlines of feeds with given interval.
+		qint64 autoUpdateJitter(qint64 interval) const;
+
 		QList<ServiceEntryPoint*> m_feedServices;
 
 		FeedsModel* m_feedsModel;
@@ -101,7 +131,14 @@ class FeedReader : public QObject {
 		QTimer* m_autoUpdateTimer;
 		bool m_globalAutoUpdateEnabled;
 		int m_globalAutoUpdateInitialInterval;
-		int m_globalAutoUpdateRemainingInterval;
+		int m_adaptiveAutoUpdateMinInterval;
+		int m_adaptiveAutoUpdateMaxInterval;
+
+		// Min-heap of scheduled auto-updates ordered by their deadlines. Entries
+		// whose deadline differs from current deadline of their feed are stale.
+		QVector<ScheduledAutoUpdate> m_autoUpdateQueue;
+		bool m_autoUpdateReschedulingRequested;
+		bool m_settingAutoUpdateDeadline;
 
 		ServiceOperator* m_serviceOperator;
 
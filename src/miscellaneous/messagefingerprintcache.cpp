@@ -0,0 +1,88 @@
+// This file is part of RSS Guard.
+//
+// Copyright (C) 2011-2017 by Martin Rotter <rotter.martinos@gmail.com>
+//
+// RSS Guard is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// RSS Guard is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with RSS Guard. If not, see <http://www.gnu.org/licenses/>.
+
+#include "miscellaneous/messagefingerprintcache.h"
+
+#include <QCryptographicHash>
+#include <QMutexLocker>
+#include <QtEndian>
+
+
+MessageFingerprintCache::MessageFingerprintCache(int max_entries)
+	: m_fingerprints(max_entries), m_hits(0), m_misses(0) {
+}
+
+MessageFingerprintCache::~MessageFingerprintCache() {
+}
+
+bool MessageFingerprintCache::isUnchanged(quint64 key, qint64 created, const QString& contents, bool created_from_feed) {
+	QMutexLocker locker(&m_mutex);
+	const Fingerprint* fingerprint = m_fingerprints.object(key);
+
+	// Same rules as in DatabaseQueries::updateMessages() apply here, stored message is
+	// updated only if its date is fetched from feed and both date and contents changed.
+	if (fingerprint != nullptr &&
+	        (!created_from_feed || fingerprint->m_created == created || fingerprint->m_contentsHash == contentsHash(contents))) {
+		m_hits++;
+		return true;
+	}
+
+	else {
+		m_misses++;
+		return false;
+	}
+}
+
+void MessageFingerprintCache::insert(quint64 key, qint64 created, const QString& contents) {
+	Fingerprint* fingerprint = new Fingerprint();
+	fingerprint->m_created = created;
+	fingerprint->m_contentsHash = contentsHash(contents);
+	QMutexLocker locker(&m_mutex);
+	m_fingerprints.insert(key, fingerprint);
+}
+
+void MessageFingerprintCache::clear() {
+	QMutexLocker locker(&m_mutex);
+	m_fingerprints.clear();
+}
+
+quint64 MessageFingerprintCache::hits() const {
+	QMutexLocker locker(&m_mutex);
+	return m_hits;
+}
+
+quint64 MessageFingerprintCache::misses() const {
+	QMutexLocker locker(&m_mutex);
+	return m_misses;
+}
+
+double MessageFingerprintCache::hitRate() const {
+	QMutexLocker locker(&m_mutex);
+	return m_hits + m_misses == 0 ? 0.0 : (100.0 * m_hits) / (m_hits + m_misses);
+}
+
+quint64 MessageFingerprintCache::messageKey(int account_id, int feed_custom_id, const QString& url_key) {
+	QCryptographicHash hash(QCryptographicHash::Md5);
+	hash.addData(QByteArray::number(account_id) + ':' + QByteArray::number(feed_custom_id) + ':');
+	hash.addData(url_key.toUtf8());
+	return qFromLittleEndian<quint64>(reinterpret_cast<const uchar*>(hash.result().constData()));
+}
+
+quint64 MessageFingerprintCache::contentsHash(const QString& contents) {
+	const QByteArray digest = QCryptographicHash::hash(contents.toUtf8(), QCryptographicHash::Md5);
+	return qFromLittleEndian<quint64>(reinterpret_cast<const uchar*>(digest.constData()));
+}
@@ -0,0 +1,70 @@
+// This file is part of RSS Guard.
+//
+// Copyright (C) 2011-2017 by Martin Rotter <rotter.martinos@gmail.com>
+//
+// RSS Guard is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// RSS Guard is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with RSS Guard. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef MESSAGEFINGERPRINTCACHE_H
+#define MESSAGEFINGERPRINTCACHE_H
+
+#include <QCache>
+#include <QMutex>
+
+
+// Remembers compact fingerprints of messages which are stored in DB,
+// so that messages which did not change since the last update of their
+// feed can be skipped before any SQL query is run. Entries of all feeds
+// share single LRU, which keeps memory usage bounded.
+// NOTE: This class is thread-safe.
+class MessageFingerprintCache {
+	public:
+		explicit MessageFingerprintCache(int max_entries);
+		virtual ~MessageFingerprintCache();
+
+		// Returns true if message with given key was stored in given
+		// feed with the same date or contents, thus it is unchanged.
+		bool isUnchanged(quint64 key, qint64 created, const QString& contents, bool created_from_feed);
+
+		// Remembers message state which was just read from or written to DB.
+		void insert(quint64 key, qint64 created, const QString& contents);
+
+		// Forgets everything, must be called whenever
+		// messages are physically removed from DB.
+		void clear();
+
+		quint64 hits() const;
+		quint64 misses() const;
+
+		// Returns ratio of skipped messages to all looked up
+		// messages in percents.
+		double hitRate() const;
+
+		// Calculates key of message unique within all feeds of all accounts.
+		static quint64 messageKey(int account_id, int feed_custom_id, const QString& url_key);
+
+	private:
+		struct Fingerprint {
+			qint64 m_created;
+			quint64 m_contentsHash;
+		};
+
+		static quint64 contentsHash(const QString& contents);
+
+		mutable QMutex m_mutex;
+		QCache<quint64, Fingerprint> m_fingerprints;
+		quint64 m_hits;
+		quint64 m_misses;
+};
+
+#endif // MESSAGEFINGERPRINTCACHE_H
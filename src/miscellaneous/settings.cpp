@@ -55,6 +55,21 @@ DVALUE(int) Feeds::AutoUpdateIntervalDef  = DEFAULT_AUTO_UPDATE_INTERVAL;
 DKEY Feeds::AutoUpdateEnabled             = "auto_update_enabled";
 DVALUE(bool) Feeds::AutoUpdateEnabledDef  = false;
 
+DKEY Feeds::AdaptiveUpdateMinInterval             = "adaptive_update_min_interval";
+DVALUE(int) Feeds::AdaptiveUpdateMinIntervalDef   = DEFAULT_AUTO_UPDATE_INTERVAL;
+
+DKEY Feeds::AdaptiveUpdateMaxInterval             = "adaptive_update_max_interval";
+DVALUE(int) Feeds::AdaptiveUpdateMaxIntervalDef   = DEFAULT_ADAPTIVE_UPDATE_MAX_INTERVAL;
+
+DKEY Feeds::MaxFeedSize                   = "max_feed_size";
+DVALUE(int) Feeds::MaxFeedSizeDef         = DEFAULT_FEED_MAX_SIZE;
+
+DKEY Feeds::MaxDownloads                  = "max_downloads";
+DVALUE(int) Feeds::MaxDownloadsDef        = FEED_DOWNLOADER_MAX_DOWNLOADS;
+
+DKEY Feeds::MaxHostDownloads              = "max_host_downloads";
+DVALUE(int) Feeds::MaxHostDownloadsDef    = FEED_DOWNLOADER_MAX_HOST_DOWNLOADS;
+
 DKEY Feeds::FeedsUpdateOnStartup            = "feeds_update_on_startup";
 DVALUE(bool) Feeds::FeedsUpdateOnStartupDef = false;
 
@@ -230,9 +245,6 @@ DVALUE(int) Proxy::PortDef          = 80;
 // Database.
 DKEY Database::ID                       = "database";
 
-DKEY Database::UseTransactions              = "use_transactions";
-DVALUE(bool) Database::UseTransactionsDef   = false;
-
 DKEY Database::UseInMemory              = "use_in_memory_db";
 DVALUE(bool) Database::UseInMemoryDef   = false;
 
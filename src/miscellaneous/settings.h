@@ -73,6 +73,21 @@ namespace Feeds {
 	KEY AutoUpdateEnabled;
 	VALUE(bool) AutoUpdateEnabledDef;
 
+	KEY AdaptiveUpdateMinInterval;
+	VALUE(int) AdaptiveUpdateMinIntervalDef;
+
+	KEY AdaptiveUpdateMaxInterval;
+	VALUE(int) AdaptiveUpdateMaxIntervalDef;
+
+	KEY MaxFeedSize;
+	VALUE(int) MaxFeedSizeDef;
+
+	KEY MaxDownloads;
+	VALUE(int) MaxDownloadsDef;
+
+	KEY MaxHostDownloads;
+	VALUE(int) MaxHostDownloadsDef;
+
 	KEY FeedsUpdateOnStartup;
 	VALUE(bool) FeedsUpdateOnStartupDef;
 
@@ -257,9 +272,6 @@ namespace Proxy {
 namespace Database {
 	KEY ID;
 
-	KEY UseTransactions;
-	VALUE(bool) UseTransactionsDef;
-
 	KEY UseInMemory;
 	VALUE(bool) UseInMemoryDef;
 
@@ -27,6 +27,7 @@
 #include <QStringList>
 #include <QLocale>
 #include <QDir>
+#include <QUrl>
 
 
 quint64 TextFactory::s_encryptionKey = 0x0;
@@ -55,20 +56,337 @@ int TextFactory::stringWidth(const QString& string, const QFontMetrics& metrics)
 }
 
 QDateTime TextFactory::parseDateTime(const QString& date_time) {
+	const QChar* begin = date_time.constData();
+	const QChar* end = begin + date_time.size();
+
+	// Trim white space without copying the input.
+	while (begin < end && begin->isSpace()) {
+		begin++;
+	}
+
+	while (end > begin && (end - 1)->isSpace()) {
+		end--;
+	}
+
+	if (begin == end) {
+		return QDateTime();
+	}
+
+	// Formats used by vast majority of feeds are recognized by
+	// hand-written tokenizers, other formats are matched against patterns.
+	QDateTime dt;
+
+	if (begin->isDigit() && end - begin >= 4 && (begin + 2)->isDigit() && parseIsoDateTime(begin, end, dt)) {
+		return dt;
+	}
+
+	else if (parseRfcDateTime(begin, end, dt)) {
+		return dt;
+	}
+
+	else {
+		return parseDateTimeWithPatterns(date_time);
+	}
+}
+
+bool TextFactory::equalsIgnoringCase(const QChar* pos, const char* text) {
+	for (; *text != '\0'; pos++, text++) {
+		if (pos->toLower() != QChar(QLatin1Char(*text)).toLower()) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+int TextFactory::readNumber(const QChar*& pos, const QChar* end, int min_digits, int max_digits) {
+	int number = 0;
+	int digits = 0;
+
+	while (pos < end && digits < max_digits && pos->isDigit()) {
+		number = number * 10 + pos->digitValue();
+		digits++;
+		pos++;
+	}
+
+	return digits >= min_digits ? number : -1;
+}
+
+bool TextFactory::readTime(const QChar*& pos, const QChar* end, QTime& time) {
+	// Format is HH:MM[:SS[.fraction]].
+	const int hours = readNumber(pos, end, 2, 2);
+
+	if (hours < 0 || pos >= end || *pos != QL1C(':')) {
+		return false;
+	}
+
+	pos++;
+	const int minutes = readNumber(pos, end, 2, 2);
+	int seconds = 0;
+	int miliseconds = 0;
+
+	if (minutes < 0) {
+		return false;
+	}
+
+	if (pos < end && *pos == QL1C(':')) {
+		pos++;
+
+		if ((seconds = readNumber(pos, end, 2, 2)) < 0) {
+			return false;
+		}
+
+		if (pos < end && (*pos == QL1C('.') || *pos == QL1C(','))) {
+			pos++;
+			int scale = 100;
+			const QChar* fraction_begin = pos;
+
+			// Only miliseconds are kept from the fraction.
+			while (pos < end && pos->isDigit()) {
+				miliseconds += pos->digitValue() * scale;
+				scale /= 10;
+				pos++;
+			}
+
+			if (pos == fraction_begin) {
+				return false;
+			}
+		}
+	}
+
+	// Leap second is accepted as the last second of the minute.
+	time = QTime(hours, minutes, qMin(seconds, 59), miliseconds);
+	return time.isValid();
+}
+
+bool TextFactory::readTimeZone(const QChar*& pos, const QChar* end, int& offset) {
+	offset = 0;
+
+	if (pos == end) {
+		// Time without any zone is considered UTC.
+		return true;
+	}
+
+	if (*pos == QL1C('+') || *pos == QL1C('-')) {
+		// Numerical offset +hh, +hhmm or +hh:mm.
+		const int sign = *pos == QL1C('+') ? 1 : -1;
+		pos++;
+		const int hours = readNumber(pos, end, 2, 2);
+		int minutes = 0;
+
+		if (hours < 0) {
+			return false;
+		}
+
+		if (pos < end && *pos == QL1C(':')) {
+			pos++;
+		}
+
+		if (pos < end && (minutes = readNumber(pos, end, 2, 2)) < 0) {
+			return false;
+		}
+
+		offset = sign * (hours * 3600 + minutes * 60);
+		return pos == end;
+	}
+
+	// Time zone names defined by RFC 822.
+	struct TimeZone {
+		const char* m_name;
+		int m_offsetHours;
+	};
+
+	static const TimeZone zones[] = {
+		{"Z", 0}, {"UT", 0}, {"UTC", 0}, {"GMT", 0},
+		{"EST", -5}, {"EDT", -4}, {"CST", -6}, {"CDT", -5},
+		{"MST", -7}, {"MDT", -6}, {"PST", -8}, {"PDT", -7}
+	};
+
+	const int length = end - pos;
+
+	for (const TimeZone& zone : zones) {
+		if (length == int(qstrlen(zone.m_name)) && equalsIgnoringCase(pos, zone.m_name)) {
+			offset = zone.m_offsetHours * 3600;
+			pos = end;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool TextFactory::parseIsoDateTime(const QChar* pos, const QChar* end, QDateTime& result) {
+	// Format is YYYY[-MM[-DD]][(T| )HH:MM[:SS[.fraction]][zone]].
+	const int year = readNumber(pos, end, 4, 4);
+	int month = 1;
+	int day = 1;
+	QTime time(0, 0);
+	int offset = 0;
+
+	if (year < 0) {
+		return false;
+	}
+
+	if (pos < end && *pos == QL1C('-')) {
+		pos++;
+
+		if ((month = readNumber(pos, end, 2, 2)) < 0) {
+			return false;
+		}
+
+		if (pos < end && *pos == QL1C('-')) {
+			pos++;
+
+			if ((day = readNumber(pos, end, 2, 2)) < 0) {
+				return false;
+			}
+		}
+	}
+
+	if (pos < end) {
+		if (*pos != QL1C('T') && *pos != QL1C('t') && *pos != QL1C(' ')) {
+			return false;
+		}
+
+		pos++;
+
+		if (!readTime(pos, end, time)) {
+			return false;
+		}
+
+		while (pos < end && pos->isSpace()) {
+			pos++;
+		}
+
+		if (!readTimeZone(pos, end, offset)) {
+			return false;
+		}
+	}
+
+	const QDate date(year, month, day);
+
+	if (!date.isValid()) {
+		return false;
+	}
+
+	result = QDateTime(date, time, Qt::UTC).addSecs(-offset);
+	return true;
+}
+
+bool TextFactory::parseRfcDateTime(const QChar* pos, const QChar* end, QDateTime& result) {
+	// Format is [Day,] D[D] Mon YY[YY] [HH:MM[:SS] [zone]].
+	static const char* const months[] = {
+		"jan", "feb", "mar", "apr", "may", "jun", "jul", "aug", "sep", "oct", "nov", "dec"
+	};
+
+	if (pos->isLetter()) {
+		// Skip name of the day.
+		while (pos < end && pos->isLetter()) {
+			pos++;
+		}
+
+		if (pos < end && *pos == QL1C(',')) {
+			pos++;
+		}
+
+		while (pos < end && pos->isSpace()) {
+			pos++;
+		}
+	}
+
+	const int day = readNumber(pos, end, 1, 2);
+
+	if (day < 0 || pos >= end || !pos->isSpace()) {
+		return false;
+	}
+
+	while (pos < end && pos->isSpace()) {
+		pos++;
+	}
+
+	// Month name, only its first three letters are significant.
+	const QChar* month_begin = pos;
+	int month = 0;
+
+	while (pos < end && pos->isLetter()) {
+		pos++;
+	}
+
+	if (pos - month_begin >= 3) {
+		for (int i = 0; i < 12; i++) {
+			if (equalsIgnoringCase(month_begin, months[i])) {
+				month = i + 1;
+				break;
+			}
+		}
+	}
+
+	if (month == 0 || pos >= end || !pos->isSpace()) {
+		return false;
+	}
+
+	while (pos < end && pos->isSpace()) {
+		pos++;
+	}
+
+	const QChar* year_begin = pos;
+	int year = readNumber(pos, end, 2, 4);
+
+	if (year < 0 || pos - year_begin == 3) {
+		return false;
+	}
+
+	else if (pos - year_begin == 2) {
+		// Two-digit years as allowed by RFC 822.
+		year += year < 50 ? 2000 : 1900;
+	}
+
+	QTime time(0, 0);
+	int offset = 0;
+
+	while (pos < end && pos->isSpace()) {
+		pos++;
+	}
+
+	if (pos < end) {
+		if (!readTime(pos, end, time)) {
+			return false;
+		}
+
+		while (pos < end && pos->isSpace()) {
+			pos++;
+		}
+
+		if (!readTimeZone(pos, end, offset)) {
+			return false;
+		}
+	}
+
+	const QDate date(year, month, day);
+
+	if (!date.isValid()) {
+		return false;
+	}
+
+	result = QDateTime(date, time, Qt::UTC).addSecs(-offset);
+	return true;
+}
+
+QDateTime TextFactory::parseDateTimeWithPatterns(const QString& date_time) {
 	const QString input_date = date_time.simplified();
 	QDateTime dt;
 	QTime time_zone_offset;
 	const QLocale locale(QLocale::C);
 	bool positive_time_zone_offset = false;
-	QStringList date_patterns;
-	date_patterns << QSL("yyyy-MM-ddTHH:mm:ss") << QSL("MMM dd yyyy hh:mm:ss") <<
-	              QSL("MMM d yyyy hh:mm:ss") << QSL("ddd, dd MMM yyyy HH:mm:ss") <<
-	              QSL("dd MMM yyyy") << QSL("yyyy-MM-dd HH:mm:ss.z") << QSL("yyyy-MM-dd") <<
-	              QSL("yyyy") << QSL("yyyy-MM") << QSL("yyyy-MM-dd") << QSL("yyyy-MM-ddThh:mm") <<
-	              QSL("yyyy-MM-ddThh:mm:ss");
-	QStringList timezone_offset_patterns;
-	timezone_offset_patterns << QSL("+hh:mm") << QSL("-hh:mm") << QSL("+hhmm")
-	                         << QSL("-hhmm") << QSL("+hh") << QSL("-hh");
+	static const QStringList date_patterns = QStringList() <<
+	                                         QSL("yyyy-MM-ddTHH:mm:ss") << QSL("MMM dd yyyy hh:mm:ss") <<
+	                                         QSL("MMM d yyyy hh:mm:ss") << QSL("ddd, dd MMM yyyy HH:mm:ss") <<
+	                                         QSL("dd MMM yyyy") << QSL("yyyy-MM-dd HH:mm:ss.z") << QSL("yyyy-MM-dd") <<
+	                                         QSL("yyyy") << QSL("yyyy-MM") << QSL("yyyy-MM-dd") << QSL("yyyy-MM-ddThh:mm") <<
+	                                         QSL("yyyy-MM-ddThh:mm:ss");
+	static const QStringList timezone_offset_patterns = QStringList() <<
+	                                                    QSL("+hh:mm") << QSL("-hh:mm") << QSL("+hhmm") <<
+	                                                    QSL("-hhmm") << QSL("+hh") << QSL("-hh");
 
 	if (input_date.size() >= TIMEZONE_OFFSET_LIMIT) {
 		foreach (const QString& pattern, timezone_offset_patterns) {
@@ -135,6 +453,50 @@ QString TextFactory::shorten(const QString& input, int text_length_limit) {
 	}
 }
 
+QString TextFactory::fromPercentEncoding(const QString& text) {
+	if (!text.contains(QL1C('%'))) {
+		return text;
+	}
+
+	else {
+		return QUrl::fromPercentEncoding(text.toUtf8());
+	}
+}
+
+QString TextFactory::normalizeTitle(const QString& title) {
+	const QChar* pos = title.constData();
+	const QChar* end = pos + title.size();
+	QString output;
+	output.reserve(title.size());
+
+	while (pos < end) {
+		if (!pos->isSpace()) {
+			output.append(*pos++);
+			continue;
+		}
+
+		const QChar* space_start = pos;
+
+		while (pos < end && pos->isSpace()) {
+			pos++;
+		}
+
+		if (pos - space_start > 1) {
+			output.append(QL1C(' '));
+		}
+
+		else if (*space_start != QL1C('\n') && *space_start != QL1C('\r')) {
+			output.append(*space_start);
+		}
+	}
+
+	if (!output.isEmpty() && output.at(0).isSpace()) {
+		output.remove(0, 1);
+	}
+
+	return output;
+}
+
 quint64 TextFactory::initializeSecretEncryptionKey() {
 	if (s_encryptionKey == 0x0) {
 		// Check if file with encryption key exists.
@@ -53,7 +53,27 @@ class TextFactory {
 		// Shortens input string according to given length limit.
 		static QString shorten(const QString& input, int text_length_limit = TEXT_TITLE_LIMIT);
 
+		// Decodes percent-encoded text. Text without any
+		// escapes is returned as it is, without decoding.
+		static QString fromPercentEncoding(const QString& text);
+
+		// Replaces each run of white space with single space, removes
+		// lone line breaks and leading white space. Input is scanned once.
+		static QString normalizeTitle(const QString& title);
+
 	private:
+		// Tokenizers of date/time formats used by feeds. They do not allocate
+		// and they accept only input which is completely recognized.
+		static bool parseIsoDateTime(const QChar* pos, const QChar* end, QDateTime& result);
+		static bool parseRfcDateTime(const QChar* pos, const QChar* end, QDateTime& result);
+		static bool equalsIgnoringCase(const QChar* pos, const char* text);
+		static int readNumber(const QChar*& pos, const QChar* end, int min_digits, int max_digits);
+		static bool readTime(const QChar*& pos, const QChar* end, QTime& time);
+		static bool readTimeZone(const QChar*& pos, const QChar* end, int& offset);
+
+		// Matches input against list of known date/time patterns.
+		static QDateTime parseDateTimeWithPatterns(const QString& date_time);
+
 		static quint64 initializeSecretEncryptionKey();
 		static quint64 generateSecretEncryptionKey();
 
@@ -65,7 +65,6 @@ void AdBlockManager::setEnabled(bool enabled) {
 	load();
 	// TODO: Reload user stylesheet.
 	// mApp->reloadUserStyleSheet();
-	QMutexLocker locker(&m_mutex);
 
 	if (m_enabled) {
 		m_matcher->update();
@@ -81,8 +80,8 @@ QList<AdBlockSubscription*> AdBlockManager::subscriptions() const {
 }
 
 bool AdBlockManager::block(QWebEngineUrlRequestInfo& request) {
-	QMutexLocker locker(&m_mutex);
-
+	// NOTE: This is called for each request from IO thread, matcher
+	// uses its current snapshot of rules without any locking.
 	if (!isEnabled()) {
 		return false;
 	}
@@ -96,9 +95,8 @@ bool AdBlockManager::block(QWebEngineUrlRequestInfo& request) {
 	}
 
 	bool res = false;
-	const AdBlockRule* blockedRule = m_matcher->match(request, urlDomain, urlString);
 
-	if (blockedRule) {
+	if (m_matcher->match(request, urlDomain, urlString)) {
 		res = true;
 
 		if (request.resourceType() == QWebEngineUrlRequestInfo::ResourceTypeMainFrame) {
@@ -115,16 +113,16 @@ bool AdBlockManager::block(QWebEngineUrlRequestInfo& request) {
 	return res;
 }
 
-QStringList AdBlockManager::disabledRules() const {
+QSet<QString> AdBlockManager::disabledRules() const {
 	return m_disabledRules;
 }
 
 void AdBlockManager::addDisabledRule(const QString& filter) {
-	m_disabledRules.append(filter);
+	m_disabledRules.insert(filter);
 }
 
 void AdBlockManager::removeDisabledRule(const QString& filter) {
-	m_disabledRules.removeOne(filter);
+	m_disabledRules.remove(filter);
 }
 
 bool AdBlockManager::addSubscriptionFromUrl(const QUrl& url) {
@@ -189,13 +187,12 @@ AdBlockSubscription* AdBlockManager::addSubscription(const QString& title, const
 }
 
 bool AdBlockManager::removeSubscription(AdBlockSubscription* subscription) {
-	QMutexLocker locker(&m_mutex);
-
 	if (!m_subscriptions.contains(subscription) || !subscription->canBeRemoved()) {
 		return false;
 	}
 
 	QFile(subscription->filePath()).remove();
+	QFile(subscription->cacheFilePath()).remove();
 	m_subscriptions.removeOne(subscription);
 	m_matcher->update();
 	delete subscription;
@@ -226,7 +223,7 @@ void AdBlockManager::load() {
 	}
 
 	m_enabled = qApp->settings()->value(GROUP(AdBlock), SETTING(AdBlock::AdBlockEnabled)).toBool();
-	m_disabledRules = qApp->settings()->value(GROUP(AdBlock), SETTING(AdBlock::DisabledRules)).toStringList();
+	m_disabledRules = qApp->settings()->value(GROUP(AdBlock), SETTING(AdBlock::DisabledRules)).toStringList().toSet();
 	QDateTime lastUpdate = qApp->settings()->value(GROUP(AdBlock), SETTING(AdBlock::LastUpdatedOn)).toDateTime();
 
 	if (!m_enabled) {
@@ -290,7 +287,6 @@ void AdBlockManager::load() {
 }
 
 void AdBlockManager::updateMatcher() {
-	QMutexLocker locker(&m_mutex);
 	m_matcher->update();
 }
 
@@ -312,7 +308,7 @@ void AdBlockManager::save() {
 	}
 
 	qApp->settings()->setValue(GROUP(AdBlock), AdBlock::AdBlockEnabled, m_enabled);
-	qApp->settings()->setValue(GROUP(AdBlock), AdBlock::DisabledRules, m_disabledRules);
+	qApp->settings()->setValue(GROUP(AdBlock), AdBlock::DisabledRules, QStringList(m_disabledRules.toList()));
 }
 
 bool AdBlockManager::isEnabled() const {
@@ -22,6 +22,7 @@
 #include <QMutex>
 #include <QObject>
 #include <QPointer>
+#include <QSet>
 #include <QStringList>
 
 
@@ -55,7 +56,7 @@ class AdBlockManager : public QObject {
 
 		bool block(QWebEngineUrlRequestInfo& request);
 
-		QStringList disabledRules() const;
+		QSet<QString> disabledRules() const;
 		void addDisabledRule(const QString& filter);
 		void removeDisabledRule(const QString& filter);
 
@@ -87,7 +88,7 @@ class AdBlockManager : public QObject {
 
 		QList<AdBlockSubscription*> m_subscriptions;
 		AdBlockMatcher* m_matcher;
-		QStringList m_disabledRules;
+		QSet<QString> m_disabledRules;
 
 		AdBlockUrlInterceptor* m_interceptor;
 		QPointer<AdBlockDialog> m_adBlockDialog;
@@ -23,55 +23,57 @@
 
 #include "definitions/definitions.h"
 
+#include <QFutureWatcher>
+#include <QtConcurrent/QtConcurrentRun>
 
-AdBlockMatcher::AdBlockMatcher(AdBlockManager* manager)
-	: QObject(manager), m_manager(manager) {
+
+AdBlockMatcher::Snapshot::Snapshot() {
 }
 
-AdBlockMatcher::~AdBlockMatcher() {
-	clear();
+AdBlockMatcher::Snapshot::~Snapshot() {
+	qDeleteAll(m_rules);
 }
 
-const AdBlockRule* AdBlockMatcher::match(const QWebEngineUrlRequestInfo& request, const QString& urlDomain,
-                                         const QString& urlString) const {
-	// Exception rules.
-	if (m_networkExceptionTree.find(request, urlDomain, urlString)) {
-		return 0;
-	}
+AdBlockMatcher::AdBlockMatcher(AdBlockManager* manager)
+	: QObject(manager), m_manager(manager), m_generation(0) {
+}
 
-	int count = m_networkExceptionRules.count();
+AdBlockMatcher::~AdBlockMatcher() {
+}
 
-	for (int i = 0; i < count; ++i) {
-		const AdBlockRule* rule = m_networkExceptionRules.at(i);
+bool AdBlockMatcher::match(const QWebEngineUrlRequestInfo& request, const QString& urlDomain,
+                           const QString& urlString) const {
+	const SnapshotPointer rules = snapshot();
 
-		if (rule->networkMatch(request, urlDomain, urlString)) {
-			return 0;
-		}
+	if (!rules) {
+		return false;
 	}
 
-	// Block rules.
-	if (const AdBlockRule* rule = m_networkBlockTree.find(request, urlDomain, urlString)) {
-		return rule;
+	// Exception rules.
+	if (rules->m_networkExceptionTree.find(request, urlDomain, urlString)) {
+		return false;
 	}
 
-	count = m_networkBlockRules.count();
-
-	for (int i = 0; i < count; ++i) {
-		const AdBlockRule* rule = m_networkBlockRules.at(i);
-
-		if (rule->networkMatch(request, urlDomain, urlString)) {
-			return rule;
-		}
+	if (rules->m_networkExceptionIndex.find(request, urlDomain, urlString)) {
+		return false;
 	}
 
-	return 0;
+	// Block rules.
+	return rules->m_networkBlockTree.find(request, urlDomain, urlString) != nullptr ||
+	       rules->m_networkBlockIndex.find(request, urlDomain, urlString) != nullptr;
 }
 
 bool AdBlockMatcher::adBlockDisabledForUrl(const QUrl& url) const {
-	int count = m_documentRules.count();
+	const SnapshotPointer rules = snapshot();
+
+	if (!rules) {
+		return false;
+	}
+
+	int count = rules->m_documentRules.count();
 
 	for (int i = 0; i < count; ++i) {
-		if (m_documentRules.at(i)->urlMatch(url)) {
+		if (rules->m_documentRules.at(i)->urlMatch(url)) {
 			return true;
 		}
 	}
@@ -84,10 +86,16 @@ bool AdBlockMatcher::elemHideDisabledForUrl(const QUrl& url) const {
 		return true;
 	}
 
-	int count = m_elemhideRules.count();
+	const SnapshotPointer rules = snapshot();
+
+	if (!rules) {
+		return false;
+	}
+
+	int count = rules->m_elemhideRules.count();
 
 	for (int i = 0; i < count; ++i) {
-		if (m_elemhideRules.at(i)->urlMatch(url)) {
+		if (rules->m_elemhideRules.at(i)->urlMatch(url)) {
 			return true;
 		}
 	}
@@ -96,16 +104,23 @@ bool AdBlockMatcher::elemHideDisabledForUrl(const QUrl& url) const {
 }
 
 QString AdBlockMatcher::elementHidingRules() const {
-	return m_elementHidingRules;
+	const SnapshotPointer rules = snapshot();
+	return rules ? rules->m_elementHidingRules : QString();
 }
 
 QString AdBlockMatcher::elementHidingRulesForDomain(const QString& domain) const {
+	const SnapshotPointer snapshot_rules = snapshot();
+
+	if (!snapshot_rules) {
+		return QString();
+	}
+
 	QString rules;
 	int addedRulesCount = 0;
-	int count = m_domainRestrictedCssRules.count();
+	int count = snapshot_rules->m_domainRestrictedCssRules.count();
 
 	for (int i = 0; i < count; ++i) {
-		const AdBlockRule* rule = m_domainRestrictedCssRules.at(i);
+		const AdBlockRule* rule = snapshot_rules->m_domainRestrictedCssRules.at(i);
 
 		if (!rule->matchDomain(domain)) {
 			continue;
@@ -132,55 +147,83 @@ QString AdBlockMatcher::elementHidingRulesForDomain(const QString& domain) const
 }
 
 void AdBlockMatcher::update() {
-	clear();
-	QHash<QString, const AdBlockRule*> cssRulesHash;
-	QVector<const AdBlockRule*> exceptionCssRules;
+	QVector<AdBlockRule*> rules;
 
+	// Rules are copied here, subscriptions may change them while new snapshot is compiled.
+	// Disabled rules never match, so they are not needed at all.
 	foreach (AdBlockSubscription* subscription, m_manager->subscriptions()) {
 		foreach (const AdBlockRule* rule, subscription->allRules()) {
-			// Don't add internally disabled rules to cache.
-			if (rule->isInternalDisabled()) {
-				continue;
+			if (!rule->isInternalDisabled() && rule->isEnabled()) {
+				rules.append(rule->copy());
 			}
+		}
+	}
 
-			if (rule->isCssRule()) {
-				// We will add only enabled css rules to cache, because there is no enabled/disabled
-				// check on match. They are directly embedded to pages.
-				if (!rule->isEnabled()) {
-					continue;
-				}
+	const int generation = m_generation.fetchAndAddOrdered(1) + 1;
 
-				if (rule->isException()) {
-					exceptionCssRules.append(rule);
-				}
+	if (!snapshot()) {
+		// Requests would not be blocked at all until rules are compiled.
+		publish(compile(rules), generation);
+		return;
+	}
 
-				else {
-					cssRulesHash.insert(rule->cssSelector(), rule);
-				}
-			}
+	QFutureWatcher<SnapshotPointer>* watcher = new QFutureWatcher<SnapshotPointer>(this);
+
+	connect(watcher, &QFutureWatcher<SnapshotPointer>::finished, this, [this, watcher, generation]() {
+		publish(watcher->result(), generation);
+		watcher->deleteLater();
+	});
+	watcher->setFuture(QtConcurrent::run(&AdBlockMatcher::compile, rules));
+}
+
+void AdBlockMatcher::clear() {
+	publish(SnapshotPointer(), m_generation.fetchAndAddOrdered(1) + 1);
+}
 
-			else if (rule->isDocument()) {
-				m_documentRules.append(rule);
+AdBlockMatcher::SnapshotPointer AdBlockMatcher::compile(const QVector<AdBlockRule*>& rules) {
+	Snapshot* snapshot = new Snapshot();
+	QHash<QString, const AdBlockRule*> cssRulesHash;
+	QVector<const AdBlockRule*> exceptionCssRules;
+	QVector<const AdBlockRule*> networkExceptionRules;
+	QVector<const AdBlockRule*> networkBlockRules;
+
+	snapshot->m_rules = rules;
+
+	foreach (const AdBlockRule* rule, rules) {
+		if (rule->isCssRule()) {
+			if (rule->isException()) {
+				exceptionCssRules.append(rule);
 			}
 
-			else if (rule->isElemhide()) {
-				m_elemhideRules.append(rule);
+			else {
+				cssRulesHash.insert(rule->cssSelector(), rule);
 			}
+		}
+
+		else if (rule->isDocument()) {
+			snapshot->m_documentRules.append(rule);
+		}
 
-			else if (rule->isException()) {
-				if (!m_networkExceptionTree.add(rule)) {
-					m_networkExceptionRules.append(rule);
-				}
+		else if (rule->isElemhide()) {
+			snapshot->m_elemhideRules.append(rule);
+		}
+
+		else if (rule->isException()) {
+			if (!snapshot->m_networkExceptionTree.add(rule)) {
+				networkExceptionRules.append(rule);
 			}
+		}
 
-			else {
-				if (!m_networkBlockTree.add(rule)) {
-					m_networkBlockRules.append(rule);
-				}
+		else {
+			if (!snapshot->m_networkBlockTree.add(rule)) {
+				networkBlockRules.append(rule);
 			}
 		}
 	}
 
+	snapshot->m_networkExceptionIndex.build(networkExceptionRules);
+	snapshot->m_networkBlockIndex.build(networkBlockRules);
+
 	foreach (const AdBlockRule* rule, exceptionCssRules) {
 		const AdBlockRule* originalRule = cssRulesHash.value(rule->cssSelector());
 
@@ -193,7 +236,7 @@ void AdBlockMatcher::update() {
 		copiedRule->m_options |= AdBlockRule::DomainRestrictedOption;
 		copiedRule->m_blockedDomains.append(rule->m_allowedDomains);
 		cssRulesHash[rule->cssSelector()] = copiedRule;
-		m_createdRules.append(copiedRule);
+		snapshot->m_rules.append(copiedRule);
 	}
 
 	// Apparently, excessive amount of selectors for one CSS rule is not what WebKit likes.
@@ -207,36 +250,37 @@ void AdBlockMatcher::update() {
 		const AdBlockRule* rule = it.value();
 
 		if (rule->isDomainRestricted()) {
-			m_domainRestrictedCssRules.append(rule);
+			snapshot->m_domainRestrictedCssRules.append(rule);
 		}
 
 		else if (Q_UNLIKELY(hidingRulesCount == 1000)) {
-			m_elementHidingRules.append(rule->cssSelector());
-			m_elementHidingRules.append(QL1S("{display:none !important;} "));
+			snapshot->m_elementHidingRules.append(rule->cssSelector());
+			snapshot->m_elementHidingRules.append(QL1S("{display:none !important;} "));
 			hidingRulesCount = 0;
 		}
 
 		else {
-			m_elementHidingRules.append(rule->cssSelector() + QLatin1Char(','));
+			snapshot->m_elementHidingRules.append(rule->cssSelector() + QLatin1Char(','));
 			hidingRulesCount++;
 		}
 	}
 
 	if (hidingRulesCount != 0) {
-		m_elementHidingRules = m_elementHidingRules.left(m_elementHidingRules.size() - 1);
-		m_elementHidingRules.append(QL1S("{display:none !important;} "));
+		snapshot->m_elementHidingRules = snapshot->m_elementHidingRules.left(snapshot->m_elementHidingRules.size() - 1);
+		snapshot->m_elementHidingRules.append(QL1S("{display:none !important;} "));
 	}
+
+	return SnapshotPointer(snapshot);
 }
 
-void AdBlockMatcher::clear() {
-	m_networkExceptionTree.clear();
-	m_networkExceptionRules.clear();
-	m_networkBlockTree.clear();
-	m_networkBlockRules.clear();
-	m_domainRestrictedCssRules.clear();
-	m_elementHidingRules.clear();
-	m_documentRules.clear();
-	m_elemhideRules.clear();
-	qDeleteAll(m_createdRules);
-	m_createdRules.clear();
+AdBlockMatcher::SnapshotPointer AdBlockMatcher::snapshot() const {
+	return std::atomic_load(&m_snapshot);
+}
+
+void AdBlockMatcher::publish(const SnapshotPointer& snapshot, int generation) {
+	// Snapshots compiled for outdated rules are dropped. Readers which still
+	// use previous snapshot keep it alive until they finish.
+	if (generation == m_generation.load()) {
+		std::atomic_store(&m_snapshot, snapshot);
+	}
 }
@@ -22,13 +22,18 @@
 #include <QUrl>
 
 #include "network-web/adblock/adblocksearchtree.h"
+#include "network-web/adblock/adblocktokenindex.h"
 
+#include <QAtomicInt>
 #include <QObject>
 #include <QVector>
 
+#include <memory>
+
 
 class QWebEngineUrlRequestInfo;
 class AdBlockManager;
+class AdBlockRule;
 
 class AdBlockMatcher : public QObject {
 		Q_OBJECT
@@ -37,7 +42,8 @@ class AdBlockMatcher : public QObject {
 		explicit AdBlockMatcher(AdBlockManager* manager);
 		virtual ~AdBlockMatcher();
 
-		const AdBlockRule* match(const QWebEngineUrlRequestInfo& request, const QString& urlDomain, const QString& urlString) const;
+		// Returns true if request is blocked by current set of compiled rules.
+		bool match(const QWebEngineUrlRequestInfo& request, const QString& urlDomain, const QString& urlString) const;
 
 		bool adBlockDisabledForUrl(const QUrl& url) const;
 		bool elemHideDisabledForUrl(const QUrl& url) const;
@@ -46,22 +52,47 @@ class AdBlockMatcher : public QObject {
 		QString elementHidingRulesForDomain(const QString& domain) const;
 
 	public slots:
+		// Compiles enabled rules of all subscriptions in worker thread
+		// and publishes them once they are ready. If no rules are published
+		// yet, they are compiled right away, so that no request slips through.
 		void update();
 		void clear();
 
 	private:
-		AdBlockManager* m_manager;
+		// Immutable set of compiled rules. It owns copies of all its rules, so
+		// it can be used by any thread no matter what happens to subscriptions.
+		struct Snapshot {
+			explicit Snapshot();
+			~Snapshot();
+
+			QVector<AdBlockRule*> m_rules;
+			QVector<const AdBlockRule*> m_domainRestrictedCssRules;
+			QVector<const AdBlockRule*> m_documentRules;
+			QVector<const AdBlockRule*> m_elemhideRules;
+
+			QString m_elementHidingRules;
+			AdBlockSearchTree m_networkBlockTree;
+			AdBlockSearchTree m_networkExceptionTree;
+
+			// Network rules which cannot be put into search trees.
+			AdBlockTokenIndex m_networkBlockIndex;
+			AdBlockTokenIndex m_networkExceptionIndex;
 
-		QVector<AdBlockRule*> m_createdRules;
-		QVector<const AdBlockRule*> m_networkExceptionRules;
-		QVector<const AdBlockRule*> m_networkBlockRules;
-		QVector<const AdBlockRule*> m_domainRestrictedCssRules;
-		QVector<const AdBlockRule*> m_documentRules;
-		QVector<const AdBlockRule*> m_elemhideRules;
+			Q_DISABLE_COPY(Snapshot)
+		};
+
+		typedef std::shared_ptr<const Snapshot> SnapshotPointer;
+
+		static SnapshotPointer compile(const QVector<AdBlockRule*>& rules);
+
+		SnapshotPointer snapshot() const;
+		void publish(const SnapshotPointer& snapshot, int generation);
+
+		AdBlockManager* m_manager;
 
-		QString m_elementHidingRules;
-		AdBlockSearchTree m_networkBlockTree;
-		AdBlockSearchTree m_networkExceptionTree;
+		// NOTE: Current snapshot is read and replaced only atomically.
+		SnapshotPointer m_snapshot;
+		QAtomicInt m_generation;
 };
 
 #endif // ADBLOCKMATCHER_H
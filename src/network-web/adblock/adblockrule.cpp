@@ -51,6 +51,7 @@
 #include "definitions/definitions.h"
 #include "miscellaneous/simpleregexp.h"
 
+#include <QDataStream>
 #include <QUrl>
 #include <QString>
 #include <QStringList>
@@ -113,6 +114,51 @@ AdBlockRule* AdBlockRule::copy() const {
 	return rule;
 }
 
+void AdBlockRule::serialize(QDataStream& stream) const {
+	stream << m_filter << m_matchString << qint32(m_type) << qint32(m_options) << qint32(m_exceptions)
+	       << qint32(m_caseSensitivity) << m_isEnabled << m_isException << m_isInternalDisabled
+	       << m_allowedDomains << m_blockedDomains << (m_regExp != 0);
+
+	if (m_regExp) {
+		QStringList matchers;
+
+		foreach (const QStringMatcher& matcher, m_regExp->matchers) {
+			matchers.append(matcher.pattern());
+		}
+
+		stream << m_regExp->regExp.pattern() << matchers;
+	}
+}
+
+bool AdBlockRule::deserialize(QDataStream& stream) {
+	qint32 type, options, exceptions, caseSensitivity;
+	bool hasRegExp;
+
+	stream >> m_filter >> m_matchString >> type >> options >> exceptions >> caseSensitivity
+	       >> m_isEnabled >> m_isException >> m_isInternalDisabled >> m_allowedDomains >> m_blockedDomains >> hasRegExp;
+
+	m_type = static_cast<RuleType>(type);
+	m_options = RuleOptions(options);
+	m_exceptions = RuleOptions(exceptions);
+	m_caseSensitivity = static_cast<Qt::CaseSensitivity>(caseSensitivity);
+	delete m_regExp;
+	m_regExp = 0;
+
+	if (hasRegExp) {
+		QString pattern;
+		QStringList matchers;
+
+		stream >> pattern >> matchers;
+
+		// NOTE: Regular expression itself is compiled lazily on first match.
+		m_regExp = new RegExp;
+		m_regExp->regExp = SimpleRegExp(pattern, m_caseSensitivity);
+		m_regExp->matchers = createStringMatchers(matchers);
+	}
+
+	return stream.status() == QDataStream::Ok;
+}
+
 AdBlockSubscription* AdBlockRule::subscription() const {
 	return m_subscription;
 }
@@ -664,7 +710,8 @@ bool AdBlockRule::stringMatch(const QString& domain, const QString& encodedUrl)
 		}
 
 		else {
-			return (m_regExp->regExp.indexIn(encodedUrl) != -1);
+			// NOTE: Rules are matched from multiple threads, so stateless matching is used.
+			return m_regExp->regExp.match(encodedUrl).hasMatch();
 		}
 	}
 
@@ -54,6 +54,7 @@
 #include "miscellaneous/simpleregexp.h"
 
 
+class QDataStream;
 class QUrl;
 class QWebEngineUrlRequestInfo;
 class AdBlockSubscription;
@@ -67,6 +68,10 @@ class AdBlockRule {
 
 		AdBlockRule* copy() const;
 
+		// Writes/reads parsed rule in binary form used by subscription cache.
+		void serialize(QDataStream& stream) const;
+		bool deserialize(QDataStream& stream);
+
 		AdBlockSubscription* subscription() const;
 		void setSubscription(AdBlockSubscription* subscription);
 
@@ -180,6 +185,7 @@ class AdBlockRule {
 
 		friend class AdBlockMatcher;
 		friend class AdBlockSearchTree;
+		friend class AdBlockTokenIndex;
 		friend class AdBlockSubscription;
 };
 
@@ -54,6 +54,8 @@
 #include "exceptions/applicationexception.h"
 #include "miscellaneous/application.h"
 
+#include <QCryptographicHash>
+#include <QDataStream>
 #include <QFile>
 #include <QTimer>
 #include <QNetworkReply>
@@ -85,7 +87,11 @@ void AdBlockSubscription::setUrl(const QUrl& url) {
 	m_url = url;
 }
 
-void AdBlockSubscription::loadSubscription(const QStringList& disabledRules) {
+QString AdBlockSubscription::cacheFilePath() const {
+	return m_filePath + QSL(ADBLOCK_CACHE_EXTENSION);
+}
+
+void AdBlockSubscription::loadSubscription(const QSet<QString>& disabledRules) {
 	QFile file(m_filePath);
 
 	if (!file.exists()) {
@@ -99,29 +105,37 @@ void AdBlockSubscription::loadSubscription(const QStringList& disabledRules) {
 		return;
 	}
 
-	QTextStream textStream(&file);
-	textStream.setCodec("UTF-8");
-	// Header is on 3rd line.
-	textStream.readLine(1024);
-	textStream.readLine(1024);
-	QString header = textStream.readLine(1024);
+	const QByteArray contents = file.readAll();
+	const QByteArray hash = QCryptographicHash::hash(contents, QCryptographicHash::Sha1);
+
+	// Rules are parsed only if subscription changed since cache was created.
+	if (!loadCache(hash)) {
+		QTextStream textStream(contents);
+		textStream.setCodec("UTF-8");
+		// Header is on 3rd line.
+		textStream.readLine(1024);
+		textStream.readLine(1024);
+		QString header = textStream.readLine(1024);
+
+		if (!header.startsWith(QL1S("[Adblock")) || m_title.isEmpty()) {
+			qWarning("Invalid format of AdBlock file '%s'.", qPrintable(m_filePath));
+			QTimer::singleShot(0, this, SLOT(updateSubscription()));
+			return;
+		}
 
-	if (!header.startsWith(QL1S("[Adblock")) || m_title.isEmpty()) {
-		qWarning("Invalid format of AdBlock file '%s'.", qPrintable(m_filePath));
-		QTimer::singleShot(0, this, SLOT(updateSubscription()));
-		return;
-	}
+		m_rules.clear();
 
-	m_rules.clear();
+		while (!textStream.atEnd()) {
+			m_rules.append(new AdBlockRule(textStream.readLine(), this));
+		}
 
-	while (!textStream.atEnd()) {
-		AdBlockRule* rule = new AdBlockRule(textStream.readLine(), this);
+		saveCache(hash);
+	}
 
+	foreach (AdBlockRule* rule, m_rules) {
 		if (disabledRules.contains(rule->filter())) {
 			rule->setEnabled(false);
 		}
-
-		m_rules.append(rule);
 	}
 
 	// Initial update.
@@ -169,6 +183,76 @@ void AdBlockSubscription::subscriptionDownloaded() {
 	emit subscriptionChanged();
 }
 
+bool AdBlockSubscription::loadCache(const QByteArray& hash) {
+	QFile file(cacheFilePath());
+
+	if (!file.open(QFile::ReadOnly)) {
+		return false;
+	}
+
+	uchar* mappedCache = file.map(0, file.size());
+
+	if (mappedCache == nullptr) {
+		return false;
+	}
+
+	// Cache is read directly from mapped file without copying it.
+	QDataStream stream(QByteArray::fromRawData(reinterpret_cast<const char*>(mappedCache), int(file.size())));
+	quint32 magic, version;
+	QByteArray cacheHash;
+	qint32 count;
+
+	stream.setVersion(QDataStream::Qt_5_0);
+	stream >> magic >> version;
+
+	if (stream.status() != QDataStream::Ok || magic != ADBLOCK_CACHE_MAGIC || version != ADBLOCK_CACHE_VERSION) {
+		return false;
+	}
+
+	stream >> cacheHash >> count;
+
+	if (stream.status() != QDataStream::Ok || cacheHash != hash || count < 0) {
+		return false;
+	}
+
+	QVector<AdBlockRule*> rules;
+	rules.reserve(count);
+
+	for (int i = 0; i < count; i++) {
+		AdBlockRule* rule = new AdBlockRule(QString(), this);
+		rules.append(rule);
+
+		if (!rule->deserialize(stream)) {
+			qWarning("AdBlock cache '%s' is corrupted.", qPrintable(cacheFilePath()));
+			qDeleteAll(rules);
+			return false;
+		}
+	}
+
+	m_rules = rules;
+	return true;
+}
+
+void AdBlockSubscription::saveCache(const QByteArray& hash) const {
+	QSaveFile file(cacheFilePath());
+
+	if (!file.open(QFile::WriteOnly)) {
+		qWarning("Unable to open AdBlock cache '%s' for writing.", qPrintable(cacheFilePath()));
+		return;
+	}
+
+	QDataStream stream(&file);
+
+	stream.setVersion(QDataStream::Qt_5_0);
+	stream << quint32(ADBLOCK_CACHE_MAGIC) << quint32(ADBLOCK_CACHE_VERSION) << hash << qint32(m_rules.size());
+
+	foreach (const AdBlockRule* rule, m_rules) {
+		rule->serialize(stream);
+	}
+
+	file.commit();
+}
+
 bool AdBlockSubscription::saveDownloadedData(const QByteArray& data) {
 	QSaveFile file(m_filePath);
 
@@ -271,7 +355,7 @@ AdBlockCustomList::AdBlockCustomList(QObject* parent)
 	setFilePath(AdBlockManager::storedListsPath() + QDir::separator() + ADBLOCK_CUSTOMLIST_NAME);
 }
 
-void AdBlockCustomList::loadSubscription(const QStringList& disabledRules) {
+void AdBlockCustomList::loadSubscription(const QSet<QString>& disabledRules) {
 	// DuckDuckGo ad whitelist rules
 	// They cannot be removed, but can be disabled.
 	// Please consider not disabling them. Thanks!
@@ -47,6 +47,7 @@
 #ifndef ADBLOCKSUBSCRIPTION_H
 #define ADBLOCKSUBSCRIPTION_H
 
+#include <QSet>
 #include <QVector>
 #include <QUrl>
 
@@ -72,7 +73,10 @@ class AdBlockSubscription : public QObject {
 		QUrl url() const;
 		void setUrl(const QUrl& url);
 
-		virtual void loadSubscription(const QStringList& disabledRules);
+		// Path to binary cache of parsed rules of this subscription.
+		QString cacheFilePath() const;
+
+		virtual void loadSubscription(const QSet<QString>& disabledRules);
 		virtual void saveSubscription();
 
 		const AdBlockRule* rule(int offset) const;
@@ -102,6 +106,11 @@ class AdBlockSubscription : public QObject {
 	protected:
 		virtual bool saveDownloadedData(const QByteArray& data);
 
+		// Loads parsed rules from cache if it was created from
+		// subscription file with given hash.
+		bool loadCache(const QByteArray& hash);
+		void saveCache(const QByteArray& hash) const;
+
 		QNetworkReply* m_reply;
 		QVector<AdBlockRule*> m_rules;
 
@@ -119,7 +128,7 @@ class AdBlockCustomList : public AdBlockSubscription {
 	public:
 		explicit AdBlockCustomList(QObject* parent = 0);
 
-		void loadSubscription(const QStringList& disabledRules);
+		void loadSubscription(const QSet<QString>& disabledRules);
 		void saveSubscription();
 
 		bool canEditRules() const;
@@ -0,0 +1,174 @@
+// This file is part of RSS Guard.
+//
+// Copyright (C) 2011-2017 by Martin Rotter <rotter.martinos@gmail.com>
+//
+// RSS Guard is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// RSS Guard is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with RSS Guard. If not, see <http://www.gnu.org/licenses/>.
+
+#include "network-web/adblock/adblocktokenindex.h"
+#include "network-web/adblock/adblockrule.h"
+
+#include "definitions/definitions.h"
+
+#include <QVarLengthArray>
+
+#include <algorithm>
+
+
+static inline bool isTokenCharacter(const QChar& c) {
+	return c.isLetterOrNumber() || c == QL1C('%');
+}
+
+void AdBlockTokenIndex::appendTokens(const QString& string, QVarLengthArray<uint, 64>& tokens) {
+	const int length = string.size();
+	int start = -1;
+
+	for (int i = 0; i <= length; ++i) {
+		if (i < length && isTokenCharacter(string.at(i))) {
+			if (start < 0) {
+				start = i;
+			}
+		}
+
+		else if (start >= 0) {
+			if (i - start >= ADBLOCK_MIN_TOKEN_LENGTH) {
+				const uint token = qHash(string.midRef(start, i - start));
+
+				if (!std::count(tokens.constBegin(), tokens.constEnd(), token)) {
+					tokens.append(token);
+				}
+			}
+
+			start = -1;
+		}
+	}
+}
+
+AdBlockTokenIndex::AdBlockTokenIndex() {
+}
+
+AdBlockTokenIndex::~AdBlockTokenIndex() {
+}
+
+void AdBlockTokenIndex::build(const QVector<const AdBlockRule*>& rules) {
+	QVector<QVector<uint>> rulesTokens;
+	QHash<uint, int> tokenCounts;
+
+	m_buckets.clear();
+	m_untokenizedRules.clear();
+	rulesTokens.reserve(rules.size());
+
+	foreach (const AdBlockRule* rule, rules) {
+		const QVector<uint> tokens = ruleTokens(rule);
+
+		foreach (uint token, tokens) {
+			tokenCounts[token]++;
+		}
+
+		rulesTokens.append(tokens);
+	}
+
+	for (int i = 0; i < rules.size(); ++i) {
+		const QVector<uint>& tokens = rulesTokens.at(i);
+
+		if (tokens.isEmpty()) {
+			m_untokenizedRules.append(rules.at(i));
+			continue;
+		}
+
+		// Rule goes to bucket of its rarest token, so that buckets stay small.
+		uint rarestToken = tokens.first();
+
+		foreach (uint token, tokens) {
+			if (tokenCounts.value(token) < tokenCounts.value(rarestToken)) {
+				rarestToken = token;
+			}
+		}
+
+		m_buckets[rarestToken].append(rules.at(i));
+	}
+}
+
+const AdBlockRule* AdBlockTokenIndex::find(const QWebEngineUrlRequestInfo& request, const QString& domain,
+                                           const QString& urlString) const {
+	return find(domain, urlString, [&](const AdBlockRule* rule) {
+		return rule->networkMatch(request, domain, urlString);
+	});
+}
+
+QVector<uint> AdBlockTokenIndex::ruleTokens(const AdBlockRule* rule) {
+	switch (rule->m_type) {
+		case AdBlockRule::DomainMatchRule:
+			// Domain is always preceded by separator in URL and followed by one.
+			return patternTokens(QSL("||") + rule->m_matchString + QL1C('^'));
+
+		case AdBlockRule::StringEndsMatchRule:
+			return patternTokens(rule->m_matchString + QL1C('|'));
+
+		case AdBlockRule::StringContainsMatchRule:
+			return patternTokens(rule->m_matchString);
+
+		case AdBlockRule::RegExpMatchRule: {
+			// Wildcard rules are tokenized from their original filter, rules
+			// written directly as regular expressions cannot be tokenized.
+			QString filter = rule->m_filter;
+
+			if (filter.startsWith(QL1S("@@"))) {
+				filter = filter.mid(2);
+			}
+
+			const int optionsIndex = filter.indexOf(QL1C('$'));
+
+			if (optionsIndex >= 0) {
+				filter = filter.left(optionsIndex);
+			}
+
+			if (filter.startsWith(QL1C('/')) && filter.endsWith(QL1C('/'))) {
+				return QVector<uint>();
+			}
+
+			return patternTokens(filter);
+		}
+
+		default:
+			return QVector<uint>();
+	}
+}
+
+QVector<uint> AdBlockTokenIndex::patternTokens(const QString& pattern) {
+	const QString lowerPattern = pattern.toLower();
+	const int length = lowerPattern.size();
+	QVector<uint> tokens;
+	int start = -1;
+
+	for (int i = 0; i <= length; ++i) {
+		if (i < length && isTokenCharacter(lowerPattern.at(i))) {
+			if (start < 0) {
+				start = i;
+			}
+		}
+
+		else if (start >= 0) {
+			// Token is usable only if pattern itself bounds it by characters which cannot be part
+			// of the token in URL. Edges of pattern and wildcards may hide rest of the token.
+			if (i - start >= ADBLOCK_MIN_TOKEN_LENGTH && start > 0 && lowerPattern.at(start - 1) != QL1C('*') &&
+			    i < length && lowerPattern.at(i) != QL1C('*')) {
+				tokens.append(qHash(lowerPattern.midRef(start, i - start)));
+			}
+
+			start = -1;
+		}
+	}
+
+	return tokens;
+}
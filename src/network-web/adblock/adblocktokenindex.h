@@ -0,0 +1,91 @@
+// This file is part of RSS Guard.
+//
+// Copyright (C) 2011-2017 by Martin Rotter <rotter.martinos@gmail.com>
+//
+// RSS Guard is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// RSS Guard is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with RSS Guard. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef ADBLOCKTOKENINDEX_H
+#define ADBLOCKTOKENINDEX_H
+
+#include <QHash>
+#include <QString>
+#include <QVarLengthArray>
+#include <QVector>
+
+
+class QWebEngineUrlRequestInfo;
+class AdBlockRule;
+
+// Index of network rules bucketed by token, i.e. by maximal run of letters,
+// digits and '%' characters, which must appear in each URL matched by the rule.
+// Each rule is put into bucket of its rarest token, so URL is checked only
+// against rules sharing some token with it. Rules without any usable token
+// are checked for each URL.
+class AdBlockTokenIndex {
+	public:
+		explicit AdBlockTokenIndex();
+		virtual ~AdBlockTokenIndex();
+
+		void build(const QVector<const AdBlockRule*>& rules);
+		const AdBlockRule* find(const QWebEngineUrlRequestInfo& request, const QString& domain, const QString& urlString) const;
+
+		// Returns first rule for which "matches" returns true. Only rules which
+		// share some token with the URL are passed to "matches".
+		template<typename Predicate>
+		const AdBlockRule* find(const QString& domain, const QString& urlString, Predicate matches) const;
+
+	private:
+		// Appends hashes of all tokens of the string which are not present yet.
+		static void appendTokens(const QString& string, QVarLengthArray<uint, 64>& tokens);
+
+		// Returns hashes of tokens of the rule which are surely whole tokens of
+		// any URL matched by the rule.
+		static QVector<uint> ruleTokens(const AdBlockRule* rule);
+		static QVector<uint> patternTokens(const QString& pattern);
+
+		QHash<uint, QVector<const AdBlockRule*>> m_buckets;
+		QVector<const AdBlockRule*> m_untokenizedRules;
+};
+
+template<typename Predicate>
+inline const AdBlockRule* AdBlockTokenIndex::find(const QString& domain, const QString& urlString, Predicate matches) const {
+	QVarLengthArray<uint, 64> tokens;
+
+	// NOTE: Domain is tokenized too, because it is not encoded
+	// in the same way as host in URL string.
+	appendTokens(urlString, tokens);
+	appendTokens(domain, tokens);
+
+	for (int i = 0; i < tokens.size(); ++i) {
+		const QHash<uint, QVector<const AdBlockRule*>>::const_iterator bucket = m_buckets.constFind(tokens.at(i));
+
+		if (bucket != m_buckets.constEnd()) {
+			foreach (const AdBlockRule* rule, bucket.value()) {
+				if (matches(rule)) {
+					return rule;
+				}
+			}
+		}
+	}
+
+	foreach (const AdBlockRule* rule, m_untokenizedRules) {
+		if (matches(rule)) {
+			return rule;
+		}
+	}
+
+	return 0;
+}
+
+#endif // ADBLOCKTOKENINDEX_H
@@ -75,6 +75,10 @@ QNetworkReply* BaseNetworkAccessManager::createRequest(QNetworkAccessManager::Op
 	// This rapidly speeds up loading of web sites.
 	// NOTE: https://en.wikipedia.org/wiki/HTTP_pipelining
 	new_request.setAttribute(QNetworkRequest::HttpPipeliningAllowedAttribute, true);
+#if QT_VERSION >= 0x050800
+	// Multiplex requests to the same host over single connection if server allows it.
+	new_request.setAttribute(QNetworkRequest::HTTP2AllowedAttribute, true);
+#endif
 	// Setup custom user-agent.
 	new_request.setRawHeader(USER_AGENT_HTTP_HEADER, QString(APP_USERAGENT).toLocal8Bit());
 	return QNetworkAccessManager::createRequest(op, new_request, outgoingData);
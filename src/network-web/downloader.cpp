@@ -23,16 +23,26 @@
 
 
 Downloader::Downloader(QObject* parent)
-	: QObject(parent), m_activeReply(nullptr), m_downloadManager(new SilentNetworkAccessManager(this)),
+	: QObject(parent), m_activeReply(nullptr), m_downloadManager(SilentNetworkAccessManager::threadInstance()),
 	  m_timer(new QTimer(this)), m_customHeaders(QHash<QByteArray, QByteArray>()), m_inputData(QByteArray()),
+	  m_maxBodySize(0), m_receivedBodySize(0), m_outputBuffered(true), m_rejectedContentTypes(QStringList()),
+	  m_rejectionError(QNetworkReply::NoError),
 	  m_targetProtected(false), m_targetUsername(QString()), m_targetPassword(QString()),
-	  m_lastOutputData(QByteArray()), m_lastOutputError(QNetworkReply::NoError), m_lastContentType(QVariant()) {
+	  m_lastOutputData(QByteArray()), m_lastOutputError(QNetworkReply::NoError), m_lastContentType(QVariant()),
+	  m_lastHttpStatusCode(0), m_lastRawHeaders(QList<QNetworkReply::RawHeaderPair>()) {
 	m_timer->setInterval(DOWNLOAD_TIMEOUT);
 	m_timer->setSingleShot(true);
 	connect(m_timer, &QTimer::timeout, this, &Downloader::cancel);
 }
 
 Downloader::~Downloader() {
+	if (m_activeReply != nullptr) {
+		// Network manager is shared and outlives us, so
+		// make sure that our unfinished reply does not stay behind.
+		m_activeReply->disconnect(this);
+		m_activeReply->abort();
+		m_activeReply->deleteLater();
+	}
 }
 
 void Downloader::downloadFile(const QString& url, int timeout, bool protected_contents, const QString& username,
@@ -70,6 +80,24 @@ void Downloader::manipulateData(const QString& url, QNetworkAccessManager::Opera
 		request.setUrl(non_const_url);
 	}
 
+	// Network manager is shared by all downloads performed in this thread, so
+	// credentials cached by it for one feed must not be reused for another one.
+	request.setAttribute(QNetworkRequest::AuthenticationReuseAttribute, QNetworkRequest::Manual);
+
+	if (protected_contents) {
+		if (!request.hasRawHeader("Authorization") && request.url().scheme() == QL1S("https")) {
+			// Credentials of this feed are sent with its own request. Plain HTTP
+			// feeds get them only when server asks for them.
+			const QString basic_value = username + QL1C(':') + password;
+			request.setRawHeader("Authorization", QByteArray("Basic ") + basic_value.toUtf8().toBase64());
+		}
+
+		// Session cookies obtained with credentials of this feed
+		// must not be shared with other feeds via common cookie jar.
+		request.setAttribute(QNetworkRequest::CookieLoadControlAttribute, QNetworkRequest::Manual);
+		request.setAttribute(QNetworkRequest::CookieSaveControlAttribute, QNetworkRequest::Manual);
+	}
+
 	m_targetProtected = protected_contents;
 	m_targetUsername = username;
 	m_targetPassword = password;
@@ -102,15 +130,22 @@ void Downloader::finished() {
 		// Communication indicates that HTTP redirection is needed.
 		// Setup redirection URL and download again.
 		QNetworkRequest request = reply->request();
+		const QUrl original_url = request.url();
 
 		if (redirection_url.host().isEmpty()) {
-			request.setUrl(QUrl(reply->request().url().scheme() + QSL("://") + reply->request().url().host() + redirection_url.toString()));
+			request.setUrl(QUrl(original_url.scheme() + QSL("://") + original_url.host() + redirection_url.toString()));
 		}
 
 		else {
 			request.setUrl(redirection_url);
 		}
 
+		if (request.url().scheme() != original_url.scheme() || request.url().host() != original_url.host() ||
+		        request.url().port() != original_url.port()) {
+			// Credentials are never handed to other server or over different protocol.
+			request.setRawHeader("Authorization", QByteArray());
+		}
+
 		m_activeReply->deleteLater();
 		m_activeReply = nullptr;
 
@@ -133,10 +168,15 @@ void Downloader::finished() {
 
 	else {
 		// No redirection is indicated. Final file is obtained in our "reply" object.
-		// Read the data into output buffer.
-		m_lastOutputData = reply->readAll();
+		// Most of the data were already consumed, read the rest.
+		if (m_rejectionError == QNetworkReply::NoError) {
+			processReceivedData(reply);
+		}
+
 		m_lastContentType = reply->header(QNetworkRequest::ContentTypeHeader);
-		m_lastOutputError = reply->error();
+		m_lastOutputError = m_rejectionError != QNetworkReply::NoError ? m_rejectionError : reply->error();
+		m_lastHttpStatusCode = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+		m_lastRawHeaders = reply->rawHeaderPairs();
 		m_activeReply->deleteLater();
 		m_activeReply = nullptr;
 		emit completed(m_lastOutputError, m_lastOutputData);
@@ -151,50 +191,130 @@ void Downloader::progressInternal(qint64 bytes_received, qint64 bytes_total) {
 	emit progress(bytes_received, bytes_total);
 }
 
-void Downloader::runDeleteRequest(const QNetworkRequest& request) {
+void Downloader::metaDataChanged() {
+	QNetworkReply* reply = qobject_cast<QNetworkReply*>(sender());
+	const int http_status_code = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+
+	if (reply != m_activeReply || m_rejectionError != QNetworkReply::NoError ||
+	        (http_status_code >= 300 && http_status_code < 400)) {
+		// Body of redirections and "not modified" replies is not used.
+		return;
+	}
+
+	const QString content_type = reply->header(QNetworkRequest::ContentTypeHeader).toString().section(QL1C(';'), 0, 0).trimmed().toLower();
+
+	if (!content_type.isEmpty()) {
+		foreach (const QString& rejected_type, m_rejectedContentTypes) {
+			if (content_type.startsWith(rejected_type)) {
+				qWarning("Download of '%s' is aborted, its content type '%s' is not accepted.",
+				         qPrintable(reply->url().toString()), qPrintable(content_type));
+				rejectActiveReply(QNetworkReply::UnknownContentError);
+				return;
+			}
+		}
+	}
+
+	const qint64 content_length = reply->header(QNetworkRequest::ContentLengthHeader).toLongLong();
+
+	if (m_maxBodySize > 0 && content_length > m_maxBodySize) {
+		qWarning("Download of '%s' is aborted, its size %lld B exceeds limit %lld B.",
+		         qPrintable(reply->url().toString()), content_length, m_maxBodySize);
+		rejectActiveReply(QNetworkReply::UnknownContentError);
+	}
+}
+
+void Downloader::readyRead() {
+	QNetworkReply* reply = qobject_cast<QNetworkReply*>(sender());
+
+	if (reply != m_activeReply || m_rejectionError != QNetworkReply::NoError) {
+		return;
+	}
+
+	processReceivedData(reply);
+}
+
+void Downloader::processReceivedData(QNetworkReply* reply) {
+	// Data are moved from reply to output as they arrive, so that body
+	// is held in memory at most once and the limit is checked even if server
+	// does not announce the size or data are decompressed on the fly.
+	const QByteArray data = reply->readAll();
+
+	m_receivedBodySize += data.size();
+
+	if (m_maxBodySize > 0 && m_receivedBodySize > m_maxBodySize) {
+		qWarning("Download of '%s' is aborted, its size exceeds limit %lld B.",
+		         qPrintable(reply->url().toString()), m_maxBodySize);
+		rejectActiveReply(QNetworkReply::UnknownContentError);
+	}
+
+	else if (m_outputBuffered) {
+		m_lastOutputData.append(data);
+	}
+
+	else if (!data.isEmpty() && reply->error() == QNetworkReply::NoError &&
+	         reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() < 300) {
+		// Bodies of redirections, "not modified" replies and errors are not handed over.
+		emit dataReceived(data);
+	}
+}
+
+void Downloader::setActiveReply(QNetworkReply* reply) {
+	m_lastOutputData.clear();
+	m_receivedBodySize = 0;
+	m_rejectionError = QNetworkReply::NoError;
 	m_timer->start();
-	m_activeReply = m_downloadManager->deleteResource(request);
+	m_activeReply = reply;
 	m_activeReply->setProperty("protected", m_targetProtected);
 	m_activeReply->setProperty("username", m_targetUsername);
 	m_activeReply->setProperty("password", m_targetPassword);
 	connect(m_activeReply, &QNetworkReply::downloadProgress, this, &Downloader::progressInternal);
+	connect(m_activeReply, &QNetworkReply::metaDataChanged, this, &Downloader::metaDataChanged);
+	connect(m_activeReply, &QNetworkReply::readyRead, this, &Downloader::readyRead);
 	connect(m_activeReply, &QNetworkReply::finished, this, &Downloader::finished);
 }
 
+void Downloader::rejectActiveReply(QNetworkReply::NetworkError error) {
+	m_rejectionError = error;
+	m_lastOutputData.clear();
+	m_lastOutputData.squeeze();
+	m_activeReply->abort();
+}
+
+void Downloader::runDeleteRequest(const QNetworkRequest& request) {
+	setActiveReply(m_downloadManager->deleteResource(request));
+}
+
 void Downloader::runPutRequest(const QNetworkRequest& request, const QByteArray& data) {
-	m_timer->start();
-	m_activeReply = m_downloadManager->put(request, data);
-	m_activeReply->setProperty("protected", m_targetProtected);
-	m_activeReply->setProperty("username", m_targetUsername);
-	m_activeReply->setProperty("password", m_targetPassword);
-	connect(m_activeReply, &QNetworkReply::downloadProgress, this, &Downloader::progressInternal);
-	connect(m_activeReply, &QNetworkReply::finished, this, &Downloader::finished);
+	setActiveReply(m_downloadManager->put(request, data));
 }
 
 void Downloader::runPostRequest(const QNetworkRequest& request, const QByteArray& data) {
-	m_timer->start();
-	m_activeReply = m_downloadManager->post(request, data);
-	m_activeReply->setProperty("protected", m_targetProtected);
-	m_activeReply->setProperty("username", m_targetUsername);
-	m_activeReply->setProperty("password", m_targetPassword);
-	connect(m_activeReply, &QNetworkReply::downloadProgress, this, &Downloader::progressInternal);
-	connect(m_activeReply, &QNetworkReply::finished, this, &Downloader::finished);
+	setActiveReply(m_downloadManager->post(request, data));
 }
 
 void Downloader::runGetRequest(const QNetworkRequest& request) {
-	m_timer->start();
-	m_activeReply = m_downloadManager->get(request);
-	m_activeReply->setProperty("protected", m_targetProtected);
-	m_activeReply->setProperty("username", m_targetUsername);
-	m_activeReply->setProperty("password", m_targetPassword);
-	connect(m_activeReply, &QNetworkReply::downloadProgress, this, &Downloader::progressInternal);
-	connect(m_activeReply, &QNetworkReply::finished, this, &Downloader::finished);
+	setActiveReply(m_downloadManager->get(request));
 }
 
 QVariant Downloader::lastContentType() const {
 	return m_lastContentType;
 }
 
+int Downloader::lastHttpStatusCode() const {
+	return m_lastHttpStatusCode;
+}
+
+QByteArray Downloader::lastRawHeader(const QByteArray& name) const {
+	foreach (const QNetworkReply::RawHeaderPair& header, m_lastRawHeaders) {
+		// HTTP header names are case-insensitive.
+		if (qstricmp(header.first.constData(), name.constData()) == 0) {
+			return header.second;
+		}
+	}
+
+	return QByteArray();
+}
+
 void Downloader::cancel() {
 	if (m_activeReply != nullptr) {
 		// Download action timed-out, too slow connection or target is not reachable.
@@ -202,6 +322,18 @@ void Downloader::cancel() {
 	}
 }
 
+void Downloader::setMaximumBodySize(qint64 max_body_size) {
+	m_maxBodySize = max_body_size;
+}
+
+void Downloader::setOutputBuffered(bool buffered) {
+	m_outputBuffered = buffered;
+}
+
+void Downloader::setRejectedContentTypes(const QStringList& content_types) {
+	m_rejectedContentTypes = content_types;
+}
+
 void Downloader::appendRawHeader(const QByteArray& name, const QByteArray& value) {
 	if (!value.isEmpty()) {
 		m_customHeaders.insert(name, value);
@@ -24,6 +24,7 @@
 
 #include <QNetworkReply>
 #include <QSslError>
+#include <QStringList>
 
 
 class SilentNetworkAccessManager;
@@ -41,6 +42,24 @@ class Downloader : public QObject {
 		QByteArray lastOutputData() const;
 		QNetworkReply::NetworkError lastOutputError() const;
 		QVariant lastContentType() const;
+		int lastHttpStatusCode() const;
+
+		// Returns value of given header of last received reply
+		// or empty array if there is no such header.
+		QByteArray lastRawHeader(const QByteArray& name) const;
+
+		// Sets maximal size of received data in bytes, zero means "unlimited".
+		// Replies which exceed it are aborted as soon as it is known.
+		void setMaximumBodySize(qint64 max_body_size);
+
+		// By default, whole body is kept in memory and handed over once download
+		// finishes. Unbuffered body is handed over via dataReceived() as it arrives
+		// instead and lastOutputData() stays empty.
+		void setOutputBuffered(bool buffered);
+
+		// Replies of given content types are aborted before their body
+		// is received. Each item matches content types which start with it.
+		void setRejectedContentTypes(const QStringList& content_types);
 
 	public slots:
 		void cancel();
@@ -68,6 +87,9 @@ class Downloader : public QObject {
 		void progress(qint64 bytes_received, qint64 bytes_total);
 		void completed(QNetworkReply::NetworkError status, QByteArray contents = QByteArray());
 
+		// Emitted with next chunk of successfully received body if output is not buffered.
+		void dataReceived(const QByteArray& data);
+
 	private slots:
 		// Called when current reply is processed.
 		void finished();
@@ -75,7 +97,17 @@ class Downloader : public QObject {
 		// Called when progress of downloaded file changes.
 		void progressInternal(qint64 bytes_received, qint64 bytes_total);
 
+		// Check headers and incoming data of current reply against limits.
+		void metaDataChanged();
+		void readyRead();
+
 	private:
+		// Moves received data of current reply to output and checks their size.
+		void processReceivedData(QNetworkReply* reply);
+
+		void setActiveReply(QNetworkReply* reply);
+		void rejectActiveReply(QNetworkReply::NetworkError error);
+
 		void runDeleteRequest(const QNetworkRequest& request);
 		void runPutRequest(const QNetworkRequest& request, const QByteArray& data);
 		void runPostRequest(const QNetworkRequest& request, const QByteArray& data);
@@ -83,10 +115,15 @@ class Downloader : public QObject {
 
 	private:
 		QNetworkReply* m_activeReply;
-		QScopedPointer<SilentNetworkAccessManager> m_downloadManager;
+		SilentNetworkAccessManager* m_downloadManager;
 		QTimer* m_timer;
 		QHash<QByteArray, QByteArray> m_customHeaders;
 		QByteArray m_inputData;
+		qint64 m_maxBodySize;
+		qint64 m_receivedBodySize;
+		bool m_outputBuffered;
+		QStringList m_rejectedContentTypes;
+		QNetworkReply::NetworkError m_rejectionError;
 
 		bool m_targetProtected;
 		QString m_targetUsername;
@@ -96,6 +133,8 @@ class Downloader : public QObject {
 		QByteArray m_lastOutputData;
 		QNetworkReply::NetworkError m_lastOutputError;
 		QVariant m_lastContentType;
+		int m_lastHttpStatusCode;
+		QList<QNetworkReply::RawHeaderPair> m_lastRawHeaders;
 };
 
 #endif // DOWNLOADER_H
@@ -0,0 +1,2404 @@
+// This file is part of RSS Guard.
+//
+// Copyright (C) 2011-2017 by Martin Rotter <rotter.martinos@gmail.com>
+//
+// RSS Guard is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// RSS Guard is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with RSS Guard. If not, see <http://www.gnu.org/licenses/>.
+
+#include "network-web/htmlentities.h"
+
+#include "definitions/definitions.h"
+
+#include <cstring>
+
+
+namespace {
+	struct HtmlEntity {
+		const char* m_name;
+		uint m_codePoints[2];
+	};
+
+	// Longest name of HTML5 named character reference.
+	const int MAX_ENTITY_NAME_LENGTH = 31;
+
+	// Replacements of numeric references to C1 control characters, as defined by HTML5.
+	const ushort C1_REPLACEMENTS[32] = {
+		0x20AC, 0x0081, 0x201A, 0x0192, 0x201E, 0x2026, 0x2020, 0x2021,
+		0x02C6, 0x2030, 0x0160, 0x2039, 0x0152, 0x008D, 0x017D, 0x008F,
+		0x0090, 0x2018, 0x2019, 0x201C, 0x201D, 0x2022, 0x2013, 0x2014,
+		0x02DC, 0x2122, 0x0161, 0x203A, 0x0153, 0x009D, 0x017E, 0x0178
+	};
+
+	// All HTML5 named character references terminated with ";", sorted by name.
+	// NOTE: https://html.spec.whatwg.org/multipage/named-characters.html
+	const HtmlEntity ENTITIES[] = {
+	{"AElig", {0x000C6, 0x00000}},
+	{"AMP", {0x00026, 0x00000}},
+	{"Aacute", {0x000C1, 0x00000}},
+	{"Abreve", {0x00102, 0x00000}},
+	{"Acirc", {0x000C2, 0x00000}},
+	{"Acy", {0x00410, 0x00000}},
+	{"Afr", {0x1D504, 0x00000}},
+	{"Agrave", {0x000C0, 0x00000}},
+	{"Alpha", {0x00391, 0x00000}},
+	{"Amacr", {0x00100, 0x00000}},
+	{"And", {0x02A53, 0x00000}},
+	{"Aogon", {0x00104, 0x00000}},
+	{"Aopf", {0x1D538, 0x00000}},
+	{"ApplyFunction", {0x02061, 0x00000}},
+	{"Aring", {0x000C5, 0x00000}},
+	{"Ascr", {0x1D49C, 0x00000}},
+	{"Assign", {0x02254, 0x00000}},
+	{"Atilde", {0x000C3, 0x00000}},
+	{"Auml", {0x000C4, 0x00000}},
+	{"Backslash", {0x02216, 0x00000}},
+	{"Barv", {0x02AE7, 0x00000}},
+	{"Barwed", {0x02306, 0x00000}},
+	{"Bcy", {0x00411, 0x00000}},
+	{"Because", {0x02235, 0x00000}},
+	{"Bernoullis", {0x0212C, 0x00000}},
+	{"Beta", {0x00392, 0x00000}},
+	{"Bfr", {0x1D505, 0x00000}},
+	{"Bopf", {0x1D539, 0x00000}},
+	{"Breve", {0x002D8, 0x00000}},
+	{"Bscr", {0x0212C, 0x00000}},
+	{"Bumpeq", {0x0224E, 0x00000}},
+	{"CHcy", {0x00427, 0x00000}},
+	{"COPY", {0x000A9, 0x00000}},
+	{"Cacute", {0x00106, 0x00000}},
+	{"Cap", {0x022D2, 0x00000}},
+	{"CapitalDifferentialD", {0x02145, 0x00000}},
+	{"Cayleys", {0x0212D, 0x00000}},
+	{"Ccaron", {0x0010C, 0x00000}},
+	{"Ccedil", {0x000C7, 0x00000}},
+	{"Ccirc", {0x00108, 0x00000}},
+	{"Cconint", {0x02230, 0x00000}},
+	{"Cdot", {0x0010A, 0x00000}},
+	{"Cedilla", {0x000B8, 0x00000}},
+	{"CenterDot", {0x000B7, 0x00000}},
+	{"Cfr", {0x0212D, 0x00000}},
+	{"Chi", {0x003A7, 0x00000}},
+	{"CircleDot", {0x02299, 0x00000}},
+	{"CircleMinus", {0x02296, 0x00000}},
+	{"CirclePlus", {0x02295, 0x00000}},
+	{"CircleTimes", {0x02297, 0x00000}},
+	{"ClockwiseContourIntegral", {0x02232, 0x00000}},
+	{"CloseCurlyDoubleQuote", {0x0201D, 0x00000}},
+	{"CloseCurlyQuote", {0x02019, 0x00000}},
+	{"Colon", {0x02237, 0x00000}},
+	{"Colone", {0x02A74, 0x00000}},
+	{"Congruent", {0x02261, 0x00000}},
+	{"Conint", {0x0222F, 0x00000}},
+	{"ContourIntegral", {0x0222E, 0x00000}},
+	{"Copf", {0x02102, 0x00000}},
+	{"Coproduct", {0x02210, 0x00000}},
+	{"CounterClockwiseContourIntegral", {0x02233, 0x00000}},
+	{"Cross", {0x02A2F, 0x00000}},
+	{"Cscr", {0x1D49E, 0x00000}},
+	{"Cup", {0x022D3, 0x00000}},
+	{"CupCap", {0x0224D, 0x00000}},
+	{"DD", {0x02145, 0x00000}},
+	{"DDotrahd", {0x02911, 0x00000}},
+	{"DJcy", {0x00402, 0x00000}},
+	{"DScy", {0x00405, 0x00000}},
+	{"DZcy", {0x0040F, 0x00000}},
+	{"Dagger", {0x02021, 0x00000}},
+	{"Darr", {0x021A1, 0x00000}},
+	{"Dashv", {0x02AE4, 0x00000}},
+	{"Dcaron", {0x0010E, 0x00000}},
+	{"Dcy", {0x00414, 0x00000}},
+	{"Del", {0x02207, 0x00000}},
+	{"Delta", {0x00394, 0x00000}},
+	{"Dfr", {0x1D507, 0x00000}},
+	{"DiacriticalAcute", {0x000B4, 0x00000}},
+	{"DiacriticalDot", {0x002D9, 0x00000}},
+	{"DiacriticalDoubleAcute", {0x002DD, 0x00000}},
+	{"DiacriticalGrave", {0x00060, 0x00000}},
+	{"DiacriticalTilde", {0x002DC, 0x00000}},
+	{"Diamond", {0x022C4, 0x00000}},
+	{"DifferentialD", {0x02146, 0x00000}},
+	{"Dopf", {0x1D53B, 0x00000}},
+	{"Dot", {0x000A8, 0x00000}},
+	{"DotDot", {0x020DC, 0x00000}},
+	{"DotEqual", {0x02250, 0x00000}},
+	{"DoubleContourIntegral", {0x0222F, 0x00000}},
+	{"DoubleDot", {0x000A8, 0x00000}},
+	{"DoubleDownArrow", {0x021D3, 0x00000}},
+	{"DoubleLeftArrow", {0x021D0, 0x00000}},
+	{"DoubleLeftRightArrow", {0x021D4, 0x00000}},
+	{"DoubleLeftTee", {0x02AE4, 0x00000}},
+	{"DoubleLongLeftArrow", {0x027F8, 0x00000}},
+	{"DoubleLongLeftRightArrow", {0x027FA, 0x00000}},
+	{"DoubleLongRightArrow", {0x027F9, 0x00000}},
+	{"DoubleRightArrow", {0x021D2, 0x00000}},
+	{"DoubleRightTee", {0x022A8, 0x00000}},
+	{"DoubleUpArrow", {0x021D1, 0x00000}},
+	{"DoubleUpDownArrow", {0x021D5, 0x00000}},
+	{"DoubleVerticalBar", {0x02225, 0x00000}},
+	{"DownArrow", {0x02193, 0x00000}},
+	{"DownArrowBar", {0x02913, 0x00000}},
+	{"DownArrowUpArrow", {0x021F5, 0x00000}},
+	{"DownBreve", {0x00311, 0x00000}},
+	{"DownLeftRightVector", {0x02950, 0x00000}},
+	{"DownLeftTeeVector", {0x0295E, 0x00000}},
+	{"DownLeftVector", {0x021BD, 0x00000}},
+	{"DownLeftVectorBar", {0x02956, 0x00000}},
+	{"DownRightTeeVector", {0x0295F, 0x00000}},
+	{"DownRightVector", {0x021C1, 0x00000}},
+	{"DownRightVectorBar", {0x02957, 0x00000}},
+	{"DownTee", {0x022A4, 0x00000}},
+	{"DownTeeArrow", {0x021A7, 0x00000}},
+	{"Downarrow", {0x021D3, 0x00000}},
+	{"Dscr", {0x1D49F, 0x00000}},
+	{"Dstrok", {0x00110, 0x00000}},
+	{"ENG", {0x0014A, 0x00000}},
+	{"ETH", {0x000D0, 0x00000}},
+	{"Eacute", {0x000C9, 0x00000}},
+	{"Ecaron", {0x0011A, 0x00000}},
+	{"Ecirc", {0x000CA, 0x00000}},
+	{"Ecy", {0x0042D, 0x00000}},
+	{"Edot", {0x00116, 0x00000}},
+	{"Efr", {0x1D508, 0x00000}},
+	{"Egrave", {0x000C8, 0x00000}},
+	{"Element", {0x02208, 0x00000}},
+	{"Emacr", {0x00112, 0x00000}},
+	{"EmptySmallSquare", {0x025FB, 0x00000}},
+	{"EmptyVerySmallSquare", {0x025AB, 0x00000}},
+	{"Eogon", {0x00118, 0x00000}},
+	{"Eopf", {0x1D53C, 0x00000}},
+	{"Epsilon", {0x00395, 0x00000}},
+	{"Equal", {0x02A75, 0x00000}},
+	{"EqualTilde", {0x02242, 0x00000}},
+	{"Equilibrium", {0x021CC, 0x00000}},
+	{"Escr", {0x02130, 0x00000}},
+	{"Esim", {0x02A73, 0x00000}},
+	{"Eta", {0x00397, 0x00000}},
+	{"Euml", {0x000CB, 0x00000}},
+	{"Exists", {0x02203, 0x00000}},
+	{"ExponentialE", {0x02147, 0x00000}},
+	{"Fcy", {0x00424, 0x00000}},
+	{"Ffr", {0x1D509, 0x00000}},
+	{"FilledSmallSquare", {0x025FC, 0x00000}},
+	{"FilledVerySmallSquare", {0x025AA, 0x00000}},
+	{"Fopf", {0x1D53D, 0x00000}},
+	{"ForAll", {0x02200, 0x00000}},
+	{"Fouriertrf", {0x02131, 0x00000}},
+	{"Fscr", {0x02131, 0x00000}},
+	{"GJcy", {0x00403, 0x00000}},
+	{"GT", {0x0003E, 0x00000}},
+	{"Gamma", {0x00393, 0x00000}},
+	{"Gammad", {0x003DC, 0x00000}},
+	{"Gbreve", {0x0011E, 0x00000}},
+	{"Gcedil", {0x00122, 0x00000}},
+	{"Gcirc", {0x0011C, 0x00000}},
+	{"Gcy", {0x00413, 0x00000}},
+	{"Gdot", {0x00120, 0x00000}},
+	{"Gfr", {0x1D50A, 0x00000}},
+	{"Gg", {0x022D9, 0x00000}},
+	{"Gopf", {0x1D53E, 0x00000}},
+	{"GreaterEqual", {0x02265, 0x00000}},
+	{"GreaterEqualLess", {0x022DB, 0x00000}},
+	{"GreaterFullEqual", {0x02267, 0x00000}},
+	{"GreaterGreater", {0x02AA2, 0x00000}},
+	{"GreaterLess", {0x02277, 0x00000}},
+	{"GreaterSlantEqual", {0x02A7E, 0x00000}},
+	{"GreaterTilde", {0x02273, 0x00000}},
+	{"Gscr", {0x1D4A2, 0x00000}},
+	{"Gt", {0x0226B, 0x00000}},
+	{"HARDcy", {0x0042A, 0x00000}},
+	{"Hacek", {0x002C7, 0x00000}},
+	{"Hat", {0x0005E, 0x00000}},
+	{"Hcirc", {0x00124, 0x00000}},
+	{"Hfr", {0x0210C, 0x00000}},
+	{"HilbertSpace", {0x0210B, 0x00000}},
+	{"Hopf", {0x0210D, 0x00000}},
+	{"HorizontalLine", {0x02500, 0x00000}},
+	{"Hscr", {0x0210B, 0x00000}},
+	{"Hstrok", {0x00126, 0x00000}},
+	{"HumpDownHump", {0x0224E, 0x00000}},
+	{"HumpEqual", {0x0224F, 0x00000}},
+	{"IEcy", {0x00415, 0x00000}},
+	{"IJlig", {0x00132, 0x00000}},
+	{"IOcy", {0x00401, 0x00000}},
+	{"Iacute", {0x000CD, 0x00000}},
+	{"Icirc", {0x000CE, 0x00000}},
+	{"Icy", {0x00418, 0x00000}},
+	{"Idot", {0x00130, 0x00000}},
+	{"Ifr", {0x02111, 0x00000}},
+	{"Igrave", {0x000CC, 0x00000}},
+	{"Im", {0x02111, 0x00000}},
+	{"Imacr", {0x0012A, 0x00000}},
+	{"ImaginaryI", {0x02148, 0x00000}},
+	{"Implies", {0x021D2, 0x00000}},
+	{"Int", {0x0222C, 0x00000}},
+	{"Integral", {0x0222B, 0x00000}},
+	{"Intersection", {0x022C2, 0x00000}},
+	{"InvisibleComma", {0x02063, 0x00000}},
+	{"InvisibleTimes", {0x02062, 0x00000}},
+	{"Iogon", {0x0012E, 0x00000}},
+	{"Iopf", {0x1D540, 0x00000}},
+	{"Iota", {0x00399, 0x00000}},
+	{"Iscr", {0x02110, 0x00000}},
+	{"Itilde", {0x00128, 0x00000}},
+	{"Iukcy", {0x00406, 0x00000}},
+	{"Iuml", {0x000CF, 0x00000}},
+	{"Jcirc", {0x00134, 0x00000}},
+	{"Jcy", {0x00419, 0x00000}},
+	{"Jfr", {0x1D50D, 0x00000}},
+	{"Jopf", {0x1D541, 0x00000}},
+	{"Jscr", {0x1D4A5, 0x00000}},
+	{"Jsercy", {0x00408, 0x00000}},
+	{"Jukcy", {0x00404, 0x00000}},
+	{"KHcy", {0x00425, 0x00000}},
+	{"KJcy", {0x0040C, 0x00000}},
+	{"Kappa", {0x0039A, 0x00000}},
+	{"Kcedil", {0x00136, 0x00000}},
+	{"Kcy", {0x0041A, 0x00000}},
+	{"Kfr", {0x1D50E, 0x00000}},
+	{"Kopf", {0x1D542, 0x00000}},
+	{"Kscr", {0x1D4A6, 0x00000}},
+	{"LJcy", {0x00409, 0x00000}},
+	{"LT", {0x0003C, 0x00000}},
+	{"Lacute", {0x00139, 0x00000}},
+	{"Lambda", {0x0039B, 0x00000}},
+	{"Lang", {0x027EA, 0x00000}},
+	{"Laplacetrf", {0x02112, 0x00000}},
+	{"Larr", {0x0219E, 0x00000}},
+	{"Lcaron", {0x0013D, 0x00000}},
+	{"Lcedil", {0x0013B, 0x00000}},
+	{"Lcy", {0x0041B, 0x00000}},
+	{"LeftAngleBracket", {0x027E8, 0x00000}},
+	{"LeftArrow", {0x02190, 0x00000}},
+	{"LeftArrowBar", {0x021E4, 0x00000}},
+	{"LeftArrowRightArrow", {0x021C6, 0x00000}},
+	{"LeftCeiling", {0x02308, 0x00000}},
+	{"LeftDoubleBracket", {0x027E6, 0x00000}},
+	{"LeftDownTeeVector", {0x02961, 0x00000}},
+	{"LeftDownVector", {0x021C3, 0x00000}},
+	{"LeftDownVectorBar", {0x02959, 0x00000}},
+	{"LeftFloor", {0x0230A, 0x00000}},
+	{"LeftRightArrow", {0x02194, 0x00000}},
+	{"LeftRightVector", {0x0294E, 0x00000}},
+	{"LeftTee", {0x022A3, 0x00000}},
+	{"LeftTeeArrow", {0x021A4, 0x00000}},
+	{"LeftTeeVector", {0x0295A, 0x00000}},
+	{"LeftTriangle", {0x022B2, 0x00000}},
+	{"LeftTriangleBar", {0x029CF, 0x00000}},
+	{"LeftTriangleEqual", {0x022B4, 0x00000}},
+	{"LeftUpDownVector", {0x02951, 0x00000}},
+	{"LeftUpTeeVector", {0x02960, 0x00000}},
+	{"LeftUpVector", {0x021BF, 0x00000}},
+	{"LeftUpVectorBar", {0x02958, 0x00000}},
+	{"LeftVector", {0x021BC, 0x00000}},
+	{"LeftVectorBar", {0x02952, 0x00000}},
+	{"Leftarrow", {0x021D0, 0x00000}},
+	{"Leftrightarrow", {0x021D4, 0x00000}},
+	{"LessEqualGreater", {0x022DA, 0x00000}},
+	{"LessFullEqual", {0x02266, 0x00000}},
+	{"LessGreater", {0x02276, 0x00000}},
+	{"LessLess", {0x02AA1, 0x00000}},
+	{"LessSlantEqual", {0x02A7D, 0x00000}},
+	{"LessTilde", {0x02272, 0x00000}},
+	{"Lfr", {0x1D50F, 0x00000}},
+	{"Ll", {0x022D8, 0x00000}},
+	{"Lleftarrow", {0x021DA, 0x00000}},
+	{"Lmidot", {0x0013F, 0x00000}},
+	{"LongLeftArrow", {0x027F5, 0x00000}},
+	{"LongLeftRightArrow", {0x027F7, 0x00000}},
+	{"LongRightArrow", {0x027F6, 0x00000}},
+	{"Longleftarrow", {0x027F8, 0x00000}},
+	{"Longleftrightarrow", {0x027FA, 0x00000}},
+	{"Longrightarrow", {0x027F9, 0x00000}},
+	{"Lopf", {0x1D543, 0x00000}},
+	{"LowerLeftArrow", {0x02199, 0x00000}},
+	{"LowerRightArrow", {0x02198, 0x00000}},
+	{"Lscr", {0x02112, 0x00000}},
+	{"Lsh", {0x021B0, 0x00000}},
+	{"Lstrok", {0x00141, 0x00000}},
+	{"Lt", {0x0226A, 0x00000}},
+	{"Map", {0x02905, 0x00000}},
+	{"Mcy", {0x0041C, 0x00000}},
+	{"MediumSpace", {0x0205F, 0x00000}},
+	{"Mellintrf", {0x02133, 0x00000}},
+	{"Mfr", {0x1D510, 0x00000}},
+	{"MinusPlus", {0x02213, 0x00000}},
+	{"Mopf", {0x1D544, 0x00000}},
+	{"Mscr", {0x02133, 0x00000}},
+	{"Mu", {0x0039C, 0x00000}},
+	{"NJcy", {0x0040A, 0x00000}},
+	{"Nacute", {0x00143, 0x00000}},
+	{"Ncaron", {0x00147, 0x00000}},
+	{"Ncedil", {0x00145, 0x00000}},
+	{"Ncy", {0x0041D, 0x00000}},
+	{"NegativeMediumSpace", {0x0200B, 0x00000}},
+	{"NegativeThickSpace", {0x0200B, 0x00000}},
+	{"NegativeThinSpace", {0x0200B, 0x00000}},
+	{"NegativeVeryThinSpace", {0x0200B, 0x00000}},
+	{"NestedGreaterGreater", {0x0226B, 0x00000}},
+	{"NestedLessLess", {0x0226A, 0x00000}},
+	{"NewLine", {0x0000A, 0x00000}},
+	{"Nfr", {0x1D511, 0x00000}},
+	{"NoBreak", {0x02060, 0x00000}},
+	{"NonBreakingSpace", {0x000A0, 0x00000}},
+	{"Nopf", {0x02115, 0x00000}},
+	{"Not", {0x02AEC, 0x00000}},
+	{"NotCongruent", {0x02262, 0x00000}},
+	{"NotCupCap", {0x0226D, 0x00000}},
+	{"NotDoubleVerticalBar", {0x02226, 0x00000}},
+	{"NotElement", {0x02209, 0x00000}},
+	{"NotEqual", {0x02260, 0x00000}},
+	{"NotEqualTilde", {0x02242, 0x00338}},
+	{"NotExists", {0x02204, 0x00000}},
+	{"NotGreater", {0x0226F, 0x00000}},
+	{"NotGreaterEqual", {0x02271, 0x00000}},
+	{"NotGreaterFullEqual", {0x02267, 0x00338}},
+	{"NotGreaterGreater", {0x0226B, 0x00338}},
+	{"NotGreaterLess", {0x02279, 0x00000}},
+	{"NotGreaterSlantEqual", {0x02A7E, 0x00338}},
+	{"NotGreaterTilde", {0x02275, 0x00000}},
+	{"NotHumpDownHump", {0x0224E, 0x00338}},
+	{"NotHumpEqual", {0x0224F, 0x00338}},
+	{"NotLeftTriangle", {0x022EA, 0x00000}},
+	{"NotLeftTriangleBar", {0x029CF, 0x00338}},
+	{"NotLeftTriangleEqual", {0x022EC, 0x00000}},
+	{"NotLess", {0x0226E, 0x00000}},
+	{"NotLessEqual", {0x02270, 0x00000}},
+	{"NotLessGreater", {0x02278, 0x00000}},
+	{"NotLessLess", {0x0226A, 0x00338}},
+	{"NotLessSlantEqual", {0x02A7D, 0x00338}},
+	{"NotLessTilde", {0x02274, 0x00000}},
+	{"NotNestedGreaterGreater", {0x02AA2, 0x00338}},
+	{"NotNestedLessLess", {0x02AA1, 0x00338}},
+	{"NotPrecedes", {0x02280, 0x00000}},
+	{"NotPrecedesEqual", {0x02AAF, 0x00338}},
+	{"NotPrecedesSlantEqual", {0x022E0, 0x00000}},
+	{"NotReverseElement", {0x0220C, 0x00000}},
+	{"NotRightTriangle", {0x022EB, 0x00000}},
+	{"NotRightTriangleBar", {0x029D0, 0x00338}},
+	{"NotRightTriangleEqual", {0x022ED, 0x00000}},
+	{"NotSquareSubset", {0x0228F, 0x00338}},
+	{"NotSquareSubsetEqual", {0x022E2, 0x00000}},
+	{"NotSquareSuperset", {0x02290, 0x00338}},
+	{"NotSquareSupersetEqual", {0x022E3, 0x00000}},
+	{"NotSubset", {0x02282, 0x020D2}},
+	{"NotSubsetEqual", {0x02288, 0x00000}},
+	{"NotSucceeds", {0x02281, 0x00000}},
+	{"NotSucceedsEqual", {0x02AB0, 0x00338}},
+	{"NotSucceedsSlantEqual", {0x022E1, 0x00000}},
+	{"NotSucceedsTilde", {0x0227F, 0x00338}},
+	{"NotSuperset", {0x02283, 0x020D2}},
+	{"NotSupersetEqual", {0x02289, 0x00000}},
+	{"NotTilde", {0x02241, 0x00000}},
+	{"NotTildeEqual", {0x02244, 0x00000}},
+	{"NotTildeFullEqual", {0x02247, 0x00000}},
+	{"NotTildeTilde", {0x02249, 0x00000}},
+	{"NotVerticalBar", {0x02224, 0x00000}},
+	{"Nscr", {0x1D4A9, 0x00000}},
+	{"Ntilde", {0x000D1, 0x00000}},
+	{"Nu", {0x0039D, 0x00000}},
+	{"OElig", {0x00152, 0x00000}},
+	{"Oacute", {0x000D3, 0x00000}},
+	{"Ocirc", {0x000D4, 0x00000}},
+	{"Ocy", {0x0041E, 0x00000}},
+	{"Odblac", {0x00150, 0x00000}},
+	{"Ofr", {0x1D512, 0x00000}},
+	{"Ograve", {0x000D2, 0x00000}},
+	{"Omacr", {0x0014C, 0x00000}},
+	{"Omega", {0x003A9, 0x00000}},
+	{"Omicron", {0x0039F, 0x00000}},
+	{"Oopf", {0x1D546, 0x00000}},
+	{"OpenCurlyDoubleQuote", {0x0201C, 0x00000}},
+	{"OpenCurlyQuote", {0x02018, 0x00000}},
+	{"Or", {0x02A54, 0x00000}},
+	{"Oscr", {0x1D4AA, 0x00000}},
+	{"Oslash", {0x000D8, 0x00000}},
+	{"Otilde", {0x000D5, 0x00000}},
+	{"Otimes", {0x02A37, 0x00000}},
+	{"Ouml", {0x000D6, 0x00000}},
+	{"OverBar", {0x0203E, 0x00000}},
+	{"OverBrace", {0x023DE, 0x00000}},
+	{"OverBracket", {0x023B4, 0x00000}},
+	{"OverParenthesis", {0x023DC, 0x00000}},
+	{"PartialD", {0x02202, 0x00000}},
+	{"Pcy", {0x0041F, 0x00000}},
+	{"Pfr", {0x1D513, 0x00000}},
+	{"Phi", {0x003A6, 0x00000}},
+	{"Pi", {0x003A0, 0x00000}},
+	{"PlusMinus", {0x000B1, 0x00000}},
+	{"Poincareplane", {0x0210C, 0x00000}},
+	{"Popf", {0x02119, 0x00000}},
+	{"Pr", {0x02ABB, 0x00000}},
+	{"Precedes", {0x0227A, 0x00000}},
+	{"PrecedesEqual", {0x02AAF, 0x00000}},
+	{"PrecedesSlantEqual", {0x0227C, 0x00000}},
+	{"PrecedesTilde", {0x0227E, 0x00000}},
+	{"Prime", {0x02033, 0x00000}},
+	{"Product", {0x0220F, 0x00000}},
+	{"Proportion", {0x02237, 0x00000}},
+	{"Proportional", {0x0221D, 0x00000}},
+	{"Pscr", {0x1D4AB, 0x00000}},
+	{"Psi", {0x003A8, 0x00000}},
+	{"QUOT", {0x00022, 0x00000}},
+	{"Qfr", {0x1D514, 0x00000}},
+	{"Qopf", {0x0211A, 0x00000}},
+	{"Qscr", {0x1D4AC, 0x00000}},
+	{"RBarr", {0x02910, 0x00000}},
+	{"REG", {0x000AE, 0x00000}},
+	{"Racute", {0x00154, 0x00000}},
+	{"Rang", {0x027EB, 0x00000}},
+	{"Rarr", {0x021A0, 0x00000}},
+	{"Rarrtl", {0x02916, 0x00000}},
+	{"Rcaron", {0x00158, 0x00000}},
+	{"Rcedil", {0x00156, 0x00000}},
+	{"Rcy", {0x00420, 0x00000}},
+	{"Re", {0x0211C, 0x00000}},
+	{"ReverseElement", {0x0220B, 0x00000}},
+	{"ReverseEquilibrium", {0x021CB, 0x00000}},
+	{"ReverseUpEquilibrium", {0x0296F, 0x00000}},
+	{"Rfr", {0x0211C, 0x00000}},
+	{"Rho", {0x003A1, 0x00000}},
+	{"RightAngleBracket", {0x027E9, 0x00000}},
+	{"RightArrow", {0x02192, 0x00000}},
+	{"RightArrowBar", {0x021E5, 0x00000}},
+	{"RightArrowLeftArrow", {0x021C4, 0x00000}},
+	{"RightCeiling", {0x02309, 0x00000}},
+	{"RightDoubleBracket", {0x027E7, 0x00000}},
+	{"RightDownTeeVector", {0x0295D, 0x00000}},
+	{"RightDownVector", {0x021C2, 0x00000}},
+	{"RightDownVectorBar", {0x02955, 0x00000}},
+	{"RightFloor", {0x0230B, 0x00000}},
+	{"RightTee", {0x022A2, 0x00000}},
+	{"RightTeeArrow", {0x021A6, 0x00000}},
+	{"RightTeeVector", {0x0295B, 0x00000}},
+	{"RightTriangle", {0x022B3, 0x00000}},
+	{"RightTriangleBar", {0x029D0, 0x00000}},
+	{"RightTriangleEqual", {0x022B5, 0x00000}},
+	{"RightUpDownVector", {0x0294F, 0x00000}},
+	{"RightUpTeeVector", {0x0295C, 0x00000}},
+	{"RightUpVector", {0x021BE, 0x00000}},
+	{"RightUpVectorBar", {0x02954, 0x00000}},
+	{"RightVector", {0x021C0, 0x00000}},
+	{"RightVectorBar", {0x02953, 0x00000}},
+	{"Rightarrow", {0x021D2, 0x00000}},
+	{"Ropf", {0x0211D, 0x00000}},
+	{"RoundImplies", {0x02970, 0x00000}},
+	{"Rrightarrow", {0x021DB, 0x00000}},
+	{"Rscr", {0x0211B, 0x00000}},
+	{"Rsh", {0x021B1, 0x00000}},
+	{"RuleDelayed", {0x029F4, 0x00000}},
+	{"SHCHcy", {0x00429, 0x00000}},
+	{"SHcy", {0x00428, 0x00000}},
+	{"SOFTcy", {0x0042C, 0x00000}},
+	{"Sacute", {0x0015A, 0x00000}},
+	{"Sc", {0x02ABC, 0x00000}},
+	{"Scaron", {0x00160, 0x00000}},
+	{"Scedil", {0x0015E, 0x00000}},
+	{"Scirc", {0x0015C, 0x00000}},
+	{"Scy", {0x00421, 0x00000}},
+	{"Sfr", {0x1D516, 0x00000}},
+	{"ShortDownArrow", {0x02193, 0x00000}},
+	{"ShortLeftArrow", {0x02190, 0x00000}},
+	{"ShortRightArrow", {0x02192, 0x00000}},
+	{"ShortUpArrow", {0x02191, 0x00000}},
+	{"Sigma", {0x003A3, 0x00000}},
+	{"SmallCircle", {0x02218, 0x00000}},
+	{"Sopf", {0x1D54A, 0x00000}},
+	{"Sqrt", {0x0221A, 0x00000}},
+	{"Square", {0x025A1, 0x00000}},
+	{"SquareIntersection", {0x02293, 0x00000}},
+	{"SquareSubset", {0x0228F, 0x00000}},
+	{"SquareSubsetEqual", {0x02291, 0x00000}},
+	{"SquareSuperset", {0x02290, 0x00000}},
+	{"SquareSupersetEqual", {0x02292, 0x00000}},
+	{"SquareUnion", {0x02294, 0x00000}},
+	{"Sscr", {0x1D4AE, 0x00000}},
+	{"Star", {0x022C6, 0x00000}},
+	{"Sub", {0x022D0, 0x00000}},
+	{"Subset", {0x022D0, 0x00000}},
+	{"SubsetEqual", {0x02286, 0x00000}},
+	{"Succeeds", {0x0227B, 0x00000}},
+	{"SucceedsEqual", {0x02AB0, 0x00000}},
+	{"SucceedsSlantEqual", {0x0227D, 0x00000}},
+	{"SucceedsTilde", {0x0227F, 0x00000}},
+	{"SuchThat", {0x0220B, 0x00000}},
+	{"Sum", {0x02211, 0x00000}},
+	{"Sup", {0x022D1, 0x00000}},
+	{"Superset", {0x02283, 0x00000}},
+	{"SupersetEqual", {0x02287, 0x00000}},
+	{"Supset", {0x022D1, 0x00000}},
+	{"THORN", {0x000DE, 0x00000}},
+	{"TRADE", {0x02122, 0x00000}},
+	{"TSHcy", {0x0040B, 0x00000}},
+	{"TScy", {0x00426, 0x00000}},
+	{"Tab", {0x00009, 0x00000}},
+	{"Tau", {0x003A4, 0x00000}},
+	{"Tcaron", {0x00164, 0x00000}},
+	{"Tcedil", {0x00162, 0x00000}},
+	{"Tcy", {0x00422, 0x00000}},
+	{"Tfr", {0x1D517, 0x00000}},
+	{"Therefore", {0x02234, 0x00000}},
+	{"Theta", {0x00398, 0x00000}},
+	{"ThickSpace", {0x0205F, 0x0200A}},
+	{"ThinSpace", {0x02009, 0x00000}},
+	{"Tilde", {0x0223C, 0x00000}},
+	{"TildeEqual", {0x02243, 0x00000}},
+	{"TildeFullEqual", {0x02245, 0x00000}},
+	{"TildeTilde", {0x02248, 0x00000}},
+	{"Topf", {0x1D54B, 0x00000}},
+	{"TripleDot", {0x020DB, 0x00000}},
+	{"Tscr", {0x1D4AF, 0x00000}},
+	{"Tstrok", {0x00166, 0x00000}},
+	{"Uacute", {0x000DA, 0x00000}},
+	{"Uarr", {0x0219F, 0x00000}},
+	{"Uarrocir", {0x02949, 0x00000}},
+	{"Ubrcy", {0x0040E, 0x00000}},
+	{"Ubreve", {0x0016C, 0x00000}},
+	{"Ucirc", {0x000DB, 0x00000}},
+	{"Ucy", {0x00423, 0x00000}},
+	{"Udblac", {0x00170, 0x00000}},
+	{"Ufr", {0x1D518, 0x00000}},
+	{"Ugrave", {0x000D9, 0x00000}},
+	{"Umacr", {0x0016A, 0x00000}},
+	{"UnderBar", {0x0005F, 0x00000}},
+	{"UnderBrace", {0x023DF, 0x00000}},
+	{"UnderBracket", {0x023B5, 0x00000}},
+	{"UnderParenthesis", {0x023DD, 0x00000}},
+	{"Union", {0x022C3, 0x00000}},
+	{"UnionPlus", {0x0228E, 0x00000}},
+	{"Uogon", {0x00172, 0x00000}},
+	{"Uopf", {0x1D54C, 0x00000}},
+	{"UpArrow", {0x02191, 0x00000}},
+	{"UpArrowBar", {0x02912, 0x00000}},
+	{"UpArrowDownArrow", {0x021C5, 0x00000}},
+	{"UpDownArrow", {0x02195, 0x00000}},
+	{"UpEquilibrium", {0x0296E, 0x00000}},
+	{"UpTee", {0x022A5, 0x00000}},
+	{"UpTeeArrow", {0x021A5, 0x00000}},
+	{"Uparrow", {0x021D1, 0x00000}},
+	{"Updownarrow", {0x021D5, 0x00000}},
+	{"UpperLeftArrow", {0x02196, 0x00000}},
+	{"UpperRightArrow", {0x02197, 0x00000}},
+	{"Upsi", {0x003D2, 0x00000}},
+	{"Upsilon", {0x003A5, 0x00000}},
+	{"Uring", {0x0016E, 0x00000}},
+	{"Uscr", {0x1D4B0, 0x00000}},
+	{"Utilde", {0x00168, 0x00000}},
+	{"Uuml", {0x000DC, 0x00000}},
+	{"VDash", {0x022AB, 0x00000}},
+	{"Vbar", {0x02AEB, 0x00000}},
+	{"Vcy", {0x00412, 0x00000}},
+	{"Vdash", {0x022A9, 0x00000}},
+	{"Vdashl", {0x02AE6, 0x00000}},
+	{"Vee", {0x022C1, 0x00000}},
+	{"Verbar", {0x02016, 0x00000}},
+	{"Vert", {0x02016, 0x00000}},
+	{"VerticalBar", {0x02223, 0x00000}},
+	{"VerticalLine", {0x0007C, 0x00000}},
+	{"VerticalSeparator", {0x02758, 0x00000}},
+	{"VerticalTilde", {0x02240, 0x00000}},
+	{"VeryThinSpace", {0x0200A, 0x00000}},
+	{"Vfr", {0x1D519, 0x00000}},
+	{"Vopf", {0x1D54D, 0x00000}},
+	{"Vscr", {0x1D4B1, 0x00000}},
+	{"Vvdash", {0x022AA, 0x00000}},
+	{"Wcirc", {0x00174, 0x00000}},
+	{"Wedge", {0x022C0, 0x00000}},
+	{"Wfr", {0x1D51A, 0x00000}},
+	{"Wopf", {0x1D54E, 0x00000}},
+	{"Wscr", {0x1D4B2, 0x00000}},
+	{"Xfr", {0x1D51B, 0x00000}},
+	{"Xi", {0x0039E, 0x00000}},
+	{"Xopf", {0x1D54F, 0x00000}},
+	{"Xscr", {0x1D4B3, 0x00000}},
+	{"YAcy", {0x0042F, 0x00000}},
+	{"YIcy", {0x00407, 0x00000}},
+	{"YUcy", {0x0042E, 0x00000}},
+	{"Yacute", {0x000DD, 0x00000}},
+	{"Ycirc", {0x00176, 0x00000}},
+	{"Ycy", {0x0042B, 0x00000}},
+	{"Yfr", {0x1D51C, 0x00000}},
+	{"Yopf", {0x1D550, 0x00000}},
+	{"Yscr", {0x1D4B4, 0x00000}},
+	{"Yuml", {0x00178, 0x00000}},
+	{"ZHcy", {0x00416, 0x00000}},
+	{"Zacute", {0x00179, 0x00000}},
+	{"Zcaron", {0x0017D, 0x00000}},
+	{"Zcy", {0x00417, 0x00000}},
+	{"Zdot", {0x0017B, 0x00000}},
+	{"ZeroWidthSpace", {0x0200B, 0x00000}},
+	{"Zeta", {0x00396, 0x00000}},
+	{"Zfr", {0x02128, 0x00000}},
+	{"Zopf", {0x02124, 0x00000}},
+	{"Zscr", {0x1D4B5, 0x00000}},
+	{"aacute", {0x000E1, 0x00000}},
+	{"abreve", {0x00103, 0x00000}},
+	{"ac", {0x0223E, 0x00000}},
+	{"acE", {0x0223E, 0x00333}},
+	{"acd", {0x0223F, 0x00000}},
+	{"acirc", {0x000E2, 0x00000}},
+	{"acute", {0x000B4, 0x00000}},
+	{"acy", {0x00430, 0x00000}},
+	{"aelig", {0x000E6, 0x00000}},
+	{"af", {0x02061, 0x00000}},
+	{"afr", {0x1D51E, 0x00000}},
+	{"agrave", {0x000E0, 0x00000}},
+	{"alefsym", {0x02135, 0x00000}},
+	{"aleph", {0x02135, 0x00000}},
+	{"alpha", {0x003B1, 0x00000}},
+	{"amacr", {0x00101, 0x00000}},
+	{"amalg", {0x02A3F, 0x00000}},
+	{"amp", {0x00026, 0x00000}},
+	{"and", {0x02227, 0x00000}},
+	{"andand", {0x02A55, 0x00000}},
+	{"andd", {0x02A5C, 0x00000}},
+	{"andslope", {0x02A58, 0x00000}},
+	{"andv", {0x02A5A, 0x00000}},
+	{"ang", {0x02220, 0x00000}},
+	{"ange", {0x029A4, 0x00000}},
+	{"angle", {0x02220, 0x00000}},
+	{"angmsd", {0x02221, 0x00000}},
+	{"angmsdaa", {0x029A8, 0x00000}},
+	{"angmsdab", {0x029A9, 0x00000}},
+	{"angmsdac", {0x029AA, 0x00000}},
+	{"angmsdad", {0x029AB, 0x00000}},
+	{"angmsdae", {0x029AC, 0x00000}},
+	{"angmsdaf", {0x029AD, 0x00000}},
+	{"angmsdag", {0x029AE, 0x00000}},
+	{"angmsdah", {0x029AF, 0x00000}},
+	{"angrt", {0x0221F, 0x00000}},
+	{"angrtvb", {0x022BE, 0x00000}},
+	{"angrtvbd", {0x0299D, 0x00000}},
+	{"angsph", {0x02222, 0x00000}},
+	{"angst", {0x000C5, 0x00000}},
+	{"angzarr", {0x0237C, 0x00000}},
+	{"aogon", {0x00105, 0x00000}},
+	{"aopf", {0x1D552, 0x00000}},
+	{"ap", {0x02248, 0x00000}},
+	{"apE", {0x02A70, 0x00000}},
+	{"apacir", {0x02A6F, 0x00000}},
+	{"ape", {0x0224A, 0x00000}},
+	{"apid", {0x0224B, 0x00000}},
+	{"apos", {0x00027, 0x00000}},
+	{"approx", {0x02248, 0x00000}},
+	{"approxeq", {0x0224A, 0x00000}},
+	{"aring", {0x000E5, 0x00000}},
+	{"ascr", {0x1D4B6, 0x00000}},
+	{"ast", {0x0002A, 0x00000}},
+	{"asymp", {0x02248, 0x00000}},
+	{"asympeq", {0x0224D, 0x00000}},
+	{"atilde", {0x000E3, 0x00000}},
+	{"auml", {0x000E4, 0x00000}},
+	{"awconint", {0x02233, 0x00000}},
+	{"awint", {0x02A11, 0x00000}},
+	{"bNot", {0x02AED, 0x00000}},
+	{"backcong", {0x0224C, 0x00000}},
+	{"backepsilon", {0x003F6, 0x00000}},
+	{"backprime", {0x02035, 0x00000}},
+	{"backsim", {0x0223D, 0x00000}},
+	{"backsimeq", {0x022CD, 0x00000}},
+	{"barvee", {0x022BD, 0x00000}},
+	{"barwed", {0x02305, 0x00000}},
+	{"barwedge", {0x02305, 0x00000}},
+	{"bbrk", {0x023B5, 0x00000}},
+	{"bbrktbrk", {0x023B6, 0x00000}},
+	{"bcong", {0x0224C, 0x00000}},
+	{"bcy", {0x00431, 0x00000}},
+	{"bdquo", {0x0201E, 0x00000}},
+	{"becaus", {0x02235, 0x00000}},
+	{"because", {0x02235, 0x00000}},
+	{"bemptyv", {0x029B0, 0x00000}},
+	{"bepsi", {0x003F6, 0x00000}},
+	{"bernou", {0x0212C, 0x00000}},
+	{"beta", {0x003B2, 0x00000}},
+	{"beth", {0x02136, 0x00000}},
+	{"between", {0x0226C, 0x00000}},
+	{"bfr", {0x1D51F, 0x00000}},
+	{"bigcap", {0x022C2, 0x00000}},
+	{"bigcirc", {0x025EF, 0x00000}},
+	{"bigcup", {0x022C3, 0x00000}},
+	{"bigodot", {0x02A00, 0x00000}},
+	{"bigoplus", {0x02A01, 0x00000}},
+	{"bigotimes", {0x02A02, 0x00000}},
+	{"bigsqcup", {0x02A06, 0x00000}},
+	{"bigstar", {0x02605, 0x00000}},
+	{"bigtriangledown", {0x025BD, 0x00000}},
+	{"bigtriangleup", {0x025B3, 0x00000}},
+	{"biguplus", {0x02A04, 0x00000}},
+	{"bigvee", {0x022C1, 0x00000}},
+	{"bigwedge", {0x022C0, 0x00000}},
+	{"bkarow", {0x0290D, 0x00000}},
+	{"blacklozenge", {0x029EB, 0x00000}},
+	{"blacksquare", {0x025AA, 0x00000}},
+	{"blacktriangle", {0x025B4, 0x00000}},
+	{"blacktriangledown", {0x025BE, 0x00000}},
+	{"blacktriangleleft", {0x025C2, 0x00000}},
+	{"blacktriangleright", {0x025B8, 0x00000}},
+	{"blank", {0x02423, 0x00000}},
+	{"blk12", {0x02592, 0x00000}},
+	{"blk14", {0x02591, 0x00000}},
+	{"blk34", {0x02593, 0x00000}},
+	{"block", {0x02588, 0x00000}},
+	{"bne", {0x0003D, 0x020E5}},
+	{"bnequiv", {0x02261, 0x020E5}},
+	{"bnot", {0x02310, 0x00000}},
+	{"bopf", {0x1D553, 0x00000}},
+	{"bot", {0x022A5, 0x00000}},
+	{"bottom", {0x022A5, 0x00000}},
+	{"bowtie", {0x022C8, 0x00000}},
+	{"boxDL", {0x02557, 0x00000}},
+	{"boxDR", {0x02554, 0x00000}},
+	{"boxDl", {0x02556, 0x00000}},
+	{"boxDr", {0x02553, 0x00000}},
+	{"boxH", {0x02550, 0x00000}},
+	{"boxHD", {0x02566, 0x00000}},
+	{"boxHU", {0x02569, 0x00000}},
+	{"boxHd", {0x02564, 0x00000}},
+	{"boxHu", {0x02567, 0x00000}},
+	{"boxUL", {0x0255D, 0x00000}},
+	{"boxUR", {0x0255A, 0x00000}},
+	{"boxUl", {0x0255C, 0x00000}},
+	{"boxUr", {0x02559, 0x00000}},
+	{"boxV", {0x02551, 0x00000}},
+	{"boxVH", {0x0256C, 0x00000}},
+	{"boxVL", {0x02563, 0x00000}},
+	{"boxVR", {0x02560, 0x00000}},
+	{"boxVh", {0x0256B, 0x00000}},
+	{"boxVl", {0x02562, 0x00000}},
+	{"boxVr", {0x0255F, 0x00000}},
+	{"boxbox", {0x029C9, 0x00000}},
+	{"boxdL", {0x02555, 0x00000}},
+	{"boxdR", {0x02552, 0x00000}},
+	{"boxdl", {0x02510, 0x00000}},
+	{"boxdr", {0x0250C, 0x00000}},
+	{"boxh", {0x02500, 0x00000}},
+	{"boxhD", {0x02565, 0x00000}},
+	{"boxhU", {0x02568, 0x00000}},
+	{"boxhd", {0x0252C, 0x00000}},
+	{"boxhu", {0x02534, 0x00000}},
+	{"boxminus", {0x0229F, 0x00000}},
+	{"boxplus", {0x0229E, 0x00000}},
+	{"boxtimes", {0x022A0, 0x00000}},
+	{"boxuL", {0x0255B, 0x00000}},
+	{"boxuR", {0x02558, 0x00000}},
+	{"boxul", {0x02518, 0x00000}},
+	{"boxur", {0x02514, 0x00000}},
+	{"boxv", {0x02502, 0x00000}},
+	{"boxvH", {0x0256A, 0x00000}},
+	{"boxvL", {0x02561, 0x00000}},
+	{"boxvR", {0x0255E, 0x00000}},
+	{"boxvh", {0x0253C, 0x00000}},
+	{"boxvl", {0x02524, 0x00000}},
+	{"boxvr", {0x0251C, 0x00000}},
+	{"bprime", {0x02035, 0x00000}},
+	{"breve", {0x002D8, 0x00000}},
+	{"brvbar", {0x000A6, 0x00000}},
+	{"bscr", {0x1D4B7, 0x00000}},
+	{"bsemi", {0x0204F, 0x00000}},
+	{"bsim", {0x0223D, 0x00000}},
+	{"bsime", {0x022CD, 0x00000}},
+	{"bsol", {0x0005C, 0x00000}},
+	{"bsolb", {0x029C5, 0x00000}},
+	{"bsolhsub", {0x027C8, 0x00000}},
+	{"bull", {0x02022, 0x00000}},
+	{"bullet", {0x02022, 0x00000}},
+	{"bump", {0x0224E, 0x00000}},
+	{"bumpE", {0x02AAE, 0x00000}},
+	{"bumpe", {0x0224F, 0x00000}},
+	{"bumpeq", {0x0224F, 0x00000}},
+	{"cacute", {0x00107, 0x00000}},
+	{"cap", {0x02229, 0x00000}},
+	{"capand", {0x02A44, 0x00000}},
+	{"capbrcup", {0x02A49, 0x00000}},
+	{"capcap", {0x02A4B, 0x00000}},
+	{"capcup", {0x02A47, 0x00000}},
+	{"capdot", {0x02A40, 0x00000}},
+	{"caps", {0x02229, 0x0FE00}},
+	{"caret", {0x02041, 0x00000}},
+	{"caron", {0x002C7, 0x00000}},
+	{"ccaps", {0x02A4D, 0x00000}},
+	{"ccaron", {0x0010D, 0x00000}},
+	{"ccedil", {0x000E7, 0x00000}},
+	{"ccirc", {0x00109, 0x00000}},
+	{"ccups", {0x02A4C, 0x00000}},
+	{"ccupssm", {0x02A50, 0x00000}},
+	{"cdot", {0x0010B, 0x00000}},
+	{"cedil", {0x000B8, 0x00000}},
+	{"cemptyv", {0x029B2, 0x00000}},
+	{"cent", {0x000A2, 0x00000}},
+	{"centerdot", {0x000B7, 0x00000}},
+	{"cfr", {0x1D520, 0x00000}},
+	{"chcy", {0x00447, 0x00000}},
+	{"check", {0x02713, 0x00000}},
+	{"checkmark", {0x02713, 0x00000}},
+	{"chi", {0x003C7, 0x00000}},
+	{"cir", {0x025CB, 0x00000}},
+	{"cirE", {0x029C3, 0x00000}},
+	{"circ", {0x002C6, 0x00000}},
+	{"circeq", {0x02257, 0x00000}},
+	{"circlearrowleft", {0x021BA, 0x00000}},
+	{"circlearrowright", {0x021BB, 0x00000}},
+	{"circledR", {0x000AE, 0x00000}},
+	{"circledS", {0x024C8, 0x00000}},
+	{"circledast", {0x0229B, 0x00000}},
+	{"circledcirc", {0x0229A, 0x00000}},
+	{"circleddash", {0x0229D, 0x00000}},
+	{"cire", {0x02257, 0x00000}},
+	{"cirfnint", {0x02A10, 0x00000}},
+	{"cirmid", {0x02AEF, 0x00000}},
+	{"cirscir", {0x029C2, 0x00000}},
+	{"clubs", {0x02663, 0x00000}},
+	{"clubsuit", {0x02663, 0x00000}},
+	{"colon", {0x0003A, 0x00000}},
+	{"colone", {0x02254, 0x00000}},
+	{"coloneq", {0x02254, 0x00000}},
+	{"comma", {0x0002C, 0x00000}},
+	{"commat", {0x00040, 0x00000}},
+	{"comp", {0x02201, 0x00000}},
+	{"compfn", {0x02218, 0x00000}},
+	{"complement", {0x02201, 0x00000}},
+	{"complexes", {0x02102, 0x00000}},
+	{"cong", {0x02245, 0x00000}},
+	{"congdot", {0x02A6D, 0x00000}},
+	{"conint", {0x0222E, 0x00000}},
+	{"copf", {0x1D554, 0x00000}},
+	{"coprod", {0x02210, 0x00000}},
+	{"copy", {0x000A9, 0x00000}},
+	{"copysr", {0x02117, 0x00000}},
+	{"crarr", {0x021B5, 0x00000}},
+	{"cross", {0x02717, 0x00000}},
+	{"cscr", {0x1D4B8, 0x00000}},
+	{"csub", {0x02ACF, 0x00000}},
+	{"csube", {0x02AD1, 0x00000}},
+	{"csup", {0x02AD0, 0x00000}},
+	{"csupe", {0x02AD2, 0x00000}},
+	{"ctdot", {0x022EF, 0x00000}},
+	{"cudarrl", {0x02938, 0x00000}},
+	{"cudarrr", {0x02935, 0x00000}},
+	{"cuepr", {0x022DE, 0x00000}},
+	{"cuesc", {0x022DF, 0x00000}},
+	{"cularr", {0x021B6, 0x00000}},
+	{"cularrp", {0x0293D, 0x00000}},
+	{"cup", {0x0222A, 0x00000}},
+	{"cupbrcap", {0x02A48, 0x00000}},
+	{"cupcap", {0x02A46, 0x00000}},
+	{"cupcup", {0x02A4A, 0x00000}},
+	{"cupdot", {0x0228D, 0x00000}},
+	{"cupor", {0x02A45, 0x00000}},
+	{"cups", {0x0222A, 0x0FE00}},
+	{"curarr", {0x021B7, 0x00000}},
+	{"curarrm", {0x0293C, 0x00000}},
+	{"curlyeqprec", {0x022DE, 0x00000}},
+	{"curlyeqsucc", {0x022DF, 0x00000}},
+	{"curlyvee", {0x022CE, 0x00000}},
+	{"curlywedge", {0x022CF, 0x00000}},
+	{"curren", {0x000A4, 0x00000}},
+	{"curvearrowleft", {0x021B6, 0x00000}},
+	{"curvearrowright", {0x021B7, 0x00000}},
+	{"cuvee", {0x022CE, 0x00000}},
+	{"cuwed", {0x022CF, 0x00000}},
+	{"cwconint", {0x02232, 0x00000}},
+	{"cwint", {0x02231, 0x00000}},
+	{"cylcty", {0x0232D, 0x00000}},
+	{"dArr", {0x021D3, 0x00000}},
+	{"dHar", {0x02965, 0x00000}},
+	{"dagger", {0x02020, 0x00000}},
+	{"daleth", {0x02138, 0x00000}},
+	{"darr", {0x02193, 0x00000}},
+	{"dash", {0x02010, 0x00000}},
+	{"dashv", {0x022A3, 0x00000}},
+	{"dbkarow", {0x0290F, 0x00000}},
+	{"dblac", {0x002DD, 0x00000}},
+	{"dcaron", {0x0010F, 0x00000}},
+	{"dcy", {0x00434, 0x00000}},
+	{"dd", {0x02146, 0x00000}},
+	{"ddagger", {0x02021, 0x00000}},
+	{"ddarr", {0x021CA, 0x00000}},
+	{"ddotseq", {0x02A77, 0x00000}},
+	{"deg", {0x000B0, 0x00000}},
+	{"delta", {0x003B4, 0x00000}},
+	{"demptyv", {0x029B1, 0x00000}},
+	{"dfisht", {0x0297F, 0x00000}},
+	{"dfr", {0x1D521, 0x00000}},
+	{"dharl", {0x021C3, 0x00000}},
+	{"dharr", {0x021C2, 0x00000}},
+	{"diam", {0x022C4, 0x00000}},
+	{"diamond", {0x022C4, 0x00000}},
+	{"diamondsuit", {0x02666, 0x00000}},
+	{"diams", {0x02666, 0x00000}},
+	{"die", {0x000A8, 0x00000}},
+	{"digamma", {0x003DD, 0x00000}},
+	{"disin", {0x022F2, 0x00000}},
+	{"div", {0x000F7, 0x00000}},
+	{"divide", {0x000F7, 0x00000}},
+	{"divideontimes", {0x022C7, 0x00000}},
+	{"divonx", {0x022C7, 0x00000}},
+	{"djcy", {0x00452, 0x00000}},
+	{"dlcorn", {0x0231E, 0x00000}},
+	{"dlcrop", {0x0230D, 0x00000}},
+	{"dollar", {0x00024, 0x00000}},
+	{"dopf", {0x1D555, 0x00000}},
+	{"dot", {0x002D9, 0x00000}},
+	{"doteq", {0x02250, 0x00000}},
+	{"doteqdot", {0x02251, 0x00000}},
+	{"dotminus", {0x02238, 0x00000}},
+	{"dotplus", {0x02214, 0x00000}},
+	{"dotsquare", {0x022A1, 0x00000}},
+	{"doublebarwedge", {0x02306, 0x00000}},
+	{"downarrow", {0x02193, 0x00000}},
+	{"downdownarrows", {0x021CA, 0x00000}},
+	{"downharpoonleft", {0x021C3, 0x00000}},
+	{"downharpoonright", {0x021C2, 0x00000}},
+	{"drbkarow", {0x02910, 0x00000}},
+	{"drcorn", {0x0231F, 0x00000}},
+	{"drcrop", {0x0230C, 0x00000}},
+	{"dscr", {0x1D4B9, 0x00000}},
+	{"dscy", {0x00455, 0x00000}},
+	{"dsol", {0x029F6, 0x00000}},
+	{"dstrok", {0x00111, 0x00000}},
+	{"dtdot", {0x022F1, 0x00000}},
+	{"dtri", {0x025BF, 0x00000}},
+	{"dtrif", {0x025BE, 0x00000}},
+	{"duarr", {0x021F5, 0x00000}},
+	{"duhar", {0x0296F, 0x00000}},
+	{"dwangle", {0x029A6, 0x00000}},
+	{"dzcy", {0x0045F, 0x00000}},
+	{"dzigrarr", {0x027FF, 0x00000}},
+	{"eDDot", {0x02A77, 0x00000}},
+	{"eDot", {0x02251, 0x00000}},
+	{"eacute", {0x000E9, 0x00000}},
+	{"easter", {0x02A6E, 0x00000}},
+	{"ecaron", {0x0011B, 0x00000}},
+	{"ecir", {0x02256, 0x00000}},
+	{"ecirc", {0x000EA, 0x00000}},
+	{"ecolon", {0x02255, 0x00000}},
+	{"ecy", {0x0044D, 0x00000}},
+	{"edot", {0x00117, 0x00000}},
+	{"ee", {0x02147, 0x00000}},
+	{"efDot", {0x02252, 0x00000}},
+	{"efr", {0x1D522, 0x00000}},
+	{"eg", {0x02A9A, 0x00000}},
+	{"egrave", {0x000E8, 0x00000}},
+	{"egs", {0x02A96, 0x00000}},
+	{"egsdot", {0x02A98, 0x00000}},
+	{"el", {0x02A99, 0x00000}},
+	{"elinters", {0x023E7, 0x00000}},
+	{"ell", {0x02113, 0x00000}},
+	{"els", {0x02A95, 0x00000}},
+	{"elsdot", {0x02A97, 0x00000}},
+	{"emacr", {0x00113, 0x00000}},
+	{"empty", {0x02205, 0x00000}},
+	{"emptyset", {0x02205, 0x00000}},
+	{"emptyv", {0x02205, 0x00000}},
+	{"emsp", {0x02003, 0x00000}},
+	{"emsp13", {0x02004, 0x00000}},
+	{"emsp14", {0x02005, 0x00000}},
+	{"eng", {0x0014B, 0x00000}},
+	{"ensp", {0x02002, 0x00000}},
+	{"eogon", {0x00119, 0x00000}},
+	{"eopf", {0x1D556, 0x00000}},
+	{"epar", {0x022D5, 0x00000}},
+	{"eparsl", {0x029E3, 0x00000}},
+	{"eplus", {0x02A71, 0x00000}},
+	{"epsi", {0x003B5, 0x00000}},
+	{"epsilon", {0x003B5, 0x00000}},
+	{"epsiv", {0x003F5, 0x00000}},
+	{"eqcirc", {0x02256, 0x00000}},
+	{"eqcolon", {0x02255, 0x00000}},
+	{"eqsim", {0x02242, 0x00000}},
+	{"eqslantgtr", {0x02A96, 0x00000}},
+	{"eqslantless", {0x02A95, 0x00000}},
+	{"equals", {0x0003D, 0x00000}},
+	{"equest", {0x0225F, 0x00000}},
+	{"equiv", {0x02261, 0x00000}},
+	{"equivDD", {0x02A78, 0x00000}},
+	{"eqvparsl", {0x029E5, 0x00000}},
+	{"erDot", {0x02253, 0x00000}},
+	{"erarr", {0x02971, 0x00000}},
+	{"escr", {0x0212F, 0x00000}},
+	{"esdot", {0x02250, 0x00000}},
+	{"esim", {0x02242, 0x00000}},
+	{"eta", {0x003B7, 0x00000}},
+	{"eth", {0x000F0, 0x00000}},
+	{"euml", {0x000EB, 0x00000}},
+	{"euro", {0x020AC, 0x00000}},
+	{"excl", {0x00021, 0x00000}},
+	{"exist", {0x02203, 0x00000}},
+	{"expectation", {0x02130, 0x00000}},
+	{"exponentiale", {0x02147, 0x00000}},
+	{"fallingdotseq", {0x02252, 0x00000}},
+	{"fcy", {0x00444, 0x00000}},
+	{"female", {0x02640, 0x00000}},
+	{"ffilig", {0x0FB03, 0x00000}},
+	{"fflig", {0x0FB00, 0x00000}},
+	{"ffllig", {0x0FB04, 0x00000}},
+	{"ffr", {0x1D523, 0x00000}},
+	{"filig", {0x0FB01, 0x00000}},
+	{"fjlig", {0x00066, 0x0006A}},
+	{"flat", {0x0266D, 0x00000}},
+	{"fllig", {0x0FB02, 0x00000}},
+	{"fltns", {0x025B1, 0x00000}},
+	{"fnof", {0x00192, 0x00000}},
+	{"fopf", {0x1D557, 0x00000}},
+	{"forall", {0x02200, 0x00000}},
+	{"fork", {0x022D4, 0x00000}},
+	{"forkv", {0x02AD9, 0x00000}},
+	{"fpartint", {0x02A0D, 0x00000}},
+	{"frac12", {0x000BD, 0x00000}},
+	{"frac13", {0x02153, 0x00000}},
+	{"frac14", {0x000BC, 0x00000}},
+	{"frac15", {0x02155, 0x00000}},
+	{"frac16", {0x02159, 0x00000}},
+	{"frac18", {0x0215B, 0x00000}},
+	{"frac23", {0x02154, 0x00000}},
+	{"frac25", {0x02156, 0x00000}},
+	{"frac34", {0x000BE, 0x00000}},
+	{"frac35", {0x02157, 0x00000}},
+	{"frac38", {0x0215C, 0x00000}},
+	{"frac45", {0x02158, 0x00000}},
+	{"frac56", {0x0215A, 0x00000}},
+	{"frac58", {0x0215D, 0x00000}},
+	{"frac78", {0x0215E, 0x00000}},
+	{"frasl", {0x02044, 0x00000}},
+	{"frown", {0x02322, 0x00000}},
+	{"fscr", {0x1D4BB, 0x00000}},
+	{"gE", {0x02267, 0x00000}},
+	{"gEl", {0x02A8C, 0x00000}},
+	{"gacute", {0x001F5, 0x00000}},
+	{"gamma", {0x003B3, 0x00000}},
+	{"gammad", {0x003DD, 0x00000}},
+	{"gap", {0x02A86, 0x00000}},
+	{"gbreve", {0x0011F, 0x00000}},
+	{"gcirc", {0x0011D, 0x00000}},
+	{"gcy", {0x00433, 0x00000}},
+	{"gdot", {0x00121, 0x00000}},
+	{"ge", {0x02265, 0x00000}},
+	{"gel", {0x022DB, 0x00000}},
+	{"geq", {0x02265, 0x00000}},
+	{"geqq", {0x02267, 0x00000}},
+	{"geqslant", {0x02A7E, 0x00000}},
+	{"ges", {0x02A7E, 0x00000}},
+	{"gescc", {0x02AA9, 0x00000}},
+	{"gesdot", {0x02A80, 0x00000}},
+	{"gesdoto", {0x02A82, 0x00000}},
+	{"gesdotol", {0x02A84, 0x00000}},
+	{"gesl", {0x022DB, 0x0FE00}},
+	{"gesles", {0x02A94, 0x00000}},
+	{"gfr", {0x1D524, 0x00000}},
+	{"gg", {0x0226B, 0x00000}},
+	{"ggg", {0x022D9, 0x00000}},
+	{"gimel", {0x02137, 0x00000}},
+	{"gjcy", {0x00453, 0x00000}},
+	{"gl", {0x02277, 0x00000}},
+	{"glE", {0x02A92, 0x00000}},
+	{"gla", {0x02AA5, 0x00000}},
+	{"glj", {0x02AA4, 0x00000}},
+	{"gnE", {0x02269, 0x00000}},
+	{"gnap", {0x02A8A, 0x00000}},
+	{"gnapprox", {0x02A8A, 0x00000}},
+	{"gne", {0x02A88, 0x00000}},
+	{"gneq", {0x02A88, 0x00000}},
+	{"gneqq", {0x02269, 0x00000}},
+	{"gnsim", {0x022E7, 0x00000}},
+	{"gopf", {0x1D558, 0x00000}},
+	{"grave", {0x00060, 0x00000}},
+	{"gscr", {0x0210A, 0x00000}},
+	{"gsim", {0x02273, 0x00000}},
+	{"gsime", {0x02A8E, 0x00000}},
+	{"gsiml", {0x02A90, 0x00000}},
+	{"gt", {0x0003E, 0x00000}},
+	{"gtcc", {0x02AA7, 0x00000}},
+	{"gtcir", {0x02A7A, 0x00000}},
+	{"gtdot", {0x022D7, 0x00000}},
+	{"gtlPar", {0x02995, 0x00000}},
+	{"gtquest", {0x02A7C, 0x00000}},
+	{"gtrapprox", {0x02A86, 0x00000}},
+	{"gtrarr", {0x02978, 0x00000}},
+	{"gtrdot", {0x022D7, 0x00000}},
+	{"gtreqless", {0x022DB, 0x00000}},
+	{"gtreqqless", {0x02A8C, 0x00000}},
+	{"gtrless", {0x02277, 0x00000}},
+	{"gtrsim", {0x02273, 0x00000}},
+	{"gvertneqq", {0x02269, 0x0FE00}},
+	{"gvnE", {0x02269, 0x0FE00}},
+	{"hArr", {0x021D4, 0x00000}},
+	{"hairsp", {0x0200A, 0x00000}},
+	{"half", {0x000BD, 0x00000}},
+	{"hamilt", {0x0210B, 0x00000}},
+	{"hardcy", {0x0044A, 0x00000}},
+	{"harr", {0x02194, 0x00000}},
+	{"harrcir", {0x02948, 0x00000}},
+	{"harrw", {0x021AD, 0x00000}},
+	{"hbar", {0x0210F, 0x00000}},
+	{"hcirc", {0x00125, 0x00000}},
+	{"hearts", {0x02665, 0x00000}},
+	{"heartsuit", {0x02665, 0x00000}},
+	{"hellip", {0x02026, 0x00000}},
+	{"hercon", {0x022B9, 0x00000}},
+	{"hfr", {0x1D525, 0x00000}},
+	{"hksearow", {0x02925, 0x00000}},
+	{"hkswarow", {0x02926, 0x00000}},
+	{"hoarr", {0x021FF, 0x00000}},
+	{"homtht", {0x0223B, 0x00000}},
+	{"hookleftarrow", {0x021A9, 0x00000}},
+	{"hookrightarrow", {0x021AA, 0x00000}},
+	{"hopf", {0x1D559, 0x00000}},
+	{"horbar", {0x02015, 0x00000}},
+	{"hscr", {0x1D4BD, 0x00000}},
+	{"hslash", {0x0210F, 0x00000}},
+	{"hstrok", {0x00127, 0x00000}},
+	{"hybull", {0x02043, 0x00000}},
+	{"hyphen", {0x02010, 0x00000}},
+	{"iacute", {0x000ED, 0x00000}},
+	{"ic", {0x02063, 0x00000}},
+	{"icirc", {0x000EE, 0x00000}},
+	{"icy", {0x00438, 0x00000}},
+	{"iecy", {0x00435, 0x00000}},
+	{"iexcl", {0x000A1, 0x00000}},
+	{"iff", {0x021D4, 0x00000}},
+	{"ifr", {0x1D526, 0x00000}},
+	{"igrave", {0x000EC, 0x00000}},
+	{"ii", {0x02148, 0x00000}},
+	{"iiiint", {0x02A0C, 0x00000}},
+	{"iiint", {0x0222D, 0x00000}},
+	{"iinfin", {0x029DC, 0x00000}},
+	{"iiota", {0x02129, 0x00000}},
+	{"ijlig", {0x00133, 0x00000}},
+	{"imacr", {0x0012B, 0x00000}},
+	{"image", {0x02111, 0x00000}},
+	{"imagline", {0x02110, 0x00000}},
+	{"imagpart", {0x02111, 0x00000}},
+	{"imath", {0x00131, 0x00000}},
+	{"imof", {0x022B7, 0x00000}},
+	{"imped", {0x001B5, 0x00000}},
+	{"in", {0x02208, 0x00000}},
+	{"incare", {0x02105, 0x00000}},
+	{"infin", {0x0221E, 0x00000}},
+	{"infintie", {0x029DD, 0x00000}},
+	{"inodot", {0x00131, 0x00000}},
+	{"int", {0x0222B, 0x00000}},
+	{"intcal", {0x022BA, 0x00000}},
+	{"integers", {0x02124, 0x00000}},
+	{"intercal", {0x022BA, 0x00000}},
+	{"intlarhk", {0x02A17, 0x00000}},
+	{"intprod", {0x02A3C, 0x00000}},
+	{"iocy", {0x00451, 0x00000}},
+	{"iogon", {0x0012F, 0x00000}},
+	{"iopf", {0x1D55A, 0x00000}},
+	{"iota", {0x003B9, 0x00000}},
+	{"iprod", {0x02A3C, 0x00000}},
+	{"iquest", {0x000BF, 0x00000}},
+	{"iscr", {0x1D4BE, 0x00000}},
+	{"isin", {0x02208, 0x00000}},
+	{"isinE", {0x022F9, 0x00000}},
+	{"isindot", {0x022F5, 0x00000}},
+	{"isins", {0x022F4, 0x00000}},
+	{"isinsv", {0x022F3, 0x00000}},
+	{"isinv", {0x02208, 0x00000}},
+	{"it", {0x02062, 0x00000}},
+	{"itilde", {0x00129, 0x00000}},
+	{"iukcy", {0x00456, 0x00000}},
+	{"iuml", {0x000EF, 0x00000}},
+	{"jcirc", {0x00135, 0x00000}},
+	{"jcy", {0x00439, 0x00000}},
+	{"jfr", {0x1D527, 0x00000}},
+	{"jmath", {0x00237, 0x00000}},
+	{"jopf", {0x1D55B, 0x00000}},
+	{"jscr", {0x1D4BF, 0x00000}},
+	{"jsercy", {0x00458, 0x00000}},
+	{"jukcy", {0x00454, 0x00000}},
+	{"kappa", {0x003BA, 0x00000}},
+	{"kappav", {0x003F0, 0x00000}},
+	{"kcedil", {0x00137, 0x00000}},
+	{"kcy", {0x0043A, 0x00000}},
+	{"kfr", {0x1D528, 0x00000}},
+	{"kgreen", {0x00138, 0x00000}},
+	{"khcy", {0x00445, 0x00000}},
+	{"kjcy", {0x0045C, 0x00000}},
+	{"kopf", {0x1D55C, 0x00000}},
+	{"kscr", {0x1D4C0, 0x00000}},
+	{"lAarr", {0x021DA, 0x00000}},
+	{"lArr", {0x021D0, 0x00000}},
+	{"lAtail", {0x0291B, 0x00000}},
+	{"lBarr", {0x0290E, 0x00000}},
+	{"lE", {0x02266, 0x00000}},
+	{"lEg", {0x02A8B, 0x00000}},
+	{"lHar", {0x02962, 0x00000}},
+	{"lacute", {0x0013A, 0x00000}},
+	{"laemptyv", {0x029B4, 0x00000}},
+	{"lagran", {0x02112, 0x00000}},
+	{"lambda", {0x003BB, 0x00000}},
+	{"lang", {0x027E8, 0x00000}},
+	{"langd", {0x02991, 0x00000}},
+	{"langle", {0x027E8, 0x00000}},
+	{"lap", {0x02A85, 0x00000}},
+	{"laquo", {0x000AB, 0x00000}},
+	{"larr", {0x02190, 0x00000}},
+	{"larrb", {0x021E4, 0x00000}},
+	{"larrbfs", {0x0291F, 0x00000}},
+	{"larrfs", {0x0291D, 0x00000}},
+	{"larrhk", {0x021A9, 0x00000}},
+	{"larrlp", {0x021AB, 0x00000}},
+	{"larrpl", {0x02939, 0x00000}},
+	{"larrsim", {0x02973, 0x00000}},
+	{"larrtl", {0x021A2, 0x00000}},
+	{"lat", {0x02AAB, 0x00000}},
+	{"latail", {0x02919, 0x00000}},
+	{"late", {0x02AAD, 0x00000}},
+	{"lates", {0x02AAD, 0x0FE00}},
+	{"lbarr", {0x0290C, 0x00000}},
+	{"lbbrk", {0x02772, 0x00000}},
+	{"lbrace", {0x0007B, 0x00000}},
+	{"lbrack", {0x0005B, 0x00000}},
+	{"lbrke", {0x0298B, 0x00000}},
+	{"lbrksld", {0x0298F, 0x00000}},
+	{"lbrkslu", {0x0298D, 0x00000}},
+	{"lcaron", {0x0013E, 0x00000}},
+	{"lcedil", {0x0013C, 0x00000}},
+	{"lceil", {0x02308, 0x00000}},
+	{"lcub", {0x0007B, 0x00000}},
+	{"lcy", {0x0043B, 0x00000}},
+	{"ldca", {0x02936, 0x00000}},
+	{"ldquo", {0x0201C, 0x00000}},
+	{"ldquor", {0x0201E, 0x00000}},
+	{"ldrdhar", {0x02967, 0x00000}},
+	{"ldrushar", {0x0294B, 0x00000}},
+	{"ldsh", {0x021B2, 0x00000}},
+	{"le", {0x02264, 0x00000}},
+	{"leftarrow", {0x02190, 0x00000}},
+	{"leftarrowtail", {0x021A2, 0x00000}},
+	{"leftharpoondown", {0x021BD, 0x00000}},
+	{"leftharpoonup", {0x021BC, 0x00000}},
+	{"leftleftarrows", {0x021C7, 0x00000}},
+	{"leftrightarrow", {0x02194, 0x00000}},
+	{"leftrightarrows", {0x021C6, 0x00000}},
+	{"leftrightharpoons", {0x021CB, 0x00000}},
+	{"leftrightsquigarrow", {0x021AD, 0x00000}},
+	{"leftthreetimes", {0x022CB, 0x00000}},
+	{"leg", {0x022DA, 0x00000}},
+	{"leq", {0x02264, 0x00000}},
+	{"leqq", {0x02266, 0x00000}},
+	{"leqslant", {0x02A7D, 0x00000}},
+	{"les", {0x02A7D, 0x00000}},
+	{"lescc", {0x02AA8, 0x00000}},
+	{"lesdot", {0x02A7F, 0x00000}},
+	{"lesdoto", {0x02A81, 0x00000}},
+	{"lesdotor", {0x02A83, 0x00000}},
+	{"lesg", {0x022DA, 0x0FE00}},
+	{"lesges", {0x02A93, 0x00000}},
+	{"lessapprox", {0x02A85, 0x00000}},
+	{"lessdot", {0x022D6, 0x00000}},
+	{"lesseqgtr", {0x022DA, 0x00000}},
+	{"lesseqqgtr", {0x02A8B, 0x00000}},
+	{"lessgtr", {0x02276, 0x00000}},
+	{"lesssim", {0x02272, 0x00000}},
+	{"lfisht", {0x0297C, 0x00000}},
+	{"lfloor", {0x0230A, 0x00000}},
+	{"lfr", {0x1D529, 0x00000}},
+	{"lg", {0x02276, 0x00000}},
+	{"lgE", {0x02A91, 0x00000}},
+	{"lhard", {0x021BD, 0x00000}},
+	{"lharu", {0x021BC, 0x00000}},
+	{"lharul", {0x0296A, 0x00000}},
+	{"lhblk", {0x02584, 0x00000}},
+	{"ljcy", {0x00459, 0x00000}},
+	{"ll", {0x0226A, 0x00000}},
+	{"llarr", {0x021C7, 0x00000}},
+	{"llcorner", {0x0231E, 0x00000}},
+	{"llhard", {0x0296B, 0x00000}},
+	{"lltri", {0x025FA, 0x00000}},
+	{"lmidot", {0x00140, 0x00000}},
+	{"lmoust", {0x023B0, 0x00000}},
+	{"lmoustache", {0x023B0, 0x00000}},
+	{"lnE", {0x02268, 0x00000}},
+	{"lnap", {0x02A89, 0x00000}},
+	{"lnapprox", {0x02A89, 0x00000}},
+	{"lne", {0x02A87, 0x00000}},
+	{"lneq", {0x02A87, 0x00000}},
+	{"lneqq", {0x02268, 0x00000}},
+	{"lnsim", {0x022E6, 0x00000}},
+	{"loang", {0x027EC, 0x00000}},
+	{"loarr", {0x021FD, 0x00000}},
+	{"lobrk", {0x027E6, 0x00000}},
+	{"longleftarrow", {0x027F5, 0x00000}},
+	{"longleftrightarrow", {0x027F7, 0x00000}},
+	{"longmapsto", {0x027FC, 0x00000}},
+	{"longrightarrow", {0x027F6, 0x00000}},
+	{"looparrowleft", {0x021AB, 0x00000}},
+	{"looparrowright", {0x021AC, 0x00000}},
+	{"lopar", {0x02985, 0x00000}},
+	{"lopf", {0x1D55D, 0x00000}},
+	{"loplus", {0x02A2D, 0x00000}},
+	{"lotimes", {0x02A34, 0x00000}},
+	{"lowast", {0x02217, 0x00000}},
+	{"lowbar", {0x0005F, 0x00000}},
+	{"loz", {0x025CA, 0x00000}},
+	{"lozenge", {0x025CA, 0x00000}},
+	{"lozf", {0x029EB, 0x00000}},
+	{"lpar", {0x00028, 0x00000}},
+	{"lparlt", {0x02993, 0x00000}},
+	{"lrarr", {0x021C6, 0x00000}},
+	{"lrcorner", {0x0231F, 0x00000}},
+	{"lrhar", {0x021CB, 0x00000}},
+	{"lrhard", {0x0296D, 0x00000}},
+	{"lrm", {0x0200E, 0x00000}},
+	{"lrtri", {0x022BF, 0x00000}},
+	{"lsaquo", {0x02039, 0x00000}},
+	{"lscr", {0x1D4C1, 0x00000}},
+	{"lsh", {0x021B0, 0x00000}},
+	{"lsim", {0x02272, 0x00000}},
+	{"lsime", {0x02A8D, 0x00000}},
+	{"lsimg", {0x02A8F, 0x00000}},
+	{"lsqb", {0x0005B, 0x00000}},
+	{"lsquo", {0x02018, 0x00000}},
+	{"lsquor", {0x0201A, 0x00000}},
+	{"lstrok", {0x00142, 0x00000}},
+	{"lt", {0x0003C, 0x00000}},
+	{"ltcc", {0x02AA6, 0x00000}},
+	{"ltcir", {0x02A79, 0x00000}},
+	{"ltdot", {0x022D6, 0x00000}},
+	{"lthree", {0x022CB, 0x00000}},
+	{"ltimes", {0x022C9, 0x00000}},
+	{"ltlarr", {0x02976, 0x00000}},
+	{"ltquest", {0x02A7B, 0x00000}},
+	{"ltrPar", {0x02996, 0x00000}},
+	{"ltri", {0x025C3, 0x00000}},
+	{"ltrie", {0x022B4, 0x00000}},
+	{"ltrif", {0x025C2, 0x00000}},
+	{"lurdshar", {0x0294A, 0x00000}},
+	{"luruhar", {0x02966, 0x00000}},
+	{"lvertneqq", {0x02268, 0x0FE00}},
+	{"lvnE", {0x02268, 0x0FE00}},
+	{"mDDot", {0x0223A, 0x00000}},
+	{"macr", {0x000AF, 0x00000}},
+	{"male", {0x02642, 0x00000}},
+	{"malt", {0x02720, 0x00000}},
+	{"maltese", {0x02720, 0x00000}},
+	{"map", {0x021A6, 0x00000}},
+	{"mapsto", {0x021A6, 0x00000}},
+	{"mapstodown", {0x021A7, 0x00000}},
+	{"mapstoleft", {0x021A4, 0x00000}},
+	{"mapstoup", {0x021A5, 0x00000}},
+	{"marker", {0x025AE, 0x00000}},
+	{"mcomma", {0x02A29, 0x00000}},
+	{"mcy", {0x0043C, 0x00000}},
+	{"mdash", {0x02014, 0x00000}},
+	{"measuredangle", {0x02221, 0x00000}},
+	{"mfr", {0x1D52A, 0x00000}},
+	{"mho", {0x02127, 0x00000}},
+	{"micro", {0x000B5, 0x00000}},
+	{"mid", {0x02223, 0x00000}},
+	{"midast", {0x0002A, 0x00000}},
+	{"midcir", {0x02AF0, 0x00000}},
+	{"middot", {0x000B7, 0x00000}},
+	{"minus", {0x02212, 0x00000}},
+	{"minusb", {0x0229F, 0x00000}},
+	{"minusd", {0x02238, 0x00000}},
+	{"minusdu", {0x02A2A, 0x00000}},
+	{"mlcp", {0x02ADB, 0x00000}},
+	{"mldr", {0x02026, 0x00000}},
+	{"mnplus", {0x02213, 0x00000}},
+	{"models", {0x022A7, 0x00000}},
+	{"mopf", {0x1D55E, 0x00000}},
+	{"mp", {0x02213, 0x00000}},
+	{"mscr", {0x1D4C2, 0x00000}},
+	{"mstpos", {0x0223E, 0x00000}},
+	{"mu", {0x003BC, 0x00000}},
+	{"multimap", {0x022B8, 0x00000}},
+	{"mumap", {0x022B8, 0x00000}},
+	{"nGg", {0x022D9, 0x00338}},
+	{"nGt", {0x0226B, 0x020D2}},
+	{"nGtv", {0x0226B, 0x00338}},
+	{"nLeftarrow", {0x021CD, 0x00000}},
+	{"nLeftrightarrow", {0x021CE, 0x00000}},
+	{"nLl", {0x022D8, 0x00338}},
+	{"nLt", {0x0226A, 0x020D2}},
+	{"nLtv", {0x0226A, 0x00338}},
+	{"nRightarrow", {0x021CF, 0x00000}},
+	{"nVDash", {0x022AF, 0x00000}},
+	{"nVdash", {0x022AE, 0x00000}},
+	{"nabla", {0x02207, 0x00000}},
+	{"nacute", {0x00144, 0x00000}},
+	{"nang", {0x02220, 0x020D2}},
+	{"nap", {0x02249, 0x00000}},
+	{"napE", {0x02A70, 0x00338}},
+	{"napid", {0x0224B, 0x00338}},
+	{"napos", {0x00149, 0x00000}},
+	{"napprox", {0x02249, 0x00000}},
+	{"natur", {0x0266E, 0x00000}},
+	{"natural", {0x0266E, 0x00000}},
+	{"naturals", {0x02115, 0x00000}},
+	{"nbsp", {0x000A0, 0x00000}},
+	{"nbump", {0x0224E, 0x00338}},
+	{"nbumpe", {0x0224F, 0x00338}},
+	{"ncap", {0x02A43, 0x00000}},
+	{"ncaron", {0x00148, 0x00000}},
+	{"ncedil", {0x00146, 0x00000}},
+	{"ncong", {0x02247, 0x00000}},
+	{"ncongdot", {0x02A6D, 0x00338}},
+	{"ncup", {0x02A42, 0x00000}},
+	{"ncy", {0x0043D, 0x00000}},
+	{"ndash", {0x02013, 0x00000}},
+	{"ne", {0x02260, 0x00000}},
+	{"neArr", {0x021D7, 0x00000}},
+	{"nearhk", {0x02924, 0x00000}},
+	{"nearr", {0x02197, 0x00000}},
+	{"nearrow", {0x02197, 0x00000}},
+	{"nedot", {0x02250, 0x00338}},
+	{"nequiv", {0x02262, 0x00000}},
+	{"nesear", {0x02928, 0x00000}},
+	{"nesim", {0x02242, 0x00338}},
+	{"nexist", {0x02204, 0x00000}},
+	{"nexists", {0x02204, 0x00000}},
+	{"nfr", {0x1D52B, 0x00000}},
+	{"ngE", {0x02267, 0x00338}},
+	{"nge", {0x02271, 0x00000}},
+	{"ngeq", {0x02271, 0x00000}},
+	{"ngeqq", {0x02267, 0x00338}},
+	{"ngeqslant", {0x02A7E, 0x00338}},
+	{"nges", {0x02A7E, 0x00338}},
+	{"ngsim", {0x02275, 0x00000}},
+	{"ngt", {0x0226F, 0x00000}},
+	{"ngtr", {0x0226F, 0x00000}},
+	{"nhArr", {0x021CE, 0x00000}},
+	{"nharr", {0x021AE, 0x00000}},
+	{"nhpar", {0x02AF2, 0x00000}},
+	{"ni", {0x0220B, 0x00000}},
+	{"nis", {0x022FC, 0x00000}},
+	{"nisd", {0x022FA, 0x00000}},
+	{"niv", {0x0220B, 0x00000}},
+	{"njcy", {0x0045A, 0x00000}},
+	{"nlArr", {0x021CD, 0x00000}},
+	{"nlE", {0x02266, 0x00338}},
+	{"nlarr", {0x0219A, 0x00000}},
+	{"nldr", {0x02025, 0x00000}},
+	{"nle", {0x02270, 0x00000}},
+	{"nleftarrow", {0x0219A, 0x00000}},
+	{"nleftrightarrow", {0x021AE, 0x00000}},
+	{"nleq", {0x02270, 0x00000}},
+	{"nleqq", {0x02266, 0x00338}},
+	{"nleqslant", {0x02A7D, 0x00338}},
+	{"nles", {0x02A7D, 0x00338}},
+	{"nless", {0x0226E, 0x00000}},
+	{"nlsim", {0x02274, 0x00000}},
+	{"nlt", {0x0226E, 0x00000}},
+	{"nltri", {0x022EA, 0x00000}},
+	{"nltrie", {0x022EC, 0x00000}},
+	{"nmid", {0x02224, 0x00000}},
+	{"nopf", {0x1D55F, 0x00000}},
+	{"not", {0x000AC, 0x00000}},
+	{"notin", {0x02209, 0x00000}},
+	{"notinE", {0x022F9, 0x00338}},
+	{"notindot", {0x022F5, 0x00338}},
+	{"notinva", {0x02209, 0x00000}},
+	{"notinvb", {0x022F7, 0x00000}},
+	{"notinvc", {0x022F6, 0x00000}},
+	{"notni", {0x0220C, 0x00000}},
+	{"notniva", {0x0220C, 0x00000}},
+	{"notnivb", {0x022FE, 0x00000}},
+	{"notnivc", {0x022FD, 0x00000}},
+	{"npar", {0x02226, 0x00000}},
+	{"nparallel", {0x02226, 0x00000}},
+	{"nparsl", {0x02AFD, 0x020E5}},
+	{"npart", {0x02202, 0x00338}},
+	{"npolint", {0x02A14, 0x00000}},
+	{"npr", {0x02280, 0x00000}},
+	{"nprcue", {0x022E0, 0x00000}},
+	{"npre", {0x02AAF, 0x00338}},
+	{"nprec", {0x02280, 0x00000}},
+	{"npreceq", {0x02AAF, 0x00338}},
+	{"nrArr", {0x021CF, 0x00000}},
+	{"nrarr", {0x0219B, 0x00000}},
+	{"nrarrc", {0x02933, 0x00338}},
+	{"nrarrw", {0x0219D, 0x00338}},
+	{"nrightarrow", {0x0219B, 0x00000}},
+	{"nrtri", {0x022EB, 0x00000}},
+	{"nrtrie", {0x022ED, 0x00000}},
+	{"nsc", {0x02281, 0x00000}},
+	{"nsccue", {0x022E1, 0x00000}},
+	{"nsce", {0x02AB0, 0x00338}},
+	{"nscr", {0x1D4C3, 0x00000}},
+	{"nshortmid", {0x02224, 0x00000}},
+	{"nshortparallel", {0x02226, 0x00000}},
+	{"nsim", {0x02241, 0x00000}},
+	{"nsime", {0x02244, 0x00000}},
+	{"nsimeq", {0x02244, 0x00000}},
+	{"nsmid", {0x02224, 0x00000}},
+	{"nspar", {0x02226, 0x00000}},
+	{"nsqsube", {0x022E2, 0x00000}},
+	{"nsqsupe", {0x022E3, 0x00000}},
+	{"nsub", {0x02284, 0x00000}},
+	{"nsubE", {0x02AC5, 0x00338}},
+	{"nsube", {0x02288, 0x00000}},
+	{"nsubset", {0x02282, 0x020D2}},
+	{"nsubseteq", {0x02288, 0x00000}},
+	{"nsubseteqq", {0x02AC5, 0x00338}},
+	{"nsucc", {0x02281, 0x00000}},
+	{"nsucceq", {0x02AB0, 0x00338}},
+	{"nsup", {0x02285, 0x00000}},
+	{"nsupE", {0x02AC6, 0x00338}},
+	{"nsupe", {0x02289, 0x00000}},
+	{"nsupset", {0x02283, 0x020D2}},
+	{"nsupseteq", {0x02289, 0x00000}},
+	{"nsupseteqq", {0x02AC6, 0x00338}},
+	{"ntgl", {0x02279, 0x00000}},
+	{"ntilde", {0x000F1, 0x00000}},
+	{"ntlg", {0x02278, 0x00000}},
+	{"ntriangleleft", {0x022EA, 0x00000}},
+	{"ntrianglelefteq", {0x022EC, 0x00000}},
+	{"ntriangleright", {0x022EB, 0x00000}},
+	{"ntrianglerighteq", {0x022ED, 0x00000}},
+	{"nu", {0x003BD, 0x00000}},
+	{"num", {0x00023, 0x00000}},
+	{"numero", {0x02116, 0x00000}},
+	{"numsp", {0x02007, 0x00000}},
+	{"nvDash", {0x022AD, 0x00000}},
+	{"nvHarr", {0x02904, 0x00000}},
+	{"nvap", {0x0224D, 0x020D2}},
+	{"nvdash", {0x022AC, 0x00000}},
+	{"nvge", {0x02265, 0x020D2}},
+	{"nvgt", {0x0003E, 0x020D2}},
+	{"nvinfin", {0x029DE, 0x00000}},
+	{"nvlArr", {0x02902, 0x00000}},
+	{"nvle", {0x02264, 0x020D2}},
+	{"nvlt", {0x0003C, 0x020D2}},
+	{"nvltrie", {0x022B4, 0x020D2}},
+	{"nvrArr", {0x02903, 0x00000}},
+	{"nvrtrie", {0x022B5, 0x020D2}},
+	{"nvsim", {0x0223C, 0x020D2}},
+	{"nwArr", {0x021D6, 0x00000}},
+	{"nwarhk", {0x02923, 0x00000}},
+	{"nwarr", {0x02196, 0x00000}},
+	{"nwarrow", {0x02196, 0x00000}},
+	{"nwnear", {0x02927, 0x00000}},
+	{"oS", {0x024C8, 0x00000}},
+	{"oacute", {0x000F3, 0x00000}},
+	{"oast", {0x0229B, 0x00000}},
+	{"ocir", {0x0229A, 0x00000}},
+	{"ocirc", {0x000F4, 0x00000}},
+	{"ocy", {0x0043E, 0x00000}},
+	{"odash", {0x0229D, 0x00000}},
+	{"odblac", {0x00151, 0x00000}},
+	{"odiv", {0x02A38, 0x00000}},
+	{"odot", {0x02299, 0x00000}},
+	{"odsold", {0x029BC, 0x00000}},
+	{"oelig", {0x00153, 0x00000}},
+	{"ofcir", {0x029BF, 0x00000}},
+	{"ofr", {0x1D52C, 0x00000}},
+	{"ogon", {0x002DB, 0x00000}},
+	{"ograve", {0x000F2, 0x00000}},
+	{"ogt", {0x029C1, 0x00000}},
+	{"ohbar", {0x029B5, 0x00000}},
+	{"ohm", {0x003A9, 0x00000}},
+	{"oint", {0x0222E, 0x00000}},
+	{"olarr", {0x021BA, 0x00000}},
+	{"olcir", {0x029BE, 0x00000}},
+	{"olcross", {0x029BB, 0x00000}},
+	{"oline", {0x0203E, 0x00000}},
+	{"olt", {0x029C0, 0x00000}},
+	{"omacr", {0x0014D, 0x00000}},
+	{"omega", {0x003C9, 0x00000}},
+	{"omicron", {0x003BF, 0x00000}},
+	{"omid", {0x029B6, 0x00000}},
+	{"ominus", {0x02296, 0x00000}},
+	{"oopf", {0x1D560, 0x00000}},
+	{"opar", {0x029B7, 0x00000}},
+	{"operp", {0x029B9, 0x00000}},
+	{"oplus", {0x02295, 0x00000}},
+	{"or", {0x02228, 0x00000}},
+	{"orarr", {0x021BB, 0x00000}},
+	{"ord", {0x02A5D, 0x00000}},
+	{"order", {0x02134, 0x00000}},
+	{"orderof", {0x02134, 0x00000}},
+	{"ordf", {0x000AA, 0x00000}},
+	{"ordm", {0x000BA, 0x00000}},
+	{"origof", {0x022B6, 0x00000}},
+	{"oror", {0x02A56, 0x00000}},
+	{"orslope", {0x02A57, 0x00000}},
+	{"orv", {0x02A5B, 0x00000}},
+	{"oscr", {0x02134, 0x00000}},
+	{"oslash", {0x000F8, 0x00000}},
+	{"osol", {0x02298, 0x00000}},
+	{"otilde", {0x000F5, 0x00000}},
+	{"otimes", {0x02297, 0x00000}},
+	{"otimesas", {0x02A36, 0x00000}},
+	{"ouml", {0x000F6, 0x00000}},
+	{"ovbar", {0x0233D, 0x00000}},
+	{"par", {0x02225, 0x00000}},
+	{"para", {0x000B6, 0x00000}},
+	{"parallel", {0x02225, 0x00000}},
+	{"parsim", {0x02AF3, 0x00000}},
+	{"parsl", {0x02AFD, 0x00000}},
+	{"part", {0x02202, 0x00000}},
+	{"pcy", {0x0043F, 0x00000}},
+	{"percnt", {0x00025, 0x00000}},
+	{"period", {0x0002E, 0x00000}},
+	{"permil", {0x02030, 0x00000}},
+	{"perp", {0x022A5, 0x00000}},
+	{"pertenk", {0x02031, 0x00000}},
+	{"pfr", {0x1D52D, 0x00000}},
+	{"phi", {0x003C6, 0x00000}},
+	{"phiv", {0x003D5, 0x00000}},
+	{"phmmat", {0x02133, 0x00000}},
+	{"phone", {0x0260E, 0x00000}},
+	{"pi", {0x003C0, 0x00000}},
+	{"pitchfork", {0x022D4, 0x00000}},
+	{"piv", {0x003D6, 0x00000}},
+	{"planck", {0x0210F, 0x00000}},
+	{"planckh", {0x0210E, 0x00000}},
+	{"plankv", {0x0210F, 0x00000}},
+	{"plus", {0x0002B, 0x00000}},
+	{"plusacir", {0x02A23, 0x00000}},
+	{"plusb", {0x0229E, 0x00000}},
+	{"pluscir", {0x02A22, 0x00000}},
+	{"plusdo", {0x02214, 0x00000}},
+	{"plusdu", {0x02A25, 0x00000}},
+	{"pluse", {0x02A72, 0x00000}},
+	{"plusmn", {0x000B1, 0x00000}},
+	{"plussim", {0x02A26, 0x00000}},
+	{"plustwo", {0x02A27, 0x00000}},
+	{"pm", {0x000B1, 0x00000}},
+	{"pointint", {0x02A15, 0x00000}},
+	{"popf", {0x1D561, 0x00000}},
+	{"pound", {0x000A3, 0x00000}},
+	{"pr", {0x0227A, 0x00000}},
+	{"prE", {0x02AB3, 0x00000}},
+	{"prap", {0x02AB7, 0x00000}},
+	{"prcue", {0x0227C, 0x00000}},
+	{"pre", {0x02AAF, 0x00000}},
+	{"prec", {0x0227A, 0x00000}},
+	{"precapprox", {0x02AB7, 0x00000}},
+	{"preccurlyeq", {0x0227C, 0x00000}},
+	{"preceq", {0x02AAF, 0x00000}},
+	{"precnapprox", {0x02AB9, 0x00000}},
+	{"precneqq", {0x02AB5, 0x00000}},
+	{"precnsim", {0x022E8, 0x00000}},
+	{"precsim", {0x0227E, 0x00000}},
+	{"prime", {0x02032, 0x00000}},
+	{"primes", {0x02119, 0x00000}},
+	{"prnE", {0x02AB5, 0x00000}},
+	{"prnap", {0x02AB9, 0x00000}},
+	{"prnsim", {0x022E8, 0x00000}},
+	{"prod", {0x0220F, 0x00000}},
+	{"profalar", {0x0232E, 0x00000}},
+	{"profline", {0x02312, 0x00000}},
+	{"profsurf", {0x02313, 0x00000}},
+	{"prop", {0x0221D, 0x00000}},
+	{"propto", {0x0221D, 0x00000}},
+	{"prsim", {0x0227E, 0x00000}},
+	{"prurel", {0x022B0, 0x00000}},
+	{"pscr", {0x1D4C5, 0x00000}},
+	{"psi", {0x003C8, 0x00000}},
+	{"puncsp", {0x02008, 0x00000}},
+	{"qfr", {0x1D52E, 0x00000}},
+	{"qint", {0x02A0C, 0x00000}},
+	{"qopf", {0x1D562, 0x00000}},
+	{"qprime", {0x02057, 0x00000}},
+	{"qscr", {0x1D4C6, 0x00000}},
+	{"quaternions", {0x0210D, 0x00000}},
+	{"quatint", {0x02A16, 0x00000}},
+	{"quest", {0x0003F, 0x00000}},
+	{"questeq", {0x0225F, 0x00000}},
+	{"quot", {0x00022, 0x00000}},
+	{"rAarr", {0x021DB, 0x00000}},
+	{"rArr", {0x021D2, 0x00000}},
+	{"rAtail", {0x0291C, 0x00000}},
+	{"rBarr", {0x0290F, 0x00000}},
+	{"rHar", {0x02964, 0x00000}},
+	{"race", {0x0223D, 0x00331}},
+	{"racute", {0x00155, 0x00000}},
+	{"radic", {0x0221A, 0x00000}},
+	{"raemptyv", {0x029B3, 0x00000}},
+	{"rang", {0x027E9, 0x00000}},
+	{"rangd", {0x02992, 0x00000}},
+	{"range", {0x029A5, 0x00000}},
+	{"rangle", {0x027E9, 0x00000}},
+	{"raquo", {0x000BB, 0x00000}},
+	{"rarr", {0x02192, 0x00000}},
+	{"rarrap", {0x02975, 0x00000}},
+	{"rarrb", {0x021E5, 0x00000}},
+	{"rarrbfs", {0x02920, 0x00000}},
+	{"rarrc", {0x02933, 0x00000}},
+	{"rarrfs", {0x0291E, 0x00000}},
+	{"rarrhk", {0x021AA, 0x00000}},
+	{"rarrlp", {0x021AC, 0x00000}},
+	{"rarrpl", {0x02945, 0x00000}},
+	{"rarrsim", {0x02974, 0x00000}},
+	{"rarrtl", {0x021A3, 0x00000}},
+	{"rarrw", {0x0219D, 0x00000}},
+	{"ratail", {0x0291A, 0x00000}},
+	{"ratio", {0x02236, 0x00000}},
+	{"rationals", {0x0211A, 0x00000}},
+	{"rbarr", {0x0290D, 0x00000}},
+	{"rbbrk", {0x02773, 0x00000}},
+	{"rbrace", {0x0007D, 0x00000}},
+	{"rbrack", {0x0005D, 0x00000}},
+	{"rbrke", {0x0298C, 0x00000}},
+	{"rbrksld", {0x0298E, 0x00000}},
+	{"rbrkslu", {0x02990, 0x00000}},
+	{"rcaron", {0x00159, 0x00000}},
+	{"rcedil", {0x00157, 0x00000}},
+	{"rceil", {0x02309, 0x00000}},
+	{"rcub", {0x0007D, 0x00000}},
+	{"rcy", {0x00440, 0x00000}},
+	{"rdca", {0x02937, 0x00000}},
+	{"rdldhar", {0x02969, 0x00000}},
+	{"rdquo", {0x0201D, 0x00000}},
+	{"rdquor", {0x0201D, 0x00000}},
+	{"rdsh", {0x021B3, 0x00000}},
+	{"real", {0x0211C, 0x00000}},
+	{"realine", {0x0211B, 0x00000}},
+	{"realpart", {0x0211C, 0x00000}},
+	{"reals", {0x0211D, 0x00000}},
+	{"rect", {0x025AD, 0x00000}},
+	{"reg", {0x000AE, 0x00000}},
+	{"rfisht", {0x0297D, 0x00000}},
+	{"rfloor", {0x0230B, 0x00000}},
+	{"rfr", {0x1D52F, 0x00000}},
+	{"rhard", {0x021C1, 0x00000}},
+	{"rharu", {0x021C0, 0x00000}},
+	{"rharul", {0x0296C, 0x00000}},
+	{"rho", {0x003C1, 0x00000}},
+	{"rhov", {0x003F1, 0x00000}},
+	{"rightarrow", {0x02192, 0x00000}},
+	{"rightarrowtail", {0x021A3, 0x00000}},
+	{"rightharpoondown", {0x021C1, 0x00000}},
+	{"rightharpoonup", {0x021C0, 0x00000}},
+	{"rightleftarrows", {0x021C4, 0x00000}},
+	{"rightleftharpoons", {0x021CC, 0x00000}},
+	{"rightrightarrows", {0x021C9, 0x00000}},
+	{"rightsquigarrow", {0x0219D, 0x00000}},
+	{"rightthreetimes", {0x022CC, 0x00000}},
+	{"ring", {0x002DA, 0x00000}},
+	{"risingdotseq", {0x02253, 0x00000}},
+	{"rlarr", {0x021C4, 0x00000}},
+	{"rlhar", {0x021CC, 0x00000}},
+	{"rlm", {0x0200F, 0x00000}},
+	{"rmoust", {0x023B1, 0x00000}},
+	{"rmoustache", {0x023B1, 0x00000}},
+	{"rnmid", {0x02AEE, 0x00000}},
+	{"roang", {0x027ED, 0x00000}},
+	{"roarr", {0x021FE, 0x00000}},
+	{"robrk", {0x027E7, 0x00000}},
+	{"ropar", {0x02986, 0x00000}},
+	{"ropf", {0x1D563, 0x00000}},
+	{"roplus", {0x02A2E, 0x00000}},
+	{"rotimes", {0x02A35, 0x00000}},
+	{"rpar", {0x00029, 0x00000}},
+	{"rpargt", {0x02994, 0x00000}},
+	{"rppolint", {0x02A12, 0x00000}},
+	{"rrarr", {0x021C9, 0x00000}},
+	{"rsaquo", {0x0203A, 0x00000}},
+	{"rscr", {0x1D4C7, 0x00000}},
+	{"rsh", {0x021B1, 0x00000}},
+	{"rsqb", {0x0005D, 0x00000}},
+	{"rsquo", {0x02019, 0x00000}},
+	{"rsquor", {0x02019, 0x00000}},
+	{"rthree", {0x022CC, 0x00000}},
+	{"rtimes", {0x022CA, 0x00000}},
+	{"rtri", {0x025B9, 0x00000}},
+	{"rtrie", {0x022B5, 0x00000}},
+	{"rtrif", {0x025B8, 0x00000}},
+	{"rtriltri", {0x029CE, 0x00000}},
+	{"ruluhar", {0x02968, 0x00000}},
+	{"rx", {0x0211E, 0x00000}},
+	{"sacute", {0x0015B, 0x00000}},
+	{"sbquo", {0x0201A, 0x00000}},
+	{"sc", {0x0227B, 0x00000}},
+	{"scE", {0x02AB4, 0x00000}},
+	{"scap", {0x02AB8, 0x00000}},
+	{"scaron", {0x00161, 0x00000}},
+	{"sccue", {0x0227D, 0x00000}},
+	{"sce", {0x02AB0, 0x00000}},
+	{"scedil", {0x0015F, 0x00000}},
+	{"scirc", {0x0015D, 0x00000}},
+	{"scnE", {0x02AB6, 0x00000}},
+	{"scnap", {0x02ABA, 0x00000}},
+	{"scnsim", {0x022E9, 0x00000}},
+	{"scpolint", {0x02A13, 0x00000}},
+	{"scsim", {0x0227F, 0x00000}},
+	{"scy", {0x00441, 0x00000}},
+	{"sdot", {0x022C5, 0x00000}},
+	{"sdotb", {0x022A1, 0x00000}},
+	{"sdote", {0x02A66, 0x00000}},
+	{"seArr", {0x021D8, 0x00000}},
+	{"searhk", {0x02925, 0x00000}},
+	{"searr", {0x02198, 0x00000}},
+	{"searrow", {0x02198, 0x00000}},
+	{"sect", {0x000A7, 0x00000}},
+	{"semi", {0x0003B, 0x00000}},
+	{"seswar", {0x02929, 0x00000}},
+	{"setminus", {0x02216, 0x00000}},
+	{"setmn", {0x02216, 0x00000}},
+	{"sext", {0x02736, 0x00000}},
+	{"sfr", {0x1D530, 0x00000}},
+	{"sfrown", {0x02322, 0x00000}},
+	{"sharp", {0x0266F, 0x00000}},
+	{"shchcy", {0x00449, 0x00000}},
+	{"shcy", {0x00448, 0x00000}},
+	{"shortmid", {0x02223, 0x00000}},
+	{"shortparallel", {0x02225, 0x00000}},
+	{"shy", {0x000AD, 0x00000}},
+	{"sigma", {0x003C3, 0x00000}},
+	{"sigmaf", {0x003C2, 0x00000}},
+	{"sigmav", {0x003C2, 0x00000}},
+	{"sim", {0x0223C, 0x00000}},
+	{"simdot", {0x02A6A, 0x00000}},
+	{"sime", {0x02243, 0x00000}},
+	{"simeq", {0x02243, 0x00000}},
+	{"simg", {0x02A9E, 0x00000}},
+	{"simgE", {0x02AA0, 0x00000}},
+	{"siml", {0x02A9D, 0x00000}},
+	{"simlE", {0x02A9F, 0x00000}},
+	{"simne", {0x02246, 0x00000}},
+	{"simplus", {0x02A24, 0x00000}},
+	{"simrarr", {0x02972, 0x00000}},
+	{"slarr", {0x02190, 0x00000}},
+	{"smallsetminus", {0x02216, 0x00000}},
+	{"smashp", {0x02A33, 0x00000}},
+	{"smeparsl", {0x029E4, 0x00000}},
+	{"smid", {0x02223, 0x00000}},
+	{"smile", {0x02323, 0x00000}},
+	{"smt", {0x02AAA, 0x00000}},
+	{"smte", {0x02AAC, 0x00000}},
+	{"smtes", {0x02AAC, 0x0FE00}},
+	{"softcy", {0x0044C, 0x00000}},
+	{"sol", {0x0002F, 0x00000}},
+	{"solb", {0x029C4, 0x00000}},
+	{"solbar", {0x0233F, 0x00000}},
+	{"sopf", {0x1D564, 0x00000}},
+	{"spades", {0x02660, 0x00000}},
+	{"spadesuit", {0x02660, 0x00000}},
+	{"spar", {0x02225, 0x00000}},
+	{"sqcap", {0x02293, 0x00000}},
+	{"sqcaps", {0x02293, 0x0FE00}},
+	{"sqcup", {0x02294, 0x00000}},
+	{"sqcups", {0x02294, 0x0FE00}},
+	{"sqsub", {0x0228F, 0x00000}},
+	{"sqsube", {0x02291, 0x00000}},
+	{"sqsubset", {0x0228F, 0x00000}},
+	{"sqsubseteq", {0x02291, 0x00000}},
+	{"sqsup", {0x02290, 0x00000}},
+	{"sqsupe", {0x02292, 0x00000}},
+	{"sqsupset", {0x02290, 0x00000}},
+	{"sqsupseteq", {0x02292, 0x00000}},
+	{"squ", {0x025A1, 0x00000}},
+	{"square", {0x025A1, 0x00000}},
+	{"squarf", {0x025AA, 0x00000}},
+	{"squf", {0x025AA, 0x00000}},
+	{"srarr", {0x02192, 0x00000}},
+	{"sscr", {0x1D4C8, 0x00000}},
+	{"ssetmn", {0x02216, 0x00000}},
+	{"ssmile", {0x02323, 0x00000}},
+	{"sstarf", {0x022C6, 0x00000}},
+	{"star", {0x02606, 0x00000}},
+	{"starf", {0x02605, 0x00000}},
+	{"straightepsilon", {0x003F5, 0x00000}},
+	{"straightphi", {0x003D5, 0x00000}},
+	{"strns", {0x000AF, 0x00000}},
+	{"sub", {0x02282, 0x00000}},
+	{"subE", {0x02AC5, 0x00000}},
+	{"subdot", {0x02ABD, 0x00000}},
+	{"sube", {0x02286, 0x00000}},
+	{"subedot", {0x02AC3, 0x00000}},
+	{"submult", {0x02AC1, 0x00000}},
+	{"subnE", {0x02ACB, 0x00000}},
+	{"subne", {0x0228A, 0x00000}},
+	{"subplus", {0x02ABF, 0x00000}},
+	{"subrarr", {0x02979, 0x00000}},
+	{"subset", {0x02282, 0x00000}},
+	{"subseteq", {0x02286, 0x00000}},
+	{"subseteqq", {0x02AC5, 0x00000}},
+	{"subsetneq", {0x0228A, 0x00000}},
+	{"subsetneqq", {0x02ACB, 0x00000}},
+	{"subsim", {0x02AC7, 0x00000}},
+	{"subsub", {0x02AD5, 0x00000}},
+	{"subsup", {0x02AD3, 0x00000}},
+	{"succ", {0x0227B, 0x00000}},
+	{"succapprox", {0x02AB8, 0x00000}},
+	{"succcurlyeq", {0x0227D, 0x00000}},
+	{"succeq", {0x02AB0, 0x00000}},
+	{"succnapprox", {0x02ABA, 0x00000}},
+	{"succneqq", {0x02AB6, 0x00000}},
+	{"succnsim", {0x022E9, 0x00000}},
+	{"succsim", {0x0227F, 0x00000}},
+	{"sum", {0x02211, 0x00000}},
+	{"sung", {0x0266A, 0x00000}},
+	{"sup", {0x02283, 0x00000}},
+	{"sup1", {0x000B9, 0x00000}},
+	{"sup2", {0x000B2, 0x00000}},
+	{"sup3", {0x000B3, 0x00000}},
+	{"supE", {0x02AC6, 0x00000}},
+	{"supdot", {0x02ABE, 0x00000}},
+	{"supdsub", {0x02AD8, 0x00000}},
+	{"supe", {0x02287, 0x00000}},
+	{"supedot", {0x02AC4, 0x00000}},
+	{"suphsol", {0x027C9, 0x00000}},
+	{"suphsub", {0x02AD7, 0x00000}},
+	{"suplarr", {0x0297B, 0x00000}},
+	{"supmult", {0x02AC2, 0x00000}},
+	{"supnE", {0x02ACC, 0x00000}},
+	{"supne", {0x0228B, 0x00000}},
+	{"supplus", {0x02AC0, 0x00000}},
+	{"supset", {0x02283, 0x00000}},
+	{"supseteq", {0x02287, 0x00000}},
+	{"supseteqq", {0x02AC6, 0x00000}},
+	{"supsetneq", {0x0228B, 0x00000}},
+	{"supsetneqq", {0x02ACC, 0x00000}},
+	{"supsim", {0x02AC8, 0x00000}},
+	{"supsub", {0x02AD4, 0x00000}},
+	{"supsup", {0x02AD6, 0x00000}},
+	{"swArr", {0x021D9, 0x00000}},
+	{"swarhk", {0x02926, 0x00000}},
+	{"swarr", {0x02199, 0x00000}},
+	{"swarrow", {0x02199, 0x00000}},
+	{"swnwar", {0x0292A, 0x00000}},
+	{"szlig", {0x000DF, 0x00000}},
+	{"target", {0x02316, 0x00000}},
+	{"tau", {0x003C4, 0x00000}},
+	{"tbrk", {0x023B4, 0x00000}},
+	{"tcaron", {0x00165, 0x00000}},
+	{"tcedil", {0x00163, 0x00000}},
+	{"tcy", {0x00442, 0x00000}},
+	{"tdot", {0x020DB, 0x00000}},
+	{"telrec", {0x02315, 0x00000}},
+	{"tfr", {0x1D531, 0x00000}},
+	{"there4", {0x02234, 0x00000}},
+	{"therefore", {0x02234, 0x00000}},
+	{"theta", {0x003B8, 0x00000}},
+	{"thetasym", {0x003D1, 0x00000}},
+	{"thetav", {0x003D1, 0x00000}},
+	{"thickapprox", {0x02248, 0x00000}},
+	{"thicksim", {0x0223C, 0x00000}},
+	{"thinsp", {0x02009, 0x00000}},
+	{"thkap", {0x02248, 0x00000}},
+	{"thksim", {0x0223C, 0x00000}},
+	{"thorn", {0x000FE, 0x00000}},
+	{"tilde", {0x002DC, 0x00000}},
+	{"times", {0x000D7, 0x00000}},
+	{"timesb", {0x022A0, 0x00000}},
+	{"timesbar", {0x02A31, 0x00000}},
+	{"timesd", {0x02A30, 0x00000}},
+	{"tint", {0x0222D, 0x00000}},
+	{"toea", {0x02928, 0x00000}},
+	{"top", {0x022A4, 0x00000}},
+	{"topbot", {0x02336, 0x00000}},
+	{"topcir", {0x02AF1, 0x00000}},
+	{"topf", {0x1D565, 0x00000}},
+	{"topfork", {0x02ADA, 0x00000}},
+	{"tosa", {0x02929, 0x00000}},
+	{"tprime", {0x02034, 0x00000}},
+	{"trade", {0x02122, 0x00000}},
+	{"triangle", {0x025B5, 0x00000}},
+	{"triangledown", {0x025BF, 0x00000}},
+	{"triangleleft", {0x025C3, 0x00000}},
+	{"trianglelefteq", {0x022B4, 0x00000}},
+	{"triangleq", {0x0225C, 0x00000}},
+	{"triangleright", {0x025B9, 0x00000}},
+	{"trianglerighteq", {0x022B5, 0x00000}},
+	{"tridot", {0x025EC, 0x00000}},
+	{"trie", {0x0225C, 0x00000}},
+	{"triminus", {0x02A3A, 0x00000}},
+	{"triplus", {0x02A39, 0x00000}},
+	{"trisb", {0x029CD, 0x00000}},
+	{"tritime", {0x02A3B, 0x00000}},
+	{"trpezium", {0x023E2, 0x00000}},
+	{"tscr", {0x1D4C9, 0x00000}},
+	{"tscy", {0x00446, 0x00000}},
+	{"tshcy", {0x0045B, 0x00000}},
+	{"tstrok", {0x00167, 0x00000}},
+	{"twixt", {0x0226C, 0x00000}},
+	{"twoheadleftarrow", {0x0219E, 0x00000}},
+	{"twoheadrightarrow", {0x021A0, 0x00000}},
+	{"uArr", {0x021D1, 0x00000}},
+	{"uHar", {0x02963, 0x00000}},
+	{"uacute", {0x000FA, 0x00000}},
+	{"uarr", {0x02191, 0x00000}},
+	{"ubrcy", {0x0045E, 0x00000}},
+	{"ubreve", {0x0016D, 0x00000}},
+	{"ucirc", {0x000FB, 0x00000}},
+	{"ucy", {0x00443, 0x00000}},
+	{"udarr", {0x021C5, 0x00000}},
+	{"udblac", {0x00171, 0x00000}},
+	{"udhar", {0x0296E, 0x00000}},
+	{"ufisht", {0x0297E, 0x00000}},
+	{"ufr", {0x1D532, 0x00000}},
+	{"ugrave", {0x000F9, 0x00000}},
+	{"uharl", {0x021BF, 0x00000}},
+	{"uharr", {0x021BE, 0x00000}},
+	{"uhblk", {0x02580, 0x00000}},
+	{"ulcorn", {0x0231C, 0x00000}},
+	{"ulcorner", {0x0231C, 0x00000}},
+	{"ulcrop", {0x0230F, 0x00000}},
+	{"ultri", {0x025F8, 0x00000}},
+	{"umacr", {0x0016B, 0x00000}},
+	{"uml", {0x000A8, 0x00000}},
+	{"uogon", {0x00173, 0x00000}},
+	{"uopf", {0x1D566, 0x00000}},
+	{"uparrow", {0x02191, 0x00000}},
+	{"updownarrow", {0x02195, 0x00000}},
+	{"upharpoonleft", {0x021BF, 0x00000}},
+	{"upharpoonright", {0x021BE, 0x00000}},
+	{"uplus", {0x0228E, 0x00000}},
+	{"upsi", {0x003C5, 0x00000}},
+	{"upsih", {0x003D2, 0x00000}},
+	{"upsilon", {0x003C5, 0x00000}},
+	{"upuparrows", {0x021C8, 0x00000}},
+	{"urcorn", {0x0231D, 0x00000}},
+	{"urcorner", {0x0231D, 0x00000}},
+	{"urcrop", {0x0230E, 0x00000}},
+	{"uring", {0x0016F, 0x00000}},
+	{"urtri", {0x025F9, 0x00000}},
+	{"uscr", {0x1D4CA, 0x00000}},
+	{"utdot", {0x022F0, 0x00000}},
+	{"utilde", {0x00169, 0x00000}},
+	{"utri", {0x025B5, 0x00000}},
+	{"utrif", {0x025B4, 0x00000}},
+	{"uuarr", {0x021C8, 0x00000}},
+	{"uuml", {0x000FC, 0x00000}},
+	{"uwangle", {0x029A7, 0x00000}},
+	{"vArr", {0x021D5, 0x00000}},
+	{"vBar", {0x02AE8, 0x00000}},
+	{"vBarv", {0x02AE9, 0x00000}},
+	{"vDash", {0x022A8, 0x00000}},
+	{"vangrt", {0x0299C, 0x00000}},
+	{"varepsilon", {0x003F5, 0x00000}},
+	{"varkappa", {0x003F0, 0x00000}},
+	{"varnothing", {0x02205, 0x00000}},
+	{"varphi", {0x003D5, 0x00000}},
+	{"varpi", {0x003D6, 0x00000}},
+	{"varpropto", {0x0221D, 0x00000}},
+	{"varr", {0x02195, 0x00000}},
+	{"varrho", {0x003F1, 0x00000}},
+	{"varsigma", {0x003C2, 0x00000}},
+	{"varsubsetneq", {0x0228A, 0x0FE00}},
+	{"varsubsetneqq", {0x02ACB, 0x0FE00}},
+	{"varsupsetneq", {0x0228B, 0x0FE00}},
+	{"varsupsetneqq", {0x02ACC, 0x0FE00}},
+	{"vartheta", {0x003D1, 0x00000}},
+	{"vartriangleleft", {0x022B2, 0x00000}},
+	{"vartriangleright", {0x022B3, 0x00000}},
+	{"vcy", {0x00432, 0x00000}},
+	{"vdash", {0x022A2, 0x00000}},
+	{"vee", {0x02228, 0x00000}},
+	{"veebar", {0x022BB, 0x00000}},
+	{"veeeq", {0x0225A, 0x00000}},
+	{"vellip", {0x022EE, 0x00000}},
+	{"verbar", {0x0007C, 0x00000}},
+	{"vert", {0x0007C, 0x00000}},
+	{"vfr", {0x1D533, 0x00000}},
+	{"vltri", {0x022B2, 0x00000}},
+	{"vnsub", {0x02282, 0x020D2}},
+	{"vnsup", {0x02283, 0x020D2}},
+	{"vopf", {0x1D567, 0x00000}},
+	{"vprop", {0x0221D, 0x00000}},
+	{"vrtri", {0x022B3, 0x00000}},
+	{"vscr", {0x1D4CB, 0x00000}},
+	{"vsubnE", {0x02ACB, 0x0FE00}},
+	{"vsubne", {0x0228A, 0x0FE00}},
+	{"vsupnE", {0x02ACC, 0x0FE00}},
+	{"vsupne", {0x0228B, 0x0FE00}},
+	{"vzigzag", {0x0299A, 0x00000}},
+	{"wcirc", {0x00175, 0x00000}},
+	{"wedbar", {0x02A5F, 0x00000}},
+	{"wedge", {0x02227, 0x00000}},
+	{"wedgeq", {0x02259, 0x00000}},
+	{"weierp", {0x02118, 0x00000}},
+	{"wfr", {0x1D534, 0x00000}},
+	{"wopf", {0x1D568, 0x00000}},
+	{"wp", {0x02118, 0x00000}},
+	{"wr", {0x02240, 0x00000}},
+	{"wreath", {0x02240, 0x00000}},
+	{"wscr", {0x1D4CC, 0x00000}},
+	{"xcap", {0x022C2, 0x00000}},
+	{"xcirc", {0x025EF, 0x00000}},
+	{"xcup", {0x022C3, 0x00000}},
+	{"xdtri", {0x025BD, 0x00000}},
+	{"xfr", {0x1D535, 0x00000}},
+	{"xhArr", {0x027FA, 0x00000}},
+	{"xharr", {0x027F7, 0x00000}},
+	{"xi", {0x003BE, 0x00000}},
+	{"xlArr", {0x027F8, 0x00000}},
+	{"xlarr", {0x027F5, 0x00000}},
+	{"xmap", {0x027FC, 0x00000}},
+	{"xnis", {0x022FB, 0x00000}},
+	{"xodot", {0x02A00, 0x00000}},
+	{"xopf", {0x1D569, 0x00000}},
+	{"xoplus", {0x02A01, 0x00000}},
+	{"xotime", {0x02A02, 0x00000}},
+	{"xrArr", {0x027F9, 0x00000}},
+	{"xrarr", {0x027F6, 0x00000}},
+	{"xscr", {0x1D4CD, 0x00000}},
+	{"xsqcup", {0x02A06, 0x00000}},
+	{"xuplus", {0x02A04, 0x00000}},
+	{"xutri", {0x025B3, 0x00000}},
+	{"xvee", {0x022C1, 0x00000}},
+	{"xwedge", {0x022C0, 0x00000}},
+	{"yacute", {0x000FD, 0x00000}},
+	{"yacy", {0x0044F, 0x00000}},
+	{"ycirc", {0x00177, 0x00000}},
+	{"ycy", {0x0044B, 0x00000}},
+	{"yen", {0x000A5, 0x00000}},
+	{"yfr", {0x1D536, 0x00000}},
+	{"yicy", {0x00457, 0x00000}},
+	{"yopf", {0x1D56A, 0x00000}},
+	{"yscr", {0x1D4CE, 0x00000}},
+	{"yucy", {0x0044E, 0x00000}},
+	{"yuml", {0x000FF, 0x00000}},
+	{"zacute", {0x0017A, 0x00000}},
+	{"zcaron", {0x0017E, 0x00000}},
+	{"zcy", {0x00437, 0x00000}},
+	{"zdot", {0x0017C, 0x00000}},
+	{"zeetrf", {0x02128, 0x00000}},
+	{"zeta", {0x003B6, 0x00000}},
+	{"zfr", {0x1D537, 0x00000}},
+	{"zhcy", {0x00436, 0x00000}},
+	{"zigrarr", {0x021DD, 0x00000}},
+	{"zopf", {0x1D56B, 0x00000}},
+	{"zscr", {0x1D4CF, 0x00000}},
+	{"zwj", {0x0200D, 0x00000}},
+	{"zwnj", {0x0200C, 0x00000}},
+	};
+
+	const int ENTITIES_COUNT = sizeof(ENTITIES) / sizeof(ENTITIES[0]);
+
+	// Compares name from table with name of given length in text, like strcmp() does.
+	int compareName(const char* name, const QChar* text, int length) {
+		for (int i = 0; i < length; i++) {
+			const int difference = (uchar) name[i] - text[i].unicode();
+
+			if (difference != 0 || name[i] == '\0') {
+				return difference;
+			}
+		}
+
+		return (uchar) name[length];
+	}
+}
+
+QString HtmlEntities::decode(const QString& text) {
+	const int first_ampersand = text.indexOf(QL1C('&'));
+
+	if (first_ampersand < 0) {
+		return text;
+	}
+
+	const QChar* copied = text.constData();
+	const QChar* pos = copied + first_ampersand;
+	const QChar* end = text.constData() + text.size();
+	QString output;
+
+	// Decoded text is never longer than the input.
+	output.reserve(text.size());
+
+	while (pos < end) {
+		if (*pos != QL1C('&')) {
+			pos++;
+			continue;
+		}
+
+		const QChar* reference_start = pos++;
+		uint code_points[2];
+		const int count = readReference(pos, end, code_points);
+
+		if (count > 0) {
+			output.append(copied, reference_start - copied);
+
+			for (int i = 0; i < count; i++) {
+				appendCodePoint(output, code_points[i]);
+			}
+
+			copied = pos;
+		}
+	}
+
+	output.append(copied, end - copied);
+	return output;
+}
+
+QString HtmlEntities::encode(const QString& text) {
+	int length = 0;
+
+	foreach (const QChar& character, text) {
+		const char* reference = referenceFor(character);
+		length += reference == nullptr ? 1 : int(strlen(reference));
+	}
+
+	if (length == text.size()) {
+		// Nothing to encode.
+		return text;
+	}
+
+	QString output;
+	output.reserve(length);
+
+	foreach (const QChar& character, text) {
+		const char* reference = referenceFor(character);
+
+		if (reference == nullptr) {
+			output.append(character);
+		}
+
+		else {
+			output.append(QLatin1String(reference));
+		}
+	}
+
+	return output;
+}
+
+int HtmlEntities::readReference(const QChar*& pos, const QChar* end, uint* code_points) {
+	if (pos < end && *pos == QL1C('#')) {
+		return readNumericReference(pos, end, code_points);
+	}
+
+	else {
+		return readNamedReference(pos, end, code_points);
+	}
+}
+
+int HtmlEntities::readNumericReference(const QChar*& pos, const QChar* end, uint* code_points) {
+	const QChar* cursor = pos + 1;
+	const bool hexadecimal = cursor < end && (*cursor == QL1C('x') || *cursor == QL1C('X'));
+	const uint base = hexadecimal ? 16 : 10;
+	const QChar* digits_start;
+	uint value = 0;
+
+	if (hexadecimal) {
+		cursor++;
+	}
+
+	digits_start = cursor;
+
+	for (; cursor < end; cursor++) {
+		const ushort character = cursor->unicode();
+		uint digit;
+
+		if (character >= '0' && character <= '9') {
+			digit = character - '0';
+		}
+
+		else if (hexadecimal && character >= 'a' && character <= 'f') {
+			digit = character - 'a' + 10;
+		}
+
+		else if (hexadecimal && character >= 'A' && character <= 'F') {
+			digit = character - 'A' + 10;
+		}
+
+		else {
+			break;
+		}
+
+		// Keep value out of Unicode range once it gets there, so that it does not overflow.
+		value = qMin(value * base + digit, 0x110000u);
+	}
+
+	if (cursor == digits_start) {
+		return 0;
+	}
+
+	// Terminating ";" may be missing, browsers accept such references too.
+	pos = cursor < end && *cursor == QL1C(';') ? cursor + 1 : cursor;
+
+	if (value == 0 || value > 0x10FFFF || (value >= 0xD800 && value <= 0xDFFF)) {
+		code_points[0] = QChar::ReplacementCharacter;
+	}
+
+	else if (value >= 0x80 && value <= 0x9F) {
+		code_points[0] = C1_REPLACEMENTS[value - 0x80];
+	}
+
+	else {
+		code_points[0] = value;
+	}
+
+	return 1;
+}
+
+int HtmlEntities::readNamedReference(const QChar*& pos, const QChar* end, uint* code_points) {
+	const QChar* cursor = pos;
+
+	while (cursor < end && cursor - pos <= MAX_ENTITY_NAME_LENGTH && cursor->unicode() < 128 && cursor->isLetterOrNumber()) {
+		cursor++;
+	}
+
+	const int length = cursor - pos;
+
+	if (length == 0 || length > MAX_ENTITY_NAME_LENGTH || cursor == end || *cursor != QL1C(';')) {
+		return 0;
+	}
+
+	int low = 0;
+	int high = ENTITIES_COUNT - 1;
+
+	while (low <= high) {
+		const int middle = (low + high) / 2;
+		const int comparison = compareName(ENTITIES[middle].m_name, pos, length);
+
+		if (comparison < 0) {
+			low = middle + 1;
+		}
+
+		else if (comparison > 0) {
+			high = middle - 1;
+		}
+
+		else {
+			code_points[0] = ENTITIES[middle].m_codePoints[0];
+			code_points[1] = ENTITIES[middle].m_codePoints[1];
+			pos = cursor + 1;
+			return code_points[1] == 0 ? 1 : 2;
+		}
+	}
+
+	return 0;
+}
+
+void HtmlEntities::appendCodePoint(QString& output, uint code_point) {
+	if (QChar::requiresSurrogates(code_point)) {
+		output.append(QChar(QChar::highSurrogate(code_point)));
+		output.append(QChar(QChar::lowSurrogate(code_point)));
+	}
+
+	else {
+		output.append(QChar(code_point));
+	}
+}
+
+const char* HtmlEntities::referenceFor(QChar character) {
+	switch (character.unicode()) {
+		case '<':
+			return "&lt;";
+
+		case '>':
+			return "&gt;";
+
+		case '&':
+			return "&amp;";
+
+		case '"':
+			return "&quot;";
+
+		case '\'':
+			return "&#039;";
+
+		case 0x00B1:
+			return "&plusmn;";
+
+		case 0x00D7:
+			return "&times;";
+
+		default:
+			return nullptr;
+	}
+}
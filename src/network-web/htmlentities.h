@@ -0,0 +1,50 @@
+// This file is part of RSS Guard.
+//
+// Copyright (C) 2011-2017 by Martin Rotter <rotter.martinos@gmail.com>
+//
+// RSS Guard is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// RSS Guard is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with RSS Guard. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef HTMLENTITIES_H
+#define HTMLENTITIES_H
+
+#include <QString>
+
+
+// Encoder and decoder of HTML character references. Both of them scan
+// input once, named references are looked up in sorted table
+// of all HTML5 named character references.
+class HtmlEntities {
+	public:
+		// Replaces named and numeric character references with
+		// characters they stand for. Unknown references are kept.
+		static QString decode(const QString& text);
+
+		// Replaces characters which have special meaning
+		// in HTML with character references.
+		static QString encode(const QString& text);
+
+	private:
+		explicit HtmlEntities();
+
+		// Reads reference which starts right after "&". Returns number of decoded
+		// code points and moves "pos" after the reference, or returns 0.
+		static int readReference(const QChar*& pos, const QChar* end, uint* code_points);
+		static int readNumericReference(const QChar*& pos, const QChar* end, uint* code_points);
+		static int readNamedReference(const QChar*& pos, const QChar* end, uint* code_points);
+
+		static void appendCodePoint(QString& output, uint code_point);
+		static const char* referenceFor(QChar character);
+};
+
+#endif // HTMLENTITIES_H
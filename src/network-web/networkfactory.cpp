@@ -130,6 +130,19 @@ QString NetworkFactory::networkErrorText(QNetworkReply::NetworkError error_code)
 }
 
 QNetworkReply::NetworkError NetworkFactory::downloadIcon(const QList<QString>& urls, int timeout, QIcon& output) {
+	QByteArray icon_data;
+	QNetworkReply::NetworkError network_result = downloadIconData(urls, timeout, icon_data);
+
+	if (network_result == QNetworkReply::NoError) {
+		QPixmap icon_pixmap;
+		icon_pixmap.loadFromData(icon_data);
+		output = QIcon(icon_pixmap);
+	}
+
+	return network_result;
+}
+
+QNetworkReply::NetworkError NetworkFactory::downloadIconData(const QList<QString>& urls, int timeout, QByteArray& output) {
 	QNetworkReply::NetworkError network_result = QNetworkReply::UnknownNetworkError;
 
 	foreach (const QString& url, urls) {
@@ -139,9 +152,7 @@ QNetworkReply::NetworkError NetworkFactory::downloadIcon(const QList<QString>& u
 		                                          QNetworkAccessManager::GetOperation).first;
 
 		if (network_result == QNetworkReply::NoError) {
-			QPixmap icon_pixmap;
-			icon_pixmap.loadFromData(icon_data);
-			output = QIcon(icon_pixmap);
+			output = icon_data;
 			break;
 		}
 	}
@@ -43,6 +43,10 @@ class NetworkFactory {
 		// given URL belongs to.
 		static QNetworkReply::NetworkError downloadIcon(const QList<QString>& urls, int timeout, QIcon& output);
 
+		// Same as above, but returns raw icon data, so it
+		// can be safely called outside of GUI thread.
+		static QNetworkReply::NetworkError downloadIconData(const QList<QString>& urls, int timeout, QByteArray& output);
+
 		static NetworkResult performNetworkOperation(const QString& url, int timeout, const QByteArray& input_data,
 		                                             const QString& input_content_type, QByteArray& output,
 		                                             QNetworkAccessManager::Operation operation,
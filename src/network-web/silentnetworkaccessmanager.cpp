@@ -21,12 +21,19 @@
 
 #include <QNetworkReply>
 #include <QAuthenticator>
+#include <QThread>
+#include <QThreadStorage>
 
 Q_GLOBAL_STATIC(SilentNetworkAccessManager, qz_silent_acmanager)
 
+// Managers owned by worker threads, they are destroyed when their thread finishes.
+static QThreadStorage<SilentNetworkAccessManager*> qz_thread_acmanagers;
+
+QAtomicInt SilentNetworkAccessManager::s_settingsRevision(0);
+
 
 SilentNetworkAccessManager::SilentNetworkAccessManager(QObject* parent)
-	: BaseNetworkAccessManager(parent) {
+	: BaseNetworkAccessManager(parent), m_settingsRevision(s_settingsRevision.load()) {
 	connect(this, &SilentNetworkAccessManager::authenticationRequired,
 	        this, &SilentNetworkAccessManager::onAuthenticationRequired, Qt::DirectConnection);
 }
@@ -39,8 +46,39 @@ SilentNetworkAccessManager* SilentNetworkAccessManager::instance() {
 	return qz_silent_acmanager();
 }
 
+SilentNetworkAccessManager* SilentNetworkAccessManager::threadInstance() {
+	if (QThread::currentThread() == qApp->thread()) {
+		// Main thread uses global manager.
+		return instance();
+	}
+
+	if (!qz_thread_acmanagers.hasLocalData()) {
+		qDebug("Creating network manager for thread '%p'.", QThread::currentThreadId());
+		qz_thread_acmanagers.setLocalData(new SilentNetworkAccessManager());
+	}
+
+	SilentNetworkAccessManager* manager = qz_thread_acmanagers.localData();
+	const int settings_revision = s_settingsRevision.load();
+
+	if (manager->m_settingsRevision != settings_revision) {
+		manager->m_settingsRevision = settings_revision;
+		manager->loadSettings();
+	}
+
+	return manager;
+}
+
+void SilentNetworkAccessManager::reloadThreadInstances() {
+	s_settingsRevision.ref();
+}
+
 void SilentNetworkAccessManager::onAuthenticationRequired(QNetworkReply* reply, QAuthenticator* authenticator) {
-	if (reply->property("protected").toBool()) {
+	if (reply->property("authentication-given").toBool()) {
+		// Credentials of this feed were already rejected, do not try them again.
+		qWarning("Item '%s' rejected given username/password.", qPrintable(reply->url().toString()));
+	}
+
+	else if (reply->property("protected").toBool()) {
 		// This feed contains authentication information, it is good.
 		authenticator->setUser(reply->property("username").toString());
 		authenticator->setPassword(reply->property("password").toString());
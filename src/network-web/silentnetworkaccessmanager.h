@@ -21,6 +21,7 @@
 #include "network-web/basenetworkaccessmanager.h"
 
 #include <QPointer>
+#include <QAtomicInt>
 
 
 // Network manager used for more communication for feeds.
@@ -36,9 +37,23 @@ class SilentNetworkAccessManager : public BaseNetworkAccessManager {
 		// Returns pointer to global silent network manager
 		static SilentNetworkAccessManager* instance();
 
+		// Returns long-lived network manager owned by calling thread.
+		// All downloads performed in one thread share this manager, so that
+		// keep-alive connections, DNS results and SSL sessions get reused.
+		static SilentNetworkAccessManager* threadInstance();
+
+		// Makes all thread-owned managers reload their settings
+		// before they are used next time.
+		static void reloadThreadInstances();
+
 	public slots:
 		// This cannot do any GUI stuff.
 		void onAuthenticationRequired(QNetworkReply* reply, QAuthenticator* authenticator);
+
+	private:
+		int m_settingsRevision;
+
+		static QAtomicInt s_settingsRevision;
 };
 
 #endif // SILENTNETWORKACCESSMANAGER_H
@@ -18,8 +18,8 @@
 #include "network-web/webfactory.h"
 
 #include "miscellaneous/application.h"
+#include "network-web/htmlentities.h"
 
-#include <QRegExp>
 #include <QProcess>
 #include <QUrl>
 #include <QDesktopServices>
@@ -27,8 +27,7 @@
 Q_GLOBAL_STATIC(WebFactory, qz_webfactory)
 
 
-WebFactory::WebFactory()
-	: m_escapes(QMap<QString, QString>()), m_deEscapes(QMap<QString, QString>()) {
+WebFactory::WebFactory() {
 }
 
 WebFactory::~WebFactory() {
@@ -75,39 +74,40 @@ WebFactory* WebFactory::instance() {
 }
 
 QString WebFactory::stripTags(QString text) {
-	return text.remove(QRegExp(QSL("<[^>]*>")));
-}
+	// Everything from "<" to the nearest following ">" is removed,
+	// text after unterminated "<" is kept as it is.
+	int tag_start = text.indexOf(QL1C('<'));
 
-QString WebFactory::escapeHtml(const QString& html) {
-	if (m_escapes.isEmpty()) {
-		genereteEscapes();
+	if (tag_start < 0) {
+		return text;
 	}
 
-	QString output = html;
-	QMapIterator<QString, QString> i(m_escapes);
+	QString output;
+	int position = 0;
+	output.reserve(text.size());
 
-	while (i.hasNext()) {
-		i.next();
-		output = output.replace(i.key(), i.value());
-	}
+	while (tag_start >= 0) {
+		const int tag_end = text.indexOf(QL1C('>'), tag_start + 1);
 
-	return output;
-}
+		if (tag_end < 0) {
+			break;
+		}
 
-QString WebFactory::deEscapeHtml(const QString& text) {
-	if (m_deEscapes.isEmpty()) {
-		generateDeescapes();
+		output.append(text.midRef(position, tag_start - position));
+		position = tag_end + 1;
+		tag_start = text.indexOf(QL1C('<'), position);
 	}
 
-	QString output = text;
-	QMapIterator<QString, QString> i(m_deEscapes);
+	output.append(text.midRef(position));
+	return output;
+}
 
-	while (i.hasNext()) {
-		i.next();
-		output = output.replace(i.key(), i.value());
-	}
+QString WebFactory::escapeHtml(const QString& html) {
+	return HtmlEntities::decode(html);
+}
 
-	return output;
+QString WebFactory::deEscapeHtml(const QString& text) {
+	return HtmlEntities::encode(text);
 }
 
 QString WebFactory::toSecondLevelDomain(const QUrl& url) {
@@ -130,24 +130,3 @@ QString WebFactory::toSecondLevelDomain(const QUrl& url) {
 
 	return domain + top_level_domain;
 }
-
-void WebFactory::genereteEscapes() {
-	m_escapes[QSL("&lt;")]     = QL1C('<');
-	m_escapes[QSL("&gt;")]     = QL1C('>');
-	m_escapes[QSL("&amp;")]    = QL1C('&');
-	m_escapes[QSL("&quot;")]   = QL1C('\"');
-	m_escapes[QSL("&nbsp;")]   = QL1C(' ');
-	m_escapes[QSL("&plusmn;")]    = QSL("±");
-	m_escapes[QSL("&times;")]  = QSL("×");
-	m_escapes[QSL("&#039;")]   = QL1C('\'');
-}
-
-void WebFactory::generateDeescapes() {
-	m_deEscapes[QSL("<")]  = QSL("&lt;");
-	m_deEscapes[QSL(">")]  = QSL("&gt;");
-	m_deEscapes[QSL("&")]  = QSL("&amp;");
-	m_deEscapes[QSL("\"")]    = QSL("&quot;");
-	m_deEscapes[QSL("±")]  = QSL("&plusmn;");
-	m_deEscapes[QSL("×")]  = QSL("&times;");
-	m_deEscapes[QSL("\'")] = QSL("&#039;");
-}
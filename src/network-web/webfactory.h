@@ -20,8 +20,6 @@
 
 #include "core/messagesmodel.h"
 
-#include <QMap>
-
 
 class QWebEngineSettings;
 
@@ -36,7 +34,8 @@ class WebFactory {
 		// Strips "<....>" (HTML, XML) tags from given text.
 		QString stripTags(QString text);
 
-		// HTML entity escaping.
+		// HTML entity escaping, "escapeHtml" decodes character
+		// references, "deEscapeHtml" creates them.
 		QString escapeHtml(const QString& html);
 		QString deEscapeHtml(const QString& text);
 
@@ -49,14 +48,6 @@ class WebFactory {
 		// Opens given string URL in external browser.
 		bool openUrlInExternalBrowser(const QString& url);
 		bool sendMessageViaEmail(const Message& message);
-
-	private:
-		// Escape sequences generators.
-		void genereteEscapes();
-		void generateDeescapes();
-
-		QMap<QString, QString> m_escapes;
-		QMap<QString, QString> m_deEscapes;
 };
 
 #endif // WEBFACTORY_H
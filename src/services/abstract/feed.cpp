@@ -21,16 +21,19 @@
 #include "miscellaneous/application.h"
 #include "miscellaneous/mutex.h"
 #include "miscellaneous/databasequeries.h"
-#include "miscellaneous/feedreader.h"
+#include "miscellaneous/textfactory.h"
 #include "services/abstract/recyclebin.h"
 #include "services/abstract/serviceroot.h"
 
+#include <QDateTime>
 #include <QThread>
 
 
 Feed::Feed(RootItem* parent)
 	: RootItem(parent), m_url(QString()), m_status(Normal), m_autoUpdateType(DefaultAutoUpdate),
-	  m_autoUpdateInitialInterval(DEFAULT_AUTO_UPDATE_INTERVAL), m_autoUpdateRemainingInterval(DEFAULT_AUTO_UPDATE_INTERVAL),
+	  m_autoUpdateInitialInterval(DEFAULT_AUTO_UPDATE_INTERVAL), m_autoUpdateDeadline(0),
+	  m_publishingInterval(0), m_autoUpdateServerHint(0), m_pendingAutoUpdateServerHint(0), m_autoUpdateErrors(0),
+	  m_autoUpdateStatisticsLoaded(false),
 	  m_totalCount(0), m_unreadCount(0) {
 	setKind(RootItemKind::Feed);
 	setAutoDelete(false);
@@ -93,6 +96,7 @@ int Feed::countOfUnreadMessages() const {
 
 void Feed::setCountOfAllMessages(int count_all_messages) {
 	m_totalCount = count_all_messages;
+	invalidateCachedCounts();
 }
 
 void Feed::setCountOfUnreadMessages(int count_unread_messages) {
@@ -101,13 +105,27 @@ void Feed::setCountOfUnreadMessages(int count_unread_messages) {
 	}
 
 	m_unreadCount = count_unread_messages;
+	invalidateCachedCounts();
+}
+
+void Feed::setCounts(int unread_count, int total_count) {
+	setCountOfAllMessages(total_count);
+	setCountOfUnreadMessages(unread_count);
+}
+
+void Feed::changeCounts(int unread_delta, int total_delta) {
+	setCountOfAllMessages(qMax(0, countOfAllMessages() + total_delta));
+	setCountOfUnreadMessages(qMax(0, countOfUnreadMessages() + unread_delta));
 }
 
 void Feed::setAutoUpdateInitialInterval(int auto_update_interval) {
-	// If new initial auto-update interval is set, then
-	// we should reset time that remains to the next auto-update.
-	m_autoUpdateInitialInterval = auto_update_interval;
-	m_autoUpdateRemainingInterval = auto_update_interval;
+	if (m_autoUpdateInitialInterval != auto_update_interval) {
+		// If new initial auto-update interval is set, then
+		// the feed must be scheduled again.
+		m_autoUpdateInitialInterval = auto_update_interval;
+		m_autoUpdateDeadline = 0;
+		emit autoUpdateScheduleChanged(this);
+	}
 }
 
 Feed::AutoUpdateType Feed::autoUpdateType() const {
@@ -115,15 +133,103 @@ Feed::AutoUpdateType Feed::autoUpdateType() const {
 }
 
 void Feed::setAutoUpdateType(Feed::AutoUpdateType auto_update_type) {
-	m_autoUpdateType = auto_update_type;
+	if (m_autoUpdateType != auto_update_type) {
+		m_autoUpdateType = auto_update_type;
+		m_autoUpdateDeadline = 0;
+		emit autoUpdateScheduleChanged(this);
+	}
 }
 
 int Feed::autoUpdateRemainingInterval() const {
-	return m_autoUpdateRemainingInterval;
+	if (m_autoUpdateDeadline <= 0) {
+		return 0;
+	}
+
+	else {
+		const qint64 remaining_msecs = m_autoUpdateDeadline - QDateTime::currentMSecsSinceEpoch();
+		return qMax(0, int((remaining_msecs + 59999) / 60000));
+	}
+}
+
+qint64 Feed::autoUpdateDeadline() const {
+	return m_autoUpdateDeadline;
+}
+
+void Feed::setAutoUpdateDeadline(qint64 auto_update_deadline) {
+	if (m_autoUpdateDeadline != auto_update_deadline) {
+		m_autoUpdateDeadline = auto_update_deadline;
+		emit autoUpdateScheduleChanged(this);
+	}
+}
+
+qint64 Feed::publishingInterval() const {
+	return m_publishingInterval;
+}
+
+int Feed::autoUpdateServerHint() const {
+	return m_autoUpdateServerHint;
+}
+
+void Feed::setAutoUpdateServerHint(int auto_update_server_hint) {
+	m_pendingAutoUpdateServerHint = auto_update_server_hint;
+}
+
+int Feed::autoUpdateErrors() const {
+	return m_autoUpdateErrors;
+}
+
+void Feed::updateAutoUpdateStatistics(QSqlDatabase database, bool error_during_obtaining) {
+	qint64 publishing_interval = -1;
+
+	if (!error_during_obtaining) {
+		bool ok;
+		const qint64 new_publishing_interval = DatabaseQueries::getPublishingIntervalForFeed(database, customId(),
+		                                                                                     getParentServiceRoot()->accountId(), &ok);
+
+		if (ok) {
+			publishing_interval = new_publishing_interval;
+		}
+	}
+
+	// Statistics are read by auto-update scheduler, thus they are changed in its thread.
+	QMetaObject::invokeMethod(this, "applyAutoUpdateStatistics", Qt::QueuedConnection,
+	                          Q_ARG(qint64, publishing_interval),
+	                          Q_ARG(int, m_pendingAutoUpdateServerHint),
+	                          Q_ARG(bool, error_during_obtaining));
+}
+
+void Feed::loadAutoUpdateStatistics(QSqlDatabase database) {
+	if (m_autoUpdateStatisticsLoaded) {
+		return;
+	}
+
+	bool ok;
+	const qint64 publishing_interval = DatabaseQueries::getPublishingIntervalForFeed(database, customId(),
+	                                                                                 getParentServiceRoot()->accountId(), &ok);
+
+	if (ok) {
+		m_publishingInterval = publishing_interval;
+		m_autoUpdateStatisticsLoaded = true;
+	}
 }
 
-void Feed::setAutoUpdateRemainingInterval(int auto_update_remaining_interval) {
-	m_autoUpdateRemainingInterval = auto_update_remaining_interval;
+void Feed::applyAutoUpdateStatistics(qint64 publishing_interval, int server_hint, bool error_during_obtaining) {
+	m_autoUpdateServerHint = server_hint;
+
+	if (error_during_obtaining) {
+		m_autoUpdateErrors++;
+	}
+
+	else {
+		if (publishing_interval >= 0) {
+			m_publishingInterval = publishing_interval;
+			m_autoUpdateStatisticsLoaded = true;
+		}
+
+		m_autoUpdateErrors = 0;
+	}
+
+	emit autoUpdateStatisticsChanged(this);
 }
 
 Feed::Status Feed::status() const {
@@ -143,10 +249,7 @@ void Feed::setUrl(const QString& url) {
 }
 
 void Feed::updateCounts(bool including_total_count) {
-	bool is_main_thread = QThread::currentThread() == qApp->thread();
-	QSqlDatabase database = is_main_thread ?
-	                        qApp->database()->connection(metaObject()->className(), DatabaseFactory::FromSettings) :
-	                        qApp->database()->connection(QSL("feed_upd"), DatabaseFactory::FromSettings);
+	QSqlDatabase database = qApp->database()->connection(metaObject()->className(), DatabaseFactory::FromSettings);
 	int account_id = getParentServiceRoot()->accountId();
 
 	if (including_total_count) {
@@ -169,56 +272,63 @@ void Feed::run() {
 	                   << QThread::currentThreadId() << "\'.";
 
 	// Now, do some general operations on messages (tweak encoding etc.).
-	for (int i = 0; i < msgs.size(); i++) {
-		// Also, make sure that HTML encoding, encoding of special characters, etc., is fixed.
-		msgs[i].m_contents = QUrl::fromPercentEncoding(msgs[i].m_contents.toUtf8());
-		msgs[i].m_author = msgs[i].m_author.toUtf8();
-		// Sanitize title. Remove newlines etc.
-		msgs[i].m_title = QUrl::fromPercentEncoding(msgs[i].m_title.toUtf8())
-		                  // Replace all continuous white space.
-		                  .replace(QRegExp(QSL("[\\s]{2,}")), QSL(" "))
-		                  // Remove all newlines and leading white space.
-		                  .remove(QRegExp(QSL("([\\n\\r])|(^\\s)")));
-	}
-
+	normalizeMessages(msgs);
 	emit messagesObtained(msgs, error_during_obtaining);
 }
 
-int Feed::updateMessages(const QList<Message>& messages, bool error_during_obtaining) {
-	QList<RootItem*> items_to_update;
-	int updated_messages = 0;
-	bool is_main_thread = QThread::currentThread() == qApp->thread();
-	qDebug("Updating messages in DB. Main thread: '%s'.", qPrintable(is_main_thread ? "true" : "false"));
+bool Feed::supportsAsynchronousUpdate() const {
+	return false;
+}
 
-	if (!error_during_obtaining) {
-		bool anything_updated = false;
-		bool ok = true;
-
-		if (!messages.isEmpty()) {
-			int custom_id = customId();
-			int account_id = getParentServiceRoot()->accountId();
-			QSqlDatabase database = is_main_thread ?
-			                        qApp->database()->connection(metaObject()->className(), DatabaseFactory::FromSettings) :
-			                        qApp->database()->connection(QSL("feed_upd"), DatabaseFactory::FromSettings);
-			updated_messages = DatabaseQueries::updateMessages(database, messages, custom_id, account_id, url(), &anything_updated, &ok);
-		}
+void Feed::startDownload(Downloader* downloader) {
+	Q_UNUSED(downloader)
+}
 
-		if (ok) {
-			setStatus(updated_messages > 0 ? NewMessages : Normal);
-			updateCounts(true);
+bool Feed::finishDownload(Downloader* downloader, QByteArray* feed_contents, bool* error_during_obtaining) {
+	Q_UNUSED(downloader)
+	Q_UNUSED(feed_contents)
+	*error_during_obtaining = true;
+	return false;
+}
 
-			if (getParentServiceRoot()->recycleBin() != nullptr && anything_updated) {
-				getParentServiceRoot()->recycleBin()->updateCounts(true);
-				items_to_update.append(getParentServiceRoot()->recycleBin());
-			}
-		}
+QList<Message> Feed::parseDownloadedData(const QByteArray& feed_contents) {
+	Q_UNUSED(feed_contents)
+	return QList<Message>();
+}
+
+void Feed::normalizeMessages(QList<Message>& messages) {
+	for (int i = 0; i < messages.size(); i++) {
+		// Also, make sure that HTML encoding, encoding of special characters, etc., is fixed.
+		messages[i].m_contents = TextFactory::fromPercentEncoding(messages[i].m_contents);
+		// Sanitize title. Remove newlines etc.
+		messages[i].m_title = TextFactory::normalizeTitle(TextFactory::fromPercentEncoding(messages[i].m_title));
+	}
+}
+
+int Feed::storeMessages(QSqlDatabase database, const QList<Message>& messages, bool* any_message_changed,
+                        QPair<int, int>* inserted_counts) {
+	qDebug("Storing messages of feed '%d' in DB. Main thread: '%s'.", customId(),
+	       qPrintable(QThread::currentThread() == qApp->thread() ? "true" : "false"));
+	int updated_messages = DatabaseQueries::updateMessages(database, messages, customId(),
+	                                                       getParentServiceRoot()->accountId(), url(),
+	                                                       any_message_changed, inserted_counts);
+
+	if (updateStateStored(database)) {
+		*any_message_changed = true;
 	}
 
-	items_to_update.append(this);
-	getParentServiceRoot()->itemChanged(items_to_update);
 	return updated_messages;
 }
 
+bool Feed::updateStateStored(QSqlDatabase database) {
+	Q_UNUSED(database)
+	return false;
+}
+
+void Feed::updateStateCommitted(bool committed) {
+	Q_UNUSED(committed)
+}
+
 QString Feed::getAutoUpdateStatusDescription() const {
 	QString auto_update_string;
 
@@ -230,7 +340,12 @@ QString Feed::getAutoUpdateStatusDescription() const {
 
 		case DefaultAutoUpdate:
 			//: Describes feed auto-update status.
-			auto_update_string = tr("uses global settings (%n minute(s) to next auto-update)", 0, qApp->feedReader()->autoUpdateRemainingInterval());
+			auto_update_string = tr("uses global settings (%n minute(s) to next auto-update)", 0, autoUpdateRemainingInterval());
+			break;
+
+		case AdaptiveAutoUpdate:
+			//: Describes feed auto-update status.
+			auto_update_string = tr("adapts to publishing rate of the feed (%n minute(s) to next auto-update)", 0, autoUpdateRemainingInterval());
 			break;
 
 		case SpecificAutoUpdate:
@@ -24,8 +24,11 @@
 
 #include <QVariant>
 #include <QRunnable>
+#include <QSqlDatabase>
 
 
+class Downloader;
+
 // Base class for "feed" nodes.
 class Feed : public RootItem, public QRunnable {
 		Q_OBJECT
@@ -35,7 +38,8 @@ class Feed : public RootItem, public QRunnable {
 		enum AutoUpdateType {
 			DontAutoUpdate      = 0,
 			DefaultAutoUpdate   = 1,
-			SpecificAutoUpdate  = 2
+			SpecificAutoUpdate  = 2,
+			AdaptiveAutoUpdate  = 3
 		};
 
 		// Specifies the actual "status" of the feed.
@@ -69,8 +73,36 @@ class Feed : public RootItem, public QRunnable {
 		AutoUpdateType autoUpdateType() const;
 		void setAutoUpdateType(AutoUpdateType auto_update_type);
 
+		// Returns number of minutes to next scheduled auto-update.
 		int autoUpdateRemainingInterval() const;
-		void setAutoUpdateRemainingInterval(int auto_update_remaining_interval);
+
+		// Time of next auto-update in milliseconds since epoch,
+		// zero if feed is not scheduled for auto-update yet.
+		qint64 autoUpdateDeadline() const;
+		void setAutoUpdateDeadline(qint64 auto_update_deadline);
+
+		// Estimated interval between publishing of messages
+		// in milliseconds, zero if not known yet.
+		qint64 publishingInterval() const;
+
+		// Minimal update interval in seconds requested
+		// by server of the feed, zero if none.
+		// NOTE: Hint set during update takes effect together
+		// with statistics of that update.
+		int autoUpdateServerHint() const;
+		void setAutoUpdateServerHint(int auto_update_server_hint);
+
+		// Number of consecutive failed updates.
+		int autoUpdateErrors() const;
+
+		// Refreshes statistics used by adaptive auto-update
+		// after results of feed update were stored. Can be called from
+		// any thread, statistics are changed in thread of the feed.
+		void updateAutoUpdateStatistics(QSqlDatabase database, bool error_during_obtaining);
+
+		// Computes statistics used by adaptive auto-update from
+		// stored messages, if they are not known yet.
+		void loadAutoUpdateStatistics(QSqlDatabase database);
 
 		Status status() const;
 		void setStatus(const Status& status);
@@ -81,16 +113,66 @@ class Feed : public RootItem, public QRunnable {
 		// Runs update in thread (thread pooled).
 		void run();
 
+		// Feeds which obtain their data with single network request
+		// can be updated asynchronously, without blocking any thread.
+		// Network request is started with startDownload(), its result
+		// is processed with finishDownload() and if it returns true, then
+		// obtained data are parsed in worker thread with parseDownloadedData().
+		// Feed may also parse its data while they are being downloaded,
+		// parseDownloadedData() then only finishes the parsing.
+		// Other feeds are updated via run().
+		virtual bool supportsAsynchronousUpdate() const;
+		virtual void startDownload(Downloader* downloader);
+		virtual bool finishDownload(Downloader* downloader, QByteArray* feed_contents, bool* error_during_obtaining);
+		virtual QList<Message> parseDownloadedData(const QByteArray& feed_contents);
+
+		// Fixes encoding and white space of downloaded messages.
+		static void normalizeMessages(QList<Message>& messages);
+
+		// Stores messages obtained during update of this feed into database.
+		// Caller is responsible for transaction handling, for setting status
+		// and for adjusting message counts afterwards.
+		// Returns number of new or updated unread messages.
+		int storeMessages(QSqlDatabase database, const QList<Message>& messages, bool* any_message_changed,
+		                  QPair<int, int>* inserted_counts = nullptr);
+
+		// Called after transaction with results of update of this feed
+		// was committed or rolled back. Feeds change in-memory copy of
+		// their update-related state here.
+		virtual void updateStateCommitted(bool committed);
+
 	public slots:
 		void updateCounts(bool including_total_count);
-		int updateMessages(const QList<Message>& messages, bool error_during_obtaining);
+
+		// Sets counts of messages obtained from the database.
+		void setCounts(int unread_count, int total_count);
+
+		// Adjusts counts of messages by known differences, so that
+		// they do not have to be recalculated from the database.
+		void changeCounts(int unread_delta, int total_delta);
+
+	private slots:
+		// Negative publishing interval means that it is not known.
+		void applyAutoUpdateStatistics(qint64 publishing_interval, int server_hint, bool error_during_obtaining);
 
 	protected:
 		QString getAutoUpdateStatusDescription() const;
 
+		// Called when messages obtained during update were stored within
+		// transaction of the caller. Feeds can persist their own update-related
+		// state here, its in-memory copy must not be changed yet.
+		// Returns true if other already stored messages were changed.
+		virtual bool updateStateStored(QSqlDatabase database);
+
 	signals:
 		void messagesObtained(QList<Message> messages, bool error_during_obtaining);
 
+		// Emitted when auto-update settings or deadline of the feed change.
+		void autoUpdateScheduleChanged(Feed* feed);
+
+		// Emitted when statistics used by adaptive auto-update change.
+		void autoUpdateStatisticsChanged(Feed* feed);
+
 	private:
 		// Performs synchronous obtaining of new messages for this feed.
 		virtual QList<Message> obtainNewMessages(bool* error_during_obtaining) = 0;
@@ -100,7 +182,12 @@ class Feed : public RootItem, public QRunnable {
 		Status m_status;
 		AutoUpdateType m_autoUpdateType;
 		int m_autoUpdateInitialInterval;
-		int m_autoUpdateRemainingInterval;
+		qint64 m_autoUpdateDeadline;
+		qint64 m_publishingInterval;
+		int m_autoUpdateServerHint;
+		int m_pendingAutoUpdateServerHint;
+		int m_autoUpdateErrors;
+		bool m_autoUpdateStatisticsLoaded;
 		int m_totalCount;
 		int m_unreadCount;
 };
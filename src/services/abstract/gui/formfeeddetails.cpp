@@ -175,6 +175,7 @@ void FormFeedDetails::onAutoUpdateTypeChanged(int new_index) {
 	switch (auto_update_type) {
 		case Feed::DontAutoUpdate:
 		case Feed::DefaultAutoUpdate:
+		case Feed::AdaptiveAutoUpdate:
 			m_ui->m_spinAutoUpdateInterval->setEnabled(false);
 			break;
 
@@ -383,6 +384,7 @@ void FormFeedDetails::initialize() {
 	m_ui->m_spinAutoUpdateInterval->setValue(DEFAULT_AUTO_UPDATE_INTERVAL);
 	m_ui->m_cmbAutoUpdateType->addItem(tr("Auto-update using global interval"), QVariant::fromValue((int) Feed::DefaultAutoUpdate));
 	m_ui->m_cmbAutoUpdateType->addItem(tr("Auto-update every"), QVariant::fromValue((int) Feed::SpecificAutoUpdate));
+	m_ui->m_cmbAutoUpdateType->addItem(tr("Auto-update adaptively"), QVariant::fromValue((int) Feed::AdaptiveAutoUpdate));
 	m_ui->m_cmbAutoUpdateType->addItem(tr("Do not auto-update at all"), QVariant::fromValue((int) Feed::DontAutoUpdate));
 	// Set tab order.
 	setTabOrder(m_ui->m_cmbParentCategory, m_ui->m_cmbType);
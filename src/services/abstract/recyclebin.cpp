@@ -23,8 +23,6 @@
 #include "miscellaneous/databasequeries.h"
 #include "services/abstract/serviceroot.h"
 
-#include <QThread>
-
 
 RecycleBin::RecycleBin(RootItem* parent_item) : RootItem(parent_item), m_totalCount(0),
 	m_unreadCount(0), m_contextMenu(QList<QAction*>()) {
@@ -48,15 +46,26 @@ int RecycleBin::countOfAllMessages() const {
 }
 
 void RecycleBin::updateCounts(bool update_total_count) {
-	bool is_main_thread = QThread::currentThread() == qApp->thread();
-	QSqlDatabase database = is_main_thread ?
-	                        qApp->database()->connection(metaObject()->className(), DatabaseFactory::FromSettings) :
-	                        qApp->database()->connection(QSL("feed_upd"), DatabaseFactory::FromSettings);
+	QSqlDatabase database = qApp->database()->connection(metaObject()->className(), DatabaseFactory::FromSettings);
 	m_unreadCount = DatabaseQueries::getMessageCountsForBin(database, getParentServiceRoot()->accountId(), false);
 
 	if (update_total_count) {
 		m_totalCount = DatabaseQueries::getMessageCountsForBin(database, getParentServiceRoot()->accountId(), true);
 	}
+
+	invalidateCachedCounts();
+}
+
+void RecycleBin::setCounts(int unread_count, int total_count) {
+	m_unreadCount = unread_count;
+	m_totalCount = total_count;
+	invalidateCachedCounts();
+}
+
+void RecycleBin::changeCounts(int unread_delta, int total_delta) {
+	m_unreadCount = qMax(0, m_unreadCount + unread_delta);
+	m_totalCount = qMax(0, m_totalCount + total_delta);
+	invalidateCachedCounts();
 }
 
 QVariant RecycleBin::data(int column, int role) const {
@@ -97,7 +106,7 @@ bool RecycleBin::markAsReadUnread(RootItem::ReadStatus status) {
 	ServiceRoot* parent_root = getParentServiceRoot();
 
 	if (DatabaseQueries::markBinReadUnread(database, parent_root->accountId(), status)) {
-		updateCounts(false);
+		changeCounts((status == RootItem::Read ? 0 : m_totalCount) - m_unreadCount, 0);
 		parent_root->itemChanged(QList<RootItem*>() << this);
 		parent_root->requestReloadMessageList(status == RootItem::Read);
 		return true;
@@ -113,7 +122,7 @@ bool RecycleBin::cleanMessages(bool clear_only_read) {
 	ServiceRoot* parent_root = getParentServiceRoot();
 
 	if (DatabaseQueries::purgeMessagesFromBin(database, clear_only_read, parent_root->accountId())) {
-		updateCounts(true);
+		changeCounts(clear_only_read ? 0 : -m_unreadCount, clear_only_read ? m_unreadCount - m_totalCount : -m_totalCount);
 		parent_root->itemChanged(QList<RootItem*>() << this);
 		parent_root->requestReloadMessageList(true);
 		return true;;
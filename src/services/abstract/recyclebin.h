@@ -39,9 +39,15 @@ class RecycleBin : public RootItem {
 		int countOfUnreadMessages() const;
 		int countOfAllMessages() const;
 
+	public slots:
 		void updateCounts(bool update_total_count);
 
-	public slots:
+		// Sets counts of messages obtained from the database.
+		void setCounts(int unread_count, int total_count);
+
+		// Adjusts counts of messages by known differences.
+		void changeCounts(int unread_delta, int total_delta);
+
 		/////////////////////////////////////////
 		// /* Members to override.
 		/////////////////////////////////////////
@@ -36,7 +36,10 @@ RootItem::RootItem(RootItem* parent_item)
 	  m_icon(QIcon()),
 	  m_creationDate(QDateTime()),
 	  m_childItems(QList<RootItem*>()),
-	  m_parentItem(parent_item) {
+	  m_parentItem(parent_item),
+	  m_cachedCountsValid(false),
+	  m_cachedUnreadCount(0),
+	  m_cachedTotalCount(0) {
 	setupFonts();
 }
 
@@ -213,13 +216,11 @@ bool RootItem::performDragDropChange(RootItem* target_item) {
 }
 
 int RootItem::countOfAllMessages() const {
-	int total_count = 0;
-
-	foreach (RootItem* child_item, m_childItems) {
-		total_count += child_item->countOfAllMessages();
+	if (!m_cachedCountsValid) {
+		calculateCachedCounts();
 	}
 
-	return total_count;
+	return m_cachedTotalCount;
 }
 
 bool RootItem::isChildOf(const RootItem* root) const {
@@ -443,7 +444,14 @@ void RootItem::setBoldFont(const QFont& bold_font) {
 }
 
 bool RootItem::removeChild(RootItem* child) {
-	return m_childItems.removeOne(child);
+	if (m_childItems.removeOne(child)) {
+		invalidateCachedCounts();
+		return true;
+	}
+
+	else {
+		return false;
+	}
 }
 
 int RootItem::customId() const {
@@ -467,18 +475,43 @@ ServiceRoot* RootItem::toServiceRoot() const {
 }
 
 int RootItem::countOfUnreadMessages() const {
+	if (!m_cachedCountsValid) {
+		calculateCachedCounts();
+	}
+
+	return m_cachedUnreadCount;
+}
+
+void RootItem::invalidateCachedCounts() {
+	m_cachedCountsValid = false;
+
+	// Parent sums are calculated from sums of children, so
+	// we can stop at first parent which is already outdated.
+	for (RootItem* item = parent(); item != nullptr && item->m_cachedCountsValid; item = item->parent()) {
+		item->m_cachedCountsValid = false;
+	}
+}
+
+void RootItem::calculateCachedCounts() const {
+	int unread_count = 0;
 	int total_count = 0;
 
+	// NOTE: Counts are changed and summed only in main thread,
+	// feed update thread passes new counts via queued calls.
 	foreach (RootItem* child_item, m_childItems) {
-		total_count += child_item->countOfUnreadMessages();
+		unread_count += child_item->countOfUnreadMessages();
+		total_count += child_item->countOfAllMessages();
 	}
 
-	return total_count;
+	m_cachedUnreadCount = unread_count;
+	m_cachedTotalCount = total_count;
+	m_cachedCountsValid = true;
 }
 
 bool RootItem::removeChild(int index) {
 	if (index >= 0 && index < m_childItems.size()) {
 		m_childItems.removeAt(index);
+		invalidateCachedCounts();
 		return true;
 	}
 
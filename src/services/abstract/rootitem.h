@@ -117,7 +117,8 @@ class RootItem : public QObject {
 		virtual bool performDragDropChange(RootItem* target_item);
 
 		// Each item offers "counts" of messages.
-		// Returns counts of messages of all child items summed up.
+		// Returns counts of messages of all child items summed up,
+		// the sums are cached until counts of some child change.
 		virtual int countOfUnreadMessages() const;
 		virtual int countOfAllMessages() const;
 
@@ -140,6 +141,7 @@ class RootItem : public QObject {
 		inline void appendChild(RootItem* child) {
 			m_childItems.append(child);
 			child->setParent(this);
+			invalidateCachedCounts();
 		}
 
 		// Access to children.
@@ -151,10 +153,12 @@ class RootItem : public QObject {
 		// NOTE: Children are NOT freed from the memory.
 		inline void clearChildren() {
 			m_childItems.clear();
+			invalidateCachedCounts();
 		}
 
 		inline void setChildItems(const QList<RootItem*>& child_items) {
 			m_childItems = child_items;
+			invalidateCachedCounts();
 		}
 
 		// Removes particular child at given index.
@@ -218,8 +222,14 @@ class RootItem : public QObject {
 		Feed* toFeed() const;
 		ServiceRoot* toServiceRoot() const;
 
+	protected:
+		// Marks cached sums of message counts of this item
+		// and of all its parents as outdated.
+		void invalidateCachedCounts();
+
 	private:
 		void setupFonts();
+		void calculateCachedCounts() const;
 
 		RootItemKind::Kind m_kind;
 		int m_id;
@@ -234,6 +244,10 @@ class RootItem : public QObject {
 
 		QList<RootItem*> m_childItems;
 		RootItem* m_parentItem;
+
+		mutable bool m_cachedCountsValid;
+		mutable int m_cachedUnreadCount;
+		mutable int m_cachedTotalCount;
 };
 
 #endif // ROOTITEM_H
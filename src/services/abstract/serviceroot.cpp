@@ -53,7 +53,16 @@ bool ServiceRoot::markAsReadUnread(RootItem::ReadStatus status) {
 	QSqlDatabase database = qApp->database()->connection(metaObject()->className(), DatabaseFactory::FromSettings);
 
 	if (DatabaseQueries::markAccountReadUnread(database, accountId(), status)) {
-		updateCounts(false);
+		foreach (Feed* feed, getSubTreeFeeds()) {
+			feed->setCountOfUnreadMessages(status == RootItem::Read ? 0 : feed->countOfAllMessages());
+		}
+
+		RecycleBin* bin = recycleBin();
+
+		if (bin != nullptr) {
+			bin->changeCounts((status == RootItem::Read ? 0 : bin->countOfAllMessages()) - bin->countOfUnreadMessages(), 0);
+		}
+
 		itemChanged(getSubTree());
 		requestReloadMessageList(status == RootItem::Read);
 		return true;
@@ -146,16 +155,32 @@ bool ServiceRoot::cleanFeeds(QList<Feed*> items, bool clean_read_only) {
 	if (DatabaseQueries::cleanFeeds(database, textualFeedIds(items), clean_read_only, accountId())) {
 		// Messages are cleared, now inform model about need to reload data.
 		QList<RootItem*> itemss;
+		int moved_unread = 0;
+		int moved_total = 0;
 
 		foreach (Feed* feed, items) {
-			feed->updateCounts(true);
+			const int unread_count = feed->countOfUnreadMessages();
+			const int total_count = feed->countOfAllMessages();
+
+			if (clean_read_only) {
+				moved_total += total_count - unread_count;
+				feed->setCountOfAllMessages(unread_count);
+			}
+
+			else {
+				moved_unread += unread_count;
+				moved_total += total_count;
+				feed->setCountOfUnreadMessages(0);
+				feed->setCountOfAllMessages(0);
+			}
+
 			itemss.append(feed);
 		}
 
 		RecycleBin* bin = recycleBin();
 
 		if (bin != nullptr) {
-			bin->updateCounts(true);
+			bin->changeCounts(moved_unread, moved_total);
 			itemss.append(bin);
 		}
 
@@ -327,7 +352,7 @@ bool ServiceRoot::markFeedsReadUnread(QList<Feed*> items, RootItem::ReadStatus r
 		QList<RootItem*> itemss;
 
 		foreach (Feed* feed, items) {
-			feed->updateCounts(false);
+			feed->setCountOfUnreadMessages(read == RootItem::Read ? 0 : feed->countOfAllMessages());
 			itemss.append(feed);
 		}
 
@@ -405,10 +430,25 @@ bool ServiceRoot::onBeforeSetMessagesRead(RootItem* selected_item, const QList<M
 	return true;
 }
 
-bool ServiceRoot::onAfterSetMessagesRead(RootItem* selected_item, const QList<Message>& messages, RootItem::ReadStatus read) {
+bool ServiceRoot::onAfterSetMessagesRead(RootItem* selected_item, const QList<Message>& messages, RootItem::ReadStatus read,
+                                         const QMap<int, QPair<int, int>>& changed_counts) {
 	Q_UNUSED(messages)
-	Q_UNUSED(read)
-	selected_item->updateCounts(false);
+
+	// Counts are adjusted only by messages which really flipped their read status.
+	if (selected_item->kind() == RootItemKind::Bin) {
+		int changed_messages = 0;
+
+		foreach (const QPair<int, int>& counts, changed_counts) {
+			changed_messages += counts.second;
+		}
+
+		recycleBin()->changeCounts(read == RootItem::Read ? -changed_messages : changed_messages, 0);
+	}
+
+	else {
+		changeCountsOfFeeds(selected_item, changed_counts, read == RootItem::Read ? -1 : 1, 0);
+	}
+
 	itemChanged(QList<RootItem*>() << selected_item);
 	return true;
 }
@@ -431,19 +471,31 @@ bool ServiceRoot::onBeforeMessagesDelete(RootItem* selected_item, const QList<Me
 	return true;
 }
 
-bool ServiceRoot::onAfterMessagesDelete(RootItem* selected_item, const QList<Message>& messages) {
+bool ServiceRoot::onAfterMessagesDelete(RootItem* selected_item, const QList<Message>& messages,
+                                        const QMap<int, QPair<int, int>>& changed_counts) {
 	Q_UNUSED(messages)
+
 	// User deleted some messages he selected in message list.
-	selected_item->updateCounts(true);
 	RecycleBin* bin = recycleBin();
+	int unread_count = 0;
+	int total_count = 0;
+
+	foreach (const QPair<int, int>& counts, changed_counts) {
+		unread_count += counts.first;
+		total_count += counts.second;
+	}
 
 	if (selected_item->kind() == RootItemKind::Bin) {
+		// Messages were purged from recycle bin.
+		bin->changeCounts(-unread_count, -total_count);
 		itemChanged(QList<RootItem*>() << bin);
 	}
 
 	else {
+		changeCountsOfFeeds(selected_item, changed_counts, -1, -1);
+
 		if (bin != nullptr) {
-			bin->updateCounts(true);
+			bin->changeCounts(unread_count, total_count);
 			itemChanged(QList<RootItem*>() << selected_item << bin);
 		}
 
@@ -461,14 +513,56 @@ bool ServiceRoot::onBeforeMessagesRestoredFromBin(RootItem* selected_item, const
 	return true;
 }
 
-bool ServiceRoot::onAfterMessagesRestoredFromBin(RootItem* selected_item, const QList<Message>& messages) {
+bool ServiceRoot::onAfterMessagesRestoredFromBin(RootItem* selected_item, const QList<Message>& messages,
+                                                 const QMap<int, QPair<int, int>>& changed_counts) {
 	Q_UNUSED(selected_item)
 	Q_UNUSED(messages)
-	updateCounts(true);
-	itemChanged(getSubTree());
+	RecycleBin* bin = recycleBin();
+	QList<RootItem*> changed_items = changeCountsOfFeeds(this, changed_counts, 1, 1);
+
+	if (bin != nullptr) {
+		int unread_count = 0;
+		int total_count = 0;
+
+		foreach (const QPair<int, int>& counts, changed_counts) {
+			unread_count += counts.first;
+			total_count += counts.second;
+		}
+
+		bin->changeCounts(-unread_count, -total_count);
+		changed_items.append(bin);
+	}
+
+	itemChanged(changed_items);
 	return true;
 }
 
+QList<RootItem*> ServiceRoot::changeCountsOfFeeds(RootItem* subtree_root, const QMap<int, QPair<int, int>>& changed_counts,
+                                                  int unread_delta, int total_delta) {
+	QList<RootItem*> changed_feeds;
+
+	if (changed_counts.isEmpty()) {
+		return changed_feeds;
+	}
+
+	const QHash<int, Feed*> feeds = subtree_root->getHashedSubTreeFeeds();
+
+	for (QMap<int, QPair<int, int>>::const_iterator i = changed_counts.constBegin(); i != changed_counts.constEnd(); i++) {
+		Feed* feed = feeds.value(i.key());
+
+		// Feed of the messages might not be in the tree anymore.
+		if (feed != nullptr) {
+			// If messages only flipped their read status, then each of them changes unread count,
+			// if messages were moved, then only unread ones change unread count.
+			feed->changeCounts(unread_delta * (total_delta == 0 ? i.value().second : i.value().first),
+			                   total_delta * i.value().second);
+			changed_feeds.append(feed);
+		}
+	}
+
+	return changed_feeds;
+}
+
 void ServiceRoot::assembleFeeds(Assignment feeds) {
 	QHash<int, Category*> categories = getHashedSubTreeCategories();
 
@@ -70,6 +70,9 @@ class ServiceRoot : public RootItem {
 		// Access to recycle bin of this account if there is any.
 		virtual RecycleBin* recycleBin() const = 0;
 
+		// Recalculates counts of messages of all items from database.
+		// Counts are normally adjusted incrementally when messages change,
+		// this serves as full reconciliation.
 		void updateCounts(bool including_total_count);
 
 		QList<Message> undeletedMessages() const;
@@ -118,7 +121,9 @@ class ServiceRoot : public RootItem {
 		// which items are actually changed.
 		//
 		// "read" is status which is ABOUT TO BE SET.
-		virtual bool onAfterSetMessagesRead(RootItem* selected_item, const QList<Message>& messages, ReadStatus read);
+		// "changed_counts" are numbers of really changed messages as returned by DatabaseQueries.
+		virtual bool onAfterSetMessagesRead(RootItem* selected_item, const QList<Message>& messages, ReadStatus read,
+		                                    const QMap<int, QPair<int, int>>& changed_counts);
 
 		// Called BEFORE this importance switch update is stored in DB,
 		// when false is returned, change is aborted.
@@ -142,7 +147,8 @@ class ServiceRoot : public RootItem {
 
 		// Called AFTER the list of messages was deleted
 		// by the user from message list.
-		virtual bool onAfterMessagesDelete(RootItem* selected_item, const QList<Message>& messages);
+		virtual bool onAfterMessagesDelete(RootItem* selected_item, const QList<Message>& messages,
+		                                   const QMap<int, QPair<int, int>>& changed_counts);
 
 		// Called BEFORE the list of messages is about to be restored from recycle bin
 		// by the user from message list.
@@ -152,7 +158,8 @@ class ServiceRoot : public RootItem {
 		// Called AFTER the list of messages was restored from recycle bin
 		// by the user from message list.
 		// Selected item is naturally recycle bin.
-		virtual bool onAfterMessagesRestoredFromBin(RootItem* selected_item, const QList<Message>& messages);
+		virtual bool onAfterMessagesRestoredFromBin(RootItem* selected_item, const QList<Message>& messages,
+		                                            const QMap<int, QPair<int, int>>& changed_counts);
 
 		void completelyRemoveAllData();
 		QStringList customIDSOfMessagesForItem(RootItem* item);
@@ -172,6 +179,12 @@ class ServiceRoot : public RootItem {
 		virtual void syncIn();
 
 	protected:
+		// Adjusts counts of feeds (from given subtree) by numbers of changed messages, each
+		// changed unread message changes unread count by "unread_delta" and each changed message
+		// changes total count by "total_delta". Returns list of feeds whose counts were changed.
+		QList<RootItem*> changeCountsOfFeeds(RootItem* subtree_root, const QMap<int, QPair<int, int>>& changed_counts,
+		                                     int unread_delta, int total_delta);
+
 		// This method should obtain new tree of feed/messages/etc to perform
 		// sync in.
 		virtual RootItem* obtainNewTreeForSyncIn() const;
@@ -35,7 +35,7 @@
 OwnCloudNetworkFactory::OwnCloudNetworkFactory()
 	: m_url(QString()), m_fixedUrl(QString()), m_forceServerSideUpdate(false),
 	  m_authUsername(QString()), m_authPassword(QString()), m_urlUser(QString()), m_urlStatus(QString()),
-	  m_urlFolders(QString()), m_urlFeeds(QString()), m_urlMessages(QString()), m_urlFeedsUpdate(QString()),
+	  m_urlFolders(QString()), m_urlFeeds(QString()), m_urlUpdatedMessages(QString()), m_urlFeedsUpdate(QString()),
 	  m_urlDeleteFeed(QString()), m_urlRenameFeed(QString()), m_userId(QString()) {
 }
 
@@ -62,7 +62,7 @@ void OwnCloudNetworkFactory::setUrl(const QString& url) {
 	m_urlStatus = m_fixedUrl + API_PATH + "status";
 	m_urlFolders = m_fixedUrl + API_PATH + "folders";
 	m_urlFeeds = m_fixedUrl + API_PATH + "feeds";
-	m_urlMessages = m_fixedUrl + API_PATH + "items?id=%1&batchSize=%2&type=%3";
+	m_urlUpdatedMessages = m_fixedUrl + API_PATH + "items/updated?lastModified=%1&type=%2&id=%3";
 	m_urlFeedsUpdate = m_fixedUrl + API_PATH + "feeds/update?userId=%1&feedId=%2";
 	m_urlDeleteFeed = m_fixedUrl + API_PATH + "feeds/%1";
 	m_urlRenameFeed = m_fixedUrl + API_PATH + "feeds/%1/rename";
@@ -245,14 +245,11 @@ bool OwnCloudNetworkFactory::renameFeed(const QString& new_name, int feed_id) {
 	}
 }
 
-OwnCloudGetMessagesResponse OwnCloudNetworkFactory::getMessages(int feed_id) {
-	if (forceServerSideUpdate()) {
-		triggerFeedUpdate(feed_id);
-	}
-
-	QString final_url = m_urlMessages.arg(QString::number(feed_id),
-	                                      QString::number(-1),
-	                                      QString::number(0));
+OwnCloudGetMessagesResponse OwnCloudNetworkFactory::getUpdatedMessages(qint64 last_modified) {
+	// Type 3 stands for all items, ID is then ignored.
+	QString final_url = m_urlUpdatedMessages.arg(QString::number(last_modified),
+	                                             QString::number(3),
+	                                             QString::number(0));
 	QByteArray result_raw;
 	NetworkResult network_reply = NetworkFactory::performNetworkOperation(final_url,
 	                              qApp->settings()->value(GROUP(Feeds),
@@ -579,3 +576,14 @@ QList<Message> OwnCloudGetMessagesResponse::messages() const {
 
 	return msgs;
 }
+
+qint64 OwnCloudGetMessagesResponse::lastModified() const {
+	qint64 last_modified = 0;
+
+	foreach (const QJsonValue& message, m_rawContent["items"].toArray()) {
+		// NOTE: Newer versions of the News app send microseconds as string.
+		last_modified = qMax(last_modified, message.toObject()["lastModified"].toVariant().toLongLong());
+	}
+
+	return last_modified;
+}
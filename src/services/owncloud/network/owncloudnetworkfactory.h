@@ -58,6 +58,10 @@ class OwnCloudGetMessagesResponse : public OwnCloudResponse {
 		virtual ~OwnCloudGetMessagesResponse();
 
 		QList<Message> messages() const;
+
+		// Returns the latest modification time of returned messages,
+		// in units used by the server.
+		qint64 lastModified() const;
 };
 
 class OwnCloudStatusResponse : public OwnCloudResponse {
@@ -125,8 +129,8 @@ class OwnCloudNetworkFactory {
 		bool createFeed(const QString& url, int parent_id);
 		bool renameFeed(const QString& new_name, int feed_id);
 
-		// Get messages for given feed.
-		OwnCloudGetMessagesResponse getMessages(int feed_id);
+		// Get messages of all feeds which were created or changed after given time.
+		OwnCloudGetMessagesResponse getUpdatedMessages(qint64 last_modified);
 
 		// Misc methods.
 		QNetworkReply::NetworkError triggerFeedUpdate(int feed_id);
@@ -147,7 +151,7 @@ class OwnCloudNetworkFactory {
 		QString m_urlStatus;
 		QString m_urlFolders;
 		QString m_urlFeeds;
-		QString m_urlMessages;
+		QString m_urlUpdatedMessages;
 		QString m_urlFeedsUpdate;
 		QString m_urlDeleteFeed;
 		QString m_urlRenameFeed;
@@ -35,6 +35,7 @@ OwnCloudFeed::OwnCloudFeed(const QSqlRecord& record) : Feed(nullptr) {
 	setIcon(qApp->icons()->fromByteArray(record.value(FDS_DB_ICON_INDEX).toByteArray()));
 	setAutoUpdateType(static_cast<Feed::AutoUpdateType>(record.value(FDS_DB_UPDATE_TYPE_INDEX).toInt()));
 	setAutoUpdateInitialInterval(record.value(FDS_DB_UPDATE_INTERVAL_INDEX).toInt());
+	setAutoUpdateDeadline(record.value(FDS_DB_UPDATE_DEADLINE_INDEX).toLongLong());
 	setCustomId(record.value(FDS_DB_CUSTOM_ID_INDEX).toInt());
 	qDebug("Custom ID of Nextcloud feed when loading from DB is '%s'.", qPrintable(record.value(FDS_DB_CUSTOM_ID_INDEX).toString()));
 }
@@ -103,19 +104,12 @@ OwnCloudServiceRoot* OwnCloudFeed::serviceRoot() const {
 }
 
 QList<Message> OwnCloudFeed::obtainNewMessages(bool* error_during_obtaining) {
-	OwnCloudGetMessagesResponse messages = serviceRoot()->network()->getMessages(customId());
+	const QList<Message> messages = serviceRoot()->obtainNewMessages(customId(), error_during_obtaining);
 
-	if (serviceRoot()->network()->lastError() != QNetworkReply::NoError) {
+	if (*error_during_obtaining) {
 		setStatus(Feed::NetworkError);
-		*error_during_obtaining = true;
 		serviceRoot()->itemChanged(QList<RootItem*>() << this);
-		return QList<Message>();
 	}
 
-	else {
-		*error_during_obtaining = false;
-		return messages.messages();
-	}
-
-	return QList<Message>();
+	return messages;
 }
@@ -34,7 +34,8 @@
 
 OwnCloudServiceRoot::OwnCloudServiceRoot(RootItem* parent)
 	: ServiceRoot(parent), CacheForServiceRoot(), m_recycleBin(new OwnCloudRecycleBin(this)),
-	  m_actionSyncIn(nullptr), m_serviceMenu(QList<QAction*>()), m_network(new OwnCloudNetworkFactory()) {
+	  m_actionSyncIn(nullptr), m_serviceMenu(QList<QAction*>()), m_network(new OwnCloudNetworkFactory()),
+	  m_lastModified(0), m_lastModifiedHandedOut(0) {
 	setIcon(OwnCloudServiceEntryPoint().icon());
 }
 
@@ -100,6 +101,10 @@ void OwnCloudServiceRoot::start(bool freshly_activated) {
 }
 
 void OwnCloudServiceRoot::stop() {
+	QSqlDatabase database = qApp->database()->connection(metaObject()->className(), DatabaseFactory::FromSettings);
+
+	// Messages which were obtained but not handed to their feeds are obtained again next time.
+	DatabaseQueries::storeOwnCloudLastModified(database, m_lastModifiedHandedOut, accountId());
 }
 
 QString OwnCloudServiceRoot::code() const {
@@ -115,6 +120,82 @@ OwnCloudNetworkFactory* OwnCloudServiceRoot::network() const {
 	return m_network;
 }
 
+qint64 OwnCloudServiceRoot::lastModified() const {
+	return m_lastModified;
+}
+
+void OwnCloudServiceRoot::setLastModified(qint64 last_modified) {
+	m_lastModified = last_modified;
+	m_lastModifiedHandedOut = last_modified;
+}
+
+QList<Message> OwnCloudServiceRoot::obtainNewMessages(int feed_custom_id, bool* error_during_obtaining) {
+	QMutexLocker locker(&m_pendingMessagesMutex);
+
+	if (m_network->forceServerSideUpdate()) {
+		m_network->triggerFeedUpdate(feed_custom_id);
+	}
+
+	// Messages of this feed were already handed out, changes are obtained for all feeds.
+	if (!m_pendingMessages.contains(feed_custom_id) && !obtainUpdatedMessages()) {
+		*error_during_obtaining = true;
+		return QList<Message>();
+	}
+
+	const QList<Message> messages = m_pendingMessages.take(feed_custom_id);
+
+	if (m_pendingMessages.isEmpty()) {
+		m_lastModifiedHandedOut = m_lastModified;
+	}
+
+	*error_during_obtaining = false;
+	return messages;
+}
+
+bool OwnCloudServiceRoot::obtainUpdatedMessages() {
+	OwnCloudGetMessagesResponse response = m_network->getUpdatedMessages(m_lastModified);
+
+	if (m_network->lastError() != QNetworkReply::NoError) {
+		return false;
+	}
+
+	const QList<Message> messages = response.messages();
+	QSet<int> feed_ids;
+
+	foreach (const Feed* feed, getSubTreeFeeds()) {
+		feed_ids.insert(feed->customId());
+
+		if (!m_pendingMessages.contains(feed->customId())) {
+			m_pendingMessages.insert(feed->customId(), QList<Message>());
+		}
+	}
+
+	foreach (const Message& message, messages) {
+		if (!feed_ids.contains(message.m_feedId.toInt())) {
+			// Feed is not known locally yet, its messages are obtained
+			// once feeds are synchronized. Nobody would take them now.
+			continue;
+		}
+
+		QList<Message>& feed_messages = m_pendingMessages[message.m_feedId.toInt()];
+
+		// If feed did not take its messages obtained earlier, older state
+		// of the same message is replaced.
+		for (int i = 0; i < feed_messages.size(); i++) {
+			if (feed_messages.at(i).m_customId == message.m_customId) {
+				feed_messages.removeAt(i);
+				break;
+			}
+		}
+
+		feed_messages.append(message);
+	}
+
+	m_lastModified = qMax(m_lastModified, response.lastModified());
+	qDebug("ownCloud: Obtained %d changed messages of account '%d'.", messages.size(), accountId());
+	return true;
+}
+
 void OwnCloudServiceRoot::saveAllCachedData() {
 	QPair<QMap<RootItem::ReadStatus, QStringList>, QMap<RootItem::Importance, QList<Message>>> msgCache = takeMessageCache();
 	QMapIterator<RootItem::ReadStatus, QStringList> i(msgCache.first);
@@ -204,6 +285,9 @@ void OwnCloudServiceRoot::saveAccountDataToDatabase() {
 		if (DatabaseQueries::overwriteOwnCloudAccount(database, m_network->authUsername(),
 		                                              m_network->authPassword(), m_network->url(),
 		                                              m_network->forceServerSideUpdate(), accountId())) {
+			// All data of edited account are obtained again.
+			setLastModified(0);
+			DatabaseQueries::storeOwnCloudLastModified(database, 0, accountId());
 			updateTitle();
 			itemChanged(QList<RootItem*>() << this);
 		}
@@ -252,6 +336,7 @@ QMap<int, QVariant> OwnCloudServiceRoot::storeCustomFeedsData() {
 		QVariantMap feed_custom_data;
 		feed_custom_data.insert(QSL("auto_update_interval"), feed->autoUpdateInitialInterval());
 		feed_custom_data.insert(QSL("auto_update_type"), feed->autoUpdateType());
+		feed_custom_data.insert(QSL("auto_update_deadline"), feed->autoUpdateDeadline());
 		custom_data.insert(feed->customId(), feed_custom_data);
 	}
 
@@ -270,6 +355,7 @@ void OwnCloudServiceRoot::restoreCustomFeedsData(const QMap<int, QVariant>& data
 			QVariantMap feed_custom_data = i.value().toMap();
 			feed->setAutoUpdateInitialInterval(feed_custom_data.value(QSL("auto_update_interval")).toInt());
 			feed->setAutoUpdateType(static_cast<Feed::AutoUpdateType>(feed_custom_data.value(QSL("auto_update_type")).toInt()));
+			feed->setAutoUpdateDeadline(feed_custom_data.value(QSL("auto_update_deadline")).toLongLong());
 		}
 	}
 }
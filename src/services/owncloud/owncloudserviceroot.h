@@ -22,6 +22,7 @@
 #include "services/abstract/cacheforserviceroot.h"
 
 #include <QMap>
+#include <QMutex>
 
 
 class OwnCloudNetworkFactory;
@@ -50,6 +51,16 @@ class OwnCloudServiceRoot : public ServiceRoot, public CacheForServiceRoot {
 
 		OwnCloudNetworkFactory* network() const;
 
+		// High-water mark of delta synchronization, i.e. the latest
+		// modification time of messages which were already obtained.
+		qint64 lastModified() const;
+		void setLastModified(qint64 last_modified);
+
+		// Returns new and changed messages of given feed. Changes of all feeds
+		// of the account are obtained with single request, messages of other
+		// feeds are kept until these feeds are updated too.
+		QList<Message> obtainNewMessages(int feed_custom_id, bool* error_during_obtaining);
+
 		bool onBeforeSetMessagesRead(RootItem* selected_item, const QList<Message>& messages, ReadStatus read);
 		bool onBeforeSwitchMessageImportance(RootItem* selected_item, const QList<ImportanceChange>& changes);
 
@@ -70,10 +81,19 @@ class OwnCloudServiceRoot : public ServiceRoot, public CacheForServiceRoot {
 
 		void loadFromDatabase();
 
+		// Downloads messages changed since the high-water mark.
+		bool obtainUpdatedMessages();
+
 		OwnCloudRecycleBin* m_recycleBin;
 		QAction* m_actionSyncIn;
 		QList<QAction*> m_serviceMenu;
 		OwnCloudNetworkFactory* m_network;
+
+		// Messages obtained by delta synchronization which were not handed to their feeds yet.
+		QMutex m_pendingMessagesMutex;
+		QHash<int, QList<Message>> m_pendingMessages;
+		qint64 m_lastModified;
+		qint64 m_lastModifiedHandedOut;
 };
 
 #endif // OWNCLOUDSERVICEROOT_H
@@ -20,50 +20,131 @@
 #include "miscellaneous/textfactory.h"
 #include "network-web/webfactory.h"
 
-#include "exceptions/applicationexception.h"
 
-
-AtomParser::AtomParser(const QString& data) : FeedParser(data), m_atomNamespace(QSL("http://www.w3.org/2005/Atom")) {
+AtomParser::AtomParser(QTextCodec* codec)
+	: FeedParser(codec), m_atomNamespace(QSL("http://www.w3.org/2005/Atom")), m_feedAuthors(QStringList()) {
 }
 
 AtomParser::~AtomParser() {
 }
 
-QString AtomParser::feedAuthor() const {
-	QDomNodeList authors = m_xml.documentElement().elementsByTagNameNS(m_atomNamespace, QSL("author"));
-	QStringList author_str;
+bool AtomParser::isMessageElement() const {
+	return m_xml->name() == QL1S("entry") && m_xml->namespaceUri() == m_atomNamespace;
+}
+
+bool AtomParser::isFeedElement() const {
+	// Messages are read completely, so each author found
+	// out of them is author of the whole feed.
+	return m_xml->name() == QL1S("author") && m_xml->namespaceUri() == m_atomNamespace;
+}
+
+void AtomParser::processFeedElement() {
+	const QString name = authorName();
+
+	if (!name.isEmpty()) {
+		m_feedAuthors.append(name);
+		m_feedAuthor = m_feedAuthors.join(QSL(", "));
+	}
+}
+
+QString AtomParser::authorName() {
+	QString name;
 
-	for (int i = 0; i < authors.size(); i++) {
-		QDomNodeList names = authors.at(i).toElement().elementsByTagNameNS(m_atomNamespace, QSL("name"));
+	while (m_xml->readNextStartElement()) {
+		if (name.isEmpty() && m_xml->name() == QL1S("name") && m_xml->namespaceUri() == m_atomNamespace) {
+			name = elementText();
+		}
 
-		if (!names.isEmpty()) {
-			author_str.append(names.at(0).toElement().text());
+		else {
+			m_xml->skipCurrentElement();
 		}
 	}
 
-	return author_str.join(", ");
+	return name;
 }
 
-Message AtomParser::extractMessage(const QDomElement& msg_element, QDateTime current_time) const {
-	Message new_message;
-	QString title = textsFromPath(msg_element, m_atomNamespace, QSL("title"), true).join(QSL(", "));
-	QString summary = textsFromPath(msg_element, m_atomNamespace, QSL("content"), true).join(QSL(", "));
+bool AtomParser::extractMessage(Message& new_message, const QDateTime& current_time) {
+	QString title, content, summary, updated;
+	QString last_link_alternate, last_link_other;
+	QStringList authors;
+	bool has_title = false, has_content = false, has_summary = false, has_updated = false;
+
+	while (m_xml->readNextStartElement()) {
+		if (m_xml->namespaceUri() != m_atomNamespace) {
+			m_xml->skipCurrentElement();
+			continue;
+		}
+
+		const QStringRef name = m_xml->name();
+
+		if (name == QL1S("title") && !has_title) {
+			title = elementText();
+			has_title = true;
+		}
+
+		else if (name == QL1S("content") && !has_content) {
+			content = elementText();
+			has_content = true;
+		}
+
+		else if (name == QL1S("summary") && !has_summary) {
+			summary = elementText();
+			has_summary = true;
+		}
+
+		else if (name == QL1S("updated") && !has_updated) {
+			updated = elementText();
+			has_updated = true;
+		}
+
+		else if (name == QL1S("author")) {
+			const QString author = authorName();
+
+			if (!author.isEmpty()) {
+				authors.append(author);
+			}
+		}
+
+		else if (name == QL1S("link")) {
+			const QXmlStreamAttributes attributes = m_xml->attributes();
+			const QStringRef attribute = attributes.value(QL1S("rel"));
+
+			if (attribute == QL1S("enclosure")) {
+				new_message.m_enclosures.append(Enclosure(attributes.value(QL1S("href")).toString(),
+				                                          attributes.value(QL1S("type")).toString()));
+				qDebug("Adding enclosure '%s' for the message.", qPrintable(new_message.m_enclosures.last().m_url));
+			}
 
-	if (summary.isEmpty()) {
-		summary = textsFromPath(msg_element, m_atomNamespace, QSL("summary"), true).join(QSL(", "));
+			else if (attribute.isEmpty() || attribute == QL1S("alternate")) {
+				last_link_alternate = attributes.value(QL1S("href")).toString();
+			}
+
+			else {
+				last_link_other = attributes.value(QL1S("href")).toString();
+			}
+
+			m_xml->skipCurrentElement();
+		}
+
+		else {
+			m_xml->skipCurrentElement();
+		}
+	}
+
+	if (content.isEmpty()) {
+		content = summary;
 	}
 
 	// Now we obtained maximum of information for title & description.
-	if (title.isEmpty() && summary.isEmpty()) {
+	if (title.isEmpty() && content.isEmpty()) {
 		// BOTH title and description are empty, skip this message.
-		throw new ApplicationException(QSL("Not enough data for the message."));
+		return false;
 	}
 
 	// Title is not empty, description does not matter.
 	new_message.m_title = WebFactory::instance()->stripTags(title);
-	new_message.m_contents = summary;
-	new_message.m_author = WebFactory::instance()->escapeHtml(messageAuthor(msg_element));
-	QString updated = textsFromPath(msg_element, m_atomNamespace, QSL("updated"), true).join(QSL(", "));
+	new_message.m_contents = content;
+	new_message.m_author = WebFactory::instance()->escapeHtml(authors.join(QSL(", ")));
 	// Deal with creation date.
 	new_message.m_created = TextFactory::parseDateTime(updated);
 	new_message.m_createdFromFeed = !new_message.m_created.isNull();
@@ -73,28 +154,7 @@ Message AtomParser::extractMessage(const QDomElement& msg_element, QDateTime cur
 		new_message.m_created = current_time;
 	}
 
-	// Deal with links
-	QDomNodeList elem_links = msg_element.toElement().elementsByTagNameNS(m_atomNamespace, QSL("link"));
-	QString last_link_alternate, last_link_other;
-
-	for (int i = 0; i < elem_links.size(); i++) {
-		QDomElement link = elem_links.at(i).toElement();
-		QString attribute = link.attribute(QSL("rel"));
-
-		if (attribute == QSL("enclosure")) {
-			new_message.m_enclosures.append(Enclosure(link.attribute(QSL("href")), link.attribute(QSL("type"))));
-			qDebug("Adding enclosure '%s' for the message.", qPrintable(new_message.m_enclosures.last().m_url));
-		}
-
-		else if (attribute.isEmpty() || attribute == QSL("alternate")) {
-			last_link_alternate = link.attribute(QSL("href"));
-		}
-
-		else {
-			last_link_other = link.attribute(QSL("href"));
-		}
-	}
-
+	// Deal with links.
 	if (!last_link_alternate.isEmpty()) {
 		new_message.m_url = last_link_alternate;
 	}
@@ -107,24 +167,5 @@ Message AtomParser::extractMessage(const QDomElement& msg_element, QDateTime cur
 		new_message.m_url = new_message.m_enclosures.first().m_url;
 	}
 
-	return new_message;
-}
-
-QString AtomParser::messageAuthor(const QDomElement& msg_element) const {
-	QDomNodeList authors = msg_element.elementsByTagNameNS(m_atomNamespace, QSL("author"));
-	QStringList author_str;
-
-	for (int i = 0; i < authors.size(); i++) {
-		QDomNodeList names = authors.at(i).toElement().elementsByTagNameNS(m_atomNamespace, QSL("name"));
-
-		if (!names.isEmpty()) {
-			author_str.append(names.at(0).toElement().text());
-		}
-	}
-
-	return author_str.join(", ");
-}
-
-QDomNodeList AtomParser::messageElements() {
-	return m_xml.elementsByTagNameNS(m_atomNamespace, QSL("entry"));
+	return true;
 }
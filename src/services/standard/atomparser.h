@@ -23,22 +23,25 @@
 #include "core/message.h"
 
 #include <QList>
-#include <QDomDocument>
 
 
 class AtomParser : public FeedParser {
 	public:
-		explicit AtomParser(const QString& data);
+		explicit AtomParser(QTextCodec* codec = nullptr);
 		virtual ~AtomParser();
 
 	private:
-		QDomNodeList messageElements();
-		QString feedAuthor() const;
-		Message extractMessage(const QDomElement& msg_element, QDateTime current_time) const;
-		QString messageAuthor(const QDomElement& msg_element) const;
+		bool isMessageElement() const;
+		bool isFeedElement() const;
+		void processFeedElement();
+		bool extractMessage(Message& new_message, const QDateTime& current_time);
+
+		// Reads name of author from current "author" element.
+		QString authorName();
 
 	private:
 		QString m_atomNamespace;
+		QStringList m_feedAuthors;
 };
 
 #endif // ATOMPARSER_H
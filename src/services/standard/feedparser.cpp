@@ -17,83 +17,199 @@
 
 #include "services/standard/feedparser.h"
 
-#include "exceptions/applicationexception.h"
+#include <QTextCodec>
+#include <QXmlStreamWriter>
 
 
-FeedParser::FeedParser(const QString& data) : m_xmlData(data) {
-	m_xml.setContent(m_xmlData, true);
+FeedParser::FeedParser(QTextCodec* codec)
+	: m_xml(&m_documentReader), m_feedAuthor(QString()), m_decoder(codec != nullptr ? codec->makeDecoder() : nullptr),
+	  m_capturedDepth(0), m_capturedMessage(false), m_currentTime(QDateTime::currentDateTime()),
+	  m_updateTtl(0), m_updatePeriod(0), m_updateFrequency(1) {
 }
 
 FeedParser::~FeedParser() {
 }
 
-QList<Message> FeedParser::messages() {
-	QString feed_author = feedAuthor();
-	QList<Message> messages;
-	QDateTime current_time = QDateTime::currentDateTime();
-	// Pull out all messages.
-	QDomNodeList messages_in_xml = messageElements();
+void FeedParser::addData(const QByteArray& data) {
+	if (m_decoder.isNull()) {
+		m_documentReader.addData(data);
+	}
+
+	else {
+		m_documentReader.addData(m_decoder->toUnicode(data));
+	}
 
-	for (int i = 0; i < messages_in_xml.size(); i++) {
-		QDomNode message_item = messages_in_xml.item(i);
+	readAvailableData();
+}
+
+QList<Message> FeedParser::messages() {
+	readAvailableData();
 
-		try {
-			Message new_message = extractMessage(message_item.toElement(), current_time);
+	if (m_documentReader.hasError()) {
+		// Messages read before the error are still valid.
+		qWarning("Error during parsing of feed data on line %lld: '%s'.",
+		         m_documentReader.lineNumber(), qPrintable(m_documentReader.errorString()));
+	}
 
-			if (new_message.m_author.isEmpty()) {
-				new_message.m_author = feed_author;
+	// Author of the feed might appear anywhere in the document.
+	if (!m_feedAuthor.isEmpty()) {
+		for (int i = 0; i < m_messages.size(); i++) {
+			if (m_messages.at(i).m_author.isEmpty()) {
+				m_messages[i].m_author = m_feedAuthor;
 			}
+		}
+	}
 
-			messages.append(new_message);
+	return m_messages;
+}
+
+void FeedParser::readAvailableData() {
+	// Reader stops with "premature end" error when added data are
+	// exhausted, it continues from the same place once next chunk is added.
+	while (!m_documentReader.atEnd()) {
+		const QXmlStreamReader::TokenType token = m_documentReader.readNext();
+
+		if (m_capturedDepth > 0) {
+			captureToken();
 		}
 
-		catch (const ApplicationException& ex) {
-			qDebug(qPrintable(ex.message()));
+		else if (token == QXmlStreamReader::StartElement) {
+			m_capturedMessage = isMessageElement();
+
+			if (m_capturedMessage || isFeedElement() || isUpdateHintElement()) {
+				// Element is copied until its end arrives, rest of the document is skipped.
+				m_capturedElement.clear();
+				m_capturedWriter.reset(new QXmlStreamWriter(&m_capturedElement));
+				captureToken();
+			}
 		}
 	}
+}
+
+void FeedParser::captureToken() {
+	switch (m_documentReader.tokenType()) {
+		case QXmlStreamReader::StartElement:
+			// Namespaces are declared by writer itself as needed, so
+			// that copy does not depend on declarations of its ancestors.
+			m_capturedWriter->writeStartElement(m_documentReader.namespaceUri().toString(), m_documentReader.name().toString());
+			m_capturedWriter->writeAttributes(m_documentReader.attributes());
+			m_capturedDepth++;
+			break;
+
+		case QXmlStreamReader::Characters:
+		case QXmlStreamReader::EntityReference:
+			m_capturedWriter->writeCharacters(m_documentReader.text().toString());
+			break;
+
+		case QXmlStreamReader::EndElement:
+			m_capturedWriter->writeEndElement();
+
+			if (--m_capturedDepth == 0) {
+				processCapturedElement();
+			}
 
-	return messages;
+			break;
+
+		default:
+			break;
+	}
 }
 
-QStringList FeedParser::textsFromPath(const QDomElement& element, const QString& namespace_uri,
-                                      const QString& xml_path, bool only_first) const {
-	QStringList paths = xml_path.split('/');
-	QStringList result;
-	QList<QDomElement> current_elements;
-	current_elements.append(element);
+void FeedParser::processCapturedElement() {
+	m_capturedWriter.reset();
+	m_elementReader.clear();
+	m_elementReader.addData(m_capturedElement);
+	m_capturedElement.clear();
 
-	while (!paths.isEmpty()) {
-		QList<QDomElement> next_elements;
-		QString next_local_name = paths.takeFirst();
+	while (!m_elementReader.atEnd() && m_elementReader.readNext() != QXmlStreamReader::StartElement) {
+	}
 
-		foreach (const QDomElement& elem, current_elements) {
-			QDomNodeList elements = elem.elementsByTagNameNS(namespace_uri, next_local_name);
+	m_xml = &m_elementReader;
 
-			for (int i = 0; i < elements.size(); i++) {
-				next_elements.append(elements.at(i).toElement());
+	if (m_capturedMessage) {
+		Message new_message;
 
-				if (only_first) {
-					break;
-				}
-			}
+		if (extractMessage(new_message, m_currentTime)) {
+			m_messages.append(new_message);
+		}
 
-			if (next_elements.size() == 1 && only_first) {
-				break;
-			}
+		else {
+			qDebug("Not enough data for the message.");
 		}
+	}
+
+	else if (isUpdateHintElement()) {
+		processUpdateHintElement();
+	}
 
-		current_elements = next_elements;
+	else {
+		processFeedElement();
 	}
 
-	if (!current_elements.isEmpty()) {
-		foreach (const QDomElement& elem, current_elements) {
-			result.append(elem.text());
+	m_xml = &m_documentReader;
+}
+
+int FeedParser::updateHint() const {
+	return qMax(m_updateTtl, m_updatePeriod / m_updateFrequency);
+}
+
+bool FeedParser::isFeedElement() const {
+	return false;
+}
+
+void FeedParser::processFeedElement() {
+}
+
+bool FeedParser::isUpdateHintElement() const {
+	const QStringRef name = m_xml->name();
+
+	if (m_xml->namespaceUri().isEmpty()) {
+		return name == QL1S("ttl");
+	}
+
+	else {
+		return m_xml->namespaceUri() == QL1S("http://purl.org/rss/1.0/modules/syndication/") &&
+		       (name == QL1S("updatePeriod") || name == QL1S("updateFrequency"));
+	}
+}
+
+void FeedParser::processUpdateHintElement() {
+	const QStringRef name = m_xml->name();
+
+	if (name == QL1S("ttl")) {
+		// RSS 2.0 declares number of minutes.
+		m_updateTtl = qMax(0, elementText().trimmed().toInt()) * 60;
+	}
+
+	else if (name == QL1S("updatePeriod")) {
+		const QString period = elementText().trimmed();
+
+		if (period == QL1S("hourly")) {
+			m_updatePeriod = 3600;
+		}
+
+		else if (period == QL1S("daily")) {
+			m_updatePeriod = 86400;
+		}
+
+		else if (period == QL1S("weekly")) {
+			m_updatePeriod = 604800;
+		}
+
+		else if (period == QL1S("monthly")) {
+			m_updatePeriod = 2592000;
+		}
+
+		else if (period == QL1S("yearly")) {
+			m_updatePeriod = 31536000;
 		}
 	}
 
-	return result;
+	else {
+		m_updateFrequency = qMax(1, elementText().trimmed().toInt());
+	}
 }
 
-QString FeedParser::feedAuthor() const {
-	return "";
+QString FeedParser::elementText() {
+	return m_xml->readElementText(QXmlStreamReader::IncludeChildElements);
 }
@@ -18,28 +18,99 @@
 #ifndef FEEDPARSER_H
 #define FEEDPARSER_H
 
-#include <QDomDocument>
+#include <QXmlStreamReader>
+#include <QScopedPointer>
 #include <QString>
 
 #include "core/message.h"
 
 
+class QTextCodec;
+class QTextDecoder;
+class QXmlStreamWriter;
+
+// Single-pass streaming parser of feed documents. Particular
+// formats are handled by subclasses, which recognize messages
+// and extract their data while the document is being read.
+//
+// Document may be added in chunks as it is downloaded. Each message
+// is held in memory only until its end arrives, then it is extracted
+// and its data are released, so neither the whole document nor its
+// tree is ever kept in memory.
 class FeedParser {
 	public:
-		explicit FeedParser(const QString& data);
+		// Added data are decoded with given codec, null codec means
+		// that they are parsed in encoding declared by the document.
+		explicit FeedParser(QTextCodec* codec = nullptr);
 		virtual ~FeedParser();
 
-		virtual QList<Message> messages();
+		// Appends next chunk of the document and reads as much of it as possible.
+		void addData(const QByteArray& data);
+
+		// Reads the rest of added data and returns all messages found in the document.
+		QList<Message> messages();
+
+		// Returns minimal update interval (in seconds) declared by read
+		// document via <ttl> or syndication module, zero if none.
+		int updateHint() const;
 
 	protected:
-		QStringList textsFromPath(const QDomElement& element, const QString& namespace_uri, const QString& xml_path, bool only_first) const;
-		virtual QDomNodeList messageElements() = 0;
-		virtual QString feedAuthor() const;
-		virtual Message extractMessage(const QDomElement& msg_element, QDateTime current_time) const = 0;
+		// Returns true if current start element begins new message.
+		virtual bool isMessageElement() const = 0;
+
+		// Returns true if current start element, which does not belong
+		// to any message, carries data processed by processFeedElement().
+		virtual bool isFeedElement() const;
+
+		// Processes current feed element, see isFeedElement().
+		virtual void processFeedElement();
+
+		// Reads current message element including its end element. Returns
+		// false if message does not contain enough data and should be skipped.
+		virtual bool extractMessage(Message& message, const QDateTime& current_time) = 0;
+
+		// Returns text of current element, including texts of its child
+		// elements, and moves reader to its end element.
+		QString elementText();
+
+	private:
+		// Reads tokens of document until added data are exhausted.
+		void readAvailableData();
+
+		// Copies current token of document into captured element.
+		void captureToken();
+
+		// Processes captured message or feed element once it is complete.
+		void processCapturedElement();
+
+		bool isUpdateHintElement() const;
+
+		// Reads current element which declares update interval.
+		void processUpdateHintElement();
 
 	protected:
-		QString m_xmlData;
-		QDomDocument m_xml;
+		// Reader positioned at currently processed element. Messages and feed
+		// elements are read from their own complete copy, so that subclasses
+		// can read them in nested manner regardless of chunks of document.
+		QXmlStreamReader* m_xml;
+		QString m_feedAuthor;
+
+	private:
+		QXmlStreamReader m_documentReader;
+		QXmlStreamReader m_elementReader;
+		QScopedPointer<QTextDecoder> m_decoder;
+
+		// Copy of currently read message or feed element.
+		QScopedPointer<QXmlStreamWriter> m_capturedWriter;
+		QByteArray m_capturedElement;
+		int m_capturedDepth;
+		bool m_capturedMessage;
+
+		QList<Message> m_messages;
+		QDateTime m_currentTime;
+		int m_updateTtl;
+		int m_updatePeriod;
+		int m_updateFrequency;
 };
 
 #endif // FEEDPARSER_H
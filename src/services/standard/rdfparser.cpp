@@ -20,79 +20,94 @@
 #include "miscellaneous/textfactory.h"
 #include "network-web/webfactory.h"
 
-#include <QDomDocument>
 
-
-RdfParser::RdfParser() {
+RdfParser::RdfParser(QTextCodec* codec) : FeedParser(codec) {
 }
 
 RdfParser::~RdfParser() {
 }
 
-QList<Message> RdfParser::parseXmlData(const QString& data) {
-	QList<Message> messages;
-	QDomDocument xml_file;
-	QDateTime current_time = QDateTime::currentDateTime();
-	xml_file.setContent(data, true);
-	// Pull out all messages.
-	QDomNodeList messages_in_xml = xml_file.elementsByTagName(QSL("item"));
-
-	for (int i = 0; i < messages_in_xml.size(); i++) {
-		QDomNode message_item = messages_in_xml.item(i);
-		Message new_message;
-		// Deal with title and description.
-		QString elem_title = message_item.namedItem(QSL("title")).toElement().text().simplified();
-		QString elem_description = message_item.namedItem(QSL("description")).toElement().text();
-
-		// Now we obtained maximum of information for title & description.
-		if (elem_title.isEmpty()) {
-			if (elem_description.isEmpty()) {
-				// BOTH title and description are empty, skip this message.
-				continue;
-			}
-
-			else {
-				// Title is empty but description is not.
-				new_message.m_title = WebFactory::instance()->escapeHtml(WebFactory::instance()->stripTags(elem_description.simplified()));
-				new_message.m_contents = elem_description;
-			}
+bool RdfParser::isMessageElement() const {
+	return m_xml->name() == QL1S("item");
+}
+
+bool RdfParser::extractMessage(Message& new_message, const QDateTime& current_time) {
+	QString elem_title, elem_description, elem_link, elem_creator, elem_updated;
+	bool has_title = false, has_description = false, has_link = false, has_creator = false, has_updated = false;
+
+	// Only first occurrence of each element is used.
+	while (m_xml->readNextStartElement()) {
+		const QStringRef name = m_xml->name();
+
+		if (name == QL1S("title") && !has_title) {
+			elem_title = elementText().simplified();
+			has_title = true;
 		}
 
-		else {
-			// Title is really not empty, description does not matter.
-			new_message.m_title = WebFactory::instance()->escapeHtml(WebFactory::instance()->stripTags(elem_title));
-			new_message.m_contents = elem_description;
+		else if (name == QL1S("description") && !has_description) {
+			elem_description = elementText();
+			has_description = true;
 		}
 
-		// Deal with link and author.
-		new_message.m_url = message_item.namedItem(QSL("link")).toElement().text();
-		new_message.m_author = message_item.namedItem(QSL("creator")).toElement().text();
-		// Deal with creation date.
-		QString elem_updated = message_item.namedItem(QSL("date")).toElement().text();
+		else if (name == QL1S("link") && !has_link) {
+			elem_link = elementText();
+			has_link = true;
+		}
 
-		if (elem_updated.isEmpty()) {
-			elem_updated = message_item.namedItem(QSL("dc:date")).toElement().text();
+		else if (name == QL1S("creator") && !has_creator) {
+			elem_creator = elementText();
+			has_creator = true;
 		}
 
-		// Deal with creation date.
-		new_message.m_created = TextFactory::parseDateTime(elem_updated);
-		new_message.m_createdFromFeed = !new_message.m_created.isNull();
+		else if (name == QL1S("date") && !has_updated) {
+			elem_updated = elementText();
+			has_updated = true;
+		}
 
-		if (!new_message.m_createdFromFeed) {
-			// Date was NOT obtained from the feed, set current date as creation date for the message.
-			new_message.m_created = current_time;
+		else {
+			m_xml->skipCurrentElement();
 		}
+	}
 
-		if (new_message.m_author.isNull()) {
-			new_message.m_author = "";
+	// Now we obtained maximum of information for title & description.
+	if (elem_title.isEmpty()) {
+		if (elem_description.isEmpty()) {
+			// BOTH title and description are empty, skip this message.
+			return false;
 		}
 
-		if (new_message.m_url.isNull()) {
-			new_message.m_url = "";
+		else {
+			// Title is empty but description is not.
+			new_message.m_title = WebFactory::instance()->escapeHtml(WebFactory::instance()->stripTags(elem_description.simplified()));
+			new_message.m_contents = elem_description;
 		}
+	}
+
+	else {
+		// Title is really not empty, description does not matter.
+		new_message.m_title = WebFactory::instance()->escapeHtml(WebFactory::instance()->stripTags(elem_title));
+		new_message.m_contents = elem_description;
+	}
+
+	// Deal with link and author.
+	new_message.m_url = elem_link;
+	new_message.m_author = elem_creator;
+	// Deal with creation date.
+	new_message.m_created = TextFactory::parseDateTime(elem_updated);
+	new_message.m_createdFromFeed = !new_message.m_created.isNull();
+
+	if (!new_message.m_createdFromFeed) {
+		// Date was NOT obtained from the feed, set current date as creation date for the message.
+		new_message.m_created = current_time;
+	}
+
+	if (new_message.m_author.isNull()) {
+		new_message.m_author = "";
+	}
 
-		messages.append(new_message);
+	if (new_message.m_url.isNull()) {
+		new_message.m_url = "";
 	}
 
-	return messages;
+	return true;
 }
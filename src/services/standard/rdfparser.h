@@ -18,17 +18,21 @@
 #ifndef RDFPARSER_H
 #define RDFPARSER_H
 
+#include "services/standard/feedparser.h"
+
 #include "core/message.h"
 
 #include <QList>
 
 
-class RdfParser {
+class RdfParser : public FeedParser {
 	public:
-		explicit RdfParser();
+		explicit RdfParser(QTextCodec* codec = nullptr);
 		virtual ~RdfParser();
 
-		QList<Message> parseXmlData(const QString& data);
+	private:
+		bool isMessageElement() const;
+		bool extractMessage(Message& new_message, const QDateTime& current_time);
 };
 
 #endif // RDFPARSER_H
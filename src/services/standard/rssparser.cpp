@@ -19,47 +19,105 @@
 
 #include "miscellaneous/textfactory.h"
 #include "network-web/webfactory.h"
-#include "miscellaneous/iofactory.h"
-#include "exceptions/applicationexception.h"
 
-#include <QDomDocument>
 
-
-RssParser::RssParser(const QString& data) : FeedParser(data) {
+RssParser::RssParser(QTextCodec* codec)
+	: FeedParser(codec), m_contentNamespace(QSL("http://purl.org/rss/1.0/modules/content/")),
+	  m_dcNamespace(QSL("http://purl.org/dc/elements/1.1/")), m_atomNamespace(QSL("http://www.w3.org/2005/Atom")) {
 }
 
 RssParser::~RssParser() {
 }
 
-QDomNodeList RssParser::messageElements() {
-	QDomNode channel_elem = m_xml.namedItem(QSL("rss")).namedItem(QSL("channel"));
+bool RssParser::isMessageElement() const {
+	return m_xml->name() == QL1S("item") && m_xml->namespaceUri().isEmpty();
+}
 
-	if (channel_elem.isNull()) {
-		return QDomNodeList();
-	}
+bool RssParser::extractMessage(Message& new_message, const QDateTime& current_time) {
+	QString elem_title, elem_description, elem_encoded, elem_enclosure, elem_enclosure_type;
+	QString elem_link, elem_link_href, elem_author, elem_creator, elem_pub_date, elem_date;
+	bool has_title = false, has_description = false, has_encoded = false, has_enclosure = false;
+	bool has_link = false, has_link_href = false, has_author = false, has_creator = false, has_pub_date = false, has_date = false;
+
+	// Only first occurrence of each element is used. Core elements of RSS
+	// have no namespace, elements of extension modules must have their own one.
+	while (m_xml->readNextStartElement()) {
+		const QStringRef name = m_xml->name();
+		const QStringRef name_space = m_xml->namespaceUri();
+
+		if (name_space.isEmpty()) {
+			if (name == QL1S("title") && !has_title) {
+				elem_title = elementText().simplified();
+				has_title = true;
+			}
+
+			else if (name == QL1S("description") && !has_description) {
+				elem_description = elementText();
+				has_description = true;
+			}
+
+			else if (name == QL1S("enclosure") && !has_enclosure) {
+				elem_enclosure = m_xml->attributes().value(QL1S("url")).toString();
+				elem_enclosure_type = m_xml->attributes().value(QL1S("type")).toString();
+				has_enclosure = true;
+				m_xml->skipCurrentElement();
+			}
+
+			else if (name == QL1S("link") && !has_link) {
+				elem_link = elementText();
+				has_link = true;
+			}
+
+			else if (name == QL1S("author") && !has_author) {
+				elem_author = elementText();
+				has_author = true;
+			}
+
+			else if (name == QL1S("pubDate") && !has_pub_date) {
+				elem_pub_date = elementText();
+				has_pub_date = true;
+			}
+
+			else {
+				m_xml->skipCurrentElement();
+			}
+		}
 
-	else {
-		return channel_elem.toElement().elementsByTagName(QSL("item"));
-	}
-}
+		else if (name_space == m_contentNamespace && name == QL1S("encoded") && !has_encoded) {
+			elem_encoded = elementText();
+			has_encoded = true;
+		}
+
+		else if (name_space == m_dcNamespace && name == QL1S("creator") && !has_creator) {
+			elem_creator = elementText();
+			has_creator = true;
+		}
 
-Message RssParser::extractMessage(const QDomElement& msg_element, QDateTime current_time) const {
-	Message new_message;
-	// Deal with titles & descriptions.
-	QString elem_title = msg_element.namedItem(QSL("title")).toElement().text().simplified();
-	QString elem_description = msg_element.namedItem(QSL("encoded")).toElement().text();
-	QString elem_enclosure = msg_element.namedItem(QSL("enclosure")).toElement().attribute(QSL("url"));
-	QString elem_enclosure_type = msg_element.namedItem(QSL("enclosure")).toElement().attribute(QSL("type"));
+		else if (name_space == m_dcNamespace && name == QL1S("date") && !has_date) {
+			elem_date = elementText();
+			has_date = true;
+		}
+
+		else if (name_space == m_atomNamespace && name == QL1S("link") && !has_link_href) {
+			elem_link_href = m_xml->attributes().value(QL1S("href")).toString();
+			has_link_href = true;
+			m_xml->skipCurrentElement();
+		}
+
+		else {
+			m_xml->skipCurrentElement();
+		}
+	}
 
-	if (elem_description.isEmpty()) {
-		elem_description = msg_element.namedItem(QSL("description")).toElement().text();
+	if (!elem_encoded.isEmpty()) {
+		elem_description = elem_encoded;
 	}
 
 	// Now we obtained maximum of information for title & description.
 	if (elem_title.isEmpty()) {
 		if (elem_description.isEmpty()) {
 			// BOTH title and description are empty, skip this message.
-			throw new ApplicationException(QSL("Not enough data for the message."));
+			return false;
 		}
 
 		else {
@@ -81,7 +139,7 @@ Message RssParser::extractMessage(const QDomElement& msg_element, QDateTime curr
 	}
 
 	// Deal with link and author.
-	new_message.m_url = msg_element.namedItem(QSL("link")).toElement().text();
+	new_message.m_url = elem_link;
 
 	if (new_message.m_url.isEmpty() && !new_message.m_enclosures.isEmpty()) {
 		new_message.m_url = new_message.m_enclosures.first().m_url;
@@ -89,20 +147,15 @@ Message RssParser::extractMessage(const QDomElement& msg_element, QDateTime curr
 
 	if (new_message.m_url.isEmpty()) {
 		// Try to get "href" attribute.
-		new_message.m_url = msg_element.namedItem(QSL("link")).toElement().attribute(QSL("href"));
-	}
-
-	new_message.m_author = msg_element.namedItem(QSL("author")).toElement().text();
-
-	if (new_message.m_author.isEmpty()) {
-		new_message.m_author = msg_element.namedItem(QSL("creator")).toElement().text();
+		new_message.m_url = elem_link_href;
 	}
 
+	new_message.m_author = elem_author.isEmpty() ? elem_creator : elem_author;
 	// Deal with creation date.
-	new_message.m_created = TextFactory::parseDateTime(msg_element.namedItem(QSL("pubDate")).toElement().text());
+	new_message.m_created = TextFactory::parseDateTime(elem_pub_date);
 
 	if (new_message.m_created.isNull()) {
-		new_message.m_created = TextFactory::parseDateTime(msg_element.namedItem(QSL("date")).toElement().text());
+		new_message.m_created = TextFactory::parseDateTime(elem_date);
 	}
 
 	if (!(new_message.m_createdFromFeed = !new_message.m_created.isNull())) {
@@ -119,5 +172,5 @@ Message RssParser::extractMessage(const QDomElement& msg_element, QDateTime curr
 		new_message.m_url = "";
 	}
 
-	return new_message;
+	return true;
 }
@@ -27,12 +27,17 @@
 
 class RssParser : public FeedParser {
 	public:
-		explicit RssParser(const QString& data);
+		explicit RssParser(QTextCodec* codec = nullptr);
 		virtual ~RssParser();
 
 	private:
-		QDomNodeList messageElements();
-		Message extractMessage(const QDomElement& msg_element, QDateTime current_time) const;
+		bool isMessageElement() const;
+		bool extractMessage(Message& new_message, const QDateTime& current_time);
+
+	private:
+		QString m_contentNamespace;
+		QString m_dcNamespace;
+		QString m_atomNamespace;
 };
 
 #endif // RSSPARSER_H
@@ -28,6 +28,7 @@
 #include "miscellaneous/iconfactory.h"
 #include "miscellaneous/simplecrypt/simplecrypt.h"
 #include "network-web/networkfactory.h"
+#include "network-web/downloader.h"
 #include "gui/feedmessageviewer.h"
 #include "gui/feedsview.h"
 #include "services/abstract/recyclebin.h"
@@ -37,10 +38,13 @@
 #include <QVariant>
 #include <QTextCodec>
 #include <QPointer>
+#include <QEventLoop>
+#include <QScopedPointer>
 #include <QDomDocument>
 #include <QDomNode>
 #include <QDomElement>
 #include <QXmlStreamReader>
+#include <QPixmap>
 
 
 StandardFeed::StandardFeed(RootItem* parent_item)
@@ -51,6 +55,13 @@ StandardFeed::StandardFeed(RootItem* parent_item)
 	m_networkError = QNetworkReply::NoError;
 	m_type = Rss0X;
 	m_encoding = QString();
+	m_httpEtag = QString();
+	m_httpLastModified = QString();
+	m_pendingHttpEtag = QString();
+	m_pendingHttpLastModified = QString();
+	m_httpValidatorsChanged = false;
+	m_httpUpdateHint = 0;
+	m_documentUpdateHint = 0;
 }
 
 StandardFeed::StandardFeed(const StandardFeed& other)
@@ -61,13 +72,20 @@ StandardFeed::StandardFeed(const StandardFeed& other)
 	m_networkError = other.networkError();
 	m_type = other.type();
 	m_encoding = other.encoding();
+	m_httpEtag = other.httpEtag();
+	m_httpLastModified = other.httpLastModified();
+	m_pendingHttpEtag = QString();
+	m_pendingHttpLastModified = QString();
+	m_httpValidatorsChanged = false;
+	m_httpUpdateHint = 0;
+	m_documentUpdateHint = 0;
 	setCountOfAllMessages(other.countOfAllMessages());
 	setCountOfUnreadMessages(other.countOfUnreadMessages());
 	setUrl(other.url());
 	setStatus(other.status());
 	setAutoUpdateType(other.autoUpdateType());
 	setAutoUpdateInitialInterval(other.autoUpdateInitialInterval());
-	setAutoUpdateRemainingInterval(other.autoUpdateRemainingInterval());
+	setAutoUpdateDeadline(other.autoUpdateDeadline());
 	setTitle(other.title());
 	setId(other.id());
 	setCustomId(other.customId());
@@ -185,14 +203,35 @@ void StandardFeed::fetchMetadataForItself() {
 }
 
 QPair<StandardFeed*, QNetworkReply::NetworkError> StandardFeed::guessFeed(const QString& url,
+        const QString& username,
+        const QString& password) {
+	QByteArray icon_data;
+	QPair<StandardFeed*, QNetworkReply::NetworkError> result = guessFeedMetadata(url,
+	                                                                            qApp->settings()->value(GROUP(Feeds),
+	                                                                                SETTING(Feeds::UpdateTimeout)).toInt(),
+	                                                                            icon_data,
+	                                                                            username,
+	                                                                            password);
+
+	if (result.first != nullptr && !icon_data.isEmpty()) {
+		// Icon for feed was downloaded and is stored now in icon_data.
+		QPixmap icon_pixmap;
+		icon_pixmap.loadFromData(icon_data);
+		result.first->setIcon(QIcon(icon_pixmap));
+	}
+
+	return result;
+}
+
+QPair<StandardFeed*, QNetworkReply::NetworkError> StandardFeed::guessFeedMetadata(const QString& url, int timeout,
+        QByteArray& icon_data,
         const QString& username,
         const QString& password) {
 	QPair<StandardFeed*, QNetworkReply::NetworkError> result;
 	result.first = nullptr;
 	QByteArray feed_contents;
 	NetworkResult network_result = NetworkFactory::downloadFeedFile(url,
-	                               qApp->settings()->value(GROUP(Feeds),
-	                                                       SETTING(Feeds::UpdateTimeout)).toInt(),
+	                               timeout,
 	                               feed_contents,
 	                               !username.isEmpty(),
 	                               username,
@@ -312,14 +351,7 @@ QPair<StandardFeed*, QNetworkReply::NetworkError> StandardFeed::guessFeed(const
 		}
 
 		// Try to obtain icon.
-		QIcon icon_data;
-
-		if ((result.second = NetworkFactory::downloadIcon(icon_possible_locations,
-		                                                  DOWNLOAD_TIMEOUT,
-		                                                  icon_data)) == QNetworkReply::NoError) {
-			// Icon for feed was downloaded and is stored now in _icon_data.
-			result.first->setIcon(icon_data);
-		}
+		result.second = NetworkFactory::downloadIconData(icon_possible_locations, DOWNLOAD_TIMEOUT, icon_data);
 	}
 
 	return result;
@@ -399,70 +431,221 @@ bool StandardFeed::editItself(StandardFeed* new_feed_data) {
 	original_feed->setAutoUpdateType(new_feed_data->autoUpdateType());
 	original_feed->setAutoUpdateInitialInterval(new_feed_data->autoUpdateInitialInterval());
 	original_feed->setType(new_feed_data->type());
+	// Validators were reset, next update will download whole feed.
+	original_feed->setHttpEtag(QString());
+	original_feed->setHttpLastModified(QString());
 	// Editing is done.
 	return true;
 }
 
 QList<Message> StandardFeed::obtainNewMessages(bool* error_during_obtaining) {
+	// Here, we want to achieve "synchronous" approach, the same steps are otherwise
+	// performed asynchronously by feed downloader.
+	Downloader downloader;
+	QEventLoop loop;
 	QByteArray feed_contents;
+	connect(&downloader, &Downloader::completed, &loop, &QEventLoop::quit);
+	startDownload(&downloader);
+	loop.exec();
+
+	if (finishDownload(&downloader, &feed_contents, error_during_obtaining)) {
+		return parseDownloadedData(feed_contents);
+	}
+
+	else {
+		return QList<Message>();
+	}
+}
+
+bool StandardFeed::supportsAsynchronousUpdate() const {
+	return true;
+}
+
+void StandardFeed::startDownload(Downloader* downloader) {
 	int download_timeout = qApp->settings()->value(GROUP(Feeds), SETTING(Feeds::UpdateTimeout)).toInt();
-	m_networkError = NetworkFactory::downloadFeedFile(url(), download_timeout, feed_contents,
-	                                                  passwordProtected(), username(), password()).first;
+	// Size limit is set in MB, zero means no limit.
+	qint64 max_feed_size = qApp->settings()->value(GROUP(Feeds), SETTING(Feeds::MaxFeedSize)).toLongLong() * 1024 * 1024;
+	downloader->setMaximumBodySize(max_feed_size);
+	downloader->setRejectedContentTypes(QString(FEED_DOWNLOADER_REJECTED_TYPES).split(QL1C(',')));
+	downloader->appendRawHeader("Accept", ACCEPT_HEADER_FOR_FEED_DOWNLOADER);
+	// Empty validators are ignored by downloader.
+	downloader->appendRawHeader("If-None-Match", httpEtag().toLatin1());
+	downloader->appendRawHeader("If-Modified-Since", httpLastModified().toLatin1());
+	// Feed is parsed while it is being downloaded, so that
+	// neither its whole body nor its tree is held in memory.
+	m_parser.reset(createParser());
+
+	if (!m_parser.isNull()) {
+		FeedParser* parser = m_parser.data();
+
+		downloader->setOutputBuffered(false);
+		connect(downloader, &Downloader::dataReceived, downloader, [parser](const QByteArray& data) {
+			parser->addData(data);
+		});
+	}
+
+	downloader->downloadFile(url(), download_timeout, passwordProtected(), username(), password());
+}
+
+bool StandardFeed::finishDownload(Downloader* downloader, QByteArray* feed_contents, bool* error_during_obtaining) {
+	m_networkError = downloader->lastOutputError();
+	m_httpValidatorsChanged = false;
+	// Server may ask us to slow down even if request failed.
+	m_httpUpdateHint = httpUpdateHint(downloader);
+	setAutoUpdateServerHint(qMax(m_httpUpdateHint, m_documentUpdateHint));
 
 	if (m_networkError != QNetworkReply::NoError) {
 		qWarning("Error during fetching of new messages for feed '%s' (id %d).", qPrintable(url()), id());
 		setStatus(NetworkError);
+		m_parser.reset();
 		*error_during_obtaining = true;
-		return QList<Message>();
+		return false;
 	}
 
 	else if (status() != NewMessages) {
 		setStatus(Normal);
-		*error_during_obtaining = false;
 	}
 
-	// Encode downloaded data for further parsing.
-	QTextCodec* codec = QTextCodec::codecForName(encoding().toLocal8Bit());
-	QString formatted_feed_contents;
+	*error_during_obtaining = false;
 
-	if (codec == nullptr) {
-		// No suitable codec for this encoding was found.
-		// Use non-converted data.
-		formatted_feed_contents = feed_contents;
+	if (downloader->lastHttpStatusCode() == 304) {
+		// Feed did not change since last update, there is nothing to parse.
+		qDebug("Feed '%s' (id %d) was not modified since last update.", qPrintable(url()), id());
+		m_parser.reset();
+		return false;
 	}
 
-	else {
-		formatted_feed_contents = codec->toUnicode(feed_contents);
+	// Remember validators of new version of the feed. Server which
+	// does not send them anymore makes us perform full requests again.
+	// They are used only after messages of this version are stored.
+	m_pendingHttpEtag = QString::fromLatin1(downloader->lastRawHeader("ETag"));
+	m_pendingHttpLastModified = QString::fromLatin1(downloader->lastRawHeader("Last-Modified"));
+	m_httpValidatorsChanged = m_pendingHttpEtag != httpEtag() || m_pendingHttpLastModified != httpLastModified();
+	*feed_contents = downloader->lastOutputData();
+	return true;
+}
+
+QList<Message> StandardFeed::parseDownloadedData(const QByteArray& feed_contents) {
+	QScopedPointer<FeedParser> parser(m_parser.take());
+
+	if (parser.isNull()) {
+		// Data were not parsed during download.
+		parser.reset(createParser());
+
+		if (parser.isNull()) {
+			return QList<Message>();
+		}
+
+		parser->addData(feed_contents);
 	}
 
-	// Feed data are downloaded and encoded.
-	// Parse data and obtain messages.
-	QList<Message> messages;
+	// Feed data are downloaded. Finish parsing and obtain messages.
+	const QList<Message> messages = parser->messages();
+
+	m_documentUpdateHint = parser->updateHint();
+	setAutoUpdateServerHint(qMax(m_httpUpdateHint, m_documentUpdateHint));
+	return messages;
+}
+
+FeedParser* StandardFeed::createParser() const {
+	// Data in UTF-8 (or in unknown encoding) are parsed as they are, parser
+	// decodes them on the fly. Other data are decoded with codec chosen for the feed.
+	QTextCodec* codec = QTextCodec::codecForName(encoding().toLocal8Bit());
+
+	if (codec == QTextCodec::codecForName(DEFAULT_FEED_ENCODING)) {
+		codec = nullptr;
+	}
 
 	switch (type()) {
 		case StandardFeed::Rss0X:
 		case StandardFeed::Rss2X:
-			messages = RssParser(formatted_feed_contents).messages();
-			break;
+			return new RssParser(codec);
 
 		case StandardFeed::Rdf:
-			messages = RdfParser().parseXmlData(formatted_feed_contents);
-			break;
+			return new RdfParser(codec);
 
 		case StandardFeed::Atom10:
-			messages = AtomParser(formatted_feed_contents).messages();
+			return new AtomParser(codec);
 
 		default:
-			break;
+			return nullptr;
 	}
+}
 
-	return messages;
+int StandardFeed::httpUpdateHint(const Downloader* downloader) {
+	int update_hint = 0;
+	const QString retry_after = QString::fromLatin1(downloader->lastRawHeader("Retry-After")).trimmed();
+
+	if (!retry_after.isEmpty()) {
+		bool is_number;
+		const int retry_after_seconds = retry_after.toInt(&is_number);
+
+		if (is_number) {
+			update_hint = retry_after_seconds;
+		}
+
+		else {
+			// Value is HTTP date.
+			const QDateTime retry_after_date = TextFactory::parseDateTime(retry_after);
+
+			if (retry_after_date.isValid()) {
+				update_hint = int(QDateTime::currentDateTimeUtc().secsTo(retry_after_date));
+			}
+		}
+	}
+
+	foreach (const QString& directive, QString::fromLatin1(downloader->lastRawHeader("Cache-Control")).split(QL1C(','))) {
+		const QString trimmed_directive = directive.trimmed();
+
+		if (trimmed_directive.startsWith(QL1S("max-age="), Qt::CaseInsensitive)) {
+			update_hint = qMax(update_hint, trimmed_directive.mid(8).toInt());
+		}
+	}
+
+	return qMax(0, update_hint);
 }
 
 QNetworkReply::NetworkError StandardFeed::networkError() const {
 	return m_networkError;
 }
 
+QString StandardFeed::httpEtag() const {
+	return m_httpEtag;
+}
+
+void StandardFeed::setHttpEtag(const QString& http_etag) {
+	m_httpEtag = http_etag;
+}
+
+QString StandardFeed::httpLastModified() const {
+	return m_httpLastModified;
+}
+
+void StandardFeed::setHttpLastModified(const QString& http_last_modified) {
+	m_httpLastModified = http_last_modified;
+}
+
+bool StandardFeed::updateStateStored(QSqlDatabase database) {
+	if (m_httpValidatorsChanged && !DatabaseQueries::editFeedHttpValidators(database, id(), m_pendingHttpEtag,
+	                                                                        m_pendingHttpLastModified)) {
+		qWarning("Failed to store HTTP validators of feed '%s' (id %d).", qPrintable(url()), id());
+		m_httpValidatorsChanged = false;
+	}
+
+	return false;
+}
+
+void StandardFeed::updateStateCommitted(bool committed) {
+	if (committed && m_httpValidatorsChanged) {
+		m_httpEtag = m_pendingHttpEtag;
+		m_httpLastModified = m_pendingHttpLastModified;
+	}
+
+	m_pendingHttpEtag.clear();
+	m_pendingHttpLastModified.clear();
+	m_httpValidatorsChanged = false;
+}
+
 StandardFeed::StandardFeed(const QSqlRecord& record) : Feed(nullptr) {
 	setTitle(QString::fromUtf8(record.value(FDS_DB_TITLE_INDEX).toByteArray()));
 	setId(record.value(FDS_DB_ID_INDEX).toInt());
@@ -485,5 +668,11 @@ StandardFeed::StandardFeed(const QSqlRecord& record) : Feed(nullptr) {
 
 	setAutoUpdateType(static_cast<Feed::AutoUpdateType>(record.value(FDS_DB_UPDATE_TYPE_INDEX).toInt()));
 	setAutoUpdateInitialInterval(record.value(FDS_DB_UPDATE_INTERVAL_INDEX).toInt());
+	setAutoUpdateDeadline(record.value(FDS_DB_UPDATE_DEADLINE_INDEX).toLongLong());
+	setHttpEtag(record.value(FDS_DB_HTTP_ETAG_INDEX).toString());
+	setHttpLastModified(record.value(FDS_DB_HTTP_LAST_MOD_INDEX).toString());
+	m_httpValidatorsChanged = false;
+	m_httpUpdateHint = 0;
+	m_documentUpdateHint = 0;
 	m_networkError = QNetworkReply::NoError;
 }
@@ -26,9 +26,11 @@
 #include <QPair>
 #include <QNetworkReply>
 #include <QCoreApplication>
+#include <QScopedPointer>
 
 
 class Message;
+class FeedParser;
 class FeedsModel;
 class StandardServiceRoot;
 
@@ -125,6 +127,14 @@ class StandardFeed : public Feed {
 
 		QNetworkReply::NetworkError networkError() const;
 
+		// Validators of last downloaded version of the feed,
+		// they are used for conditional HTTP requests.
+		QString httpEtag() const;
+		void setHttpEtag(const QString& http_etag);
+
+		QString httpLastModified() const;
+		void setHttpLastModified(const QString& http_last_modified);
+
 		// Tries to guess feed hidden under given URL
 		// and uses given credentials.
 		// Returns pointer to guessed feed (if at least partially
@@ -134,16 +144,40 @@ class StandardFeed : public Feed {
 		        const QString& username = QString(),
 		        const QString& password = QString());
 
+		// Thread-safe variant of guessFeed(), which does not touch
+		// settings nor GUI classes. Raw icon data are returned
+		// via "icon_data", returned feed lives in caller thread.
+		static QPair<StandardFeed*, QNetworkReply::NetworkError> guessFeedMetadata(const QString& url, int timeout,
+		        QByteArray& icon_data,
+		        const QString& username = QString(),
+		        const QString& password = QString());
+
 		// Converts particular feed type to string.
 		static QString typeToString(Type type);
 
+		bool supportsAsynchronousUpdate() const;
+		void startDownload(Downloader* downloader);
+		bool finishDownload(Downloader* downloader, QByteArray* feed_contents, bool* error_during_obtaining);
+		QList<Message> parseDownloadedData(const QByteArray& feed_contents);
+		void updateStateCommitted(bool committed);
+
 	public slots:
 		// Fetches metadata for the feed.
 		void fetchMetadataForItself();
 
+	protected:
+		bool updateStateStored(QSqlDatabase database);
+
 	private:
 		QList<Message> obtainNewMessages(bool* error_during_obtaining);
 
+		// Returns new parser of this feed's type and encoding or null if type is unknown.
+		FeedParser* createParser() const;
+
+		// Returns minimal update interval (in seconds) requested by
+		// "Retry-After" or "Cache-Control" headers of last response.
+		static int httpUpdateHint(const Downloader* downloader);
+
 	private:
 		bool m_passwordProtected;
 		QString m_username;
@@ -152,6 +186,24 @@ class StandardFeed : public Feed {
 		Type m_type;
 		QNetworkReply::NetworkError m_networkError;
 		QString m_encoding;
+
+		QString m_httpEtag;
+		QString m_httpLastModified;
+
+		// Validators sent with last downloaded version of the feed, they
+		// replace current ones when messages of that version are committed.
+		QString m_pendingHttpEtag;
+		QString m_pendingHttpLastModified;
+
+		// True if validators were changed by last update and need to be stored.
+		bool m_httpValidatorsChanged;
+
+		// Update intervals requested by last response and last parsed document.
+		int m_httpUpdateHint;
+		int m_documentUpdateHint;
+
+		// Parser which reads the feed while it is being downloaded.
+		QScopedPointer<FeedParser> m_parser;
 };
 
 Q_DECLARE_METATYPE(StandardFeed::Type)
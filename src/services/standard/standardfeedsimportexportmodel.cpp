@@ -23,12 +23,21 @@
 #include "definitions/definitions.h"
 #include "miscellaneous/application.h"
 #include "miscellaneous/iconfactory.h"
+#include "miscellaneous/settings.h"
 
 #include <QDomDocument>
 #include <QDomElement>
 #include <QDomAttr>
 #include <QStack>
 #include <QLocale>
+#include <QUrl>
+#include <QPixmap>
+#include <QEventLoop>
+#include <QThreadPool>
+#include <QFutureWatcher>
+#include <QtConcurrent/QtConcurrentRun>
+
+#include <functional>
 
 
 FeedsImportExportModel::FeedsImportExportModel(QObject* parent)
@@ -153,6 +162,7 @@ void FeedsImportExportModel::importAsOPML20(const QByteArray& data, bool fetch_m
 
 	int completed = 0, total = 0, succeded = 0, failed = 0;
 	StandardServiceRoot* root_item = new StandardServiceRoot();
+	QList<StandardFeed*> feeds_to_fetch;
 	QStack<RootItem*> model_items;
 	model_items.push(root_item);
 	QStack<QDomElement> elements_to_process;
@@ -178,51 +188,41 @@ void FeedsImportExportModel::importAsOPML20(const QByteArray& data, bool fetch_m
 					QString feed_url = child_element.attribute(QSL("xmlUrl"));
 
 					if (!feed_url.isEmpty()) {
-						QPair<StandardFeed*, QNetworkReply::NetworkError> guessed;
+						QString feed_title = child_element.attribute(QSL("text"));
+						QString feed_encoding = child_element.attribute(QSL("encoding"), DEFAULT_FEED_ENCODING);
+						QString feed_type = child_element.attribute(QSL("version"), DEFAULT_FEED_TYPE).toUpper();
+						QString feed_description = child_element.attribute(QSL("description"));
+						QIcon feed_icon = qApp->icons()->fromByteArray(child_element.attribute(QSL("rssguard:icon")).toLocal8Bit());
+						StandardFeed* new_feed = new StandardFeed(active_model_item);
+						new_feed->setTitle(feed_title);
+						new_feed->setDescription(feed_description);
+						new_feed->setEncoding(feed_encoding);
+						new_feed->setUrl(feed_url);
+						new_feed->setCreationDate(QDateTime::currentDateTime());
+						new_feed->setIcon(feed_icon.isNull() ? qApp->icons()->fromTheme(QSL("application-rss+xml")) : feed_icon);
+
+						if (feed_type == QL1S("RSS1")) {
+							new_feed->setType(StandardFeed::Rdf);
+						}
 
-						if (fetch_metadata_online &&
-						        (guessed = StandardFeed::guessFeed(feed_url)).second == QNetworkReply::NoError) {
-							// We should obtain fresh metadata from online feed source.
-							guessed.first->setUrl(feed_url);
-							active_model_item->appendChild(guessed.first);
-							succeded++;
+						else if (feed_type == QL1S("ATOM")) {
+							new_feed->setType(StandardFeed::Atom10);
+						}
+
+						else {
+							new_feed->setType(StandardFeed::Rss2X);
+						}
+
+						active_model_item->appendChild(new_feed);
+
+						if (fetch_metadata_online) {
+							// Metadata of all feeds are fetched later at once,
+							// data from OPML file serve as fallback.
+							feeds_to_fetch.append(new_feed);
 						}
 
 						else {
-							QString feed_title = child_element.attribute(QSL("text"));
-							QString feed_encoding = child_element.attribute(QSL("encoding"), DEFAULT_FEED_ENCODING);
-							QString feed_type = child_element.attribute(QSL("version"), DEFAULT_FEED_TYPE).toUpper();
-							QString feed_description = child_element.attribute(QSL("description"));
-							QIcon feed_icon = qApp->icons()->fromByteArray(child_element.attribute(QSL("rssguard:icon")).toLocal8Bit());
-							StandardFeed* new_feed = new StandardFeed(active_model_item);
-							new_feed->setTitle(feed_title);
-							new_feed->setDescription(feed_description);
-							new_feed->setEncoding(feed_encoding);
-							new_feed->setUrl(feed_url);
-							new_feed->setCreationDate(QDateTime::currentDateTime());
-							new_feed->setIcon(feed_icon.isNull() ? qApp->icons()->fromTheme(QSL("application-rss+xml")) : feed_icon);
-
-							if (feed_type == QL1S("RSS1")) {
-								new_feed->setType(StandardFeed::Rdf);
-							}
-
-							else if (feed_type == QL1S("ATOM")) {
-								new_feed->setType(StandardFeed::Atom10);
-							}
-
-							else {
-								new_feed->setType(StandardFeed::Rss2X);
-							}
-
-							active_model_item->appendChild(new_feed);
-
-							if (fetch_metadata_online && guessed.second != QNetworkReply::NoError) {
-								failed++;
-							}
-
-							else {
-								succeded++;
-							}
+							succeded++;
 						}
 					}
 				}
@@ -254,11 +254,18 @@ void FeedsImportExportModel::importAsOPML20(const QByteArray& data, bool fetch_m
 					model_items.push(new_category);
 				}
 
-				emit parsingProgress(++completed, total);
+				if (!fetch_metadata_online) {
+					emit parsingProgress(++completed, total);
+				}
 			}
 		}
 	}
 
+	if (fetch_metadata_online) {
+		failed = fetchMetadataOnline(feeds_to_fetch);
+		succeded = feeds_to_fetch.size() - failed;
+	}
+
 	// Now, XML is processed and we have result in form of pointer item structure.
 	emit layoutAboutToBeChanged();
 	setRootItem(root_item);
@@ -281,38 +288,26 @@ void FeedsImportExportModel::importAsTxtURLPerLine(const QByteArray& data, bool
 	emit layoutChanged();
 	int completed = 0, succeded = 0, failed = 0;
 	StandardServiceRoot* root_item = new StandardServiceRoot();
+	QList<StandardFeed*> feeds_to_fetch;
 	QList<QByteArray> urls = data.split('\n');
 
 	foreach (const QByteArray& url, urls) {
 		if (!url.isEmpty()) {
-			QPair<StandardFeed*, QNetworkReply::NetworkError> guessed;
-
-			if (fetch_metadata_online &&
-			        (guessed = StandardFeed::guessFeed(url)).second == QNetworkReply::NoError) {
-				guessed.first->setUrl(url);
-				root_item->appendChild(guessed.first);
-				succeded++;
+			StandardFeed* feed = new StandardFeed();
+			feed->setUrl(url);
+			feed->setTitle(url);
+			feed->setCreationDate(QDateTime::currentDateTime());
+			feed->setIcon(qApp->icons()->fromTheme(QSL("application-rss+xml")));
+			feed->setEncoding(DEFAULT_FEED_ENCODING);
+			root_item->appendChild(feed);
+
+			if (fetch_metadata_online) {
+				feeds_to_fetch.append(feed);
 			}
 
 			else {
-				StandardFeed* feed = new StandardFeed();
-				feed->setUrl(url);
-				feed->setTitle(url);
-				feed->setCreationDate(QDateTime::currentDateTime());
-				feed->setIcon(qApp->icons()->fromTheme(QSL("application-rss+xml")));
-				feed->setEncoding(DEFAULT_FEED_ENCODING);
-				root_item->appendChild(feed);
-
-				if (fetch_metadata_online && guessed.second != QNetworkReply::NoError) {
-					failed++;
-				}
-
-				else {
-					succeded++;
-				}
+				succeded++;
 			}
-
-			qApp->processEvents();
 		}
 
 		else {
@@ -320,7 +315,15 @@ void FeedsImportExportModel::importAsTxtURLPerLine(const QByteArray& data, bool
 			failed++;
 		}
 
-		emit parsingProgress(++completed, urls.size());
+		if (!fetch_metadata_online) {
+			emit parsingProgress(++completed, urls.size());
+		}
+	}
+
+	if (fetch_metadata_online) {
+		const int failed_lookups = fetchMetadataOnline(feeds_to_fetch);
+		failed += failed_lookups;
+		succeded = feeds_to_fetch.size() - failed_lookups;
 	}
 
 	// Now, XML is processed and we have result in form of pointer item structure.
@@ -330,6 +333,108 @@ void FeedsImportExportModel::importAsTxtURLPerLine(const QByteArray& data, bool
 	emit parsingFinished(failed, succeded, false);
 }
 
+int FeedsImportExportModel::fetchMetadataOnline(const QList<StandardFeed*>& feeds) {
+	if (feeds.isEmpty()) {
+		return 0;
+	}
+
+	const int timeout = qApp->settings()->value(GROUP(Feeds), SETTING(Feeds::UpdateTimeout)).toInt();
+	QVector<FeedLookup> lookups(feeds.size());
+	QList<int> pending_lookups;
+	QHash<QString, int> host_lookups;
+	QThreadPool lookup_pool;
+	QEventLoop loop;
+	int running = 0, completed = 0, failed = 0;
+	std::function<void()> start_lookups;
+
+	for (int i = 0; i < feeds.size(); i++) {
+		pending_lookups.append(i);
+	}
+
+	lookup_pool.setMaxThreadCount(FEEDS_IMPORT_MAX_LOOKUPS);
+	start_lookups = [&]() {
+		for (int i = 0; i < pending_lookups.size() && running < FEEDS_IMPORT_MAX_LOOKUPS;) {
+			const int index = pending_lookups.at(i);
+			const QString url = feeds.at(index)->url();
+			const QString host = QUrl(url).host();
+
+			if (host_lookups.value(host) >= FEEDS_IMPORT_MAX_HOST_LOOKUPS) {
+				// This host is busy, try next feed.
+				i++;
+				continue;
+			}
+
+			QFutureWatcher<FeedLookup>* watcher = new QFutureWatcher<FeedLookup>();
+			pending_lookups.removeAt(i);
+			host_lookups[host]++;
+			running++;
+			connect(watcher, &QFutureWatcher<FeedLookup>::finished, watcher, [&, watcher, index, host]() {
+				lookups[index] = watcher->result();
+				watcher->deleteLater();
+				running--;
+
+				if (--host_lookups[host] <= 0) {
+					host_lookups.remove(host);
+				}
+
+				emit parsingProgress(++completed, feeds.size());
+
+				if (completed == feeds.size()) {
+					loop.quit();
+				}
+
+				else {
+					start_lookups();
+				}
+			});
+			watcher->setFuture(QtConcurrent::run(&lookup_pool, [url, timeout]() {
+				FeedLookup lookup;
+				QPair<StandardFeed*, QNetworkReply::NetworkError> guessed = StandardFeed::guessFeedMetadata(url, timeout,
+				                                                                                           lookup.m_iconData);
+				lookup.m_feed = guessed.first;
+				lookup.m_error = guessed.second;
+
+				if (lookup.m_feed != nullptr) {
+					// Feed was created in worker thread, hand it over to GUI thread.
+					lookup.m_feed->moveToThread(qApp->thread());
+				}
+
+				return lookup;
+			}));
+		}
+	};
+
+	start_lookups();
+	loop.exec();
+
+	// All lookups are finished, apply their results in original order.
+	for (int i = 0; i < feeds.size(); i++) {
+		StandardFeed* feed = feeds.at(i);
+		const FeedLookup& lookup = lookups.at(i);
+
+		if (lookup.m_feed != nullptr && lookup.m_error == QNetworkReply::NoError) {
+			// We obtained fresh metadata from online feed source.
+			QPixmap icon_pixmap;
+			feed->setTitle(lookup.m_feed->title());
+			feed->setDescription(lookup.m_feed->description());
+			feed->setEncoding(lookup.m_feed->encoding());
+			feed->setType(lookup.m_feed->type());
+
+			if (icon_pixmap.loadFromData(lookup.m_iconData)) {
+				feed->setIcon(QIcon(icon_pixmap));
+			}
+		}
+
+		else {
+			failed++;
+		}
+
+		delete lookup.m_feed;
+	}
+
+	return failed;
+}
+
 FeedsImportExportModel::Mode FeedsImportExportModel::mode() const {
 	return m_mode;
 }
@@ -20,6 +20,10 @@
 
 #include "services/abstract/accountcheckmodel.h"
 
+#include <QNetworkReply>
+
+class StandardFeed;
+
 
 class FeedsImportExportModel : public AccountCheckModel {
 		Q_OBJECT
@@ -55,6 +59,20 @@ class FeedsImportExportModel : public AccountCheckModel {
 		void parsingFinished(int count_failed, int count_succeeded, bool parsing_error);
 
 	private:
+		struct FeedLookup {
+			FeedLookup() : m_feed(nullptr), m_error(QNetworkReply::UnknownNetworkError), m_iconData(QByteArray()) {}
+
+			StandardFeed* m_feed;
+			QNetworkReply::NetworkError m_error;
+			QByteArray m_iconData;
+		};
+
+		// Obtains metadata of given feeds from their online sources. Lookups
+		// run in parallel (with global and per-host limit) and given feeds are
+		// updated in their original order once all lookups are finished.
+		// Returns number of feeds whose metadata could not be obtained.
+		int fetchMetadataOnline(const QList<StandardFeed*>& feeds);
+
 		Mode m_mode;
 };
 
@@ -31,6 +31,15 @@
 // Limitations
 #define MAX_MESSAGES      200
 
+// Special feeds.
+#define STARRED_ARTICLES_FEED_ID  -1
+#define ALL_ARTICLES_FEED_ID      -4
+
+// View modes of headlines.
+#define VIEW_MODE_ALL_ARTICLES  "all_articles"
+#define VIEW_MODE_UNREAD        "unread"
+#define VIEW_MODE_MARKED        "marked"
+
 // General return status codes.
 #define API_STATUS_OK     0
 #define API_STATUS_ERR    1
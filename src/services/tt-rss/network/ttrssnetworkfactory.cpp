@@ -182,9 +182,9 @@ TtRssGetFeedsCategoriesResponse TtRssNetworkFactory::getFeedsCategories() {
 	return result;
 }
 
-TtRssGetHeadlinesResponse TtRssNetworkFactory::getHeadlines(int feed_id, int limit, int skip,
-                                                            bool show_content, bool include_attachments,
-                                                            bool sanitize) {
+TtRssGetHeadlinesResponse TtRssNetworkFactory::getHeadlines(int feed_id, int limit, int skip, int since_id,
+                                                            const QString& view_mode, bool show_content,
+                                                            bool include_attachments, bool sanitize) {
 	QJsonObject json;
 	json["op"] = QSL("getHeadlines");
 	json["sid"] = m_sessionId;
@@ -192,6 +192,8 @@ TtRssGetHeadlinesResponse TtRssNetworkFactory::getHeadlines(int feed_id, int lim
 	json["force_update"] = m_forceServerSideUpdate;
 	json["limit"] = limit;
 	json["skip"] = skip;
+	json["since_id"] = since_id;
+	json["view_mode"] = view_mode;
 	json["show_content"] = show_content;
 	json["include_attachments"] = include_attachments;
 	json["sanitize"] = sanitize;
@@ -215,8 +217,6 @@ TtRssGetHeadlinesResponse TtRssNetworkFactory::getHeadlines(int feed_id, int lim
 		result = TtRssGetHeadlinesResponse(QString::fromUtf8(result_raw));
 	}
 
-	IOFactory::writeTextFile("aaa", result_raw);
-
 	if (network_reply.first != QNetworkReply::NoError) {
 		qWarning("TT-RSS: getHeadlines failed with error %d.", network_reply.first);
 	}
@@ -225,6 +225,40 @@ TtRssGetHeadlinesResponse TtRssNetworkFactory::getHeadlines(int feed_id, int lim
 	return result;
 }
 
+TtRssGetCountersResponse TtRssNetworkFactory::getCounters() {
+	QJsonObject json;
+	json["op"] = QSL("getCounters");
+	json["sid"] = m_sessionId;
+	// Counters of feeds, virtual feeds included.
+	json["output_mode"] = QSL("f");
+	const int timeout = qApp->settings()->value(GROUP(Feeds), SETTING(Feeds::UpdateTimeout)).toInt();
+	QByteArray result_raw;
+	NetworkResult network_reply = NetworkFactory::performNetworkOperation(m_fullUrl, timeout,
+	                              QJsonDocument(json).toJson(QJsonDocument::Compact),
+	                              CONTENT_TYPE, result_raw,
+	                              QNetworkAccessManager::PostOperation,
+	                              m_authIsUsed, m_authUsername, m_authPassword);
+	TtRssGetCountersResponse result(QString::fromUtf8(result_raw));
+
+	if (result.isNotLoggedIn()) {
+		// We are not logged in.
+		login();
+		json["sid"] = m_sessionId;
+		network_reply = NetworkFactory::performNetworkOperation(m_fullUrl, timeout, QJsonDocument(json).toJson(QJsonDocument::Compact),
+		                                                        CONTENT_TYPE, result_raw,
+		                                                        QNetworkAccessManager::PostOperation,
+		                                                        m_authIsUsed, m_authUsername, m_authPassword);
+		result = TtRssGetCountersResponse(QString::fromUtf8(result_raw));
+	}
+
+	if (network_reply.first != QNetworkReply::NoError) {
+		qWarning("TT-RSS: getCounters failed with error %d.", network_reply.first);
+	}
+
+	m_lastError = network_reply.first;
+	return result;
+}
+
 TtRssUpdateArticleResponse TtRssNetworkFactory::updateArticles(const QStringList& ids,
         UpdateArticle::OperatingField field,
         UpdateArticle::Mode mode) {
@@ -563,7 +597,8 @@ QList<Message> TtRssGetHeadlinesResponse::messages() const {
 		message.m_created = TextFactory::parseDateTime(mapped["updated"].toDouble() * 1000);
 		message.m_createdFromFeed = true;
 		message.m_customId = QString::number(mapped["id"].toInt());
-		message.m_feedId = mapped["feed_id"].toString();
+		// NOTE: Some versions of Tiny Tiny RSS send feed ID as string, others as number.
+		message.m_feedId = mapped["feed_id"].toVariant().toString();
 		message.m_title = mapped["title"].toString();
 		message.m_url = mapped["link"].toString();
 
@@ -585,6 +620,43 @@ QList<Message> TtRssGetHeadlinesResponse::messages() const {
 }
 
 
+TtRssGetCountersResponse::TtRssGetCountersResponse(const QString& raw_content) : TtRssResponse(raw_content) {
+}
+
+TtRssGetCountersResponse::~TtRssGetCountersResponse() {
+}
+
+QHash<int, int> TtRssGetCountersResponse::unreadCounts() const {
+	QHash<int, int> counts;
+
+	foreach (const QJsonValue& item, m_rawContent["content"].toArray()) {
+		const QJsonObject mapped = item.toObject();
+		bool is_number;
+		// NOTE: Global counters have textual IDs, categories are marked by "kind".
+		const int feed_id = mapped["id"].toVariant().toString().toInt(&is_number);
+
+		if (is_number && feed_id > 0 && !mapped.contains(QSL("kind"))) {
+			counts.insert(feed_id, mapped["counter"].toInt());
+		}
+	}
+
+	return counts;
+}
+
+int TtRssGetCountersResponse::starredCount() const {
+	foreach (const QJsonValue& item, m_rawContent["content"].toArray()) {
+		const QJsonObject mapped = item.toObject();
+
+		// Virtual feed of starred headlines reports their total count as its auxiliary counter.
+		if (mapped["id"].toVariant().toInt() == STARRED_ARTICLES_FEED_ID && !mapped.contains(QSL("kind")) &&
+		        mapped.contains(QSL("auxcounter"))) {
+			return mapped["auxcounter"].toInt();
+		}
+	}
+
+	return -1;
+}
+
 TtRssUpdateArticleResponse::TtRssUpdateArticleResponse(const QString& raw_content) : TtRssResponse(raw_content) {
 }
 
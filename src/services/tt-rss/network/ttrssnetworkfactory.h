@@ -22,6 +22,7 @@
 
 #include <QString>
 #include <QPair>
+#include <QHash>
 #include <QNetworkReply>
 #include <QJsonObject>
 
@@ -75,6 +76,18 @@ class TtRssGetHeadlinesResponse : public TtRssResponse {
 		QList<Message> messages() const;
 };
 
+class TtRssGetCountersResponse : public TtRssResponse {
+	public:
+		explicit TtRssGetCountersResponse(const QString& raw_content = QString());
+		virtual ~TtRssGetCountersResponse();
+
+		// Returns numbers of unread headlines of particular feeds.
+		QHash<int, int> unreadCounts() const;
+
+		// Returns number of all starred headlines or -1 if server does not report it.
+		int starredCount() const;
+};
+
 class TtRssUpdateArticleResponse : public TtRssResponse {
 	public:
 		explicit TtRssUpdateArticleResponse(const QString& raw_content = QString());
@@ -155,10 +168,14 @@ class TtRssNetworkFactory {
 		// Gets feeds from the server.
 		TtRssGetFeedsCategoriesResponse getFeedsCategories();
 
-		// Gets headlines (messages) from the server.
-		TtRssGetHeadlinesResponse getHeadlines(int feed_id, int limit, int skip,
-		                                       bool show_content, bool include_attachments,
-		                                       bool sanitize);
+		// Gets headlines (messages) from the server, only headlines
+		// with ID greater than "since_id" which match "view_mode" are returned.
+		TtRssGetHeadlinesResponse getHeadlines(int feed_id, int limit, int skip, int since_id,
+		                                       const QString& view_mode, bool show_content,
+		                                       bool include_attachments, bool sanitize);
+
+		// Gets counters of unread and starred headlines of feeds.
+		TtRssGetCountersResponse getCounters();
 
 		TtRssUpdateArticleResponse updateArticles(const QStringList& ids, UpdateArticle::OperatingField field,
 		                                          UpdateArticle::Mode mode);
@@ -41,6 +41,7 @@ TtRssFeed::TtRssFeed(const QSqlRecord& record) : Feed(nullptr) {
 	setIcon(qApp->icons()->fromByteArray(record.value(FDS_DB_ICON_INDEX).toByteArray()));
 	setAutoUpdateType(static_cast<Feed::AutoUpdateType>(record.value(FDS_DB_UPDATE_TYPE_INDEX).toInt()));
 	setAutoUpdateInitialInterval(record.value(FDS_DB_UPDATE_INTERVAL_INDEX).toInt());
+	setAutoUpdateDeadline(record.value(FDS_DB_UPDATE_DEADLINE_INDEX).toLongLong());
 	setCustomId(record.value(FDS_DB_CUSTOM_ID_INDEX).toInt());
 	qDebug("Custom ID of TT-RSS feed when loading from DB is '%s'.", qPrintable(record.value(FDS_DB_CUSTOM_ID_INDEX).toString()));
 }
@@ -69,6 +70,14 @@ QVariant TtRssFeed::data(int column, int role) const {
 						auto_update_string = tr("uses global settings");
 						break;
 
+					case AdaptiveAutoUpdate:
+						//: Describes feed auto-update status.
+						auto_update_string = tr("adapts to publishing rate of the feed "
+						                        "(%n minute(s) to next auto-update)",
+						                        0,
+						                        autoUpdateRemainingInterval());
+						break;
+
 					case SpecificAutoUpdate:
 					default:
 						//: Describes feed auto-update status.
@@ -135,7 +144,7 @@ bool TtRssFeed::cleanMessages(bool clear_only_read) {
 }
 
 bool TtRssFeed::editItself(TtRssFeed* new_feed_data) {
-	QSqlDatabase database = qApp->database()->connection("aa", DatabaseFactory::FromSettings);
+	QSqlDatabase database = qApp->database()->connection(metaObject()->className(), DatabaseFactory::FromSettings);
 
 	if (DatabaseQueries::editBaseFeed(database, id(), new_feed_data->autoUpdateType(),
 	                                  new_feed_data->autoUpdateInitialInterval())) {
@@ -150,35 +159,24 @@ bool TtRssFeed::editItself(TtRssFeed* new_feed_data) {
 }
 
 QList<Message> TtRssFeed::obtainNewMessages(bool* error_during_obtaining) {
-	QList<Message> messages;
-	int newly_added_messages = 0;
-	int limit = MAX_MESSAGES;
-	int skip = 0;
-
-	do {
-		TtRssGetHeadlinesResponse headlines = serviceRoot()->network()->getHeadlines(customId(), limit, skip,
-		                                      true, true, false);
-
-		if (serviceRoot()->network()->lastError() != QNetworkReply::NoError) {
-			setStatus(Feed::NetworkError);
-			*error_during_obtaining = true;
-			serviceRoot()->itemChanged(QList<RootItem*>() << this);
-			return QList<Message>();
-		}
-
-		else {
-			QList<Message> new_messages = headlines.messages();
-			messages.append(new_messages);
-			newly_added_messages = new_messages.size();
-			skip += newly_added_messages;
-		}
+	const QList<Message> messages = serviceRoot()->obtainNewMessages(customId(), error_during_obtaining);
+
+	if (*error_during_obtaining) {
+		setStatus(Feed::NetworkError);
+		serviceRoot()->itemChanged(QList<RootItem*>() << this);
 	}
-	while (newly_added_messages > 0);
 
-	*error_during_obtaining = false;
 	return messages;
 }
 
+void TtRssFeed::updateStateCommitted(bool committed) {
+	serviceRoot()->headlinesCommitted(customId(), committed);
+}
+
+bool TtRssFeed::updateStateStored(QSqlDatabase database) {
+	return serviceRoot()->synchronizeMessageStates(database, customId());
+}
+
 bool TtRssFeed::removeItself() {
 	QSqlDatabase database = qApp->database()->connection(metaObject()->className(), DatabaseFactory::FromSettings);
 	return DatabaseQueries::deleteFeed(database, customId(), serviceRoot()->accountId());
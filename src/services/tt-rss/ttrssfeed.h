@@ -46,6 +46,11 @@ class TtRssFeed : public Feed {
 		bool editItself(TtRssFeed* new_feed_data);
 		bool removeItself();
 
+		void updateStateCommitted(bool committed);
+
+	protected:
+		bool updateStateStored(QSqlDatabase database);
+
 	private:
 		QList<Message> obtainNewMessages(bool* error_during_obtaining);
 };
@@ -40,7 +40,8 @@
 
 TtRssServiceRoot::TtRssServiceRoot(RootItem* parent)
 	: ServiceRoot(parent), CacheForServiceRoot(), m_recycleBin(new TtRssRecycleBin(this)),
-	  m_actionSyncIn(nullptr), m_serviceMenu(QList<QAction*>()), m_network(new TtRssNetworkFactory()) {
+	  m_actionSyncIn(nullptr), m_serviceMenu(QList<QAction*>()), m_network(new TtRssNetworkFactory()),
+	  m_starredHeadlinesObtained(false), m_obtainedHeadlineId(0), m_lastHeadlineId(0) {
 	setIcon(TtRssServiceEntryPoint().icon());
 }
 
@@ -236,6 +237,298 @@ TtRssNetworkFactory* TtRssServiceRoot::network() const {
 	return m_network;
 }
 
+int TtRssServiceRoot::lastHeadlineId() const {
+	return m_lastHeadlineId;
+}
+
+void TtRssServiceRoot::setLastHeadlineId(int last_headline_id) {
+	QMutexLocker locker(&m_pendingHeadlinesMutex);
+
+	m_pendingHeadlines.clear();
+	m_uncommittedHeadlines.clear();
+	m_unstoredHeadlineIds.clear();
+	m_feedsToSynchronize.clear();
+	m_synchronizedFeeds.clear();
+	m_obtainedHeadlineId = last_headline_id;
+	m_lastHeadlineId = last_headline_id;
+}
+
+QList<Message> TtRssServiceRoot::obtainNewMessages(int feed_custom_id, bool* error_during_obtaining) {
+	QMutexLocker locker(&m_pendingHeadlinesMutex);
+
+	// Headlines of this feed were already handed out, new ones are obtained for all feeds.
+	if (!m_pendingHeadlines.contains(feed_custom_id) && !obtainNewHeadlines()) {
+		*error_during_obtaining = true;
+		return QList<Message>();
+	}
+
+	QSqlDatabase database = qApp->database()->connection(metaObject()->className(), DatabaseFactory::FromSettings);
+	QList<Message> messages;
+	bool ok;
+
+	// Feed which was not synchronized yet (for example it was just added on the server)
+	// does not have its older headlines, they are below the high-water mark.
+	if (!DatabaseQueries::hasFeedAnyMessages(database, feed_custom_id, accountId(), &ok) && ok &&
+	    !obtainAllHeadlines(feed_custom_id, messages)) {
+		*error_during_obtaining = true;
+		return QList<Message>();
+	}
+
+	const QList<Message> pending_messages = m_pendingHeadlines.take(feed_custom_id);
+	QSet<QString> obtained_ids;
+
+	foreach (const Message& message, messages) {
+		obtained_ids.insert(message.m_customId);
+	}
+
+	foreach (const Message& message, pending_messages) {
+		if (!obtained_ids.contains(message.m_customId)) {
+			messages.append(message);
+		}
+	}
+
+	// Handed out headlines are remembered until they are committed.
+	m_uncommittedHeadlines[feed_custom_id].append(pending_messages);
+	*error_during_obtaining = false;
+	return messages;
+}
+
+bool TtRssServiceRoot::synchronizeMessageStates(QSqlDatabase database, int feed_custom_id) {
+	QMutexLocker locker(&m_pendingHeadlinesMutex);
+
+	if (!m_feedsToSynchronize.remove(feed_custom_id)) {
+		return false;
+	}
+
+	m_synchronizedFeeds.insert(feed_custom_id);
+	const QHash<int, QSet<int>>::const_iterator unread_ids = m_unreadHeadlineIds.constFind(feed_custom_id);
+
+	return DatabaseQueries::synchronizeMessageStates(database, feed_custom_id, accountId(),
+	                                                 unread_ids != m_unreadHeadlineIds.constEnd() ? &unread_ids.value() : nullptr,
+	                                                 m_starredHeadlinesObtained ? &m_starredHeadlineIds : nullptr) > 0;
+}
+
+void TtRssServiceRoot::headlinesCommitted(int feed_custom_id, bool committed) {
+	QMutexLocker locker(&m_pendingHeadlinesMutex);
+	const QList<Message> messages = m_uncommittedHeadlines.take(feed_custom_id);
+
+	if (m_synchronizedFeeds.remove(feed_custom_id) && !committed) {
+		m_feedsToSynchronize.insert(feed_custom_id);
+	}
+
+	if (messages.isEmpty()) {
+		return;
+	}
+
+	else if (committed) {
+		foreach (const Message& message, messages) {
+			m_unstoredHeadlineIds.remove(message.m_customId.toInt());
+		}
+
+		storeLastHeadlineId();
+	}
+
+	else {
+		// Headlines are handed to the feed again with its next update.
+		m_pendingHeadlines[feed_custom_id] = messages + m_pendingHeadlines.value(feed_custom_id);
+	}
+}
+
+bool TtRssServiceRoot::obtainNewHeadlines() {
+	QSet<int> feed_ids;
+
+	foreach (const Feed* feed, getSubTreeFeeds()) {
+		feed_ids.insert(feed->customId());
+	}
+
+	// Headlines of feeds which were removed from the account would be never stored.
+	foreach (int feed_id, m_pendingHeadlines.keys()) {
+		if (!feed_ids.contains(feed_id)) {
+			foreach (const Message& message, m_pendingHeadlines.take(feed_id)) {
+				m_unstoredHeadlineIds.remove(message.m_customId.toInt());
+			}
+		}
+	}
+
+	int obtained_headline_id = m_obtainedHeadlineId;
+	int skip = 0;
+	int newly_added_messages;
+
+	do {
+		// Virtual feed with all articles covers whole account in one request.
+		TtRssGetHeadlinesResponse headlines = m_network->getHeadlines(ALL_ARTICLES_FEED_ID, MAX_MESSAGES, skip,
+		                                                              m_obtainedHeadlineId, VIEW_MODE_ALL_ARTICLES,
+		                                                              true, true, false);
+
+		if (m_network->lastError() != QNetworkReply::NoError) {
+			return false;
+		}
+
+		const QList<Message> new_messages = headlines.messages();
+
+		foreach (const Message& message, new_messages) {
+			const int message_id = message.m_customId.toInt();
+			const int feed_id = message.m_feedId.toInt();
+
+			obtained_headline_id = qMax(obtained_headline_id, message_id);
+
+			// Headlines obtained earlier but not yet stored are not duplicated. Headlines of feeds
+			// which are not synchronized into the account yet are obtained when the feeds are added.
+			if (feed_ids.contains(feed_id) && !m_unstoredHeadlineIds.contains(message_id)) {
+				m_unstoredHeadlineIds.insert(message_id);
+				m_pendingHeadlines[feed_id].append(message);
+			}
+		}
+
+		newly_added_messages = new_messages.size();
+		skip += newly_added_messages;
+	}
+	while (newly_added_messages > 0);
+
+	qDebug("TT-RSS: Obtained new headlines of account '%d' since ID '%d'.", accountId(), m_obtainedHeadlineId);
+	m_obtainedHeadlineId = obtained_headline_id;
+
+	// Read and starred states of already stored messages can be changed on the server too.
+	if (!obtainChangedHeadlineStates(feed_ids)) {
+		return false;
+	}
+
+	// Every feed of the account has now its (possibly empty) list of new headlines.
+	foreach (int feed_id, feed_ids) {
+		if (!m_pendingHeadlines.contains(feed_id)) {
+			m_pendingHeadlines.insert(feed_id, QList<Message>());
+		}
+	}
+
+	storeLastHeadlineId();
+	return true;
+}
+
+bool TtRssServiceRoot::obtainAllHeadlines(int feed_custom_id, QList<Message>& messages) {
+	int skip = 0;
+	int newly_added_messages;
+
+	do {
+		TtRssGetHeadlinesResponse headlines = m_network->getHeadlines(feed_custom_id, MAX_MESSAGES, skip, 0,
+		                                                              VIEW_MODE_ALL_ARTICLES, true, true, false);
+
+		if (m_network->lastError() != QNetworkReply::NoError) {
+			return false;
+		}
+
+		const QList<Message> new_messages = headlines.messages();
+
+		messages.append(new_messages);
+		newly_added_messages = new_messages.size();
+		skip += newly_added_messages;
+	}
+	while (newly_added_messages > 0);
+
+	qDebug("TT-RSS: Obtained all %d headlines of feed '%d'.", messages.size(), feed_custom_id);
+	return true;
+}
+
+bool TtRssServiceRoot::obtainChangedHeadlineStates(const QSet<int>& feed_ids) {
+	TtRssGetCountersResponse counters = m_network->getCounters();
+
+	if (m_network->lastError() != QNetworkReply::NoError || counters.hasError()) {
+		return false;
+	}
+
+	QSqlDatabase database = qApp->database()->connection(metaObject()->className(), DatabaseFactory::FromSettings);
+	int starred_count;
+	bool ok;
+	QMap<int, int> unread_counts = DatabaseQueries::getStateCountsForSynchronization(database, accountId(),
+	                                                                                 &starred_count, &ok);
+
+	if (!ok) {
+		return false;
+	}
+
+	// Server counts also obtained headlines which are not stored yet.
+	QList<QHash<int, QList<Message>>> unstored_headlines;
+	unstored_headlines << m_pendingHeadlines << m_uncommittedHeadlines;
+
+	foreach (const QHash<int, QList<Message>>& headlines, unstored_headlines) {
+		for (QHash<int, QList<Message>>::const_iterator i = headlines.constBegin(); i != headlines.constEnd(); i++) {
+			foreach (const Message& message, i.value()) {
+				unread_counts[i.key()] += message.m_isRead ? 0 : 1;
+				starred_count += message.m_isImportant ? 1 : 0;
+			}
+		}
+	}
+
+	// Headlines are listed only for feeds whose counts differ, which is
+	// rare, so that states of large accounts are not downloaded each time.
+	const QHash<int, int> server_unread_counts = counters.unreadCounts();
+	const int server_starred_count = counters.starredCount();
+
+	m_unreadHeadlineIds.clear();
+	m_starredHeadlineIds.clear();
+	m_starredHeadlinesObtained = server_starred_count < 0 || server_starred_count != starred_count;
+
+	foreach (int feed_id, feed_ids) {
+		if (server_unread_counts.value(feed_id) != unread_counts.value(feed_id) &&
+		        !obtainHeadlineIds(feed_id, VIEW_MODE_UNREAD, m_unreadHeadlineIds[feed_id])) {
+			return false;
+		}
+	}
+
+	if (m_starredHeadlinesObtained && !obtainHeadlineIds(ALL_ARTICLES_FEED_ID, VIEW_MODE_MARKED, m_starredHeadlineIds)) {
+		m_starredHeadlinesObtained = false;
+		return false;
+	}
+
+	m_feedsToSynchronize = m_starredHeadlinesObtained ? feed_ids : m_unreadHeadlineIds.keys().toSet();
+	qDebug("TT-RSS: Read states of %d feeds of account '%d' differ from server, starred states %s.",
+	       m_unreadHeadlineIds.size(), accountId(), m_starredHeadlinesObtained ? "differ" : "match");
+	return true;
+}
+
+bool TtRssServiceRoot::obtainHeadlineIds(int feed_custom_id, const QString& view_mode, QSet<int>& headline_ids) {
+	int skip = 0;
+	int newly_added_messages;
+
+	do {
+		// Contents of headlines are not needed, just their IDs.
+		TtRssGetHeadlinesResponse headlines = m_network->getHeadlines(feed_custom_id, MAX_MESSAGES, skip, 0,
+		                                                              view_mode, false, false, false);
+
+		if (m_network->lastError() != QNetworkReply::NoError) {
+			return false;
+		}
+
+		const QList<Message> new_messages = headlines.messages();
+
+		foreach (const Message& message, new_messages) {
+			headline_ids.insert(message.m_customId.toInt());
+		}
+
+		newly_added_messages = new_messages.size();
+		skip += newly_added_messages;
+	}
+	while (newly_added_messages > 0);
+
+	return true;
+}
+
+void TtRssServiceRoot::storeLastHeadlineId() {
+	int last_headline_id = m_obtainedHeadlineId;
+
+	// Mark cannot get past any headline which is not stored yet.
+	foreach (int headline_id, m_unstoredHeadlineIds) {
+		last_headline_id = qMin(last_headline_id, headline_id - 1);
+	}
+
+	if (last_headline_id > m_lastHeadlineId) {
+		QSqlDatabase database = qApp->database()->connection(metaObject()->className(), DatabaseFactory::FromSettings);
+
+		if (DatabaseQueries::storeTtRssLastHeadlineId(database, last_headline_id, accountId())) {
+			m_lastHeadlineId = last_headline_id;
+		}
+	}
+}
+
 void TtRssServiceRoot::saveAccountDataToDatabase() {
 	QSqlDatabase database = qApp->database()->connection(metaObject()->className(), DatabaseFactory::FromSettings);
 
@@ -245,6 +538,9 @@ void TtRssServiceRoot::saveAccountDataToDatabase() {
 		                                           m_network->authIsUsed(), m_network->authUsername(),
 		                                           m_network->authPassword(), m_network->url(),
 		                                           m_network->forceServerSideUpdate(), accountId())) {
+			// All data of edited account are obtained again.
+			setLastHeadlineId(0);
+			DatabaseQueries::storeTtRssLastHeadlineId(database, 0, accountId());
 			updateTitle();
 			itemChanged(QList<RootItem*>() << this);
 		}
@@ -308,6 +604,7 @@ QMap<int, QVariant> TtRssServiceRoot::storeCustomFeedsData() {
 		QVariantMap feed_custom_data;
 		feed_custom_data.insert(QSL("auto_update_interval"), feed->autoUpdateInitialInterval());
 		feed_custom_data.insert(QSL("auto_update_type"), feed->autoUpdateType());
+		feed_custom_data.insert(QSL("auto_update_deadline"), feed->autoUpdateDeadline());
 		custom_data.insert(feed->customId(), feed_custom_data);
 	}
 
@@ -326,6 +623,7 @@ void TtRssServiceRoot::restoreCustomFeedsData(const QMap<int, QVariant>& data, c
 			QVariantMap feed_custom_data = i.value().toMap();
 			feed->setAutoUpdateInitialInterval(feed_custom_data.value(QSL("auto_update_interval")).toInt());
 			feed->setAutoUpdateType(static_cast<Feed::AutoUpdateType>(feed_custom_data.value(QSL("auto_update_type")).toInt()));
+			feed->setAutoUpdateDeadline(feed_custom_data.value(QSL("auto_update_deadline")).toLongLong());
 		}
 	}
 }
@@ -22,6 +22,9 @@
 #include "services/abstract/cacheforserviceroot.h"
 
 #include <QCoreApplication>
+#include <QMutex>
+#include <QSet>
+#include <QSqlDatabase>
 
 
 class TtRssCategory;
@@ -57,6 +60,30 @@ class TtRssServiceRoot : public ServiceRoot, public CacheForServiceRoot {
 		// Access to network.
 		TtRssNetworkFactory* network() const;
 
+		// High-water mark of synchronization, all headlines with
+		// this or lower ID were already stored.
+		int lastHeadlineId() const;
+
+		// Sets new high-water mark, obtained headlines which
+		// were not stored yet are forgotten.
+		void setLastHeadlineId(int last_headline_id);
+
+		// Returns new messages of given feed. All new headlines of the account
+		// are obtained with single request, headlines of other feeds are kept
+		// until these feeds are updated too. Feed without any stored messages
+		// gets all its headlines.
+		QList<Message> obtainNewMessages(int feed_custom_id, bool* error_during_obtaining);
+
+		// Sets read and starred states of stored messages of given feed according
+		// to the server, if it was not done since new headlines were obtained.
+		// Returns true if any message was changed.
+		bool synchronizeMessageStates(QSqlDatabase database, int feed_custom_id);
+
+		// Called when messages obtained for given feed were committed or rolled
+		// back. High-water mark is advanced only by committed headlines, rolled
+		// back ones are returned to the feed with its next update.
+		void headlinesCommitted(int feed_custom_id, bool committed);
+
 		void saveAccountDataToDatabase();
 		void updateTitle();
 
@@ -71,10 +98,49 @@ class TtRssServiceRoot : public ServiceRoot, public CacheForServiceRoot {
 
 		void loadFromDatabase();
 
+		// Downloads headlines newer than any obtained headline and IDs of unread
+		// and starred headlines whose counts differ from stored messages.
+		bool obtainNewHeadlines();
+
+		// Compares counters of the server with stored and obtained messages
+		// and downloads IDs of unread and starred headlines which differ.
+		bool obtainChangedHeadlineStates(const QSet<int>& feed_ids);
+
+		// Downloads all headlines of given feed.
+		bool obtainAllHeadlines(int feed_custom_id, QList<Message>& messages);
+
+		// Downloads IDs of all headlines of given feed with given view mode.
+		bool obtainHeadlineIds(int feed_custom_id, const QString& view_mode, QSet<int>& headline_ids);
+
+		// Persists high-water mark if it can be advanced.
+		void storeLastHeadlineId();
+
 		TtRssRecycleBin* m_recycleBin;
 		QAction* m_actionSyncIn;
 		QList<QAction*> m_serviceMenu;
 		TtRssNetworkFactory* m_network;
+
+		// Obtained headlines which were not handed to their feeds yet and
+		// headlines handed to feeds which were not committed yet.
+		QMutex m_pendingHeadlinesMutex;
+		QHash<int, QList<Message>> m_pendingHeadlines;
+		QHash<int, QList<Message>> m_uncommittedHeadlines;
+
+		// IDs of all obtained headlines which were not committed yet.
+		QSet<int> m_unstoredHeadlineIds;
+
+		// IDs of unread headlines of feeds and of starred headlines on the server, they are
+		// obtained only if counters of the server do not match stored messages. Feeds whose stored
+		// messages were not synchronized with them yet or not committed yet.
+		QHash<int, QSet<int>> m_unreadHeadlineIds;
+		QSet<int> m_starredHeadlineIds;
+		bool m_starredHeadlinesObtained;
+		QSet<int> m_feedsToSynchronize;
+		QSet<int> m_synchronizedFeeds;
+
+		// The highest ID of obtained headline and the high-water mark.
+		int m_obtainedHeadlineId;
+		int m_lastHeadlineId;
 };
 
 #endif // TTRSSSERVICEROOT_H